@@ -0,0 +1,326 @@
+#!/usr/bin/env python3
+"""
+Generate entity tables and repository implementations for @Entity / @Repository classes
+Scans the headers under src/ for classes annotated with @Entity and writes a
+header with one EntityTable specialization per entity: its name, its @Id member
+and every member annotated @Indexed. For each @Repository interface deriving from
+CpaRepository<T, ID> it then emits <Entity>EntityRepository, an EntityRepository
+whose FindBy<Member> methods go through the member's secondary index when it is
+@Indexed and scan the records otherwise. A @Storage("log") annotation on the
+interface stores the records in an EntityLogStore instead of one file each,
+@Storage("nvs") keeps them in NVS blobs through an NvsEntityStore, and
+@Cache("lru" | "size" | "pinned"[, bound]) gives the repository an EntityCache.
+
+Usage: generate_entity_repositories.py <output_header> [source_dir]
+Prints the scanned header paths (one per line) so build systems can track them.
+"""
+
+import re
+import sys
+from pathlib import Path
+
+ENTITY = re.compile(r'/\*\s*@Entity\s*\*/')
+REPOSITORY = re.compile(r'/\*\s*@Repository\s*\*/')
+CLASS_HEAD = re.compile(r'\b(?:class|struct)\s+(\w+)[^{;]*\{')
+STORAGE = re.compile(r'/\*\s*@Storage\(\s*"(\w+)"\s*\)\s*\*/')
+STORAGE_KINDS = ('file', 'log', 'nvs')
+CACHE = re.compile(r'/\*\s*@Cache\(\s*"(\w+)"\s*(?:,\s*(\d+)\s*)?\)\s*\*/')
+CACHE_OPTIONS = {'lru': 'Lru', 'size': 'SizeBounded', 'pinned': 'Pinned'}
+REPOSITORY_HEAD = re.compile(r'\bclass\s+(\w+)\s*:\s*public\s+CpaRepository\s*<\s*(\w+)\s*,\s*([^>{]+?)\s*>\s*\{')
+ANNOTATION = re.compile(r'/\*\s*@(\w+)\s*\*/')
+# Doc comments go, annotation comments stay
+PLAIN_COMMENT = re.compile(r'/\*(?!\s*@\w+\s*\*/).*?\*/', re.S)
+PUBLIC_FIELD = re.compile(r'^Public\s+(?!Static\b|static\b|Virtual\b|virtual\b)(.+?)\s+(\w+)\s*(?:=[^;]*|\{[^;]*\})?;$')
+OPTIONAL_TYPE = re.compile(r'^(?:std::)?optional\s*<\s*(.+)\s*>$')
+PURE_VIRTUAL = re.compile(r'^Public\s+Virtual\s+(.+?)\s+(\w+)\s*\((.*)\)\s*=\s*0\s*;$')
+FIND_BY = re.compile(r'^FindBy([A-Z]\w*)$')
+PARAMETER = re.compile(r'^(?:const\s+)?(.+?)\s*&?\s*(\w+)$')
+
+
+def class_body(text, open_brace):
+    """Return the text between the brace at open_brace and its matching close"""
+    depth = 0
+    for index in range(open_brace, len(text)):
+        if text[index] == '{':
+            depth += 1
+        elif text[index] == '}':
+            depth -= 1
+            if depth == 0:
+                return text[open_brace + 1:index]
+    return ''
+
+
+def statements(body):
+    """Top-level statements of a class body, each with the annotations before it"""
+    body = PLAIN_COMMENT.sub('', re.sub(r'//[^\n]*', '', body))
+    result = []
+    depth = 0
+    start = 0
+    for index, char in enumerate(body):
+        if char == '{':
+            depth += 1
+        elif char == '}':
+            depth -= 1
+            if depth == 0:
+                # End of a method body
+                start = index + 1
+        elif char == ';' and depth == 0:
+            text = body[start:index + 1]
+            start = index + 1
+            annotations = ANNOTATION.findall(text)
+            result.append((annotations, ' '.join(ANNOTATION.sub('', text).split())))
+    return result
+
+
+def find_entities(source_dir):
+    """Return {class_name: entity} for every @Entity with a public optional @Id member"""
+    entities = {}
+    for header in sorted(source_dir.rglob('*.h')):
+        text = header.read_text(encoding='utf-8', errors='ignore')
+        for annotation in ENTITY.finditer(text):
+            head = CLASS_HEAD.search(text, annotation.end())
+            if not head:
+                continue
+            name = head.group(1)
+            fields = {}
+            id_field = None
+            indexed = []
+            for annotations, statement in statements(class_body(text, head.end() - 1)):
+                match = PUBLIC_FIELD.match(statement)
+                if not match or '(' in statement:
+                    continue
+                field_type = ' '.join(match.group(1).split())
+                field = match.group(2)
+                fields[field] = field_type
+                if 'Id' in annotations:
+                    id_field = field
+                if 'Indexed' in annotations:
+                    indexed.append(field)
+            if id_field is None or not OPTIONAL_TYPE.match(fields[id_field]):
+                # e.g. a private or non-optional @Id; the framework alone handles these
+                continue
+            for field in list(indexed):
+                if not OPTIONAL_TYPE.match(fields[field]):
+                    print(f"Warning: {name}::{field} is @Indexed but not optional<...>, not indexed", file=sys.stderr)
+                    indexed.remove(field)
+            entities[name] = {
+                'header': header,
+                'fields': fields,
+                'id': id_field,
+                'id_type': OPTIONAL_TYPE.match(fields[id_field]).group(1).strip(),
+                'indexed': indexed,
+            }
+    return entities
+
+
+def find_repositories(source_dir, entities):
+    """Return a dict per @Repository interface of a known entity: header, names, storage, cache and queries"""
+    repositories = []
+    for header in sorted(source_dir.rglob('*.h')):
+        text = header.read_text(encoding='utf-8', errors='ignore')
+        for annotation in REPOSITORY.finditer(text):
+            head = REPOSITORY_HEAD.search(text, annotation.end())
+            if not head:
+                continue
+            repository, entity, id_type = head.group(1), head.group(2), ' '.join(head.group(3).split())
+            if entity not in entities:
+                continue
+            storage = STORAGE.search(text, annotation.end(), head.start())
+            storage = storage.group(1) if storage else 'file'
+            if storage not in STORAGE_KINDS:
+                print(f"Warning: {repository} has unknown @Storage(\"{storage}\"), using file storage", file=sys.stderr)
+                storage = 'file'
+            cache = CACHE.search(text, annotation.end(), head.start())
+            if cache and cache.group(1) not in CACHE_OPTIONS:
+                print(f"Warning: {repository} has unknown @Cache(\"{cache.group(1)}\"), not cached", file=sys.stderr)
+                cache = None
+            if cache and cache.group(1) == 'pinned' and cache.group(2):
+                print(f"Warning: {repository} has a bound on a pinned cache, ignored", file=sys.stderr)
+            queries = []
+            supported = True
+            for _, statement in statements(class_body(text, head.end() - 1)):
+                method = PURE_VIRTUAL.match(statement)
+                if not method:
+                    continue
+                query = derive_query(entities[entity], entity, method)
+                if query is None:
+                    print(f"Warning: cannot derive {repository}::{method.group(2)}, "
+                          f"no {entity}EntityRepository generated", file=sys.stderr)
+                    supported = False
+                    break
+                queries.append(query)
+            if supported:
+                repositories.append({
+                    'header': header,
+                    'repository': repository,
+                    'entity': entity,
+                    'id_type': id_type,
+                    'storage': storage,
+                    'cache': cache_options(cache),
+                    'queries': queries,
+                })
+    return repositories
+
+
+def cache_options(cache):
+    """EntityCacheOptions expression for a @Cache match, None without one"""
+    if cache is None:
+        return None
+    factory = CACHE_OPTIONS[cache.group(1)]
+    bound = cache.group(2) if cache.group(1) != 'pinned' and cache.group(2) else ''
+    return f'EntityCacheOptions::{factory}({bound})'
+
+
+def derive_query(entity, entity_name, method):
+    """FindBy<Member>(value) returning optional<T> or StdVector<T>; None when it cannot be derived"""
+    return_type = ' '.join(method.group(1).split())
+    find_by = FIND_BY.match(method.group(2))
+    parameter = PARAMETER.match(method.group(3).strip())
+    if not find_by or not parameter:
+        return None
+    member = find_by.group(1)[0].lower() + find_by.group(1)[1:]
+    if member not in entity['fields']:
+        return None
+    if re.match(r'^(?:std::)?optional\s*<', return_type):
+        first = True
+    elif re.match(r'^(?:StdVector|std::vector)\s*<', return_type):
+        first = False
+    else:
+        return None
+    index = entity['indexed'].index(member) if member in entity['indexed'] else None
+    return {
+        'return_type': return_type,
+        'method': method.group(2),
+        'parameters': method.group(3).strip(),
+        'argument': parameter.group(2),
+        'member': member,
+        'first': first,
+        'index': index,
+    }
+
+
+def generate_table(name, entity):
+    lines = [
+        'template<>',
+        f'struct EntityTable<{name}> {{',
+        '    Static constexpr Bool available = true;',
+        f'    Static constexpr const char* name = "{name}";',
+        f'    Static const {entity["fields"][entity["id"]]}& Id(const {name}& entity) {{',
+        f'        return entity.{entity["id"]};',
+        '    }',
+        f'    Static constexpr Size indexCount = {len(entity["indexed"])};',
+        f'    Static constexpr EntityIndexField<{name}> indexes[] = {{',
+    ]
+    for field in entity['indexed']:
+        key = f'EntityFieldKey<{name}, {entity["fields"][field]}, &{name}::{field}>'
+        lines.append(f'        {{"{field}", &{key}::Key, {key}::numeric}},')
+    if not entity['indexed']:
+        lines.append('        {nullptr, nullptr, false},')
+    lines.append('    };')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def generate_repository(spec):
+    repository, entity, id_type = spec['repository'], spec['entity'], spec['id_type']
+    class_name = f'{entity}EntityRepository'
+    base = f'EntityRepository<{entity}, {id_type}, {repository}>'
+    lines = [
+        f'DefineStandardPointers({class_name})',
+        f'class {class_name} : public {base} {{',
+    ]
+    # Constructor bodies apply the @Cache annotation
+    body = ' {}' if spec['cache'] is None else f' {{\n        ConfigureCache({spec["cache"]});\n    }}'
+    if spec['storage'] == 'log':
+        lines += [
+            f'    // @Storage("log"): records in <logDirectory>/{entity}.log, index files through fileManager',
+            f'    Public explicit {class_name}(IFileManagerPtr fileManager, CStdString& logDirectory = ENTITYLOGSTORE_DIRECTORY)',
+            f'        : {base}(fileManager, std::make_shared<EntityLogStore>(logDirectory + "/{entity}.log")){body}',
+        ]
+    elif spec['storage'] == 'nvs':
+        lines += [
+            f'    // @Storage("nvs"): records in blobs of the "{entity[:15]}" NVS namespace, index files through fileManager',
+            f'    Public explicit {class_name}(IFileManagerPtr fileManager, INvsPartitionPtr partition = NvsEntityStore::DefaultPartition())',
+            f'        : {base}(fileManager, std::make_shared<NvsEntityStore>(partition, "{entity}")){body}',
+        ]
+    else:
+        lines += [
+            f'    Public explicit {class_name}(IFileManagerPtr fileManager)',
+            f'        : {base}(fileManager, std::make_shared<EntityFileStore>(fileManager, "{entity}")){body}',
+        ]
+    lines += [
+        '',
+        '    // Records in a store of the caller\'s choosing',
+        f'    Public {class_name}(IFileManagerPtr fileManager, IEntityStorePtr recordStore)',
+        f'        : {base}(fileManager, recordStore){body}',
+    ]
+    for query in spec['queries']:
+        lines.append('')
+        if query['index'] is not None:
+            lines.append(f'    // Through the {query["member"]} index')
+        lines.append(f'    Public {query["return_type"]} {query["method"]}({query["parameters"]}) override {{')
+        if query['index'] is not None:
+            call = 'FindFirstByIndex' if query['first'] else 'FindByIndex'
+            lines.append(f'        return {call}({query["index"]}, {query["argument"]});')
+        else:
+            call = 'FindFirstWhere' if query['first'] else 'FindWhere'
+            lines.append(f'        return {call}([&](const {entity}& entity) {{')
+            lines.append(f'            return entity.{query["member"]} == {query["argument"]};')
+            lines.append('        });')
+        lines.append('    }')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def generate_header(entities, repositories, source_dir):
+    out = [
+        '// Generated by scripts/generate_entity_repositories.py - do not edit',
+        '#ifndef GENERATED_ENTITY_REPOSITORIES_H',
+        '#define GENERATED_ENTITY_REPOSITORIES_H',
+        '',
+        '#include <StandardDefines.h>',
+        '#include "storage/EntityFileStore.h"',
+        '#include "storage/EntityLogStore.h"',
+        '#include "storage/NvsEntityStore.h"',
+        '#include "storage/EntityRepository.h"',
+    ]
+    headers = {entity['header'] for entity in entities.values()} | {spec['header'] for spec in repositories}
+    for header in sorted(headers):
+        out.append(f'#include "{header.relative_to(source_dir).as_posix()}"')
+    out.append('')
+    for name in sorted(entities):
+        out.append(generate_table(name, entities[name]))
+        out.append('')
+    for spec in repositories:
+        out.append(generate_repository(spec))
+        out.append('')
+    out.append('#endif // GENERATED_ENTITY_REPOSITORIES_H')
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: generate_entity_repositories.py <output_header> [source_dir]", file=sys.stderr)
+        sys.exit(1)
+
+    output = Path(sys.argv[1])
+    script_dir = Path(__file__).parent
+    source_dir = Path(sys.argv[2]) if len(sys.argv) > 2 else script_dir.parent / 'src'
+    source_dir = source_dir.resolve()
+
+    entities = find_entities(source_dir)
+    repositories = find_repositories(source_dir, entities)
+    content = generate_header(entities, repositories, source_dir)
+
+    # Only touch the file when it changes, so dependent objects are not rebuilt
+    output.parent.mkdir(parents=True, exist_ok=True)
+    if not output.exists() or output.read_text(encoding='utf-8') != content:
+        output.write_text(content, encoding='utf-8')
+
+    headers = {entity['header'] for entity in entities.values()} | {spec['header'] for spec in repositories}
+    for header in sorted(headers):
+        print(header.as_posix())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""
+Generate compile-time field tables for @Serializable and @Entity classes
+Scans the headers under src/ for classes annotated with @Serializable or @Entity and writes
+a header with one SerializableFieldTable specialization per class: a constexpr
+field descriptor array, a perfect hash (hash-and-displace) from JSON key to
+field index and visitors over the members. The streaming deserializer uses the
+tables to dispatch each key in O(1); the MessagePack codec reads and writes
+the members through the visitors.
+
+Classes under a tests or *_tests directory are test fixtures: their tables go
+to SerializableTestFieldTables.h next to the output header, which only targets
+built with FIELDTABLE_TEST_FIXTURES=1 include, so production code does not
+compile them.
+
+Usage: generate_field_tables.py <output_header> [source_dir]
+Prints the scanned header paths (one per line) so build systems can track them.
+"""
+
+import re
+import sys
+from pathlib import Path
+
+ANNOTATION = re.compile(r'/\*\s*@(Serializable|Entity)\s*\*/')
+ID_MEMBER = re.compile(r'/\*\s*@Id\s*\*/(?:\s*/\*.*?\*/)*\s*[^;{}()]*?(\w+)\s*;', re.S)
+CLASS_HEAD = re.compile(r'\b(?:class|struct)\s+(\w+)[^{;]*\{')
+PUBLIC_FIELD = re.compile(r'^Public\s+(?!Static\b|static\b|Virtual\b|virtual\b)(.+?)\s+(\w+)\s*(?:=[^;]*|\{[^;]*\})?;$')
+PLAIN_FIELD = re.compile(r'^(?!return\b|using\b|typedef\b|static\b|Static\b|friend\b)([\w:<>,\s\*&]+?)\s+(\w+)\s*(?:=[^;]*|\{[^;]*\})?;$')
+
+MAX_DISPLACEMENT = 0xFFFF
+
+
+def field_key_hash(key):
+    """FNV-1a, must match FieldKeyHash() in src/serializer/FieldTable.h"""
+    value = 2166136261
+    for byte in key.encode('utf-8'):
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def field_slot_mix(value, displacement):
+    """Must match FieldSlotMix() in src/serializer/FieldTable.h"""
+    value = (value + displacement * 0x9E3779B9) & 0xFFFFFFFF
+    value ^= value >> 16
+    value = (value * 0x85EBCA6B) & 0xFFFFFFFF
+    value ^= value >> 13
+    value = (value * 0xC2B2AE35) & 0xFFFFFFFF
+    value ^= value >> 16
+    return value
+
+
+def class_body(text, open_brace):
+    """Return the text between the brace at open_brace and its matching close"""
+    depth = 0
+    for index in range(open_brace, len(text)):
+        if text[index] == '{':
+            depth += 1
+        elif text[index] == '}':
+            depth -= 1
+            if depth == 0:
+                return text[open_brace + 1:index]
+    return ''
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def parse_fields(body):
+    """Public data members of a class body, in declaration order"""
+    fields = []
+    access_public = False
+    depth = 0
+    statement = ''
+    for line in strip_comments(body).splitlines():
+        line = line.strip()
+        if not line:
+            continue
+        if depth == 0:
+            label = re.match(r'^(public|private|protected)\s*:\s*(.*)$', line)
+            if label:
+                access_public = label.group(1) == 'public'
+                line = label.group(2).strip()
+                if not line:
+                    continue
+            if line.startswith('Private') or line.startswith('Protected'):
+                statement = ''
+                depth += line.count('{') - line.count('}')
+                continue
+            statement = (statement + ' ' + line).strip() if statement else line
+            if '(' in statement:
+                # Constructor or method, skip its body
+                depth += statement.count('{') - statement.count('}')
+                statement = ''
+                continue
+            if not statement.endswith(';'):
+                continue
+            match = PUBLIC_FIELD.match(statement)
+            if not match and access_public:
+                match = PLAIN_FIELD.match(statement)
+            if match:
+                fields.append((' '.join(match.group(1).split()), match.group(2)))
+            statement = ''
+        else:
+            depth += line.count('{') - line.count('}')
+    return fields
+
+
+def find_serializable_classes(source_dir):
+    """Return [(header_path, class_name, fields)] for every annotated class"""
+    classes = []
+    for header in sorted(source_dir.rglob('*.h')):
+        text = header.read_text(encoding='utf-8', errors='ignore')
+        for annotation in ANNOTATION.finditer(text):
+            head = CLASS_HEAD.search(text, annotation.end())
+            if not head:
+                continue
+            body = class_body(text, head.end() - 1)
+            fields = parse_fields(body)
+            id_member = ID_MEMBER.search(body)
+            if annotation.group(1) == 'Entity' and id_member and id_member.group(1) not in [name for _, name in fields]:
+                # An entity with a private @Id has private state a table cannot reach
+                continue
+            if fields:
+                classes.append((header, head.group(1), fields))
+    return classes
+
+
+def build_perfect_hash(keys):
+    """Return (slot_count, bucket_count, displacements, slots) with every key in its own slot"""
+    slot_count = 1
+    while slot_count < len(keys):
+        slot_count *= 2
+    while True:
+        bucket_count = max(1, (len(keys) + 1) // 2)
+        hashes = [field_key_hash(key) for key in keys]
+        buckets = [[] for _ in range(bucket_count)]
+        for index, value in enumerate(hashes):
+            buckets[value % bucket_count].append(index)
+
+        slots = [None] * slot_count
+        displacements = [0] * bucket_count
+        placed_all = True
+        # Largest buckets first, while the table is still empty
+        for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+            members = buckets[bucket]
+            if not members:
+                continue
+            for displacement in range(MAX_DISPLACEMENT + 1):
+                targets = [field_slot_mix(hashes[i], displacement) & (slot_count - 1) for i in members]
+                if len(set(targets)) == len(targets) and all(slots[t] is None for t in targets):
+                    for index, target in zip(members, targets):
+                        slots[target] = index
+                    displacements[bucket] = displacement
+                    break
+            else:
+                placed_all = False
+                break
+        if placed_all:
+            return slot_count, bucket_count, displacements, slots
+        slot_count *= 2
+
+
+def generate_table(class_name, fields):
+    keys = [name for _, name in fields]
+    slot_count, bucket_count, displacements, slots = build_perfect_hash(keys)
+    lines = [
+        'template<>',
+        f'struct SerializableFieldTable<{class_name}> {{',
+        '    Static constexpr Bool available = true;',
+        f'    Static constexpr Size fieldCount = {len(fields)};',
+        f'    Static constexpr Size slotCount = {slot_count};',
+        f'    Static constexpr Size bucketCount = {bucket_count};',
+        f'    Static constexpr FieldDescriptor<{class_name}> fields[] = {{',
+    ]
+    for field_type, name in fields:
+        lines.append(f'        {{"{name}", {len(name.encode("utf-8"))}, '
+                     f'&FieldMemberReader<{class_name}, {field_type}, &{class_name}::{name}>::Read}},')
+    lines.append('    };')
+    lines.append('    Static constexpr uint32_t displacements[] = {' + ', '.join(str(d) for d in displacements) + '};')
+    lines.append('    Static constexpr uint8_t slots[] = {' +
+                 ', '.join('kEmptyFieldSlot' if s is None else str(s) for s in slots) + '};')
+    lines.append('')
+    lines.append('    template<typename Visitor>')
+    lines.append('    Static Void ForEachField(Visitor&& visitor) {')
+    for index, (_, name) in enumerate(fields):
+        lines.append(f'        visitor(fields[{index}], &{class_name}::{name});')
+    lines.append('    }')
+    lines.append('')
+    lines.append('    template<typename Visitor>')
+    lines.append('    Static Void VisitField(Size index, Visitor&& visitor) {')
+    lines.append('        switch (index) {')
+    for index, (_, name) in enumerate(fields):
+        lines.append(f'            case {index}: visitor(&{class_name}::{name}); return;')
+    lines.append('            default: return;')
+    lines.append('        }')
+    lines.append('    }')
+    lines.append('};')
+    lines.append(f'static_assert(FieldLookup<{class_name}>::IsPerfect(), '
+                 f'"{class_name} field table is not a perfect hash");')
+    return '\n'.join(lines)
+
+
+def is_test_header(header, source_dir):
+    """Whether header lies in a tests or *_tests directory under source_dir"""
+    return any(part == 'tests' or part.endswith('_tests') for part in header.relative_to(source_dir).parts[:-1])
+
+
+def generate_header(classes, source_dir, guard='SERIALIZABLE_FIELD_TABLES_H'):
+    out = [
+        '// Generated by scripts/generate_field_tables.py - do not edit',
+        f'#ifndef {guard}',
+        f'#define {guard}',
+        '',
+        '#include <StandardDefines.h>',
+        '#include <cstdint>',
+        '#include "serializer/StreamingDeserializer.h"',
+    ]
+    for header in sorted({header for header, _, _ in classes}):
+        out.append(f'#include "{header.relative_to(source_dir).as_posix()}"')
+    out.append('')
+    for _, class_name, fields in classes:
+        if len(fields) >= 0xFF:
+            print(f"Warning: {class_name} has too many fields for a field table, skipped", file=sys.stderr)
+            continue
+        out.append(generate_table(class_name, fields))
+        out.append('')
+    out.append(f'#endif // {guard}')
+    return '\n'.join(out) + '\n'
+
+
+def write_if_changed(output, content):
+    """Only touch the file when it changes, so dependent objects are not rebuilt"""
+    output.parent.mkdir(parents=True, exist_ok=True)
+    if not output.exists() or output.read_text(encoding='utf-8') != content:
+        output.write_text(content, encoding='utf-8')
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: generate_field_tables.py <output_header> [source_dir]", file=sys.stderr)
+        sys.exit(1)
+
+    output = Path(sys.argv[1])
+    script_dir = Path(__file__).parent
+    source_dir = Path(sys.argv[2]) if len(sys.argv) > 2 else script_dir.parent / 'src'
+    source_dir = source_dir.resolve()
+
+    classes = find_serializable_classes(source_dir)
+    fixtures = [entry for entry in classes if is_test_header(entry[0], source_dir)]
+    production = [entry for entry in classes if not is_test_header(entry[0], source_dir)]
+    write_if_changed(output, generate_header(production, source_dir))
+    write_if_changed(output.parent / 'SerializableTestFieldTables.h',
+                     generate_header(fixtures, source_dir, 'SERIALIZABLE_TEST_FIELD_TABLES_H'))
+
+    for header in sorted({header for header, _, _ in classes}):
+        print(header.as_posix())
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,494 @@
+#!/usr/bin/env python3
+"""
+Generate a static route dispatch table for @RestController classes
+Scans the headers under src/ for classes annotated with @RestController, joins
+their @RequestMapping prefix with each @GetMapping / @PostMapping / @PutMapping /
+@DeleteMapping / @PatchMapping and writes a header with:
+  - GeneratedRouteId, one enumerator per handler method
+  - kGeneratedRoutes, a constexpr StaticRoute array in the same order
+  - MatchGeneratedRoute(), a switch on method, segment count and then each
+    segment key, so dispatch needs no heap and no startup insertion
+and, next to it, GeneratedRouteAdapters.h with one adapter per handler that
+parses the typed @PathVariable parameters straight from the matched captures
+and invokes the controller method.
+
+Usage: generate_route_table.py <output_header> [source_dir]
+Prints the scanned header paths (one per line) so build systems can track them.
+"""
+
+import re
+import sys
+from pathlib import Path
+
+CONTROLLER = re.compile(r'/\*\s*@RestController\s*\*/')
+REQUEST_MAPPING = re.compile(r'/\*\s*@RequestMapping\(\s*"([^"]*)"\s*\)\s*\*/')
+METHOD_MAPPING = re.compile(r'/\*\s*@(Get|Post|Put|Delete|Patch)Mapping(?:\(\s*"([^"]*)"\s*\))?\s*\*/')
+CLASS_HEAD = re.compile(r'\b(?:class|struct)\s+(\w+)[^{;]*\{')
+METHOD_NAME = re.compile(r'(\w+)\s*\(')
+PARAMETER_ANNOTATION = re.compile(r'/\*\s*@(\w+)(?:\(\s*"([^"]*)"\s*\))?\s*\*/')
+ENUM_DECLARATION = re.compile(r'\benum\s+class\s+(\w+)(?:\s*:\s*[\w:]+)?\s*\{([^}]*)\}')
+
+METHODS = ['Get', 'Post', 'Put', 'Delete', 'Patch']
+MAX_SEGMENTS = 16
+MAX_CAPTURES = 8  # STATICROUTE_MAX_CAPTURES
+
+
+def segment_key(segment):
+    """Length plus first, middle and last byte; must match RouteSegmentKey() in src/router/StaticRouteTable.h"""
+    data = segment.encode('utf-8')
+    if not data:
+        return 0
+    return ((len(data) & 0xFF) << 24) ^ (data[0] << 16) ^ (data[len(data) // 2] << 8) ^ data[-1]
+
+
+def strip_line_comments(text):
+    """Drop // comments so commented-out annotations are ignored; /* */ annotations stay"""
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def class_body(text, open_brace):
+    """Return the text between the brace at open_brace and its matching close"""
+    depth = 0
+    for index in range(open_brace, len(text)):
+        if text[index] == '{':
+            depth += 1
+        elif text[index] == '}':
+            depth -= 1
+            if depth == 0:
+                return text[open_brace + 1:index]
+    return ''
+
+
+def join_path(base, sub):
+    """"/switch" + "/{id}/on" -> "/switch/{id}/on"; no trailing slash except for the root"""
+    segments = [s for s in (base + '/' + sub).split('/') if s]
+    return '/' + '/'.join(segments)
+
+
+def parameter_list(body, open_paren):
+    """Text between the parenthesis at open_paren and its matching close"""
+    depth = 0
+    for index in range(open_paren, len(body)):
+        if body[index] == '(':
+            depth += 1
+        elif body[index] == ')':
+            depth -= 1
+            if depth == 0:
+                return body[open_paren + 1:index]
+    return ''
+
+
+def parse_parameters(text):
+    """[(annotation, annotation_value, type, name)] for a handler parameter list"""
+    parameters = []
+    depth = 0
+    current = ''
+    pieces = []
+    for char in text:
+        if char in '<(':
+            depth += 1
+        elif char in '>)':
+            depth -= 1
+        if char == ',' and depth == 0:
+            pieces.append(current)
+            current = ''
+        else:
+            current += char
+    pieces.append(current)
+    for piece in pieces:
+        annotation = PARAMETER_ANNOTATION.search(piece)
+        declaration = PARAMETER_ANNOTATION.sub('', piece).split('=')[0].strip()
+        if not declaration:
+            continue
+        name = re.search(r'(\w+)\s*$', declaration)
+        if not name:
+            continue
+        declared_type = ' '.join(declaration[:name.start()].split())
+        parameters.append((annotation.group(1) if annotation else None,
+                           annotation.group(2) if annotation else None,
+                           declared_type, name.group(1)))
+    return parameters
+
+
+def find_enums(source_dir):
+    """{enum_name: (header, [enumerator])} for every enum class under source_dir"""
+    enums = {}
+    for header in sorted(source_dir.rglob('*.h')):
+        text = re.sub(r'/\*.*?\*/', '', strip_line_comments(header.read_text(encoding='utf-8', errors='ignore')), flags=re.S)
+        for declaration in ENUM_DECLARATION.finditer(text):
+            names = [re.match(r'\s*(\w+)', item).group(1)
+                     for item in declaration.group(2).split(',') if re.match(r'\s*(\w+)', item)]
+            enums.setdefault(declaration.group(1), (header, names))
+    return enums
+
+
+def find_routes(source_dir):
+    """Return (headers, [(method, pattern, class_name, handler, parameters, header)]) in declaration order"""
+    headers = []
+    routes = []
+    for header in sorted(source_dir.rglob('*.h')):
+        text = strip_line_comments(header.read_text(encoding='utf-8', errors='ignore'))
+        found = False
+        for annotation in CONTROLLER.finditer(text):
+            head = CLASS_HEAD.search(text, annotation.end())
+            if not head:
+                continue
+            # @RequestMapping may sit just before or just after @RestController
+            window_start = text.rfind('\n\n', 0, annotation.start())
+            mapping = REQUEST_MAPPING.search(text, max(window_start, 0), head.start())
+            base = mapping.group(1) if mapping else ''
+            body = class_body(text, head.end() - 1)
+            for method_mapping in METHOD_MAPPING.finditer(body):
+                name = METHOD_NAME.search(body, method_mapping.end())
+                if not name:
+                    continue
+                path = join_path(base, method_mapping.group(2) or '')
+                parameters = parse_parameters(parameter_list(body, name.end() - 1))
+                routes.append((method_mapping.group(1), path, head.group(1), name.group(1), parameters, header))
+                found = True
+        if found:
+            headers.append(header)
+    return headers, routes
+
+
+def parse_segments(pattern):
+    """[(is_variable, text)] per segment, or None when a variable is not a whole segment"""
+    segments = []
+    for segment in [s for s in pattern.split('/') if s]:
+        if segment.startswith('{') and segment.endswith('}') and len(segment) > 2:
+            segments.append((True, segment[1:-1]))
+        elif '{' in segment or '}' in segment:
+            return None
+        else:
+            segments.append((False, segment))
+    return segments
+
+
+def cpp_string(text):
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def emit_accept(route, indent, lines):
+    pad = ' ' * indent
+    lines.append(f'{pad}// {route["pattern"]}')
+    for index, (is_variable, _) in enumerate(route['segments']):
+        if is_variable:
+            lines.append(f'{pad}match.Capture(s.View({index}));')
+    lines.append(f'{pad}match.routeId = static_cast<Int>(GeneratedRouteId::{route["id"]});')
+    lines.append(f'{pad}return match;')
+
+
+def emit_segment(routes, position, indent, lines):
+    """Decision tree over segment `position` for routes that agree on every earlier segment.
+    Literal branches come first and return on success; when they do not match, control
+    falls through to the variable branch, which gives literals priority with backtracking."""
+    pad = ' ' * indent
+    if position == len(routes[0]['segments']):
+        route = routes[0]
+        # "/xyz/" matches "/xyz" but a trailing slash after a variable does not match
+        if route['segments'] and route['segments'][-1][0]:
+            lines.append(f'{pad}if (!s.trailingSlash) {{')
+            emit_accept(route, indent + 4, lines)
+            lines.append(f'{pad}}}')
+        else:
+            emit_accept(route, indent, lines)
+        return
+
+    literals = {}
+    variables = []
+    for route in routes:
+        is_variable, text = route['segments'][position]
+        if is_variable:
+            variables.append(route)
+        else:
+            literals.setdefault(text, []).append(route)
+
+    by_key = {}
+    for text in literals:
+        by_key.setdefault(segment_key(text), []).append(text)
+    if by_key:
+        lines.append(f'{pad}switch (s.keys[{position}]) {{')
+        for value, texts in by_key.items():
+            lines.append(f'{pad}    case 0x{value:08X}u:')
+            for text in texts:
+                lines.append(f'{pad}        if (s.View({position}) == {cpp_string(text)}) {{')
+                emit_segment(literals[text], position + 1, indent + 12, lines)
+                lines.append(f'{pad}        }}')
+            lines.append(f'{pad}        break;')
+        lines.append(f'{pad}    default:')
+        lines.append(f'{pad}        break;')
+        lines.append(f'{pad}}}')
+    if variables:
+        lines.append(f'{pad}if (s.lengths[{position}] != 0) {{')
+        emit_segment(variables, position + 1, indent + 4, lines)
+        lines.append(f'{pad}}}')
+
+
+def generate_matcher(routes):
+    lines = [
+        '/**',
+        ' * @brief Match a request against the generated routes',
+        ' * Switches on method, segment count and then each segment key; a literal',
+        ' * segment wins over a variable, as in EndpointTrie. Captures are views into path.',
+        ' */',
+        'inline StaticRouteMatch MatchGeneratedRoute(RouteMethod method, std::string_view path) {',
+        '    StaticRouteMatch match;',
+        '    RouteSegments s;',
+        '    if (!RouteSegments::Split(path, s)) {',
+        '        return match;',
+        '    }',
+        '    switch (method) {',
+    ]
+    for method in METHODS:
+        method_routes = [r for r in routes if r['method'] == method]
+        if not method_routes:
+            continue
+        lines.append(f'        case RouteMethod::{method}:')
+        lines.append('            switch (s.count) {')
+        for count in sorted({len(r['segments']) for r in method_routes}):
+            lines.append(f'                case {count}:')
+            emit_segment([r for r in method_routes if len(r['segments']) == count], 0, 20, lines)
+            lines.append('                    break;')
+        lines.append('                default:')
+        lines.append('                    break;')
+        lines.append('            }')
+        lines.append('            break;')
+    lines.append('        default:')
+    lines.append('            break;')
+    lines.append('    }')
+    lines.append('    return match;')
+    lines.append('}')
+    return lines
+
+
+def generate_header(routes, headers, source_dir):
+    out = [
+        '// Generated by scripts/generate_route_table.py - do not edit',
+        '#ifndef GENERATED_ROUTE_TABLE_H',
+        '#define GENERATED_ROUTE_TABLE_H',
+        '',
+        '#include <StandardDefines.h>',
+        '#include <cstdint>',
+        '#include <string_view>',
+        '#include "router/StaticRouteTable.h"',
+        '',
+        '// Sources:',
+    ]
+    for header in headers:
+        out.append(f'//   {header.relative_to(source_dir).as_posix()}')
+    out.append('')
+
+    out.append('enum class GeneratedRouteId : uint8_t {')
+    for route in routes:
+        out.append(f'    {route["id"]},')
+    out.append('};')
+    out.append('')
+    out.append(f'constexpr Size kGeneratedRouteCount = {len(routes)};')
+    out.append('')
+
+    out.append('// Indexed by GeneratedRouteId')
+    out.append('constexpr StaticRoute kGeneratedRoutes[] = {')
+    for route in routes:
+        variables = sum(1 for is_variable, _ in route['segments'] if is_variable)
+        out.append(f'    {{RouteMethod::{route["method"]}, {cpp_string(route["pattern"])}, '
+                   f'{cpp_string(route["controller"])}, {cpp_string(route["handler"])}, '
+                   f'{len(route["segments"])}, {variables}}},')
+    if not routes:
+        out.append('    {RouteMethod::Unknown, "", "", "", 0, 0},')
+    out.append('};')
+    out.append('')
+
+    # The generator and RouteSegmentKey must agree, or a literal would never match
+    literals = sorted({text for route in routes for is_variable, text in route['segments'] if not is_variable})
+    for literal in literals:
+        out.append(f'static_assert(RouteSegmentKey({cpp_string(literal)}) == 0x{segment_key(literal):08X}u, '
+                   f'"route segment key mismatch");')
+    if literals:
+        out.append('')
+
+    out.extend(generate_matcher(routes))
+    out.append('')
+    out.append('#endif // GENERATED_ROUTE_TABLE_H')
+    return '\n'.join(out) + '\n'
+
+
+def value_type(declared_type):
+    """Member type for a parameter, e.g. const StdString& becomes StdString"""
+    text = re.sub(r'\bconst\b', '', declared_type).replace('&', '')
+    return ' '.join(text.split())
+
+
+def adapter_variables(route):
+    """[(capture_index, type, name, variable)] for the @PathVariable parameters, or None
+    when one names a variable the pattern does not have"""
+    variable_names = [text for is_variable, text in route['segments'] if is_variable]
+    variables = []
+    for annotation, value, declared_type, name in route['parameters']:
+        if annotation != 'PathVariable':
+            continue
+        variable = value or name
+        if variable not in variable_names:
+            print(f"Warning: {route['controller']}::{route['handler']} has no {{{variable}}} in {route['pattern']}, "
+                  "adapter skipped", file=sys.stderr)
+            return None
+        variables.append((variable_names.index(variable), value_type(declared_type), name, variable))
+    return variables
+
+
+def generate_adapter(route, variables):
+    lines = [
+        f'// {route["method"].upper()} {route["pattern"]} -> {route["controller"]}::{route["handler"]}',
+        f'struct {route["id"]}_Adapter {{',
+        f'    Static constexpr GeneratedRouteId routeId = GeneratedRouteId::{route["id"]};',
+        '',
+        '    struct PathVariables {',
+    ]
+    for _, member_type, name, _ in variables:
+        lines.append(f'        {member_type} {name}{{}};')
+    lines.append('    };')
+    lines.append('')
+    lines.append('    // false (with failure filled in for a 400) when a variable is missing or invalid')
+    lines.append('    Static Bool Parse(const StaticRouteMatch& match, PathVariables& out, PathVariableFailure& failure) {')
+    if variables:
+        checks = [f'ParsePathVariable(match, {index}, {cpp_string(variable)}, out.{name}, failure)'
+                  for index, _, name, variable in variables]
+        lines.append('        return ' + ' &&\n               '.join(checks) + ';')
+    else:
+        lines.append('        (Void)match;')
+        lines.append('        (Void)out;')
+        lines.append('        (Void)failure;')
+        lines.append('        return true;')
+    lines.append('    }')
+    lines.append('')
+
+    # Remaining parameters (@RequestBody etc.) are passed through in declaration order
+    extra = [(declared_type, name) for annotation, _, declared_type, name in route['parameters']
+             if annotation != 'PathVariable']
+    signature = ''.join(f', {declared_type} {name}' for declared_type, name in extra)
+    arguments = []
+    for annotation, _, _, name in route['parameters']:
+        arguments.append(f'variables.{name}' if annotation == 'PathVariable' else f'std::move({name})')
+    unused = '' if variables else '        (Void)variables;\n'
+    lines.append('    template<typename Controller>')
+    lines.append(f'    Static decltype(auto) Invoke(Controller& controller, const PathVariables& variables{signature}) {{')
+    if unused:
+        lines.append(unused.rstrip('\n'))
+    lines.append(f'        return controller.{route["handler"]}({", ".join(arguments)});')
+    lines.append('    }')
+    lines.append('};')
+    return lines
+
+
+def generate_adapters_header(routes, enums, source_dir):
+    adapters = []
+    used_enums = set()
+    headers = set()
+    for route in routes:
+        variables = adapter_variables(route)
+        if variables is None:
+            continue
+        adapters.append((route, variables))
+        headers.add(route['header'])
+        for _, member_type, _, _ in variables:
+            if member_type in enums:
+                used_enums.add(member_type)
+                headers.add(enums[member_type][0])
+
+    out = [
+        '// Generated by scripts/generate_route_table.py - do not edit',
+        '#ifndef GENERATED_ROUTE_ADAPTERS_H',
+        '#define GENERATED_ROUTE_ADAPTERS_H',
+        '',
+        '#include <StandardDefines.h>',
+        '#include <utility>',
+        '#include "router/PathVariable.h"',
+        '#include "router/StaticRouteTable.h"',
+    ]
+    for header in sorted(headers):
+        out.append(f'#include "{header.relative_to(source_dir).as_posix()}"')
+    out.append('')
+    out.append('// Usage, after MatchGeneratedRoute picked routeId X:')
+    out.append('//   X_Adapter::PathVariables variables;')
+    out.append('//   PathVariableFailure failure;')
+    out.append('//   if (!X_Adapter::Parse(match, variables, failure)) -> 400 with failure.Message()')
+    out.append('//   else X_Adapter::Invoke(controller, variables, <body arguments>)')
+    out.append('')
+
+    for enum_name in sorted(used_enums):
+        names = enums[enum_name][1]
+        out.append('template<>')
+        out.append(f'struct PathVariableEnumNames<{enum_name}> {{')
+        out.append('    Static constexpr Bool available = true;')
+        out.append(f'    Static constexpr PathVariableEnumEntry<{enum_name}> entries[] = {{')
+        for name in names:
+            out.append(f'        {{{cpp_string(name)}, {enum_name}::{name}}},')
+        out.append('    };')
+        out.append('};')
+        out.append('')
+
+    for route, variables in adapters:
+        out.extend(generate_adapter(route, variables))
+        out.append('')
+    out.append('#endif // GENERATED_ROUTE_ADAPTERS_H')
+    return '\n'.join(out) + '\n'
+
+
+def write_if_changed(output, content):
+    """Only touch the file when it changes, so dependent objects are not rebuilt"""
+    output.parent.mkdir(parents=True, exist_ok=True)
+    if not output.exists() or output.read_text(encoding='utf-8') != content:
+        output.write_text(content, encoding='utf-8')
+
+
+def build_routes(raw_routes):
+    routes = []
+    seen = set()
+    for method, pattern, class_name, handler, parameters, header in raw_routes:
+        segments = parse_segments(pattern)
+        if segments is None:
+            print(f"Warning: {class_name}::{handler} has an unsupported pattern {pattern}, skipped", file=sys.stderr)
+            continue
+        variables = sum(1 for is_variable, _ in segments if is_variable)
+        if len(segments) > MAX_SEGMENTS or variables > MAX_CAPTURES:
+            print(f"Warning: {class_name}::{handler} pattern {pattern} is too deep, skipped", file=sys.stderr)
+            continue
+        key = (method, tuple('{}' if is_variable else text for is_variable, text in segments))
+        if key in seen:
+            print(f"Warning: {method} {pattern} is mapped twice, {class_name}::{handler} skipped", file=sys.stderr)
+            continue
+        seen.add(key)
+        routes.append({
+            'method': method,
+            'pattern': pattern,
+            'controller': class_name,
+            'handler': handler,
+            'id': f'{class_name}_{handler}',
+            'segments': segments,
+            'parameters': parameters,
+            'header': header,
+        })
+    return routes
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: generate_route_table.py <output_header> [source_dir]", file=sys.stderr)
+        sys.exit(1)
+
+    output = Path(sys.argv[1])
+    script_dir = Path(__file__).parent
+    source_dir = Path(sys.argv[2]) if len(sys.argv) > 2 else script_dir.parent / 'src'
+    source_dir = source_dir.resolve()
+
+    headers, raw_routes = find_routes(source_dir)
+    routes = build_routes(raw_routes)
+    write_if_changed(output, generate_header(routes, headers, source_dir))
+    write_if_changed(output.parent / 'GeneratedRouteAdapters.h',
+                     generate_adapters_header(routes, find_enums(source_dir), source_dir))
+
+    for header in headers:
+        print(header.as_posix())
+
+
+if __name__ == '__main__':
+    main()
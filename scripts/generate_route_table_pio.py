@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+"""
+PlatformIO pre-build script wrapper
+Calls generate_route_table.py and adds the generated header directory to the include path
+"""
+
+import subprocess
+import sys
+from pathlib import Path
+
+Import("env")
+
+# Get the project root directory
+project_dir = env.get("PROJECT_DIR")
+script_path = Path(project_dir) / 'scripts' / 'generate_route_table.py'
+generated_dir = Path(env.subst("$BUILD_DIR")) / 'generated'
+output_path = generated_dir / 'GeneratedRouteTable.h'
+
+# Call the main script; it rewrites the header only when a route changes
+try:
+    result = subprocess.run(
+        [sys.executable, str(script_path), str(output_path), str(Path(project_dir) / 'src')],
+        cwd=project_dir,
+        capture_output=True,
+        text=True,
+        check=False
+    )
+
+    if result.returncode == 0:
+        env.Append(CPPPATH=[str(generated_dir)])
+        headers = [line for line in result.stdout.strip().split('\n') if line.strip()]
+        print(f"Generated route table from {len(headers)} @RestController headers")
+    else:
+        print(f"Warning: route table not generated: {result.stderr.strip()}")
+except Exception as e:
+    print(f"Error running generate_route_table.py: {e}")
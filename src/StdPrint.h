@@ -0,0 +1,22 @@
+#ifndef STD_PRINT_H
+#define STD_PRINT_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+#else
+    #include <iostream>
+#endif
+
+// Print macros - compatible with both Arduino and non-Arduino
+#ifdef ARDUINO
+    // Arduino version using Serial.print/Serial.println
+    #define std_print(x) Serial.print(x)
+    #define std_println(x) Serial.println(x)
+#else
+    // Non-Arduino version using std::cout
+    #define std_print(x) std::cout << x
+    #define std_println(x) std::cout << x << std::endl
+#endif
+
+#endif // STD_PRINT_H
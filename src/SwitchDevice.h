@@ -11,6 +11,7 @@
 #include "controller/SwitchRepository.h"
 #include "controller/Switch.h"
 #include "controller/SwitchResponseDto.h"
+#include "storage/AppRepositories.h"
 
 class SwitchDevice : public ISwitchDevice {
     Private Int id;
@@ -28,8 +29,13 @@ class SwitchDevice : public ISwitchDevice {
     /* @Autowired */
     Private ILoggerPtr logger;
 
+#if APPREPOSITORIES_AVAILABLE
+    // The generated SwitchEntityRepository, pinned in memory by its @Cache("pinned")
+    Private SwitchRepositoryPtr switchRepository = AppRepositories::Switches();
+#else
     /* @Autowired */
     Private SwitchRepositoryPtr switchRepository;
+#endif
 
     /**
      * @brief Constructor with id, relayPin, and switchPin parameters
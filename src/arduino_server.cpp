@@ -6,6 +6,28 @@
 //#include "tests/AllTests.h"
 #include "service/ISwitchService.h"
 
+#ifdef HTTPSERVER_SELECT_LOOP
+    #include <memory>
+    #include "server/AppRequestHandler.h"
+    #include "server/HttpCompression.h"
+    #include "server/SelectHttpServer.h"
+
+    #if !APPREQUESTHANDLER_AVAILABLE
+        #error "HTTPSERVER_SELECT_LOOP needs the generated route table"
+    #endif
+
+    #ifndef HTTPSERVER_SELECT_PORT
+        #define HTTPSERVER_SELECT_PORT 8080
+    #endif
+
+// Keep-alive listener next to the framework's; answered from loop(). Large
+// bodies such as GET /switch go out gzipped to clients that accept it, and
+// the handler's fixed bodies are compressed once in setup().
+std::unique_ptr<AppRequestHandler> selectHandler;
+std::unique_ptr<SelectHttpServer> selectServer;
+HttpCompression selectCompression;
+#endif
+
 void setup() {
     Serial.begin(115200);
 
@@ -16,6 +38,21 @@ void setup() {
     IArduinoSpringBootAppPtr springBootApp;
 
     springBootApp->StartApp();
+
+#ifdef HTTPSERVER_SELECT_LOOP
+    /* @Autowired */
+    ISwitchServicePtr switchService;
+
+    selectHandler.reset(new AppRequestHandler(switchService));
+    selectServer.reset(new SelectHttpServer([](const HttpServerRequest& request, HttpServerResponse& response) {
+        selectHandler->Handle(request, response);
+    }));
+    selectHandler->AddConstantBodies(selectCompression);
+    selectServer->SetCompression(&selectCompression);
+    if (!selectServer->Start(HTTPSERVER_SELECT_PORT)) {
+        Serial.println("SelectHttpServer: could not listen");
+    }
+#endif
 }
 
 void loop() {
@@ -24,6 +61,10 @@ void loop() {
 
     springBootApp->ListenToRequest();
 
+#ifdef HTTPSERVER_SELECT_LOOP
+    selectServer->Poll(0);
+#endif
+
     /* @Autowired */
     ISwitchServicePtr switchService;
     switchService->RefreshAllSwitches();
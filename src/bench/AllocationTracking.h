@@ -0,0 +1,49 @@
+#ifndef ALLOCATION_TRACKING_H
+#define ALLOCATION_TRACKING_H
+
+#include <cstdlib>
+#include <new>
+#include "BenchUtils.h"
+
+// Replaces the global operator new / delete so benchmarks can count heap
+// allocations (see BenchBytesAllocatedPerOp). The replacements are not inline,
+// so include this header from exactly one translation unit per executable.
+
+inline void* BenchTrackedAllocate(std::size_t size) {
+    BenchAllocationCounters& counters = GetBenchAllocationCounters();
+    if (counters.enabled.load(std::memory_order_relaxed)) {
+        counters.bytes.fetch_add(size, std::memory_order_relaxed);
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(std::size_t size) {
+    return BenchTrackedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return BenchTrackedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif // ALLOCATION_TRACKING_H
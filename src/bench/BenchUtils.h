@@ -0,0 +1,345 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <StandardDefines.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <sys/resource.h>
+#include "../serializer/JsonPullParser.h"
+
+// Helpers shared by the desktop benchmark executables
+
+// Stops the compiler from discarding a result that is otherwise unused
+template<typename T>
+inline Void BenchKeep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const volatile Void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * Heap allocation counters.
+ * Only advance in executables that include bench/AllocationTracking.h,
+ * which replaces the global operator new.
+ */
+struct BenchAllocationCounters {
+    std::atomic<Size> bytes{0};
+    std::atomic<Size> count{0};
+    std::atomic<Bool> enabled{false};
+};
+
+inline BenchAllocationCounters& GetBenchAllocationCounters() {
+    static BenchAllocationCounters counters;
+    return counters;
+}
+
+// Timing limits for one measurement
+struct BenchOptions {
+    Size minIterations = 10;
+    Long minMillis = 200;
+};
+
+/**
+ * @brief Time a callable and return nanoseconds per call
+ * Runs fn until both minIterations calls and minMillis have elapsed,
+ * after a short warm-up so first-touch allocation is not measured.
+ * @param fn Callable to measure
+ * @param minIterations Lower bound on the number of timed calls
+ * @param minMillis Lower bound on the total timed duration
+ */
+template<typename Fn>
+inline double BenchNanosPerOp(Fn&& fn, Size minIterations = 10, Long minMillis = 200) {
+    for (Size i = 0; i < 3; i++) {
+        fn();
+    }
+    typedef std::chrono::steady_clock Clock;
+    Size iterations = 0;
+    Clock::time_point start = Clock::now();
+    Clock::time_point now = start;
+    while (iterations < minIterations ||
+           std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() < minMillis) {
+        fn();
+        iterations++;
+        now = Clock::now();
+    }
+    double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+    return elapsed / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Heap bytes and allocation count per call of fn, averaged over a few calls
+ * @param allocations Receives allocations per call
+ * @return Bytes allocated per call
+ */
+template<typename Fn>
+inline double BenchBytesAllocatedPerOp(Fn&& fn, double& allocations) {
+    const Size runs = 5;
+    BenchAllocationCounters& counters = GetBenchAllocationCounters();
+    fn();
+    counters.bytes = 0;
+    counters.count = 0;
+    counters.enabled = true;
+    for (Size i = 0; i < runs; i++) {
+        fn();
+    }
+    counters.enabled = false;
+    allocations = static_cast<double>(counters.count.load()) / runs;
+    return static_cast<double>(counters.bytes.load()) / runs;
+}
+
+/**
+ * @brief Peak resident set size of the process so far, in KiB
+ */
+inline Long BenchPeakRssKb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<Long>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<Long>(usage.ru_maxrss);
+#endif
+}
+
+/**
+ * One measured operation
+ */
+struct BenchResult {
+    StdString group;
+    StdString name;
+    // Elements processed per call (collection size), 1 for single values
+    Size elements = 1;
+    // Encoded body size, 0 when not applicable
+    Size payloadBytes = 0;
+    double nanosPerOp = 0;
+    double bytesAllocatedPerOp = 0;
+    double allocationsPerOp = 0;
+    // Process peak RSS right after the measurement
+    Long peakRssKb = 0;
+};
+
+/**
+ * Collects results and prints them as a table or as JSON
+ */
+class BenchReport {
+    Private StdString title;
+    Private BenchOptions options;
+    Private StdVector<BenchResult> results;
+
+    Public BenchReport(CStdString& title, const BenchOptions& options) : title(title), options(options) {}
+
+    Public const BenchOptions& GetOptions() const {
+        return options;
+    }
+
+    Public const StdVector<BenchResult>& GetResults() const {
+        return results;
+    }
+
+    /**
+     * @brief Measure fn (time, allocations, peak RSS) and record it
+     * @return Copy of the recorded result
+     */
+    Public template<typename Fn>
+    BenchResult Measure(CStdString& group, CStdString& name, Size elements, Size payloadBytes, Fn&& fn) {
+        BenchResult result;
+        result.group = group;
+        result.name = name;
+        result.elements = elements;
+        result.payloadBytes = payloadBytes;
+        result.nanosPerOp = BenchNanosPerOp(fn, options.minIterations, options.minMillis);
+        result.bytesAllocatedPerOp = BenchBytesAllocatedPerOp(fn, result.allocationsPerOp);
+        result.peakRssKb = BenchPeakRssKb();
+        results.push_back(result);
+        return result;
+    }
+
+    Public Void PrintTableHeader() const {
+        std::printf("%-16s %-40s %8s %10s %14s %12s %12s %10s\n",
+                    "group", "case", "elements", "bytes", "ns/op", "alloc B/op", "allocs/op", "rss KiB");
+    }
+
+    Public Void PrintTableRow(const BenchResult& result) const {
+        std::printf("%-16s %-40s %8zu %10zu %14.1f %12.1f %12.1f %10ld\n",
+                    result.group.c_str(), result.name.c_str(), result.elements, result.payloadBytes,
+                    result.nanosPerOp, result.bytesAllocatedPerOp, result.allocationsPerOp, result.peakRssKb);
+    }
+
+    /**
+     * @brief Write every result as one JSON document
+     */
+    Public Void WriteJson(FILE* out) const {
+        std::fprintf(out, "{\n  \"benchmark\": ");
+        WriteJsonString(out, title);
+        std::fprintf(out, ",\n  \"minMillis\": %ld,\n  \"peakRssKb\": %ld,\n  \"results\": [\n",
+                     options.minMillis, BenchPeakRssKb());
+        for (Size i = 0; i < results.size(); i++) {
+            const BenchResult& result = results[i];
+            std::fprintf(out, "    {\"group\": ");
+            WriteJsonString(out, result.group);
+            std::fprintf(out, ", \"name\": ");
+            WriteJsonString(out, result.name);
+            std::fprintf(out, ", \"elements\": %zu, \"payloadBytes\": %zu, \"nsPerOp\": %.1f, "
+                              "\"bytesAllocatedPerOp\": %.1f, \"allocationsPerOp\": %.1f, \"peakRssKb\": %ld}%s\n",
+                         result.elements, result.payloadBytes, result.nanosPerOp, result.bytesAllocatedPerOp,
+                         result.allocationsPerOp, result.peakRssKb, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+    Private Static Void WriteJsonString(FILE* out, CStdString& value) {
+        StdString quoted;
+        JsonPullParser::AppendQuoted(value, quoted);
+        std::fputs(quoted.c_str(), out);
+    }
+};
+
+/**
+ * Command line shared by the benchmark executables: --json <file|->, --quick
+ * and --help, plus the options a benchmark adds with Flag() before Parse().
+ * Each added option takes a value; unknown arguments are ignored.
+ *
+ *     BenchCommandLine commandLine;
+ *     commandLine.Flag("--keys", "Names in the key directory (default 100000)", keyCount, 1);
+ *     if (!commandLine.Parse(argc, argv)) {
+ *         return 0;
+ *     }
+ *     BenchReport report("hash_bench", commandLine.options);
+ *     ...
+ *     return commandLine.WriteJson(report) ? 0 : 1;
+ */
+class BenchCommandLine {
+    // Timing limits, shortened by --quick
+    Public BenchOptions options;
+    // Where WriteJson() writes: a file, "-" for stdout, empty for nowhere
+    Public StdString jsonPath;
+    Public Bool quick = false;
+
+    Private struct Argument {
+        StdString name;
+        StdString value;
+        StdString help;
+        std::function<Void(const char*)> apply;
+    };
+    Private Bool writesJson;
+    Private StdString quickHelp;
+    Private StdVector<Argument> flags;
+
+    /**
+     * @param writesJson False for benchmarks that print their own table and take no --json
+     * @param quickHelp What --quick does, for --help
+     */
+    Public explicit BenchCommandLine(Bool writesJson = true, CStdString& quickHelp = "Shorter measurements (20 ms per case)")
+        : writesJson(writesJson), quickHelp(quickHelp) {}
+
+    /**
+     * @brief Add an option taking a value
+     * @param value Placeholder for the value in the usage line, e.g. "N"
+     * @param apply Called with the value
+     */
+    Public Void Flag(CStdString& name, CStdString& value, CStdString& help, std::function<Void(const char*)> apply) {
+        flags.push_back({name, value, help, std::move(apply)});
+    }
+
+    // An integer option, raised to minimum
+    Public Void Flag(CStdString& name, CStdString& help, Int& target, Int minimum) {
+        Flag(name, "N", help, [&target, minimum](const char* value) {
+            target = std::max(minimum, std::atoi(value));
+        });
+    }
+
+    // A path or other string option
+    Public Void Flag(CStdString& name, CStdString& help, StdString& target) {
+        Flag(name, "<path>", help, [&target](const char* value) {
+            target = value;
+        });
+    }
+
+    /**
+     * @brief Read the arguments into the options and the added flags
+     * @return False when --help was given and the usage has been printed
+     */
+    Public Bool Parse(int argc, char* argv[]) {
+        for (int i = 1; i < argc; i++) {
+            StdString arg = argv[i];
+            if (writesJson && arg == "--json" && i + 1 < argc) {
+                jsonPath = argv[++i];
+            } else if (arg == "--quick") {
+                quick = true;
+                options.minMillis = 20;
+                options.minIterations = 3;
+            } else if (arg == "--help" || arg == "-h") {
+                PrintUsage(argv[0]);
+                return false;
+            } else if (i + 1 < argc) {
+                for (const Argument& flag : flags) {
+                    if (arg == flag.name) {
+                        flag.apply(argv[++i]);
+                        break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // The table goes to stdout unless JSON does
+    Public Bool Verbose() const {
+        return jsonPath != "-";
+    }
+
+    /**
+     * @brief Write the report as JSON to jsonPath, if one was given
+     * @return False when the file could not be opened
+     */
+    Public Bool WriteJson(const BenchReport& report) const {
+        if (jsonPath.empty()) {
+            return true;
+        }
+        FILE* out = jsonPath == "-" ? stdout : std::fopen(jsonPath.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+            return false;
+        }
+        report.WriteJson(out);
+        if (out != stdout) {
+            std::fclose(out);
+        }
+        return true;
+    }
+
+    Private Void PrintUsage(const char* program) const {
+        StdVector<Argument> shown;
+        if (writesJson) {
+            shown.push_back({"--json", "<file|->", "Write results as JSON to a file, or - for stdout", nullptr});
+        }
+        shown.push_back({"--quick", "", quickHelp, nullptr});
+        shown.insert(shown.end(), flags.begin(), flags.end());
+        Size width = 6;
+        std::printf("Usage: %s", program);
+        for (const Argument& flag : shown) {
+            if (flag.value.empty()) {
+                std::printf(" [%s]", flag.name.c_str());
+            } else {
+                std::printf(" [%s %s]", flag.name.c_str(), flag.value.c_str());
+            }
+            width = std::max(width, flag.name.size());
+        }
+        shown.push_back({"--help", "", "Show this help message", nullptr});
+        std::printf("\n");
+        for (const Argument& flag : shown) {
+            std::printf("  %-*s  %s\n", static_cast<int>(width), flag.name.c_str(), flag.help.c_str());
+        }
+    }
+};
+
+#endif // BENCH_UTILS_H
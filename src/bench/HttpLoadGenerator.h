@@ -0,0 +1,285 @@
+#ifndef ARDUINO
+#ifndef HTTP_LOAD_GENERATOR_H
+#define HTTP_LOAD_GENERATOR_H
+
+#include <StandardDefines.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../serializer/NumberFormat.h"
+
+// Raw-socket HTTP load generator for the desktop benchmarks: one thread keeps
+// many connections busy, so a thousand clients cost a thousand sockets rather
+// than a thousand threads.
+
+struct HttpLoadOptions {
+    uint16_t port = 8080;
+    // Sent as is, e.g. "GET /switch/1 HTTP/1.1\r\nHost: bench\r\n\r\n"
+    StdString request;
+    Size connections = 1;
+    // Requests in flight per connection; above 1 they are pipelined
+    Size pipeline = 1;
+    // Open a new connection for every request instead of keeping them alive
+    Bool reconnect = false;
+    double seconds = 1;
+};
+
+struct HttpLoadResult {
+    Size responses = 0;
+    Size errors = 0;
+    Size connects = 0;
+    double seconds = 0;
+
+    double RequestsPerSecond() const {
+        return seconds > 0 ? responses / seconds : 0;
+    }
+};
+
+/**
+ * @brief Raise the open-file limit as far as allowed
+ * @return The soft limit now in effect
+ */
+inline Size RaiseOpenFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return 0;
+    }
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return static_cast<Size>(limit.rlim_cur);
+}
+
+// Length of the complete response at offset, or 0 if it has not all arrived
+inline Size HttpResponseLength(const StdString& buffer, Size offset) {
+    Size headerEnd = buffer.find("\r\n\r\n", offset);
+    if (headerEnd == StdString::npos) {
+        return 0;
+    }
+    Size field = buffer.find("Content-Length: ", offset);
+    uint64_t bodyLength = 0;
+    if (field != StdString::npos && field < headerEnd) {
+        const char* digits = buffer.data() + field + 16;
+        NumberFormat::ParseUInt(digits, buffer.data() + headerEnd, bodyLength);
+    }
+    Size total = headerEnd + 4 + static_cast<Size>(bodyLength) - offset;
+    return offset + total <= buffer.size() ? total : 0;
+}
+
+/**
+ * One blocking keep-alive connection to 127.0.0.1, for benchmarks that time a
+ * single request at a time
+ */
+class HttpBenchClient {
+    Private Int fd = -1;
+    Private StdString received;
+
+    Public HttpBenchClient() = default;
+    HttpBenchClient(const HttpBenchClient&) = delete;
+    HttpBenchClient& operator=(const HttpBenchClient&) = delete;
+
+    Public ~HttpBenchClient() {
+        Close();
+    }
+
+    Public Bool Open(uint16_t port) {
+        Close();
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            Close();
+            return false;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return true;
+    }
+
+    /**
+     * @brief Send one request and read its whole response
+     * @param response Receives the status line, headers and body
+     * @return false when the connection failed or closed early
+     */
+    Public Bool Exchange(CStdString& request, StdString& response) {
+        received.clear();
+        Size sent = 0;
+        while (sent < request.size()) {
+            ssize_t written = send(fd, request.data() + sent, request.size() - sent, 0);
+            if (written <= 0) {
+                return false;
+            }
+            sent += static_cast<Size>(written);
+        }
+        char chunk[16384];
+        Size length = 0;
+        while ((length = HttpResponseLength(received, 0)) == 0) {
+            ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                return false;
+            }
+            received.append(chunk, static_cast<Size>(count));
+        }
+        response.assign(received, 0, length);
+        return true;
+    }
+
+    Public Void Close() {
+        if (fd >= 0) {
+            close(fd);
+        }
+        fd = -1;
+    }
+};
+
+class HttpLoadGenerator {
+    Private struct Client {
+        Int fd = -1;
+        StdString received;
+        Size outstanding = 0;
+    };
+
+    Private HttpLoadOptions options;
+    Private StdString batch;
+    Private StdVector<Client> clients;
+    Private HttpLoadResult result;
+
+    Public explicit HttpLoadGenerator(HttpLoadOptions loadOptions) : options(std::move(loadOptions)) {
+        for (Size i = 0; i < options.pipeline; i++) {
+            batch += options.request;
+        }
+    }
+
+    Public HttpLoadResult Run() {
+        result = HttpLoadResult();
+        clients.assign(options.connections, Client());
+        for (Client& client : clients) {
+            if (!Open(client)) {
+                result.errors++;
+            }
+        }
+
+        StdVector<pollfd> fds(clients.size());
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(options.seconds));
+        while (std::chrono::steady_clock::now() < deadline) {
+            for (Size i = 0; i < clients.size(); i++) {
+                fds[i] = pollfd{clients[i].fd, POLLIN, 0};
+            }
+            if (poll(fds.data(), static_cast<nfds_t>(fds.size()), 100) <= 0) {
+                continue;
+            }
+            for (Size i = 0; i < clients.size(); i++) {
+                if (fds[i].revents != 0) {
+                    Receive(clients[i]);
+                }
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (Client& client : clients) {
+            Close(client);
+        }
+        return result;
+    }
+
+    Private Bool Open(Client& client) {
+        client.fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (client.fd < 0) {
+            return false;
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(client.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            Close(client);
+            return false;
+        }
+        int noDelay = 1;
+        setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        fcntl(client.fd, F_SETFL, fcntl(client.fd, F_GETFL, 0) | O_NONBLOCK);
+        result.connects++;
+        return Send(client);
+    }
+
+    Private Bool Send(Client& client) {
+        Size sent = 0;
+        while (sent < batch.size()) {
+            ssize_t written = send(client.fd, batch.data() + sent, batch.size() - sent, 0);
+            if (written <= 0) {
+                pollfd writable{client.fd, POLLOUT, 0};
+                if (written < 0 && errno == EAGAIN && poll(&writable, 1, 1000) > 0) {
+                    continue;
+                }
+                return false;
+            }
+            sent += static_cast<Size>(written);
+        }
+        client.outstanding = options.pipeline;
+        return true;
+    }
+
+    Private Void Receive(Client& client) {
+        char chunk[16384];
+        ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+            client.received.append(chunk, static_cast<Size>(received));
+        }
+        Size offset = 0;
+        Size length = 0;
+        while (client.outstanding > 0 && (length = HttpResponseLength(client.received, offset)) > 0) {
+            offset += length;
+            client.outstanding--;
+            result.responses++;
+        }
+        client.received.erase(0, offset);
+
+        Bool closed = received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR);
+        if (client.outstanding == 0 && !options.reconnect && !closed) {
+            if (!Send(client)) {
+                result.errors++;
+                Reopen(client);
+            }
+        } else if ((client.outstanding == 0 && options.reconnect) || closed) {
+            if (client.outstanding > 0) {
+                result.errors++;
+            }
+            Reopen(client);
+        }
+    }
+
+    Private Void Reopen(Client& client) {
+        Close(client);
+        if (!Open(client)) {
+            result.errors++;
+        }
+    }
+
+    Private Static Void Close(Client& client) {
+        if (client.fd >= 0) {
+            close(client.fd);
+        }
+        client.fd = -1;
+        client.received.clear();
+        client.outstanding = 0;
+    }
+};
+
+#endif // HTTP_LOAD_GENERATOR_H
+#endif // ARDUINO
@@ -0,0 +1,226 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "controller/SwitchResponseDto.h"
+#include "server/HttpCompression.h"
+#include "server/SelectHttpServer.h"
+
+// Response compression benchmark for GET /switch with --switches devices
+// (default 100), serialized as the handler does.
+//
+// The encode group times the encoders and HttpCompression::Apply() on the
+// body, compressing on the fly and serving a precompressed constant. The
+// round-trip group runs SelectHttpServer, the server the ESP32 uses, on
+// loopback and times a kept-alive GET /switch without Accept-Encoding,
+// with gzip, and with the body registered as a constant.
+//
+// Loopback hides the transfer time that dominates over WiFi, so the last
+// table adds wire bytes at --link-mbps (default 5, what an ESP32 serving
+// HTTP over WiFi sustains in practice) to the loopback time. The ESP32's
+// core is an order of magnitude slower than a desktop one, so scale the
+// encode group accordingly before comparing it with the transfer saved.
+
+StdString SwitchListBody(Int switches) {
+    StdVector<SwitchResponseDto> list;
+    for (Int id = 1; id <= switches; id++) {
+        SwitchState state = id % 3 == 0 ? SwitchState::On : SwitchState::Off;
+        list.push_back(SwitchResponseDto(id, state, state, state));
+    }
+    return nayan::serializer::SerializationUtility::Serialize(list);
+}
+
+// Keeps one connection to the server and reads each response whole
+class RoundTripClient {
+    Private Int fd = -1;
+    Private StdString received;
+
+    Public Bool Connect(uint16_t port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    Public ~RoundTripClient() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    /**
+     * @brief Send request and wait for the whole response
+     * @return Bytes of the response, headers included; 0 on failure
+     */
+    Public Size Exchange(const StdString& request) {
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+            return 0;
+        }
+        received.clear();
+        char chunk[16384];
+        while (true) {
+            Size headerEnd = received.find("\r\n\r\n");
+            if (headerEnd != StdString::npos) {
+                Size field = received.find("Content-Length: ");
+                uint64_t length = 0;
+                NumberFormat::ParseUInt(received.data() + field + 16, received.data() + headerEnd, length);
+                if (received.size() >= headerEnd + 4 + length) {
+                    return received.size();
+                }
+            }
+            ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                return 0;
+            }
+            received.append(chunk, static_cast<Size>(count));
+        }
+    }
+};
+
+int main(int argc, char* argv[]) {
+    Int switches = 100;
+    double linkMbps = 5;
+
+    BenchCommandLine commandLine;
+    commandLine.Flag("--switches", "Devices in the GET /switch body (default 100)", switches, 1);
+    commandLine.Flag("--link-mbps", "M", "Link rate for the transfer estimate (default 5)", [&linkMbps](const char* value) {
+        linkMbps = std::max(0.1, std::atof(value));
+    });
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("compression_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    const Size count = static_cast<Size>(switches);
+    const StdString body = SwitchListBody(switches);
+    HttpCompression onTheFly;
+    HttpCompression precompressed;
+    precompressed.AddConstant(body);
+    HttpCompression::Buffers buffers;
+    HttpServerRequest acceptsGzip;
+    acceptsGzip.headers.emplace_back("Accept-Encoding", "gzip, deflate");
+
+    DeflateEncoder encoder;
+    StdString encoded;
+    encoder.Gzip(body, encoded);
+    const Size gzipSize = encoded.size();
+    StdVector<BenchResult> results;
+    results.push_back(report.Measure("encode", "gzip", count, gzipSize, [&]() {
+        encoded.clear();
+        encoder.Gzip(body, encoded);
+    }));
+    results.push_back(report.Measure("encode", "deflate", count, gzipSize - 12, [&]() {
+        encoded.clear();
+        encoder.Zlib(body, encoded);
+    }));
+    HttpServerResponse response;
+    results.push_back(report.Measure("encode", "apply, on the fly", count, gzipSize, [&]() {
+        response.Reset();
+        response.body.assign(body);
+        onTheFly.Apply(acceptsGzip, response, buffers);
+    }));
+    results.push_back(report.Measure("encode", "apply, precompressed", count, gzipSize, [&]() {
+        response.Reset();
+        response.body.assign(body);
+        precompressed.Apply(acceptsGzip, response, buffers);
+    }));
+
+    struct RoundTrip {
+        const char* name;
+        const HttpCompression* compression;
+        Bool constantBody;
+        const char* request;
+    };
+    const RoundTrip roundTrips[] = {
+        {"identity", &onTheFly, false, "GET /switch HTTP/1.1\r\nHost: bench\r\n\r\n"},
+        {"gzip", &onTheFly, false, "GET /switch HTTP/1.1\r\nHost: bench\r\nAccept-Encoding: gzip\r\n\r\n"},
+        {"gzip, precompressed", &precompressed, true, "GET /switch HTTP/1.1\r\nHost: bench\r\nAccept-Encoding: gzip\r\n\r\n"},
+    };
+    struct WireCost {
+        const char* name;
+        Size wireBytes;
+        double loopbackMicros;
+    };
+    StdVector<WireCost> costs;
+    Size failures = 0;
+    for (const RoundTrip& roundTrip : roundTrips) {
+        // Serialized per request like the real handler, unless the body is constant
+        SelectHttpServer server([&](const HttpServerRequest&, HttpServerResponse& out) {
+            if (roundTrip.constantBody) {
+                out.body.assign(body);
+            } else {
+                out.body = SwitchListBody(switches);
+            }
+        });
+        server.SetCompression(roundTrip.compression);
+        if (!server.Start(0, "127.0.0.1")) {
+            std::cerr << "Could not start the server" << std::endl;
+            return 1;
+        }
+        std::atomic<Bool> stop{false};
+        std::thread loop([&]() {
+            while (!stop.load()) {
+                server.Poll(10);
+            }
+        });
+
+        RoundTripClient client;
+        const StdString request = roundTrip.request;
+        Size wireBytes = client.Connect(server.GetPort()) ? client.Exchange(request) : 0;
+        if (wireBytes > 0) {
+            BenchResult result = report.Measure("round trip", roundTrip.name, count, wireBytes, [&]() {
+                failures += client.Exchange(request) == wireBytes ? 0 : 1;
+            });
+            results.push_back(result);
+            costs.push_back({roundTrip.name, wireBytes, result.nanosPerOp / 1000});
+        } else {
+            failures++;
+        }
+        stop.store(true);
+        loop.join();
+    }
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+        std::printf("\n%-24s %12s %14s %16s   (link %.1f Mbit/s)\n", "GET /switch", "wire bytes", "loopback us",
+                    "over link us", linkMbps);
+        for (const WireCost& cost : costs) {
+            double transferMicros = cost.wireBytes * 8 / linkMbps;
+            std::printf("%-24s %12zu %14.1f %16.1f\n", cost.name, cost.wireBytes, cost.loopbackMicros,
+                        cost.loopbackMicros + transferMicros);
+        }
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " round trips failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
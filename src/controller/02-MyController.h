@@ -2,6 +2,7 @@
 #define MY_CONTROLLER
 
 #include "01-IMyController.h"
+#include "../StdPrint.h"
 
 /* @RestController */
 /* @RequestMapping("/myUrlTee") */
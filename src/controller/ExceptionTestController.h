@@ -6,6 +6,7 @@
 #include "ResponseEntity.h"
 #include "HttpStatus.h"
 #include "CustomException.h"
+#include "../errors/Expected.h"
 #include <stdexcept>
 #include <exception>
 
@@ -16,27 +17,62 @@ public:
 
     /* @GetMapping("/runtime-error") */
     ResponseEntity<StdString> ThrowRuntimeException() override {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
         throw std::runtime_error("This is a runtime error with a detailed message");
+#else
+        return Unexpected(std::runtime_error("This is a runtime error with a detailed message")).ToResponseEntity();
+#endif
     }
 
     /* @GetMapping("/logic-error") */
     ResponseEntity<StdString> ThrowLogicException() override {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
         throw std::logic_error("This is a logic error: invalid operation attempted");
+#else
+        return Unexpected(std::logic_error("This is a logic error: invalid operation attempted")).ToResponseEntity();
+#endif
     }
 
     /* @GetMapping("/string-exception") */
     ResponseEntity<StdString> ThrowStringException() override {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
         throw "This is a const char* exception (not std::exception)";
+#else
+        return Unexpected("This is a const char* exception (not std::exception)").ToResponseEntity();
+#endif
     }
 
     /* @GetMapping("/int-exception") */
     ResponseEntity<StdString> ThrowIntException() override {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
         throw 42;  // Throwing an int
+#else
+        return Unexpected(42).ToResponseEntity();
+#endif
     }
 
     /* @GetMapping("/custom-exception") */
     ResponseEntity<StdString> ThrowCustomException() override {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
         throw CustomException("This is a custom exception type");
+#else
+        return Unexpected(CustomException("This is a custom exception type")).ToResponseEntity();
+#endif
+    }
+
+    /* @GetMapping("/expected-error") */
+    ResponseEntity<StdString> ReturnExpectedError() override {
+        Expected<StdString> result = LoadMessage();
+        if (!result.HasValue()) {
+            return result.Error().ToResponseEntity();
+        }
+        return ResponseEntity<StdString>::Ok(result.Value());
+    }
+
+private:
+    // Fails the way /runtime-error does, but without throwing
+    Expected<StdString> LoadMessage() {
+        return Unexpected(std::runtime_error("This is a runtime error with a detailed message"));
     }
 };
 
@@ -36,6 +36,11 @@ public:
      * @brief Throws a custom exception type
      */
     virtual ResponseEntity<StdString> ThrowCustomException() = 0;
+
+    /**
+     * @brief Fails through Expected without throwing; same status and body as ThrowRuntimeException
+     */
+    virtual ResponseEntity<StdString> ReturnExpectedError() = 0;
 };
 
 #include "ExceptionTestController.h"
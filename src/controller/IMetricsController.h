@@ -0,0 +1,27 @@
+#ifndef IMETRICSCONTROLLER_H
+#define IMETRICSCONTROLLER_H
+
+#include <StandardDefines.h>
+
+// Forward declarations
+template<typename T>
+class ResponseEntity;
+
+DefineStandardPointers(IMetricsController)
+class IMetricsController {
+    Public Virtual ~IMetricsController() = default;
+
+    /**
+     * @brief Per-route request counts, status codes and latency histograms
+     * @return ResponseEntity<StdString> in Prometheus text format
+     */
+    Public Virtual ResponseEntity<StdString> GetMetrics() = 0;
+
+    /**
+     * @brief Same counters in the compact binary form of RouteMetrics::WriteBinary
+     * @return ResponseEntity<StdString> holding the raw bytes
+     */
+    Public Virtual ResponseEntity<StdString> GetBinaryMetrics() = 0;
+};
+
+#endif // IMETRICSCONTROLLER_H
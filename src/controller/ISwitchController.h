@@ -8,6 +8,7 @@ template<typename T>
 class ResponseEntity;
 
 class SwitchResponseDto;
+DefineStandardTypes(SwitchState)
 
 DefineStandardPointers(ISwitchController)
 class ISwitchController {
@@ -34,6 +35,14 @@ class ISwitchController {
      */
     Public Virtual ResponseEntity<SwitchResponseDto> ToggleSwitch(Int id) = 0;
 
+    /**
+     * @brief Set a switch to the given state by ID
+     * @param id The switch ID
+     * @param state Target state, On or Off
+     * @return ResponseEntity<SwitchResponseDto>, or 404 if not found
+     */
+    Public Virtual ResponseEntity<SwitchResponseDto> SetSwitchState(Int id, SwitchState state) = 0;
+
     /**
      * @brief Get switch details by ID
      * @param id The switch ID
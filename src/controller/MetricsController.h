@@ -0,0 +1,28 @@
+#ifndef METRICSCONTROLLER_H
+#define METRICSCONTROLLER_H
+
+#include <StandardDefines.h>
+#include "IMetricsController.h"
+#include "ResponseEntity.h"
+#include "HttpStatus.h"
+#include "../metrics/RouteMetrics.h"
+
+/* @RestController */
+/* @RequestMapping("/metrics") */
+class MetricsController final : public IMetricsController {
+    Public MetricsController() = default;
+
+    Public Virtual ~MetricsController() = default;
+
+    /* @GetMapping */
+    Public Virtual ResponseEntity<StdString> GetMetrics() override {
+        return ResponseEntity<StdString>::Ok(RouteMetrics::Global().WritePrometheus());
+    }
+
+    /* @GetMapping("/binary") */
+    Public Virtual ResponseEntity<StdString> GetBinaryMetrics() override {
+        return ResponseEntity<StdString>::Ok(RouteMetrics::Global().WriteBinary());
+    }
+};
+
+#endif // METRICSCONTROLLER_H
@@ -6,6 +6,7 @@
 #include "SwitchResponseDto.h"
 #include "ResponseEntity.h"
 #include "HttpStatus.h"
+#include "../SwitchState.h"
 #include "../service/ISwitchService.h"
 
 /* @RestController */
@@ -16,6 +17,9 @@ class SwitchController final : public ISwitchController {
 
     Public SwitchController() = default;
 
+    // For servers that build their controllers themselves, e.g. AppRequestHandler
+    Public explicit SwitchController(ISwitchServicePtr service) : switchService(std::move(service)) {}
+
     Public Virtual ~SwitchController() = default;
 
     /* @PutMapping("/{id}/on") */
@@ -45,6 +49,15 @@ class SwitchController final : public ISwitchController {
         return ResponseEntity<SwitchResponseDto>::Ok(result.value());
     }
 
+    /* @PutMapping("/{id}/state/{state}") */
+    Public Virtual ResponseEntity<SwitchResponseDto> SetSwitchState(/* @PathVariable("id") */ Int id, /* @PathVariable("state") */ SwitchState state) override {
+        optional<SwitchResponseDto> result = state == SwitchState::On ? switchService->TurnOnSwitch(id) : switchService->TurnOffSwitch(id);
+        if (!result.has_value()) {
+            return ResponseEntity<SwitchResponseDto>::NotFound(SwitchResponseDto());
+        }
+        return ResponseEntity<SwitchResponseDto>::Ok(result.value());
+    }
+
     /* @GetMapping("/{id}") */
     Public Virtual ResponseEntity<SwitchResponseDto> GetSwitchStateById(/* @PathVariable("id") */ Int id) override {
         optional<SwitchResponseDto> result = switchService->GetSwitchStateById(id);
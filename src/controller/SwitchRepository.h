@@ -6,6 +6,7 @@
 #include "Switch.h"
 
 /* @Repository */
+/* @Cache("pinned") */
 DefineStandardPointers(SwitchRepository)
 class SwitchRepository : public CpaRepository<Switch, int> {
     Public Virtual ~SwitchRepository() = default;
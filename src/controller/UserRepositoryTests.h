@@ -27,6 +27,37 @@
 #include "UserRepository.h"
 #include "User.h"
 #include "../tests/TestUtils.h"
+#ifndef ARDUINO
+    #include "../storage/AppRepositories.h"
+#endif
+
+// On the desktop the tests run against the app's repository, AppRepositories::Users()
+#if !defined(ARDUINO) && APPREPOSITORIES_AVAILABLE
+    #define USERREPOSITORYTESTS_APP_REPOSITORY 1
+#else
+    #define USERREPOSITORYTESTS_APP_REPOSITORY 0
+#endif
+
+// The repository under test
+inline UserRepositoryPtr GetTestRepository() {
+#if USERREPOSITORYTESTS_APP_REPOSITORY
+    return AppRepositories::Users();
+#else
+    return Implementation<UserRepository>::type::GetInstance();
+#endif
+}
+
+#ifndef ARDUINO
+// Directory the repository under test writes to
+inline std::string GetTestRoot() {
+#if USERREPOSITORYTESTS_APP_REPOSITORY
+    return DirectoryFileManager::ConfiguredRoot();
+#else
+    // The framework's desktop file manager has a fixed root
+    return "/Users/nkurude/db";
+#endif
+}
+#endif
 
 // Helper class for file verification - different implementations for Arduino and non-Arduino
 #ifdef ARDUINO
@@ -112,7 +143,7 @@ public:
     // Clean up test files from database directory
     static void CleanupTestFiles() {
         #ifndef ARDUINO
-        std::string dbPath = "/Users/nkurude/db";
+        std::string dbPath = GetTestRoot();
         #else
         std::string dbPath = "";
         #endif
@@ -152,10 +183,13 @@ inline std::string GetTestFilePath(const std::string& filename) {
         // Arduino: just return the hashed filename (Preferences uses keys, not paths)
         StdString hashed = GenerateHashForTest(CStdString(filename.c_str()));
         return "/" + std::string(hashed.c_str());
+    #elif USERREPOSITORYTESTS_APP_REPOSITORY
+        // App repository: EntityFileStore keeps the file name as given
+        return GetTestRoot() + "/" + filename;
     #else
         // Non-Arduino: return full path with hashed filename
         StdString hashed = GenerateHashForTest(CStdString(filename.c_str()));
-        return "/Users/nkurude/db/" + std::string(hashed.c_str());
+        return GetTestRoot() + "/" + std::string(hashed.c_str());
     #endif
 }
 
@@ -165,14 +199,14 @@ inline std::string GetTestFilePath(const std::string& filename) {
 bool TestSaveUser() {
     TEST_START("Test Save User");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create a new user
     User user;
     user.id = optional<int>(1);
     user.name = optional<StdString>(StdString("John Doe"));
     
-    // Save the user (repository uses DesktopFileManager - writes to actual disk)
+    // Save the user (writes to actual disk)
     User savedUser = repository->Save(user);
     
     // Verify Save returned the user
@@ -202,7 +236,7 @@ bool TestSaveUser() {
 bool TestSaveAndFindById() {
     TEST_START("Test Save and FindById");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -238,7 +272,7 @@ bool TestSaveAndFindById() {
 bool TestFindByIdNotFound() {
     TEST_START("Test FindById with non-existent ID");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Try to find a user that doesn't exist
     int id = 999;
@@ -259,7 +293,7 @@ bool TestFindByIdNotFound() {
 bool TestUpdateUser() {
     TEST_START("Test Update User");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -302,7 +336,7 @@ bool TestUpdateUser() {
 bool TestDeleteById() {
     TEST_START("Test DeleteById");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -340,7 +374,7 @@ bool TestDeleteById() {
 bool TestDeleteEntity() {
     TEST_START("Test Delete Entity");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -373,7 +407,7 @@ bool TestDeleteEntity() {
 bool TestExistsByIdTrue() {
     TEST_START("Test ExistsById - existing user");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -405,7 +439,7 @@ bool TestExistsByIdTrue() {
 bool TestExistsByIdFalse() {
     TEST_START("Test ExistsById - non-existent user");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Check if non-existent user exists
     int id = 999;
@@ -415,7 +449,7 @@ bool TestExistsByIdFalse() {
     
 #ifndef ARDUINO
     // Verify file doesn't exist on disk
-    std::string expectedFilePath = "/Users/nkurude/db/User_id_999";
+    std::string expectedFilePath = GetTestRoot() + "/User_id_999";
 #else
     std::string expectedFilePath = GetTestFilePath("User_id_999");
 #endif
@@ -429,7 +463,7 @@ bool TestExistsByIdFalse() {
 bool TestFindAll() {
     TEST_START("Test FindAll");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save multiple users
     User user1;
@@ -487,7 +521,7 @@ bool TestFindAll() {
 bool TestSaveMultipleUsers() {
     TEST_START("Test Save Multiple Users");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Save multiple users
     for (int i = 20; i < 25; i++) {
@@ -519,7 +553,7 @@ bool TestSaveMultipleUsers() {
 bool TestUpdateNonExistentUser() {
     TEST_START("Test Update Non-existent User");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Try to update a user that doesn't exist
     User user;
@@ -557,7 +591,7 @@ bool TestUpdateNonExistentUser() {
 bool TestDeleteByIdNonExistent() {
     TEST_START("Test DeleteById Non-existent User");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Try to delete a user that doesn't exist
     int id = 999;
@@ -578,7 +612,7 @@ bool TestDeleteByIdNonExistent() {
 bool TestFileContentsMatchEntity() {
     TEST_START("Test File Contents Match Entity");
     
-    UserRepositoryPtr repository = Implementation<UserRepository>::type::GetInstance();
+    UserRepositoryPtr repository = GetTestRepository();
     
     // Create and save a user
     User user;
@@ -690,7 +724,8 @@ int RunAllTests(int argc, char* argv[]) {
         std_println("");
     } else {
         #ifndef ARDUINO
-        std_print("Test files are available at: /Users/nkurude/db/");
+        std_print("Test files are available at: ");
+        std_print(GetTestRoot() + "/");
         #else
         std_print("Test files are stored in Arduino Preferences.");
         #endif
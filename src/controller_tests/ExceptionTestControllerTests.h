@@ -262,6 +262,44 @@ bool TestThrowCustomException() {
     return true;
 }
 
+// Test 6: Expected error path - Should return 500 with the message, without throwing
+bool TestReturnExpectedError() {
+    TEST_EXCEPTION_START("Test Return Expected Error - 500 with message");
+    
+    ISpecialHttpClientPtr httpClient = GetHttpClient();
+    if (!httpClient) {
+        std_println("FAILED - HTTP client is null!");
+        PrintExceptionTestResult("Return Expected Error", false);
+        return false;
+    }
+    
+    StdString url = BASE_URL_EXCEPTION_TEST + "/expected-error";
+    std_print("[DEBUG] URL: ");
+    std_println(url.c_str());
+    
+    StdString responseJson = httpClient->Get(url);
+    std_print("[DEBUG] Response received: ");
+    std_println(responseJson.c_str());
+    
+    HttpResponse response = ParseHttpResponse(responseJson);
+    std_print("[DEBUG] Status code: ");
+    std_println(std::to_string(response.statusCode).c_str());
+    std_print("[DEBUG] Body: ");
+    std_println(response.body.c_str());
+    
+    // Should return 500 Internal Server Error, like /runtime-error
+    ASSERT_EXCEPTION(response.statusCode == 500, 
+                     "HTTP status should be 500 Internal Server Error");
+    
+    // Body should carry the message through the registry's template
+    bool hasMessage = response.body.find("runtime error") != StdString::npos &&
+                      response.body.find("Internal Server Error") != StdString::npos;
+    ASSERT_EXCEPTION(hasMessage, "Body should contain the error and its message");
+    
+    PrintExceptionTestResult("Return Expected Error", true);
+    return true;
+}
+
 // ========== RUN ALL TESTS ==========
 
 /**
@@ -293,6 +331,7 @@ int RunAllExceptionTestControllerTests(const std::string& ip, const std::string&
     TestThrowStringException();
     TestThrowIntException();
     TestThrowCustomException();
+    TestReturnExpectedError();
     
     // Print summary
     std_println("");
@@ -1,18 +1,73 @@
 #ifndef ARDUINO
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
 #include "tests/AllTests.h"
 #include "IHttpRequestManager.h"
 
 #include "ISpringBootCppApp.h"
+#include "server/AppRequestHandler.h"
+#include "server/HttpCompression.h"
+#include "server/ThreadedHttpServer.h"
+#include "service/ISwitchService.h"
 
 
 /* @Autowired */
 ISpringBootCppAppPtr springBootCppApp;
 
+/* @Autowired */
+ISwitchServicePtr switchService;
+
+// Value following "--name" on the command line, or nullptr
+const char* FindArgument(int argc, char* argv[], const char* name) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (StdString(argv[i]) == name) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+#if APPREQUESTHANDLER_AVAILABLE
+// Serves the switch and metrics routes on a ThreadPool instead of the framework's single-threaded loop,
+// gzipping bodies for clients that accept it; fixed bodies are compressed once, here
+int RunThreadedServer(Size threads, uint16_t port) {
+    AppRequestHandler handler(switchService);
+    HttpCompression compression;
+    handler.AddConstantBodies(compression);
+    ThreadedHttpServer server([&handler](const HttpServerRequest& request, HttpServerResponse& response) {
+        handler.Handle(request, response);
+    }, threads);
+    server.SetCompression(&compression);
+    if (!server.Start(port)) {
+        std::cout << "Could not listen on port " << port << std::endl;
+        return 1;
+    }
+    std::cout << "Threaded server listening on port " << server.GetPort()
+              << " with " << server.GetWorkerCount() << " workers" << std::endl;
+    while (server.IsRunning()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    return 0;
+}
+#endif
+
 // Main function - runs the HTTP server loop
+// --threads N [--port P] serves requests on N worker threads (default port 8080)
 int main(int argc, char* argv[]) {
 
     RunAllTestSuites(argc, argv);
 
+#if APPREQUESTHANDLER_AVAILABLE
+    const char* threads = FindArgument(argc, argv, "--threads");
+    if (threads != nullptr) {
+        const char* port = FindArgument(argc, argv, "--port");
+        return RunThreadedServer(static_cast<Size>(std::atoi(threads)),
+                                 static_cast<uint16_t>(port != nullptr ? std::atoi(port) : 8080));
+    }
+#endif
+
     springBootCppApp->StartApp();
 
     while(true) {
@@ -23,4 +78,3 @@ int main(int argc, char* argv[]) {
 }
 
 #endif // ARDUINO
-
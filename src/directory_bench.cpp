@@ -0,0 +1,120 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "storage/DirectoryFileManager.h"
+
+// Directory benchmark: DirectoryFileManager with --files files (default
+// 100000) of 64 bytes, all in one directory ("flat") or spread over 256
+// shard directories ("sharded").
+//
+//   Create+Delete  creates a new file and deletes it, so the count stays N
+//   Read           reads a stored file, cycling through the names
+//   Exists         one stat of a stored file, no listing cached
+//   List           the cached listing once the directories were scanned
+//
+// Files are on disk under --dir (default: the system temp directory) and
+// removed afterwards. Writing the N files and the first scan are timed once
+// and printed below the table. How much sharding helps depends on the
+// filesystem: ext4 and APFS index large directories, FAT and SPIFFS do not.
+
+namespace {
+
+StdString BenchFileName(Size index) {
+    return "Product_id_" + std::to_string(index);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Int fileCount = 100000;
+    StdString baseDirectory = std::filesystem::temp_directory_path().string();
+
+    BenchCommandLine commandLine;
+    commandLine.Flag("--files", "Files stored (default 100000)", fileCount, 1);
+    commandLine.Flag("--dir", "Directory for the files (default: system temp directory)", baseDirectory);
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("directory_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    const StdString root = baseDirectory + "/directory_bench_" + std::to_string(::getpid());
+    std::filesystem::create_directories(root);
+    const StdString contents(64, 'x');
+    const Size count = static_cast<Size>(fileCount);
+
+    StdVector<BenchResult> results;
+    StdString loads;
+    Size failures = 0;
+    for (Int layout = 0; layout < 2; layout++) {
+        const StdString name = StdString(layout == 0 ? "flat" : "sharded, 256") + ", " + std::to_string(count);
+        const StdString directory = root + "/" + std::to_string(layout);
+        DirectoryFileManager::Options fileOptions;
+        fileOptions.shardBuckets = layout == 0 ? 0 : 256;
+        DirectoryFileManager files(directory, fileOptions);
+
+        auto start = std::chrono::steady_clock::now();
+        for (Size i = 0; i < count; i++) {
+            failures += files.Create(BenchFileName(i), contents) ? 0 : 1;
+        }
+        double createMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        results.push_back(report.Measure("Create+Delete", name, 1, contents.size(), [&, step = count]() mutable {
+            StdString file = BenchFileName(step++);
+            failures += files.Create(file, contents) && files.Delete(file) ? 0 : 1;
+        }));
+        results.push_back(report.Measure("Read", name, 1, contents.size(), [&, step = Size(0)]() mutable {
+            failures += files.Read(BenchFileName((step++ * 7919) % count)).size() == contents.size() ? 0 : 1;
+        }));
+        results.push_back(report.Measure("Exists", name, 1, 0, [&, step = Size(0)]() mutable {
+            failures += files.Exists(BenchFileName((step++ * 7919) % count)) ? 0 : 1;
+        }));
+
+        start = std::chrono::steady_clock::now();
+        failures += files.List().size() == count ? 0 : 1;
+        double scanMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        results.push_back(report.Measure("List", name, count, 0, [&]() {
+            failures += files.List().size() == count ? 0 : 1;
+        }));
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-22s create %9.1f ms  (%6.2f us per file)  first List %7.1f ms\n",
+                      name.c_str(), createMillis, 1000.0 * createMillis / count, scanMillis);
+        loads += line;
+        std::filesystem::remove_all(directory);
+    }
+    std::filesystem::remove_all(root);
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+        std::printf("\nWriting the files and the first scan:\n%s", loads.c_str());
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " file operations failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
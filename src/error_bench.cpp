@@ -0,0 +1,182 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "bench/HttpLoadGenerator.h"
+#include "controller/CustomException.h"
+#include "errors/ErrorResponse.h"
+#include "errors/Expected.h"
+#include "server/AppRequestHandler.h"
+#include "server/ThreadedHttpServer.h"
+
+// Error-path benchmark for the /exception-test/* handlers: requests per second
+// when a handler fails. "registry" maps the exception a handler throws through
+// ExceptionResponseRegistry::Invoke(), and "expected" fails through Expected
+// with no throw at all; both in process, one op being one failed handler call.
+// "server" requests the endpoint over a keep-alive connection from a
+// ThreadedHttpServer running AppRequestHandler, so one op is the whole
+// request: parse, route, throw, map, write and read back. Its
+// /expected-error and /response-entity/string rows are the same server path
+// without a throw.
+
+template<typename Handler>
+ErrorResponse RegistryCatch(const ExceptionResponseRegistry& registry, Handler&& handler) {
+    ErrorResponse response;
+    registry.Invoke([&]() {
+        handler();
+        return true;
+    }, response);
+    return response;
+}
+
+// What each /exception-test endpoint throws
+struct ErrorCase {
+    const char* endpoint;
+    void (*throwError)();
+    ErrorResponse (*returnError)(const ExceptionResponseRegistry& registry);
+};
+
+const ErrorCase kErrorCases[] = {
+    {"/runtime-error",
+     []() { throw std::runtime_error("This is a runtime error with a detailed message"); },
+     [](const ExceptionResponseRegistry& registry) {
+         return Unexpected(std::runtime_error("This is a runtime error with a detailed message"), registry);
+     }},
+    {"/logic-error",
+     []() { throw std::logic_error("This is a logic error: invalid operation attempted"); },
+     [](const ExceptionResponseRegistry& registry) {
+         return Unexpected(std::logic_error("This is a logic error: invalid operation attempted"), registry);
+     }},
+    {"/string-exception",
+     []() { throw "This is a const char* exception (not std::exception)"; },
+     [](const ExceptionResponseRegistry& registry) {
+         return Unexpected("This is a const char* exception (not std::exception)", registry);
+     }},
+    {"/int-exception",
+     []() { throw 42; },
+     [](const ExceptionResponseRegistry& registry) { return Unexpected(42, registry); }},
+    {"/custom-exception",
+     []() { throw CustomException("This is a custom exception type"); },
+     [](const ExceptionResponseRegistry& registry) {
+         return Unexpected(CustomException("This is a custom exception type"), registry);
+     }},
+};
+
+int main(int argc, char* argv[]) {
+    BenchCommandLine commandLine;
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("error_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    const ExceptionResponseRegistry& registry = ExceptionResponseRegistry::Default();
+#if APPREQUESTHANDLER_AVAILABLE
+    // The switch routes are not requested, so no switch service is needed
+    AppRequestHandler handler(nullptr, registry);
+    ThreadedHttpServer server([&handler](const HttpServerRequest& request, HttpServerResponse& response) {
+        handler.Handle(request, response);
+    }, 1);
+    HttpBenchClient client;
+    if (!server.Start(0, "127.0.0.1") || !client.Open(server.GetPort())) {
+        std::cerr << "Could not start the server" << std::endl;
+        return 1;
+    }
+#endif
+
+    StdVector<BenchResult> results;
+    Size failures = 0;
+    for (const ErrorCase& error : kErrorCases) {
+        // Same status and body whichever way the error travels
+        ErrorResponse thrown = RegistryCatch(registry, error.throwError);
+        ErrorResponse returned = error.returnError(registry);
+        if (thrown.status != returned.status || thrown.body != returned.body) {
+            std::cerr << "Error paths disagree on " << error.endpoint << std::endl;
+            failures++;
+        }
+
+        results.push_back(report.Measure(error.endpoint, "registry", 1, thrown.body.size(), [&]() {
+            ErrorResponse response = RegistryCatch(registry, error.throwError);
+            BenchKeep(response);
+        }));
+        results.push_back(report.Measure(error.endpoint, "expected", 1, thrown.body.size(), [&]() {
+            ErrorResponse response = error.returnError(registry);
+            BenchKeep(response);
+        }));
+#if APPREQUESTHANDLER_AVAILABLE
+        StdString request = StdString("GET /exception-test") + error.endpoint + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+        StdString response;
+        StdString status = "HTTP/1.1 " + std::to_string(static_cast<Int>(thrown.status)) + " ";
+        if (!client.Exchange(request, response) || response.compare(0, status.size(), status) != 0 ||
+            response.compare(response.size() - thrown.body.size(), StdString::npos, thrown.body) != 0) {
+            std::cerr << "Server answers " << error.endpoint << " differently" << std::endl;
+            failures++;
+        }
+        results.push_back(report.Measure(error.endpoint, "server", 1, thrown.body.size(), [&]() {
+            client.Exchange(request, response);
+            BenchKeep(response);
+        }));
+#endif
+    }
+
+#if APPREQUESTHANDLER_AVAILABLE
+    // The same server path for a handler that fails without throwing, and one that succeeds
+    StdVector<BenchResult> baselines;
+    const char* const kBaselines[][2] = {{"/expected-error", "/exception-test/expected-error"},
+                                         {"no error", "/response-entity/string"}};
+    for (const auto& baseline : kBaselines) {
+        StdString request = StdString("GET ") + baseline[1] + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+        StdString response;
+        baselines.push_back(report.Measure(baseline[0], "server", 1, 0, [&]() {
+            client.Exchange(request, response);
+            BenchKeep(response);
+        }));
+    }
+    client.Close();
+    server.Stop();
+#endif
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+#if APPREQUESTHANDLER_AVAILABLE
+        for (const BenchResult& result : baselines) {
+            report.PrintTableRow(result);
+        }
+        const Size columns = 3;
+#else
+        const Size columns = 2;
+#endif
+        std::printf("\n%-20s %16s %16s %16s\n", "requests/s", "registry", "expected", columns == 3 ? "server" : "");
+        for (Size i = 0; i + columns - 1 < results.size(); i += columns) {
+            std::printf("%-20s %16.0f %16.0f", results[i].group.c_str(), 1e9 / results[i].nanosPerOp,
+                        1e9 / results[i + 1].nanosPerOp);
+            if (columns == 3) {
+                std::printf(" %16.0f", 1e9 / results[i + 2].nanosPerOp);
+            }
+            std::printf("\n");
+        }
+#if APPREQUESTHANDLER_AVAILABLE
+        for (const BenchResult& result : baselines) {
+            std::printf("%-20s %16s %16s %16.0f\n", result.group.c_str(), "", "", 1e9 / result.nanosPerOp);
+        }
+#endif
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+#endif // ARDUINO
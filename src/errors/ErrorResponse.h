@@ -0,0 +1,395 @@
+#ifndef ERRORRESPONSE_H
+#define ERRORRESPONSE_H
+
+#include <StandardDefines.h>
+#include <HttpStatus.h>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<ResponseEntity.h>)
+    #include <ResponseEntity.h>
+    #define ERRORRESPONSE_HAS_RESPONSE_ENTITY 1
+#else
+    #define ERRORRESPONSE_HAS_RESPONSE_ENTITY 0
+#endif
+
+// ESP32 builds may use -fno-exceptions; only the Expected path exists there
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+    #define ERRORRESPONSE_HAS_EXCEPTIONS 1
+#else
+    #define ERRORRESPONSE_HAS_EXCEPTIONS 0
+#endif
+
+// dynamic_cast lets std::exception subclasses be matched without a rethrow per entry
+#if defined(__cpp_rtti) || defined(__GXX_RTTI)
+    #define ERRORRESPONSE_HAS_RTTI 1
+#else
+    #define ERRORRESPONSE_HAS_RTTI 0
+#endif
+
+/**
+ * Status and body sent for a failed request
+ */
+struct ErrorResponse {
+    HttpStatus status = HttpStatus::INTERNAL_SERVER_ERROR;
+    StdString body;
+
+#if ERRORRESPONSE_HAS_RESPONSE_ENTITY
+    ResponseEntity<StdString> ToResponseEntity() const {
+        return ResponseEntity<StdString>::Status(status, body);
+    }
+#endif
+};
+
+/**
+ * A response body with an optional {message} placeholder, split once when it is
+ * registered so rendering is two appends and one allocation.
+ * The message is JSON-escaped, since templates are JSON objects.
+ */
+class ErrorBodyTemplate {
+    Private StdString prefix;
+    Private StdString suffix;
+    Private Bool hasMessage = false;
+
+    Public ErrorBodyTemplate() = default;
+
+    Public explicit ErrorBodyTemplate(const char* text) {
+        static const char kPlaceholder[] = "{message}";
+        const char* placeholder = std::strstr(text, kPlaceholder);
+        if (placeholder == nullptr) {
+            prefix = text;
+            return;
+        }
+        hasMessage = true;
+        prefix.assign(text, static_cast<Size>(placeholder - text));
+        suffix = placeholder + sizeof(kPlaceholder) - 1;
+    }
+
+    Public Bool HasMessage() const {
+        return hasMessage;
+    }
+
+    Public StdString Render(const char* message) const {
+        if (!hasMessage) {
+            return prefix;
+        }
+        Size length = std::strlen(message);
+        StdString body;
+        // Escaping rarely grows a message; the extra 16 bytes cover a few quotes
+        body.reserve(prefix.size() + length + suffix.size() + 16);
+        body += prefix;
+        AppendEscaped(message, length, body);
+        body += suffix;
+        return body;
+    }
+
+    Private Static Void AppendEscaped(const char* text, Size length, StdString& out) {
+        static const char kHex[] = "0123456789abcdef";
+        for (Size i = 0; i < length; i++) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out += "\\u00";
+                out += kHex[(c >> 4) & 0xF];
+                out += kHex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+};
+
+// Unique per type without RTTI: the address of a per-type variable
+template<typename T>
+struct ErrorTypeTag {
+    Static constexpr char id = 0;
+};
+
+/**
+ * Message carried by an exception object: what() for std::exception, the text
+ * for const char*, a `message` member for types like CustomException, and
+ * nothing otherwise.
+ */
+template<typename T, typename Enable = void>
+struct ErrorMessageOf {
+    Static const char* Get(const T&) {
+        return "";
+    }
+};
+
+template<typename T>
+struct ErrorMessageOf<T, typename std::enable_if<std::is_base_of<std::exception, T>::value>::type> {
+    Static const char* Get(const T& error) {
+        return error.what();
+    }
+};
+
+template<>
+struct ErrorMessageOf<const char*> {
+    Static const char* Get(const char* const& error) {
+        return error != nullptr ? error : "";
+    }
+};
+
+template<typename T>
+struct ErrorMessageOf<T, typename std::enable_if<
+    std::is_same<decltype(std::declval<const T&>().message.c_str()), const char*>::value &&
+    !std::is_base_of<std::exception, T>::value>::type> {
+    Static const char* Get(const T& error) {
+        return error.message.c_str();
+    }
+};
+
+/**
+ * Maps error types to an HttpStatus and a preformatted body template.
+ *
+ * The same table serves both error paths:
+ * - Respond(error) builds the response for a handler that fails without
+ *   throwing (see Expected.h); no exception machinery is involved.
+ * - Invoke(handler, error) maps whatever a handler throws. std::exception
+ *   subclasses are matched with a dynamic_cast per entry; other types need a
+ *   rethrow per non-std entry, so register the common ones first.
+ *
+ * Entries are checked in registration order, so register subclasses before
+ * their bases. Register at startup, before requests are served.
+ */
+class ExceptionResponseRegistry {
+    Private struct Entry;
+    // Tries the thrown exception against one entry; fills response on a match
+    typedef Bool (*Catcher)(const Entry& entry, ErrorResponse& response);
+#if ERRORRESPONSE_HAS_RTTI
+    typedef const char* (*StdMatcher)(const std::exception& error);
+#endif
+
+    Private struct Entry {
+        const void* tag;
+        HttpStatus status;
+        ErrorBodyTemplate body;
+        Catcher catcher;
+#if ERRORRESPONSE_HAS_RTTI
+        // Set for std::exception subclasses; returns the message on a match
+        StdMatcher stdMatcher;
+#endif
+
+        ErrorResponse Render(const char* message) const {
+            ErrorResponse response;
+            response.status = status;
+            response.body = body.Render(message);
+            return response;
+        }
+    };
+
+    Private StdVector<Entry> entries;
+    Private HttpStatus fallbackStatus = HttpStatus::INTERNAL_SERVER_ERROR;
+    Private ErrorBodyTemplate fallbackBody;
+
+    Public ExceptionResponseRegistry()
+        : fallbackBody("{\"error\":\"Internal Server Error\",\"message\":\"Unknown exception occurred\"}") {}
+
+    /**
+     * @brief Registry with the standard mappings:
+     * std::invalid_argument and std::out_of_range to 400, any other
+     * std::exception to 500 with its message, anything else to 500
+     */
+    Public Static ExceptionResponseRegistry& Default() {
+        static ExceptionResponseRegistry registry = CreateDefault();
+        return registry;
+    }
+
+    /**
+     * @brief Map error type T to a status and body
+     * @param bodyTemplate JSON body; "{message}" is replaced by the error's message
+     */
+    Public template<typename T>
+    Void Register(HttpStatus status, const char* bodyTemplate) {
+        Entry entry;
+        entry.tag = &ErrorTypeTag<T>::id;
+        entry.status = status;
+        entry.body = ErrorBodyTemplate(bodyTemplate);
+        entry.catcher = &CatchAs<T>;
+#if ERRORRESPONSE_HAS_RTTI
+        entry.stdMatcher = StdMatcherFor<T>();
+#endif
+        for (Entry& existing : entries) {
+            if (existing.tag == entry.tag) {
+                existing = entry;
+                return;
+            }
+        }
+        entries.push_back(entry);
+    }
+
+    // Response for error types that match no entry
+    Public Void SetFallback(HttpStatus status, const char* bodyTemplate) {
+        fallbackStatus = status;
+        fallbackBody = ErrorBodyTemplate(bodyTemplate);
+    }
+
+    /**
+     * @brief Response for an error value, without throwing
+     * Matches like Invoke() would if error were thrown.
+     * Without RTTI a std::exception subclass matches its own entry or the
+     * std::exception one, not intermediate bases.
+     */
+    Public template<typename T>
+    ErrorResponse Respond(const T& error) const {
+        const char* message = ErrorMessageOf<T>::Get(error);
+#if ERRORRESPONSE_HAS_RTTI
+        if constexpr (std::is_base_of<std::exception, T>::value) {
+            for (const Entry& entry : entries) {
+                if (entry.stdMatcher != nullptr && entry.stdMatcher(error) != nullptr) {
+                    return entry.Render(message);
+                }
+            }
+            return Fallback(message);
+        }
+#endif
+        for (const Entry& entry : entries) {
+            if (entry.tag == &ErrorTypeTag<T>::id) {
+                return entry.Render(message);
+            }
+        }
+        if (std::is_base_of<std::exception, T>::value) {
+            for (const Entry& entry : entries) {
+                if (entry.tag == &ErrorTypeTag<std::exception>::id) {
+                    return entry.Render(message);
+                }
+            }
+        }
+        return Fallback(message);
+    }
+
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+    /**
+     * @brief Call a handler, mapping anything it throws
+     * The cheapest way to use the registry: std::exception subclasses are caught
+     * directly and never rethrown, and other types are only rethrown when
+     * non-std entries are registered.
+     * @param error Receives the response when the handler throws
+     * @return The handler's result, or empty when it threw
+     */
+    Public template<typename Handler>
+    auto Invoke(Handler&& handler, ErrorResponse& error) const -> optional<decltype(handler())> {
+        try {
+            return handler();
+        } catch (const std::exception& thrown) {
+            error = Translate(thrown);
+        } catch (...) {
+            error = TranslateByRethrow(false);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Response for a caught std::exception; call only from its catch block
+     */
+    Public ErrorResponse Translate(const std::exception& error) const {
+#if ERRORRESPONSE_HAS_RTTI
+        for (const Entry& entry : entries) {
+            if (entry.stdMatcher != nullptr && entry.stdMatcher(error) != nullptr) {
+                return entry.Render(error.what());
+            }
+        }
+        return Fallback(error.what());
+#else
+        (void)error;
+        return TranslateByRethrow(true);
+#endif
+    }
+
+    /**
+     * @brief Response for the exception currently being handled, of any type
+     * Call only from inside a catch block; costs one extra rethrow over Invoke().
+     */
+    Public ErrorResponse TranslateCurrentException() const {
+        try {
+            throw;
+        } catch (const std::exception& error) {
+            return Translate(error);
+        } catch (...) {
+            return TranslateByRethrow(false);
+        }
+    }
+#endif
+
+    Private ErrorResponse Fallback(const char* message) const {
+        ErrorResponse response;
+        response.status = fallbackStatus;
+        response.body = fallbackBody.Render(message);
+        return response;
+    }
+
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+    Private ErrorResponse TranslateByRethrow(Bool includeStd) const {
+        ErrorResponse response;
+        for (const Entry& entry : entries) {
+#if ERRORRESPONSE_HAS_RTTI
+            if (!includeStd && entry.stdMatcher != nullptr) {
+                continue;
+            }
+#else
+            (void)includeStd;
+#endif
+            if (entry.catcher(entry, response)) {
+                return response;
+            }
+        }
+        return Fallback("");
+    }
+#endif
+
+    Private template<typename T>
+    Static Bool CatchAs(const Entry& entry, ErrorResponse& response) {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+        try {
+            throw;
+        } catch (const T& error) {
+            response = entry.Render(ErrorMessageOf<T>::Get(error));
+            return true;
+        } catch (...) {
+            return false;
+        }
+#else
+        (void)entry;
+        (void)response;
+        return false;
+#endif
+    }
+
+#if ERRORRESPONSE_HAS_RTTI
+    Private template<typename T>
+    Static typename std::enable_if<std::is_base_of<std::exception, T>::value, StdMatcher>::type StdMatcherFor() {
+        return [](const std::exception& error) -> const char* {
+            if constexpr (std::is_same<T, std::exception>::value) {
+                return error.what();
+            } else {
+                return dynamic_cast<const T*>(&error) != nullptr ? error.what() : nullptr;
+            }
+        };
+    }
+
+    Private template<typename T>
+    Static typename std::enable_if<!std::is_base_of<std::exception, T>::value, StdMatcher>::type StdMatcherFor() {
+        return nullptr;
+    }
+#endif
+
+    Private Static ExceptionResponseRegistry CreateDefault() {
+        ExceptionResponseRegistry registry;
+        registry.Register<std::invalid_argument>(HttpStatus::BAD_REQUEST,
+            "{\"error\":\"Bad Request\",\"message\":\"{message}\"}");
+        registry.Register<std::out_of_range>(HttpStatus::BAD_REQUEST,
+            "{\"error\":\"Bad Request\",\"message\":\"{message}\"}");
+        registry.Register<std::exception>(HttpStatus::INTERNAL_SERVER_ERROR,
+            "{\"error\":\"Internal Server Error\",\"message\":\"{message}\"}");
+        return registry;
+    }
+};
+
+#endif // ERRORRESPONSE_H
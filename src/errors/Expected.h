@@ -0,0 +1,64 @@
+#ifndef EXPECTED_H
+#define EXPECTED_H
+
+#include <StandardDefines.h>
+#include <utility>
+#include "ErrorResponse.h"
+
+/**
+ * A value or the error response to send instead, for handlers that fail
+ * without throwing (and the only error path under -fno-exceptions):
+ *
+ *     Expected<SwitchResponseDto> result = LoadSwitch(id);
+ *     if (!result.HasValue()) {
+ *         return result.Error().ToResponseEntity();
+ *     }
+ *
+ * Errors are built with Unexpected(), which maps them through
+ * ExceptionResponseRegistry exactly as if they had been thrown.
+ */
+template<typename T>
+class Expected {
+    Private optional<T> value;
+    Private ErrorResponse error;
+
+    Public Expected(const T& result) : value(result) {}
+
+    Public Expected(T&& result) : value(std::move(result)) {}
+
+    Public Expected(ErrorResponse failure) : error(std::move(failure)) {}
+
+    Public Bool HasValue() const {
+        return value.has_value();
+    }
+
+    Public explicit operator bool() const {
+        return value.has_value();
+    }
+
+    // Only valid when HasValue()
+    Public const T& Value() const {
+        return *value;
+    }
+
+    Public T& Value() {
+        return *value;
+    }
+
+    // Only meaningful when !HasValue()
+    Public const ErrorResponse& Error() const {
+        return error;
+    }
+};
+
+/**
+ * @brief Error response for an error value, as the registry maps it when thrown
+ * @param error e.g. std::invalid_argument("id must be positive")
+ */
+template<typename E>
+inline ErrorResponse Unexpected(const E& error,
+                                const ExceptionResponseRegistry& registry = ExceptionResponseRegistry::Default()) {
+    return registry.Respond(error);
+}
+
+#endif // EXPECTED_H
@@ -0,0 +1,107 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "storage/HashedFileManager.h"
+#include "storage/MemoryFileManager.h"
+
+// Hash benchmark: file name hashing and the key directory.
+//
+//   Hash       StableHash (XXH64) against std::hash, which the framework
+//              truncates to 32 bits for file names, and FNV-1a, which
+//              DirectoryFileManager shards by; keys of 16, 64 and 1024 bytes
+//   Directory  HashedFileManager::Find over --keys names (default 100000),
+//              and Create + Delete of a new name, in a MemoryFileManager
+//
+// The bytes column is the key length, so throughput is bytes per ns.
+
+namespace {
+
+uint32_t Fnv1a(std::string_view data) {
+    uint32_t hash = 2166136261u;
+    for (char c : data) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// Keeps the compiler from dropping a hash that is never used
+volatile uint64_t sink = 0;
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Int keyCount = 100000;
+
+    BenchCommandLine commandLine;
+    commandLine.Flag("--keys", "Names in the key directory (default 100000)", keyCount, 1);
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("hash_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    StdVector<BenchResult> results;
+    for (Size length : {Size(16), Size(64), Size(1024)}) {
+        StdString key(length, 'k');
+        for (Size i = 0; i < length; i++) {
+            key[i] = static_cast<char>('a' + (i * 7) % 26);
+        }
+        const StdString suffix = ", " + std::to_string(length) + " B";
+        results.push_back(report.Measure("Hash", "StableHash (XXH64)" + suffix, 1, length, [&]() {
+            sink = sink + StableHash::Of(key);
+        }));
+        results.push_back(report.Measure("Hash", "std::hash" + suffix, 1, length, [&]() {
+            sink = sink + std::hash<StdString>()(key);
+        }));
+        results.push_back(report.Measure("Hash", "FNV-1a 32" + suffix, 1, length, [&]() {
+            sink = sink + Fnv1a(key);
+        }));
+    }
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    HashedFileManager hashed(files);
+    const Size count = static_cast<Size>(keyCount);
+    for (Size i = 0; i < count; i++) {
+        hashed.Create("Product_id_" + std::to_string(i), "x");
+    }
+    const StdString name = std::to_string(count) + " names";
+    Size failures = 0;
+    results.push_back(report.Measure("Directory", "Find, " + name, 1, 0, [&, step = Size(0)]() mutable {
+        StdString file;
+        failures += hashed.Find("Product_id_" + std::to_string((step++ * 7919) % count), file) ? 0 : 1;
+    }));
+    results.push_back(report.Measure("Directory", "Create+Delete, " + name, 1, 1, [&, step = count]() mutable {
+        StdString file = "Product_id_" + std::to_string(step++);
+        failures += hashed.Create(file, "x") && hashed.Delete(file) ? 0 : 1;
+    }));
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " key directory operations failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
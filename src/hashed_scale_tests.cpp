@@ -0,0 +1,13 @@
+#ifndef ARDUINO
+#include "tests/EntityRepositoryTests.h"
+
+// Stores a million keys through a HashedFileManager and reads each back,
+// the scale the key directory and its 64-bit hashes are meant for. Too slow
+// for RunAllTestSuites, which stores HASHED_SCALE_TEST_KEYS; ctest runs it.
+static const Size kHashedScaleKeys = 1000000;
+
+int main() {
+    return TestHashedFileManagerScale(kHashedScaleKeys) ? 0 : 1;
+}
+
+#endif // ARDUINO
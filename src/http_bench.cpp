@@ -0,0 +1,302 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "controller/SwitchDto.h"
+#include "metrics/RouteMetrics.h"
+#include "repository_tests/Order.h"
+#include "router/StaticRouteTable.h"
+#include "serializer/StreamingDeserializer.h"
+#include "server/HttpMessage.h"
+#include "server/HttpResponseWriter.h"
+#include "server/RequestArena.h"
+
+#if STATICROUTE_HAS_GENERATED_TABLE && __has_include(<GeneratedRouteAdapters.h>)
+#include <GeneratedRouteAdapters.h>
+#define HTTP_BENCH_HAS_ADAPTERS 1
+#else
+#define HTTP_BENCH_HAS_ADAPTERS 0
+#endif
+
+// HTTP request benchmark: what the server does with a request before the
+// handler's own work, per request, on a connection in steady state. "copying"
+// is the parser the servers used before RequestArena: method, target, every
+// header and the body copied into strings and header names lower-cased.
+// "arena views" reads the same bytes into a reused RequestArena and parses
+// them into views. The request-path group adds routing, path variables and
+// metrics for PUT /switch/{id}/on; the body group deserializes a
+// @RequestBody from a copied string and from the body view.
+//
+// The response groups send what ResponseEntityController returns for each
+// /response-entity/* endpoint over a socket pair. "format + send" is the
+// previous write path: the handler returns a response, AppendHttpResponse
+// copies status line, headers and body into the connection's output string
+// and send() writes it. "writer" fills the body in the connection's
+// HttpResponseWriter and sends constant header fragments and the body with
+// one writev. Syscalls and bytes copied in user space per response are
+// printed after the table.
+
+// A PUT /switch/1/on as curl sends it
+static const char kSwitchOnRequest[] =
+    "PUT /switch/1/on HTTP/1.1\r\n"
+    "Host: 192.168.1.50:8080\r\n"
+    "User-Agent: curl/8.5.0\r\n"
+    "Accept: */*\r\n"
+    "\r\n";
+
+static const char kSwitchBodyRequest[] =
+    "PUT /switch HTTP/1.1\r\n"
+    "Host: 192.168.1.50:8080\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 27\r\n"
+    "\r\n"
+    "{\"id\":1,\"switchState\":\"On\"}";
+
+// Status and body of each ResponseEntityController endpoint
+struct ResponseEntityCase {
+    const char* endpoint;
+    Int status;
+    Void (*writeBody)(StdString& out);
+};
+
+static const StdString kCreatedMessage = "Created successfully";
+
+const ResponseEntityCase kResponseEntityCases[] = {
+    {"/string", 201, [](StdString& out) { JsonPullParser::AppendQuoted(kCreatedMessage, out); }},
+    {"/int", 202, [](StdString& out) { NumberFormat::AppendInt(42, out); }},
+    {"/order", 203, [](StdString& out) {
+         Order order;
+         order.id = 1;
+         order.orderNumber = StdString("ORD-12345");
+         order.customerId = 100;
+         order.totalAmount = 99.99;
+         out = nayan::serializer::SerializationUtility::Serialize(order);
+     }},
+    {"/void", 404, [](StdString&) {}},
+};
+
+// Reads one response's bytes back so the socket buffer never fills
+Void BenchReceive(Int fd, Size size) {
+    char buffer[4096];
+    Size received = 0;
+    while (received < size) {
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            return;
+        }
+        received += static_cast<Size>(count);
+    }
+}
+
+// The request as the copying parser produced it
+struct CopiedRequest {
+    StdString method;
+    StdString target;
+    StdVector<std::pair<StdString, StdString>> headers;
+    StdString body;
+};
+
+// The previous parser, reduced to what it copied; the input is well formed
+Void ParseByCopying(const char* data, Size size, CopiedRequest& out) {
+    std::string_view buffer(data, size);
+    Size headerEnd = buffer.find("\r\n\r\n");
+    std::string_view head = buffer.substr(0, headerEnd);
+    Size lineEnd = head.find("\r\n");
+    std::string_view requestLine = head.substr(0, lineEnd);
+    Size firstSpace = requestLine.find(' ');
+    Size secondSpace = requestLine.find(' ', firstSpace + 1);
+    out.method.assign(requestLine.data(), firstSpace);
+    out.target.assign(requestLine.data() + firstSpace + 1, secondSpace - firstSpace - 1);
+
+    out.headers.clear();
+    Size contentLength = 0;
+    while (lineEnd != std::string_view::npos) {
+        Size start = lineEnd + 2;
+        lineEnd = head.find("\r\n", start);
+        std::string_view line = head.substr(start, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - start);
+        Size colon = line.find(':');
+        StdString name(line.substr(0, colon));
+        for (char& c : name) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        std::string_view value = line.substr(colon + 2);
+        if (name == "content-length") {
+            uint64_t length = 0;
+            NumberFormat::ParseUInt(value.data(), value.data() + value.size(), length);
+            contentLength = static_cast<Size>(length);
+        }
+        out.headers.emplace_back(std::move(name), StdString(value));
+    }
+    out.body.assign(data + headerEnd + 4, contentLength);
+}
+
+// What a connection holds between requests
+struct BenchConnection {
+    RequestArena input;
+    HttpServerRequest request;
+
+    // As the servers do it: receive into the arena, parse in place
+    const HttpServerRequest& Receive(const char* raw, Size size) {
+        std::memcpy(input.Reserve(size), raw, size);
+        input.Commit(size);
+        std::string_view pending = input.Pending();
+        Size consumed = 0;
+        HttpRequestParser::Parse(pending.data(), pending.size(), request, consumed);
+        input.Consume(consumed);
+        return request;
+    }
+
+    // After the response is written
+    Void Done() {
+        input.Reset();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    BenchCommandLine commandLine;
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("http_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    const Size requestSize = sizeof(kSwitchOnRequest) - 1;
+    StdVector<BenchResult> results;
+    // The copying server appended each read to a string and parsed into a fresh request
+    results.push_back(report.Measure("parse", "copying", 1, requestSize, [&]() {
+        StdString received(kSwitchOnRequest, requestSize);
+        CopiedRequest copied;
+        ParseByCopying(received.data(), received.size(), copied);
+        BenchKeep(copied);
+    }));
+    BenchConnection connection;
+    results.push_back(report.Measure("parse", "arena views", 1, requestSize, [&]() {
+        BenchKeep(connection.Receive(kSwitchOnRequest, requestSize).target.size());
+        connection.Done();
+    }));
+
+#if HTTP_BENCH_HAS_ADAPTERS
+    RouteMetrics metrics;
+    results.push_back(report.Measure("request path", "arena views", 1, requestSize, [&]() {
+        const HttpServerRequest& request = connection.Receive(kSwitchOnRequest, requestSize);
+        StaticRouteMatch match = MatchGeneratedRoute(RouteMethodFromString(request.method), request.Path());
+        RouteRequestTimer timer(metrics, match.Found() ? match.routeId : RouteMetrics::kUnmatchedRoute);
+        SwitchController_TurnOnSwitch_Adapter::PathVariables variables;
+        PathVariableFailure failure;
+        BenchKeep(SwitchController_TurnOnSwitch_Adapter::Parse(match, variables, failure) ? variables.id : -1);
+        timer.SetStatus(200);
+        connection.Done();
+    }));
+#endif
+
+    const Size bodyRequestSize = sizeof(kSwitchBodyRequest) - 1;
+    results.push_back(report.Measure("request body", "copy, then deserialize", 1, bodyRequestSize, [&]() {
+        StdString received(kSwitchBodyRequest, bodyRequestSize);
+        CopiedRequest copied;
+        ParseByCopying(received.data(), received.size(), copied);
+        StringChunkSource source(copied.body, JsonPullParser::kDefaultChunkSize);
+        BenchKeep(StreamingDeserializer::Deserialize<SwitchDto>(source));
+    }));
+    results.push_back(report.Measure("request body", "deserialize from view", 1, bodyRequestSize, [&]() {
+        BenchKeep(StreamingDeserializer::Deserialize<SwitchDto>(connection.Receive(kSwitchBodyRequest, bodyRequestSize).body));
+        connection.Done();
+    }));
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        std::cerr << "socketpair failed" << std::endl;
+        return 1;
+    }
+    struct WriteCost {
+        const char* endpoint;
+        const char* path;
+        double syscalls;
+        double bytesCopied;
+    };
+    StdVector<WriteCost> costs;
+    HttpResponseWriter writer;
+    StdString output;
+    for (const ResponseEntityCase& entity : kResponseEntityCases) {
+        HttpServerResponse sample;
+        sample.status = entity.status;
+        entity.writeBody(sample.body);
+        Size wireBytes = FormatHttpResponse(sample, true).size();
+        Size syscalls = 0;
+        Size bytesCopied = 0;
+        Size responses = 0;
+        auto formatAndSend = [&]() {
+            HttpServerResponse response;
+            response.status = entity.status;
+            entity.writeBody(response.body);
+            output.clear();
+            AppendHttpResponse(response, true, output);
+            bytesCopied += output.size();
+            syscalls++;
+            responses++;
+            BenchKeep(send(sockets[0], output.data(), output.size(), MSG_NOSIGNAL));
+            BenchReceive(sockets[1], output.size());
+        };
+        BenchResult formatted = report.Measure(StdString("response ") + entity.endpoint, "format + send", 1,
+                                               wireBytes, formatAndSend);
+        results.push_back(formatted);
+        costs.push_back({entity.endpoint, "format + send", static_cast<double>(syscalls) / responses,
+                         static_cast<double>(bytesCopied) / responses});
+
+        Size writerSyscalls = writer.GetSyscallCount();
+        Size writerCopied = writer.GetBytesCopied();
+        responses = 0;
+        auto writeVectors = [&]() {
+            HttpServerResponse& response = writer.Next();
+            response.status = entity.status;
+            entity.writeBody(response.body);
+            writer.Commit(true);
+            writer.Write(sockets[0]);
+            responses++;
+            BenchReceive(sockets[1], wireBytes);
+        };
+        results.push_back(report.Measure(StdString("response ") + entity.endpoint, "writer", 1, wireBytes, writeVectors));
+        costs.push_back({entity.endpoint, "writer", static_cast<double>(writer.GetSyscallCount() - writerSyscalls) / responses,
+                         static_cast<double>(writer.GetBytesCopied() - writerCopied) / responses});
+    }
+    close(sockets[0]);
+    close(sockets[1]);
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+        std::printf("\n%-24s %-16s %14s %14s\n", "/response-entity", "path", "syscalls/resp", "copied B/resp");
+        for (const WriteCost& cost : costs) {
+            std::printf("%-24s %-16s %14.2f %14.1f\n", cost.endpoint, cost.path, cost.syscalls, cost.bytesCopied);
+        }
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    // Steady state means no allocation left on the request side
+    for (const BenchResult& result : results) {
+        Bool requestSide = result.group == "parse" || result.group == "request path";
+        if (requestSide && result.name != "copying" && result.allocationsPerOp > 0) {
+            std::cerr << result.group << " allocates " << result.allocationsPerOp << " times per request" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,157 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <GeneratedEntityRepositories.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "bench/BenchUtils.h"
+#include "storage/EntityJournal.h"
+#include "storage/MemoryFileManager.h"
+
+// Transaction benchmark for EntityJournal: --threads threads (default
+// 1,4,16) commit transactions back to back for --seconds, each saving a
+// Product and an Order, both in EntityLogStores, together, once with
+// group commit and once with a write and fsync per commit. The report shows
+// commits/s and how many commits shared each fsync.
+//
+// fsync cost decides the result, so point --dir at the file system the
+// journal would live on; a tmpfs makes fsync free and group commit moot.
+
+struct CommitResult {
+    Size commits = 0;
+    Size failures = 0;
+    Size syncs = 0;
+    double seconds = 0;
+};
+
+CommitResult RunCommits(const StdString& directory, Size threads, Bool group, double seconds) {
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    // Both over logs, which sync, so the journal is checkpointed as it would be in use
+    ProductEntityRepository products(files, std::make_shared<EntityLogStore>(directory + "/Product.log"));
+    OrderEntityRepository orders(files, directory);
+    EntityJournal::Options options;
+    options.groupCommit = group;
+    EntityJournalPtr journal = std::make_shared<EntityJournal>(directory + "/entities.journal", options);
+    products.AttachJournal(journal);
+    orders.AttachJournal(journal);
+    journal->Replay();
+
+    std::atomic<Size> failures{0};
+    std::atomic<Bool> stop{false};
+    StdVector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (Size t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            // Each thread cycles through its own ids, so saves replace earlier ones
+            for (Int i = 0; !stop.load(std::memory_order_relaxed); i = (i + 1) % 1000) {
+                Int id = static_cast<Int>(t) * 1000 + i + 1;
+                Product product;
+                product.id = id;
+                product.name = "Product " + std::to_string(id);
+                product.price = 9.99;
+                product.category = "Bench";
+                Order order;
+                order.id = id;
+                order.orderNumber = "ORD-" + std::to_string(id);
+                order.customerId = static_cast<Int>(t);
+                EntityTransaction transaction = journal->Begin();
+                products.Save(product, transaction);
+                orders.Save(order, transaction);
+                if (!transaction.Commit()) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    CommitResult result;
+    EntityJournal::Stats stats = journal->GetStats();
+    result.commits = stats.commits;
+    result.failures = failures.load();
+    result.syncs = stats.syncs;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+StdVector<Size> ParseList(const StdString& list) {
+    StdVector<Size> values;
+    Size start = 0;
+    while (start <= list.size()) {
+        Size comma = list.find(',', start);
+        if (comma == StdString::npos) {
+            comma = list.size();
+        }
+        Int value = std::atoi(list.substr(start, comma - start).c_str());
+        if (value > 0) {
+            values.push_back(static_cast<Size>(value));
+        }
+        start = comma + 1;
+    }
+    return values;
+}
+
+int main(int argc, char* argv[]) {
+    StdString directory = (std::filesystem::temp_directory_path() / ("journal_bench_" + std::to_string(::getpid()))).string();
+    StdVector<Size> threadCounts = {1, 4, 16};
+    double seconds = 0;
+
+    BenchCommandLine commandLine(false, "Half a second per run");
+    commandLine.Flag("--dir", "<path>", "Directory for the journal and the order log (default: system temp)", [&directory](const char* value) {
+        directory = StdString(value) + "/journal_bench_" + std::to_string(::getpid());
+    });
+    commandLine.Flag("--threads", "1,4,16", "Committing thread counts to compare (default 1,4,16)", [&threadCounts](const char* value) {
+        threadCounts = ParseList(value);
+    });
+    commandLine.Flag("--seconds", "S", "Duration of each run (default 2)", [&seconds](const char* value) {
+        seconds = std::atof(value);
+    });
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+    if (seconds <= 0) {
+        seconds = commandLine.quick ? 0.5 : 2;
+    }
+
+    std::printf("%.1f s per run, journal in %s\n", seconds, directory.c_str());
+    std::printf("\n%-8s %-8s %10s %10s %12s %12s %9s\n", "threads", "commit", "commits", "failures", "commits/s",
+                "per fsync", "speedup");
+    Size failures = 0;
+    for (Size threads : threadCounts) {
+        double singleRate = 0;
+        for (Bool group : {false, true}) {
+            CommitResult result = RunCommits(directory, threads, group, seconds);
+            double rate = result.seconds > 0 ? result.commits / result.seconds : 0;
+            if (!group) {
+                singleRate = rate;
+            }
+            std::printf("%-8zu %-8s %10zu %10zu %12.0f %12.2f %8.2fx\n", threads, group ? "group" : "single",
+                        result.commits, result.failures, rate,
+                        result.syncs > 0 ? static_cast<double>(result.commits) / result.syncs : 0.0,
+                        singleRate > 0 ? rate / singleRate : 0.0);
+            failures += result.failures;
+        }
+    }
+    std::filesystem::remove_all(directory);
+
+    if (failures > 0) {
+        std::cerr << failures << " commits failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,269 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <ArduinoJson.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "bench/HttpLoadGenerator.h"
+#include "http_client/SpecialHttpClient.h"
+#include "server/AppRequestHandler.h"
+#include "server/ThreadedHttpServer.h"
+#include "service/ISwitchService.h"
+
+// Load test for ThreadedHttpServer: --clients threads, each with its own
+// SpecialHttpClient, send PUT /switch/{id}/toggle back to back for --seconds.
+// By default the server runs in-process, once per worker count (1, 2, 4, 8),
+// and the report shows requests/s and the speedup over one worker. With --url
+// the same load goes to an already running server (desktop_server --threads N).
+//
+// The stub relays make a toggle take microseconds, so --handler-delay-us adds
+// a sleep per request standing in for real relay and storage I/O; without it
+// the clients, not the workers, are the bottleneck.
+//
+// --connections 1,100,1000 measures connection handling instead: a raw-socket
+// generator (bench/HttpLoadGenerator.h) holds that many connections open and
+// sends GET /switch/1 on each, first with keep-alive and then with a new
+// connection per request. --pipeline D keeps D requests in flight per
+// connection. --port targets a running server instead of an in-process one.
+
+struct LoadResult {
+    Size requests = 0;
+    Size failures = 0;
+    double seconds = 0;
+};
+
+// Status code from SpecialHttpClient's JSON envelope; 0 when the request failed
+Int ResponseStatus(const StdString& envelope) {
+    JsonDocument doc;
+    if (deserializeJson(doc, envelope.c_str()) != DeserializationError::Ok || !doc["statusCode"].is<int>()) {
+        return 0;
+    }
+    return doc["statusCode"].as<int>();
+}
+
+LoadResult RunLoad(const StdString& baseUrl, Size clients, double seconds) {
+    std::atomic<Size> requests{0};
+    std::atomic<Size> failures{0};
+    std::atomic<Bool> stop{false};
+    StdVector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (Size c = 0; c < clients; c++) {
+        threads.emplace_back([&, c]() {
+            SpecialHttpClient client;
+            // Spread clients over the three switches so per-device locks are exercised
+            StdString url = baseUrl + "/switch/" + std::to_string(c % 3 + 1) + "/toggle";
+            while (!stop.load(std::memory_order_relaxed)) {
+                Int status = ResponseStatus(client.Put(url, ""));
+                requests.fetch_add(1, std::memory_order_relaxed);
+                if (status < 200 || status >= 300) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    LoadResult result;
+    result.requests = requests.load();
+    result.failures = failures.load();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+StdVector<Size> ParseList(const StdString& text) {
+    StdVector<Size> values;
+    Size start = 0;
+    while (start < text.size()) {
+        Size comma = text.find(',', start);
+        if (comma == StdString::npos) {
+            comma = text.size();
+        }
+        Int value = std::atoi(text.substr(start, comma - start).c_str());
+        if (value > 0) {
+            values.push_back(static_cast<Size>(value));
+        }
+        start = comma + 1;
+    }
+    return values;
+}
+
+/**
+ * @brief Keep-alive against connection-per-request at each connection count
+ * @return Number of failed requests
+ */
+Size RunConnectionLoad(uint16_t port, const StdVector<Size>& connectionCounts, Size pipeline, double seconds) {
+    Size limit = RaiseOpenFileLimit();
+    std::printf("\n%-12s %-12s %12s %10s %10s\n", "connections", "mode", "requests/s", "connects", "errors");
+    Size errors = 0;
+    for (Size connections : connectionCounts) {
+        // Client and in-process server each hold one descriptor per connection
+        if (connections * 2 + 32 > limit) {
+            std::printf("%-12zu skipped: open-file limit is %zu\n", connections, limit);
+            continue;
+        }
+        for (Bool reconnect : {false, true}) {
+            HttpLoadOptions options;
+            options.port = port;
+            options.connections = connections;
+            options.pipeline = reconnect ? 1 : pipeline;
+            options.reconnect = reconnect;
+            options.seconds = seconds;
+            options.request = reconnect ? "GET /switch/1 HTTP/1.1\r\nHost: load_test\r\nConnection: close\r\n\r\n"
+                                        : "GET /switch/1 HTTP/1.1\r\nHost: load_test\r\n\r\n";
+            HttpLoadResult result = HttpLoadGenerator(options).Run();
+            std::printf("%-12zu %-12s %12.0f %10zu %10zu\n", connections, reconnect ? "close" : "keep-alive",
+                        result.RequestsPerSecond(), result.connects, result.errors);
+            errors += result.errors;
+        }
+    }
+    return errors;
+}
+
+Void PrintRow(const char* label, const LoadResult& result, double baseline) {
+    double rate = result.seconds > 0 ? result.requests / result.seconds : 0;
+    std::printf("%-10s %10zu %10zu %12.0f %9.2fx\n", label, result.requests, result.failures, rate,
+                baseline > 0 ? rate / baseline : 1.0);
+}
+
+int main(int argc, char* argv[]) {
+    StdString url;
+    Size clients = 8;
+    double seconds = 3;
+    StdVector<Size> workerCounts = {1, 2, 4, 8};
+    Int handlerDelayMicros = 1000;
+    StdVector<Size> connectionCounts;
+    Size pipeline = 1;
+    Int port = 0;
+
+    // Parse arguments
+    for (int i = 1; i < argc; i++) {
+        StdString arg = argv[i];
+        if (arg == "--url" && i + 1 < argc) {
+            url = argv[++i];
+        } else if (arg == "--clients" && i + 1 < argc) {
+            clients = static_cast<Size>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workerCounts = ParseList(argv[++i]);
+        } else if (arg == "--handler-delay-us" && i + 1 < argc) {
+            handlerDelayMicros = std::atoi(argv[++i]);
+        } else if (arg == "--connections" && i + 1 < argc) {
+            connectionCounts = ParseList(argv[++i]);
+        } else if (arg == "--pipeline" && i + 1 < argc) {
+            pipeline = static_cast<Size>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "--quick") {
+            seconds = 1;
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--url <base>] [--clients N] [--seconds S] [--workers 1,2,4,8]"
+                      << " [--handler-delay-us D] [--quick]" << std::endl;
+            std::cout << "       " << argv[0] << " --connections 1,100,1000 [--pipeline D] [--port P] [--seconds S]"
+                      << std::endl;
+            std::cout << "  --url               Load an external server, e.g. http://127.0.0.1:8080" << std::endl;
+            std::cout << "  --clients           Concurrent client threads (default 8)" << std::endl;
+            std::cout << "  --seconds           Duration of each run (default 3)" << std::endl;
+            std::cout << "  --workers           In-process server worker counts to compare (default 1,2,4,8)" << std::endl;
+            std::cout << "  --handler-delay-us  Simulated I/O per request, in-process only (default 1000)" << std::endl;
+            std::cout << "  --connections       Connection counts for the keep-alive test, e.g. 1,100,1000" << std::endl;
+            std::cout << "  --pipeline          Requests in flight per kept-alive connection (default 1)" << std::endl;
+            std::cout << "  --port              Server for the keep-alive test; in-process when omitted" << std::endl;
+            std::cout << "  --quick             One second per run" << std::endl;
+            std::cout << "  --help              Show this help message" << std::endl;
+            return 0;
+        }
+    }
+
+    if (!connectionCounts.empty()) {
+        std::printf("%.1f s per run, pipeline %zu, %u hardware threads\n", seconds, pipeline,
+                    std::thread::hardware_concurrency());
+        if (port > 0) {
+            return RunConnectionLoad(static_cast<uint16_t>(port), connectionCounts, pipeline, seconds) == 0 ? 0 : 1;
+        }
+#if APPREQUESTHANDLER_AVAILABLE
+        AppRequestHandler handler(Implementation<ISwitchService>::type::GetInstance());
+        ThreadedHttpServer server([&](const HttpServerRequest& request) { return handler.Handle(request); },
+                                  std::max(1u, std::thread::hardware_concurrency()));
+        if (!server.Start(0, "127.0.0.1")) {
+            std::cerr << "Could not start the server" << std::endl;
+            return 1;
+        }
+        Size errors = RunConnectionLoad(server.GetPort(), connectionCounts, pipeline, seconds);
+        server.Stop();
+        return errors == 0 ? 0 : 1;
+#else
+        std::cerr << "GeneratedRouteTable.h not generated; use --port to load a running server" << std::endl;
+        return 1;
+#endif
+    }
+
+    std::printf("%zu clients, %.1f s per run, %u hardware threads\n", clients, seconds,
+                std::thread::hardware_concurrency());
+
+    // SpecialHttpClient logs every request to std::cout; keep it quiet during runs
+    std::streambuf* console = std::cout.rdbuf();
+    std::cout.rdbuf(nullptr);
+
+    if (!url.empty()) {
+        // The first request initializes curl globally, which is not thread-safe
+        SpecialHttpClient().Get(url + "/switch");
+        LoadResult result = RunLoad(url, clients, seconds);
+        std::cout.rdbuf(console);
+        std::printf("\n%-10s %10s %10s %12s %10s\n", "server", "requests", "failures", "requests/s", "speedup");
+        PrintRow("external", result, 0);
+        return result.failures == 0 ? 0 : 1;
+    }
+
+#if APPREQUESTHANDLER_AVAILABLE
+    AppRequestHandler handler(Implementation<ISwitchService>::type::GetInstance());
+    StdVector<std::pair<Size, LoadResult>> results;
+    for (Size workers : workerCounts) {
+        ThreadedHttpServer server([&](const HttpServerRequest& request) {
+            if (handlerDelayMicros > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(handlerDelayMicros));
+            }
+            return handler.Handle(request);
+        }, workers);
+        if (!server.Start(0, "127.0.0.1")) {
+            std::cout.rdbuf(console);
+            std::cerr << "Could not start the server" << std::endl;
+            return 1;
+        }
+        StdString base = "http://127.0.0.1:" + std::to_string(server.GetPort());
+        SpecialHttpClient().Get(base + "/switch");
+        results.emplace_back(workers, RunLoad(base, clients, seconds));
+        server.Stop();
+    }
+    std::cout.rdbuf(console);
+
+    std::printf("\n%-10s %10s %10s %12s %10s\n", "workers", "requests", "failures", "requests/s", "speedup");
+    double baseline = 0;
+    Size failures = 0;
+    for (const auto& entry : results) {
+        const LoadResult& result = entry.second;
+        if (baseline == 0 && result.seconds > 0) {
+            baseline = result.requests / result.seconds;
+        }
+        PrintRow(std::to_string(entry.first).c_str(), result, baseline);
+        failures += result.failures;
+    }
+    return failures == 0 ? 0 : 1;
+#else
+    std::cout.rdbuf(console);
+    std::cerr << "GeneratedRouteTable.h not generated; use --url to load an external server" << std::endl;
+    return 1;
+#endif
+}
+
+#endif // ARDUINO
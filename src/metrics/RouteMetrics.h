@@ -0,0 +1,523 @@
+#ifndef ROUTEMETRICS_H
+#define ROUTEMETRICS_H
+
+#include <StandardDefines.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../router/StaticRouteTable.h"
+#include "../serializer/NumberFormat.h"
+
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #if defined(ESP32)
+        #include <esp_timer.h>
+    #endif
+#else
+    #include <chrono>
+#endif
+
+// Routes registered by hand on top of the generated table. Each route costs
+// about 480 bytes (status counts plus the latency histogram); define
+// ROUTEMETRICS_MAX_ROUTES to fix the total instead.
+#ifndef ROUTEMETRICS_SPARE_ROUTES
+    #define ROUTEMETRICS_SPARE_ROUTES 8
+#endif
+
+/**
+ * Counters of one route as read at a point in time; also what DecodeBinary returns
+ */
+struct RouteMetricsSnapshot {
+    StdString method;
+    StdString pattern;
+    uint64_t requests = 0;
+    uint64_t sumNanos = 0;
+    // (status code, count) for every code seen; code 0 collects untracked codes
+    StdVector<std::pair<uint32_t, uint64_t>> statuses;
+    // (histogram bucket index, count) for every non-empty bucket, in index order
+    StdVector<std::pair<uint32_t, uint64_t>> buckets;
+};
+
+/**
+ * Per-route request counts, status-code counts and latency histograms in fixed memory.
+ *
+ * Record() is lock-free and allocation-free: a handful of relaxed atomic
+ * increments, so it can run on every request from any server thread.
+ * Latencies go into a log-linear histogram: 64 ns steps up to 256 ns, then four
+ * linear sub-buckets per power of two, which keeps the relative error under 25%
+ * from 256 ns up to 4.3 s in 100 buckets.
+ *
+ * Route ids come from RegisterRoute(). Global() registers the generated route
+ * table first, so a StaticRouteMatch::routeId is also a metrics route id.
+ */
+class RouteMetrics {
+#if defined(ROUTEMETRICS_MAX_ROUTES)
+    Public Static constexpr Size kMaxRoutes = ROUTEMETRICS_MAX_ROUTES;
+#elif STATICROUTE_HAS_GENERATED_TABLE
+    Public Static constexpr Size kMaxRoutes = kGeneratedRouteCount + ROUTEMETRICS_SPARE_ROUTES;
+#else
+    Public Static constexpr Size kMaxRoutes = ROUTEMETRICS_SPARE_ROUTES;
+#endif
+    Public Static constexpr Size kBucketCount = 100;
+    // Codes counted individually; anything else is counted as code 0 ("other")
+    Public Static constexpr uint32_t kTrackedStatusCodes[] = {
+        200, 201, 202, 203, 204, 301, 302, 304, 400, 401, 403, 404, 405, 409, 500, 503
+    };
+    Public Static constexpr Size kStatusSlots = sizeof(kTrackedStatusCodes) / sizeof(kTrackedStatusCodes[0]) + 1;
+    // Route id for requests that matched no route
+    Public Static constexpr Int kUnmatchedRoute = static_cast<Int>(kMaxRoutes);
+
+    Private struct RouteInfo {
+        const char* method;
+        const char* pattern;
+    };
+
+    Private struct RouteCounters {
+        std::atomic<uint32_t> requests;
+        std::atomic<uint64_t> sumNanos;
+        std::atomic<uint32_t> statuses[kStatusSlots];
+        std::atomic<uint32_t> buckets[kBucketCount];
+    };
+
+    Private RouteInfo routes[kMaxRoutes + 1];
+    Private RouteCounters counters[kMaxRoutes + 1];
+    Private Size routeCount = 0;
+
+    Public RouteMetrics() {
+        routes[kMaxRoutes] = {"", "unmatched"};
+        Reset();
+    }
+
+    RouteMetrics(const RouteMetrics&) = delete;
+    RouteMetrics& operator=(const RouteMetrics&) = delete;
+
+    /**
+     * @brief Process-wide instance, with the generated routes (if any) already registered
+     */
+    Public Static RouteMetrics& Global() {
+        static RouteMetrics* metrics = CreateGlobal();
+        return *metrics;
+    }
+
+    /**
+     * @brief Register a route before serving requests (not thread-safe)
+     * @param method HTTP method, e.g. "GET"; must outlive this object
+     * @param pattern Route pattern, e.g. "/switch/{id}"; must outlive this object
+     * @return Route id for Record(), or -1 when all kMaxRoutes slots are taken
+     */
+    Public Int RegisterRoute(const char* method, const char* pattern) {
+        if (routeCount == kMaxRoutes) {
+            return -1;
+        }
+        routes[routeCount] = {method, pattern};
+        return static_cast<Int>(routeCount++);
+    }
+
+    /**
+     * @brief Register every route of the generated table, in GeneratedRouteId order
+     * @return false if the table does not fit or was not generated
+     */
+    Public Bool RegisterGeneratedRoutes() {
+#if STATICROUTE_HAS_GENERATED_TABLE
+        if (routeCount + kGeneratedRouteCount > kMaxRoutes) {
+            return false;
+        }
+        for (const StaticRoute& route : kGeneratedRoutes) {
+            RegisterRoute(RouteMethodName(route.method), route.pattern);
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Public Size GetRouteCount() const {
+        return routeCount;
+    }
+
+    /**
+     * @brief Count one handled request
+     * @param routeId Id from RegisterRoute(); kUnmatchedRoute or any unknown id
+     *        is counted as unmatched
+     * @param status HTTP status code sent
+     * @param nanos Time spent handling the request
+     */
+    Public Void Record(Int routeId, uint32_t status, uint64_t nanos) {
+        RouteCounters& route = counters[routeId >= 0 && static_cast<Size>(routeId) < routeCount
+                                            ? static_cast<Size>(routeId) : kMaxRoutes];
+        route.requests.fetch_add(1, std::memory_order_relaxed);
+        route.sumNanos.fetch_add(nanos, std::memory_order_relaxed);
+        route.statuses[StatusSlot(status)].fetch_add(1, std::memory_order_relaxed);
+        route.buckets[BucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Zero every counter; registered routes are kept
+    Public Void Reset() {
+        for (RouteCounters& route : counters) {
+            route.requests.store(0, std::memory_order_relaxed);
+            route.sumNanos.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint32_t>& count : route.statuses) {
+                count.store(0, std::memory_order_relaxed);
+            }
+            for (std::atomic<uint32_t>& count : route.buckets) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Histogram bucket of a latency
+     * Below 256 ns buckets are 64 ns wide; above, each power of two is split into
+     * four equal buckets. Latencies of 4.3 s or more land in the last bucket.
+     */
+    Public Static Size BucketIndex(uint64_t nanos) {
+        uint32_t units = static_cast<uint32_t>((nanos > 0xFFFFFFFFull ? 0xFFFFFFFFull : nanos) >> 6);
+        if (units < 4) {
+            return units;
+        }
+        Size exponent = HighestBit(units);
+        return (exponent - 1) * 4 + ((units >> (exponent - 2)) & 3);
+    }
+
+    /**
+     * @brief Exclusive upper bound of a bucket, in nanoseconds
+     */
+    Public Static uint64_t BucketUpperNanos(Size index) {
+        if (index < 4) {
+            return static_cast<uint64_t>(index + 1) << 6;
+        }
+        Size exponent = index / 4 + 1;
+        return static_cast<uint64_t>(5 + index % 4) << (exponent - 2) << 6;
+    }
+
+    // Monotonic time in nanoseconds, for measuring a request
+    Public Static uint64_t NowNanos() {
+#ifdef ARDUINO
+    #if defined(ESP32)
+        return static_cast<uint64_t>(esp_timer_get_time()) * 1000;
+    #else
+        return static_cast<uint64_t>(micros()) * 1000;
+    #endif
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Counters of every route that has served a request, unmatched last
+     */
+    Public StdVector<RouteMetricsSnapshot> Snapshot() const {
+        StdVector<RouteMetricsSnapshot> snapshots;
+        for (Size i = 0; i <= kMaxRoutes; i++) {
+            if (i == routeCount) {
+                i = kMaxRoutes;
+            }
+            const RouteCounters& route = counters[i];
+            uint32_t requests = route.requests.load(std::memory_order_relaxed);
+            if (requests == 0) {
+                continue;
+            }
+            RouteMetricsSnapshot snapshot;
+            snapshot.method = routes[i].method;
+            snapshot.pattern = routes[i].pattern;
+            snapshot.requests = requests;
+            snapshot.sumNanos = route.sumNanos.load(std::memory_order_relaxed);
+            for (Size slot = 0; slot < kStatusSlots; slot++) {
+                uint32_t count = route.statuses[slot].load(std::memory_order_relaxed);
+                if (count != 0) {
+                    snapshot.statuses.push_back({slot + 1 < kStatusSlots ? kTrackedStatusCodes[slot] : 0, count});
+                }
+            }
+            for (Size bucket = 0; bucket < kBucketCount; bucket++) {
+                uint32_t count = route.buckets[bucket].load(std::memory_order_relaxed);
+                if (count != 0) {
+                    snapshot.buckets.push_back({static_cast<uint32_t>(bucket), count});
+                }
+            }
+            snapshots.push_back(std::move(snapshot));
+        }
+        return snapshots;
+    }
+
+    /**
+     * @brief Prometheus text exposition format (version 0.0.4)
+     * http_requests_total{method,route,code} and the
+     * http_request_duration_seconds{method,route} histogram. Only non-empty
+     * buckets get an le line; cumulative counts make the others redundant.
+     */
+    Public StdString WritePrometheus() const {
+        StdVector<RouteMetricsSnapshot> snapshots = Snapshot();
+        StdString out;
+        out.reserve(256 + snapshots.size() * 512);
+        out += "# HELP http_requests_total Requests handled, by route and status code.\n";
+        out += "# TYPE http_requests_total counter\n";
+        for (const RouteMetricsSnapshot& route : snapshots) {
+            for (const std::pair<uint32_t, uint64_t>& status : route.statuses) {
+                out += "http_requests_total";
+                AppendLabels(route, out);
+                out.pop_back();
+                out += ",code=\"";
+                if (status.first == 0) {
+                    out += "other";
+                } else {
+                    NumberFormat::AppendUInt(status.first, out);
+                }
+                out += "\"} ";
+                NumberFormat::AppendUInt(status.second, out);
+                out += '\n';
+            }
+        }
+        out += "# HELP http_request_duration_seconds Time spent handling a request.\n";
+        out += "# TYPE http_request_duration_seconds histogram\n";
+        for (const RouteMetricsSnapshot& route : snapshots) {
+            uint64_t cumulative = 0;
+            for (const std::pair<uint32_t, uint64_t>& bucket : route.buckets) {
+                cumulative += bucket.second;
+                if (bucket.first + 1 == kBucketCount) {
+                    break;
+                }
+                out += "http_request_duration_seconds_bucket";
+                AppendLabels(route, out);
+                out.pop_back();
+                out += ",le=\"";
+                NumberFormat::AppendDouble(static_cast<double>(BucketUpperNanos(bucket.first)) / 1e9, out);
+                out += "\"} ";
+                NumberFormat::AppendUInt(cumulative, out);
+                out += '\n';
+            }
+            out += "http_request_duration_seconds_bucket";
+            AppendLabels(route, out);
+            out.pop_back();
+            out += ",le=\"+Inf\"} ";
+            NumberFormat::AppendUInt(route.requests, out);
+            out += "\nhttp_request_duration_seconds_sum";
+            AppendLabels(route, out);
+            out += ' ';
+            NumberFormat::AppendDouble(static_cast<double>(route.sumNanos) / 1e9, out);
+            out += "\nhttp_request_duration_seconds_count";
+            AppendLabels(route, out);
+            out += ' ';
+            NumberFormat::AppendUInt(route.requests, out);
+            out += '\n';
+        }
+        return out;
+    }
+
+    /**
+     * @brief Compact binary form of Snapshot(), for clients that poll often
+     * "RM", version byte 1, then a varint route count and per route:
+     * method, pattern (varint length + bytes), requests, sumNanos,
+     * status count + (code, count) pairs, bucket count + (index delta, count)
+     * pairs. Every number is an unsigned LEB128 varint.
+     */
+    Public StdString WriteBinary() const {
+        StdVector<RouteMetricsSnapshot> snapshots = Snapshot();
+        StdString out = "RM";
+        out += static_cast<char>(1);
+        AppendVarint(snapshots.size(), out);
+        for (const RouteMetricsSnapshot& route : snapshots) {
+            AppendVarint(route.method.size(), out);
+            out += route.method;
+            AppendVarint(route.pattern.size(), out);
+            out += route.pattern;
+            AppendVarint(route.requests, out);
+            AppendVarint(route.sumNanos, out);
+            AppendVarint(route.statuses.size(), out);
+            for (const std::pair<uint32_t, uint64_t>& status : route.statuses) {
+                AppendVarint(status.first, out);
+                AppendVarint(status.second, out);
+            }
+            AppendVarint(route.buckets.size(), out);
+            uint32_t previous = 0;
+            for (const std::pair<uint32_t, uint64_t>& bucket : route.buckets) {
+                AppendVarint(bucket.first - previous, out);
+                AppendVarint(bucket.second, out);
+                previous = bucket.first;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Parse the output of WriteBinary()
+     * @return false if the data is truncated or not version 1
+     */
+    Public Static Bool DecodeBinary(CStdString& data, StdVector<RouteMetricsSnapshot>& out) {
+        out.clear();
+        if (data.size() < 3 || data.compare(0, 2, "RM") != 0 || data[2] != 1) {
+            return false;
+        }
+        Size pos = 3;
+        uint64_t routes = 0;
+        if (!ReadVarint(data, pos, routes)) {
+            return false;
+        }
+        for (uint64_t r = 0; r < routes; r++) {
+            RouteMetricsSnapshot route;
+            uint64_t entries = 0;
+            if (!ReadString(data, pos, route.method) || !ReadString(data, pos, route.pattern) ||
+                !ReadVarint(data, pos, route.requests) || !ReadVarint(data, pos, route.sumNanos) ||
+                !ReadVarint(data, pos, entries)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < entries; i++) {
+                uint64_t code = 0;
+                uint64_t count = 0;
+                if (!ReadVarint(data, pos, code) || !ReadVarint(data, pos, count)) {
+                    return false;
+                }
+                route.statuses.push_back({static_cast<uint32_t>(code), count});
+            }
+            if (!ReadVarint(data, pos, entries)) {
+                return false;
+            }
+            uint64_t index = 0;
+            for (uint64_t i = 0; i < entries; i++) {
+                uint64_t delta = 0;
+                uint64_t count = 0;
+                if (!ReadVarint(data, pos, delta) || !ReadVarint(data, pos, count)) {
+                    return false;
+                }
+                index += delta;
+                route.buckets.push_back({static_cast<uint32_t>(index), count});
+            }
+            out.push_back(std::move(route));
+        }
+        return pos == data.size();
+    }
+
+    Public Static const char* RouteMethodName(RouteMethod method) {
+        switch (method) {
+            case RouteMethod::Get: return "GET";
+            case RouteMethod::Post: return "POST";
+            case RouteMethod::Put: return "PUT";
+            case RouteMethod::Delete: return "DELETE";
+            case RouteMethod::Patch: return "PATCH";
+            case RouteMethod::Unknown: break;
+        }
+        return "";
+    }
+
+    Private Static RouteMetrics* CreateGlobal() {
+        // Never destroyed, so requests finishing during shutdown can still record
+        RouteMetrics* metrics = new RouteMetrics();
+        metrics->RegisterGeneratedRoutes();
+        return metrics;
+    }
+
+    Private Static Size StatusSlot(uint32_t status) {
+        for (Size slot = 0; slot + 1 < kStatusSlots; slot++) {
+            if (kTrackedStatusCodes[slot] == status) {
+                return slot;
+            }
+        }
+        return kStatusSlots - 1;
+    }
+
+    // Index of the highest set bit; value must be non-zero
+    Private Static Size HighestBit(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<Size>(31 - __builtin_clz(value));
+#else
+        Size bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    // {method="GET",route="/switch/{id}"}
+    Private Static Void AppendLabels(const RouteMetricsSnapshot& route, StdString& out) {
+        out += "{method=\"";
+        AppendLabelValue(route.method, out);
+        out += "\",route=\"";
+        AppendLabelValue(route.pattern, out);
+        out += "\"}";
+    }
+
+    Private Static Void AppendLabelValue(CStdString& value, StdString& out) {
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    Private Static Void AppendVarint(uint64_t value, StdString& out) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    Private Static Bool ReadVarint(CStdString& data, Size& pos, uint64_t& value) {
+        value = 0;
+        for (Size shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Private Static Bool ReadString(CStdString& data, Size& pos, StdString& value) {
+        uint64_t length = 0;
+        if (!ReadVarint(data, pos, length) || length > data.size() - pos) {
+            return false;
+        }
+        value.assign(data, pos, static_cast<Size>(length));
+        pos += static_cast<Size>(length);
+        return true;
+    }
+};
+
+/**
+ * Times one request and records it when it goes out of scope.
+ * Start it before routing so matching is timed too. The status defaults to 500,
+ * so a handler that throws is counted as failed:
+ *
+ *     RouteRequestTimer timer(RouteMetrics::Global(), RouteMetrics::kUnmatchedRoute);
+ *     StaticRouteMatch match = MatchGeneratedRoute(method, path);
+ *     timer.SetRoute(match.routeId);
+ *     ...
+ *     timer.SetStatus(200);
+ */
+class RouteRequestTimer {
+    Private RouteMetrics& metrics;
+    Private Int routeId;
+    Private uint32_t status = 500;
+    Private uint64_t start;
+
+    Public RouteRequestTimer(RouteMetrics& metrics, Int routeId)
+        : metrics(metrics), routeId(routeId), start(RouteMetrics::NowNanos()) {}
+
+    RouteRequestTimer(const RouteRequestTimer&) = delete;
+    RouteRequestTimer& operator=(const RouteRequestTimer&) = delete;
+
+    Public Void SetRoute(Int id) {
+        routeId = id;
+    }
+
+    Public Void SetStatus(uint32_t code) {
+        status = code;
+    }
+
+    Public ~RouteRequestTimer() {
+        metrics.Record(routeId, status, RouteMetrics::NowNanos() - start);
+    }
+};
+
+#endif // ROUTEMETRICS_H
@@ -0,0 +1,15 @@
+#ifndef ARDUINO
+#include "serialization_tests/NumberFormatTests.h"
+
+// Runs the NumberFormat tests against the snprintf/strtod fallback. The
+// target defines NUMBERFORMAT_HAS_FLOAT_CHARCONV=0, which is what toolchains
+// without floating-point std::to_chars / std::from_chars get.
+#if NUMBERFORMAT_HAS_FLOAT_CHARCONV
+    #error "number_format_fallback_tests must be built with NUMBERFORMAT_HAS_FLOAT_CHARCONV=0"
+#endif
+
+int main() {
+    return RunAllNumberFormatTests() == 0 ? 0 : 1;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,151 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <GeneratedEntityRepositories.h>
+#include <IFileManager.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "bench/BenchUtils.h"
+#include "storage/MemoryFileManager.h"
+#include "storage/NvsEntityStore.h"
+#include "storage/NvsSimulator.h"
+
+// NVS wear benchmark: --switches switches (default 40) are saved, then
+// --toggles toggles (default 20000) each save one switch with its state
+// flipped, cycling through them. Every layout runs on a fresh NvsSimulator of
+// the nvs partition in partitions.csv (24 KB, six pages):
+//
+//   files      one key per entity file plus the id list, as the framework's
+//              Preferences file manager stores an EntityFileStore
+//   nvs N      NvsEntityStore with packBytes N; 0 is one blob per record
+//
+// Columns: NVS entries live after the setup, flash bytes programmed per
+// toggle, write amplification (those bytes over the record's), page erases
+// per 1000 toggles, the most erases any page had, and how many toggles the
+// most-erased page lasts at 100000 erase cycles.
+
+namespace {
+
+// Entity files as NVS blobs, names cut to the 15 characters a key holds
+class NvsFileManager : public IFileManager {
+    Private INvsPartitionPtr nvs;
+
+    Public explicit NvsFileManager(INvsPartitionPtr partition) : nvs(partition) {}
+
+    Public Bool Create(CStdString& filename, CStdString& contents) override {
+        return nvs->SetBlob("files", Key(filename), contents);
+    }
+
+    Public StdString Read(CStdString& filename) override {
+        StdString contents;
+        nvs->GetBlob("files", Key(filename), contents);
+        return contents;
+    }
+
+    Public Bool Update(CStdString& filename, CStdString& contents) override {
+        return Create(filename, contents);
+    }
+
+    Public Bool Delete(CStdString& filename) override {
+        return nvs->EraseKey("files", Key(filename));
+    }
+
+    Public Bool Append(CStdString& filename, CStdString& contents) override {
+        return Create(filename, Read(filename) + contents);
+    }
+
+    Private Static StdString Key(CStdString& filename) {
+        return filename.substr(0, INvsPartition::kMaxKeyLength);
+    }
+};
+
+struct WearResult {
+    Size liveEntries = 0;
+    Size bytesProgrammed = 0;
+    Size recordBytes = 0;
+    Size pageErases = 0;
+    Size maxPageErases = 0;
+    Size failures = 0;
+};
+
+WearResult RunToggles(Int packBytes, Size switchCount, Size toggles) {
+    NvsSimulatorPtr nvs = std::make_shared<NvsSimulator>();
+    MemoryFileManagerPtr indexFiles = std::make_shared<MemoryFileManager>();
+    IEntityStorePtr store;
+    if (packBytes < 0) {
+        store = std::make_shared<EntityFileStore>(std::make_shared<NvsFileManager>(nvs), "Switch");
+    } else {
+        NvsEntityStore::Options options;
+        options.packBytes = static_cast<Size>(packBytes);
+        store = std::make_shared<NvsEntityStore>(nvs, "Switch", options);
+    }
+    SwitchEntityRepository switches(indexFiles, store);
+
+    WearResult result;
+    StdVector<Switch> devices;
+    for (Size i = 0; i < switchCount; i++) {
+        devices.emplace_back(static_cast<int>(i + 1), SwitchState::Off);
+    }
+    switches.SaveAll(devices);
+    INvsPartition::Stats before = nvs->GetStats();
+    result.liveEntries = before.usedEntries;
+    for (Size t = 0; t < toggles; t++) {
+        Switch& device = devices[t % switchCount];
+        device.virtualState = device.virtualState.value() == SwitchState::On ? SwitchState::Off : SwitchState::On;
+        switches.Save(device);
+        result.recordBytes += nayan::serializer::SerializationUtility::Serialize(device).size();
+        // Save() does not report a failed write; the record reads back stale then
+        StdString record = store->Read(std::to_string(device.id.value()));
+        if (record.find(device.virtualState.value() == SwitchState::On ? "\"On\"" : "\"Off\"") == StdString::npos) {
+            result.failures++;
+        }
+    }
+    INvsPartition::Stats after = nvs->GetStats();
+    result.bytesProgrammed = after.bytesProgrammed - before.bytesProgrammed;
+    result.pageErases = after.pageErases - before.pageErases;
+    result.maxPageErases = after.maxPageErases;
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Int switches = 40;
+    Int toggleCount = 0;
+    StdVector<Int> layouts = {-1, 0, 128, 256, 512, 1024};
+
+    BenchCommandLine commandLine(false, "2000 toggles per layout");
+    commandLine.Flag("--switches", "Switches saved before toggling (default 40)", switches, 1);
+    commandLine.Flag("--toggles", "Toggles per layout (default 20000)", toggleCount, 1);
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+    const Size switchCount = static_cast<Size>(switches);
+    const Size toggles = toggleCount > 0 ? static_cast<Size>(toggleCount) : commandLine.quick ? 2000 : 20000;
+
+    std::printf("%zu switches, %zu toggles, %u-byte nvs partition\n", switchCount, toggles, NVSSIMULATOR_PARTITION_BYTES);
+    std::printf("\n%-10s %8s %14s %10s %14s %10s %16s %9s\n", "layout", "entries", "bytes/toggle", "write amp",
+                "erases/1000", "max page", "toggles to 100k", "failures");
+    Size failures = 0;
+    for (Int layout : layouts) {
+        WearResult result = RunToggles(layout, switchCount, toggles);
+        StdString name = layout < 0 ? "files" : "nvs " + std::to_string(layout);
+        double perToggle = static_cast<double>(result.bytesProgrammed) / toggles;
+        double amplification = result.recordBytes > 0 ? static_cast<double>(result.bytesProgrammed) / result.recordBytes : 0;
+        double erasesPerThousand = 1000.0 * result.pageErases / toggles;
+        double lifetime = result.maxPageErases > 0 ? 100000.0 * toggles / result.maxPageErases : 0;
+        std::printf("%-10s %8zu %14.1f %9.1fx %14.2f %10zu %16.3g %9zu\n", name.c_str(), result.liveEntries, perToggle,
+                    amplification, erasesPerThousand, result.maxPageErases, lifetime, result.failures);
+        failures += result.failures;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " toggles were not stored" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
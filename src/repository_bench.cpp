@@ -0,0 +1,134 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <GeneratedEntityRepositories.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "storage/MemoryFileManager.h"
+
+// Repository benchmark: ProductRepository::FindByCategory over --products
+// products (default 10000) spread over --categories categories (default 20).
+//
+// "full scan" is the derived query as it was, reading and deserializing every
+// record to compare its category; "index" goes through the category index.
+// Files live in a MemoryFileManager, so the times are parsing and lookup
+// alone; the bytes column is what the query reads, which on a disk or in NVS
+// is also what it waits for.
+//
+// FindById repeats lookups without a cache, with an LRU cache over the 100
+// most used ids and over all of them (mostly misses), and with the whole
+// table pinned.
+
+// Exposes the scan the generated repository no longer uses for FindByCategory
+class ScanningProductRepository : public ProductEntityRepository {
+    Public explicit ScanningProductRepository(IFileManagerPtr fileManager) : ProductEntityRepository(fileManager) {}
+
+    Public StdVector<Product> ScanByCategory(CStdString& category) {
+        return FindWhere([&](const Product& product) {
+            return product.category == category;
+        });
+    }
+};
+
+int main(int argc, char* argv[]) {
+    Int productCount = 10000;
+    Int categoryCount = 20;
+
+    BenchCommandLine commandLine;
+    commandLine.Flag("--products", "Products stored (default 10000)", productCount, 1);
+    commandLine.Flag("--categories", "Categories they are spread over (default 20)", categoryCount, 1);
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("repository_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    ScanningProductRepository products(files);
+    for (Int id = 1; id <= productCount; id++) {
+        Product product;
+        product.id = id;
+        product.name = "Product " + std::to_string(id);
+        product.price = 0.25 * id;
+        product.category = "Category " + std::to_string(id % categoryCount);
+        products.Save(product);
+    }
+    const StdString category = "Category 1";
+    const Size indexFileBytes = files->Peek("Product_idx_category").size();
+
+    // Matches and bytes read by one query of each kind
+    files->ResetCounters();
+    const Size matches = products.ScanByCategory(category).size();
+    const Size scanBytes = files->GetCounters().bytesRead;
+    files->ResetCounters();
+    Size failures = products.FindByCategory(category).size() == matches ? 0 : 1;
+    const Size indexBytes = files->GetCounters().bytesRead;
+
+    StdVector<BenchResult> results;
+    results.push_back(report.Measure("FindByCategory", "full scan", matches, scanBytes, [&]() {
+        failures += products.ScanByCategory(category).size() == matches ? 0 : 1;
+    }));
+    results.push_back(report.Measure("FindByCategory", "index", matches, indexBytes, [&]() {
+        failures += products.FindByCategory(category).size() == matches ? 0 : 1;
+    }));
+    // A fresh repository loads Product_IDs and the index file before its first query
+    results.push_back(report.Measure("FindByCategory", "index, first query after open", matches, indexBytes, [&]() {
+        ProductEntityRepository reopened(files);
+        failures += reopened.FindByCategory(category).size() == matches ? 0 : 1;
+    }));
+    results.push_back(report.Measure("Save", "update, category changed", 1, 0, [&, id = 0]() mutable {
+        Product product;
+        product.id = 1 + id % productCount;
+        product.name = "Product";
+        product.category = "Category " + std::to_string(id++ % categoryCount);
+        products.Update(product);
+    }));
+
+    // Repeated FindById: hot ids are the first 100, uniform ids cover every product
+    auto findById = [&](CStdString& name, Int range) {
+        Size step = 0;
+        Int hot = std::min(range, productCount);
+        products.FindById(1);
+        results.push_back(report.Measure("FindById", name, 1, 0, [&]() {
+            failures += products.FindById(static_cast<Int>(1 + (step++ * 7919) % hot)).has_value() ? 0 : 1;
+        }));
+    };
+    findById("no cache", 100);
+    products.ConfigureCache(EntityCacheOptions::Lru(1024));
+    findById("LRU 1024, 100 hot ids", 100);
+    products.ResetCacheCounters();
+    findById("LRU 1024, uniform ids", productCount);
+    EntityCache<Product>::Counters uniform = products.GetCacheCounters();
+    products.ConfigureCache(EntityCacheOptions::Pinned());
+    findById("pinned, uniform ids", productCount);
+    products.ConfigureCache(EntityCacheOptions::Off());
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+        std::printf("\n%d products, %d categories: index file %zu bytes, a query reads %zu of %d records\n",
+                    productCount, categoryCount, indexFileBytes, matches, productCount);
+        std::printf("LRU 1024 over uniform ids: %zu hits, %zu misses\n", uniform.hits, uniform.misses);
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " queries returned the wrong products" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
@@ -10,12 +10,15 @@ class Customer {
     /* @NotNull */
     Public optional<int> id;
 
+    /* @Indexed */
     Public optional<StdString> email;
 
     Public optional<StdString> firstName;
 
+    /* @Indexed */
     Public optional<StdString> lastName;
 
+    /* @Indexed */
     Public optional<StdString> phone;
 
 };
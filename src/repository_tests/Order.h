@@ -12,6 +12,7 @@ class Order {
 
     Public optional<StdString> orderNumber;
 
+    /* @Indexed */
     Public optional<int> customerId;
 
     Public optional<double> totalAmount;
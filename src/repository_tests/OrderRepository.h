@@ -6,6 +6,7 @@
 #include "Order.h"
 
 /* @Repository */
+/* @Storage("log") */
 DefineStandardPointers(OrderRepository)
 class OrderRepository : public CpaRepository<Order, int> {
     Public Virtual ~OrderRepository() = default;
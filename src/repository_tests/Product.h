@@ -14,6 +14,7 @@ class Product {
 
     Public optional<double> price;
 
+    /* @Indexed */
     Public optional<StdString> category;
 };
 
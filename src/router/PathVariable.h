@@ -0,0 +1,243 @@
+#ifndef PATHVARIABLE_H
+#define PATHVARIABLE_H
+
+#include <StandardDefines.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "../serializer/NumberFormat.h"
+
+// Why a path variable was rejected; anything but None is answered with 400
+enum class PathVariableError : uint8_t {
+    None,
+    Missing,
+    Empty,
+    Malformed,
+    OutOfRange,
+    UnknownValue
+};
+
+inline const char* PathVariableErrorText(PathVariableError error) {
+    switch (error) {
+        case PathVariableError::None: return "ok";
+        case PathVariableError::Missing: return "missing";
+        case PathVariableError::Empty: return "empty";
+        case PathVariableError::Malformed: return "malformed";
+        case PathVariableError::OutOfRange: return "out of range";
+        case PathVariableError::UnknownValue: return "unknown value";
+    }
+    return "invalid";
+}
+
+/**
+ * First path variable that failed to parse
+ */
+struct PathVariableFailure {
+    const char* name = nullptr;
+    PathVariableError error = PathVariableError::None;
+
+    Bool Failed() const {
+        return error != PathVariableError::None;
+    }
+
+    // e.g. "Invalid path variable 'id': malformed"
+    StdString Message() const {
+        StdString message = "Invalid path variable '";
+        message += name != nullptr ? name : "";
+        message += "': ";
+        message += PathVariableErrorText(error);
+        return message;
+    }
+};
+
+/**
+ * Enumerator names accepted for an enum path variable.
+ * Specializations are generated by scripts/generate_route_table.py for every
+ * enum used as a @PathVariable type.
+ */
+template<typename T>
+struct PathVariableEnumNames {
+    Static constexpr Bool available = false;
+};
+
+template<typename T>
+struct PathVariableEnumEntry {
+    const char* name;
+    T value;
+};
+
+/**
+ * Parses one path variable straight from the URL bytes.
+ * The whole segment must be consumed: "12abc" is malformed, not 12.
+ */
+template<typename T, typename Enable = void>
+struct PathVariableParser;
+
+template<typename T>
+struct PathVariableParser<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    Static PathVariableError Parse(std::string_view text, T& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        const char* first = text.data();
+        const char* last = first + text.size();
+        if (std::is_signed<T>::value) {
+            int64_t value = 0;
+            Size consumed = NumberFormat::ParseInt(first, last, value);
+            if (consumed == 0) {
+                return DigitsOnly(text) ? PathVariableError::OutOfRange : PathVariableError::Malformed;
+            }
+            if (consumed != text.size()) {
+                return PathVariableError::Malformed;
+            }
+            if (value < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+                value > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+                return PathVariableError::OutOfRange;
+            }
+            out = static_cast<T>(value);
+        } else {
+            uint64_t value = 0;
+            Size consumed = NumberFormat::ParseUInt(first, last, value);
+            if (consumed == 0) {
+                return DigitsOnly(text) ? PathVariableError::OutOfRange : PathVariableError::Malformed;
+            }
+            if (consumed != text.size()) {
+                return PathVariableError::Malformed;
+            }
+            if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                return PathVariableError::OutOfRange;
+            }
+            out = static_cast<T>(value);
+        }
+        return PathVariableError::None;
+    }
+
+    // A digit string NumberFormat refused can only have overflowed
+    Private Static Bool DigitsOnly(std::string_view text) {
+        Size start = std::is_signed<T>::value && !text.empty() && text[0] == '-' ? 1 : 0;
+        if (start == text.size()) {
+            return false;
+        }
+        for (Size i = start; i < text.size(); i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<>
+struct PathVariableParser<bool> {
+    Static PathVariableError Parse(std::string_view text, bool& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        if (text == "true" || text == "1") {
+            out = true;
+        } else if (text == "false" || text == "0") {
+            out = false;
+        } else {
+            return PathVariableError::Malformed;
+        }
+        return PathVariableError::None;
+    }
+};
+
+template<typename T>
+struct PathVariableParser<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    Static PathVariableError Parse(std::string_view text, T& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        double value = 0;
+        if (NumberFormat::ParseDouble(text.data(), text.data() + text.size(), value) != text.size()) {
+            return PathVariableError::Malformed;
+        }
+        if (!std::isfinite(value) || std::fabs(value) > static_cast<double>(std::numeric_limits<T>::max())) {
+            return PathVariableError::OutOfRange;
+        }
+        out = static_cast<T>(value);
+        return PathVariableError::None;
+    }
+};
+
+// A view into the request path: no copy, valid while the request buffer is
+template<>
+struct PathVariableParser<std::string_view> {
+    Static PathVariableError Parse(std::string_view text, std::string_view& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        out = text;
+        return PathVariableError::None;
+    }
+};
+
+// Owned copy, for handlers that take StdString
+template<>
+struct PathVariableParser<StdString> {
+    Static PathVariableError Parse(std::string_view text, StdString& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        out.assign(text.data(), text.size());
+        return PathVariableError::None;
+    }
+};
+
+template<typename T>
+struct PathVariableParser<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    static_assert(PathVariableEnumNames<T>::available,
+                  "Enum path variable without generated names; is its header under src/?");
+
+    // Enumerator name, matched exactly (the same spelling SerializationUtility writes)
+    Static PathVariableError Parse(std::string_view text, T& out) {
+        if (text.empty()) {
+            return PathVariableError::Empty;
+        }
+        for (const PathVariableEnumEntry<T>& entry : PathVariableEnumNames<T>::entries) {
+            if (text == entry.name) {
+                out = entry.value;
+                return PathVariableError::None;
+            }
+        }
+        return PathVariableError::UnknownValue;
+    }
+};
+
+/**
+ * @brief Parse capture `index` of a route match into out
+ * Works with any match type exposing captureCount and captures[]
+ * (StaticRouteMatch, RadixRouteMatch).
+ * @return false and fills failure when the value is missing or invalid
+ */
+template<typename Match, typename T>
+inline Bool ParsePathVariable(const Match& match, Size index, const char* name, T& out, PathVariableFailure& failure) {
+    PathVariableError error = index < match.captureCount
+        ? PathVariableParser<T>::Parse(match.captures[index], out)
+        : PathVariableError::Missing;
+    if (error != PathVariableError::None) {
+        failure.name = name;
+        failure.error = error;
+        return false;
+    }
+    return true;
+}
+
+#if __has_include(<ResponseEntity.h>)
+#include <ResponseEntity.h>
+#include <HttpStatus.h>
+
+/**
+ * @brief 400 response for a rejected path variable, sent instead of invoking the handler
+ */
+inline ResponseEntity<StdString> PathVariableBadRequest(const PathVariableFailure& failure) {
+    return ResponseEntity<StdString>::Status(HttpStatus::BAD_REQUEST, failure.Message());
+}
+#endif
+
+#endif // PATHVARIABLE_H
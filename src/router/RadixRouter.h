@@ -0,0 +1,374 @@
+#ifndef RADIXROUTER_H
+#define RADIXROUTER_H
+
+#include <StandardDefines.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Most path variables one route may declare; captures live in a fixed array of this size
+#ifndef RADIXROUTER_MAX_CAPTURES
+    #define RADIXROUTER_MAX_CAPTURES 8
+#endif
+
+/**
+ * One registered route
+ */
+struct RadixRoute {
+    StdString pattern;
+    Int handlerId = -1;
+    // Variable names in capture order, e.g. {"userId", "postId"}
+    StdVector<StdString> variableNames;
+};
+
+/**
+ * Result of RadixRouter::Match.
+ * Captures are views into the matched path, so they are valid only as long as
+ * the path buffer is; nothing is allocated or copied while matching.
+ */
+struct RadixRouteMatch {
+    Int handlerId = -1;
+    const RadixRoute* route = nullptr;
+    Size captureCount = 0;
+    std::string_view captures[RADIXROUTER_MAX_CAPTURES];
+
+    Bool Found() const {
+        return route != nullptr;
+    }
+
+    /**
+     * @brief Capture position of a variable of the matched route
+     * @return Index into captures, or -1 when the route has no such variable
+     */
+    Int CaptureIndex(std::string_view name) const {
+        if (route == nullptr) {
+            return -1;
+        }
+        for (Size i = 0; i < route->variableNames.size(); i++) {
+            if (route->variableNames[i] == name) {
+                return static_cast<Int>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Value of a named variable; empty when the route has no such variable
+     * With repeated names the first occurrence wins.
+     */
+    std::string_view Capture(std::string_view name) const {
+        Int index = CaptureIndex(name);
+        return index < 0 ? std::string_view() : captures[index];
+    }
+};
+
+/**
+ * Compressed radix-tree router.
+ *
+ * Patterns use the EndpointTrie syntax: literal segments and whole-segment
+ * variables such as /api/users/{userId}/posts/{postId}. Literal runs shared by
+ * several routes are stored once (character-level prefix compression), and a
+ * variable is an edge that consumes one non-empty path segment.
+ *
+ * Matching follows EndpointTrie: literals take priority over variables (with
+ * backtracking when the literal branch fails deeper down), and a single
+ * trailing slash is ignored after a literal segment ("/xyz/" matches "/xyz")
+ * but not after a variable. Anything from '?' on is ignored.
+ *
+ * Routes are registered at startup. Every Insert recompiles the tree into flat
+ * arrays (one text buffer for all edge labels, one node array, one edge array),
+ * so Match walks contiguous memory and allocates nothing.
+ */
+class RadixRouter {
+    Public RadixRouter() {
+        Clear();
+    }
+
+    /**
+     * @brief Register a route
+     * Registering the same pattern again replaces its handler id.
+     * @param pattern Path pattern, e.g. "/switch/{id}/on"
+     * @param handlerId Non-negative id returned by Match for this route
+     * @return false when the pattern is malformed (not starting with '/', a variable
+     *         that is not a whole segment) or has more than RADIXROUTER_MAX_CAPTURES variables
+     */
+    Public Bool Insert(CStdString& pattern, Int handlerId) {
+        StdVector<PatternPart> parts;
+        StdVector<StdString> names;
+        if (handlerId < 0 || !ParsePattern(pattern, parts, names)) {
+            return false;
+        }
+
+        Size node = 0;
+        for (const PatternPart& part : parts) {
+            node = part.isVariable ? InsertVariable(node) : InsertLiteral(node, part.text);
+        }
+
+        if (tree[node].route >= 0) {
+            RadixRoute& existing = routes[static_cast<Size>(tree[node].route)];
+            existing.pattern = pattern;
+            existing.handlerId = handlerId;
+            existing.variableNames = names;
+        } else {
+            RadixRoute route;
+            route.pattern = pattern;
+            route.handlerId = handlerId;
+            route.variableNames = names;
+            tree[node].route = static_cast<Int>(routes.size());
+            routes.push_back(route);
+        }
+        Compile();
+        return true;
+    }
+
+    /**
+     * @brief Find the route for a request path
+     * @param path Request path, e.g. a view into the request line
+     * @return Match with the handler id and captures; Found() is false when no route matches
+     */
+    Public RadixRouteMatch Match(std::string_view path) const {
+        RadixRouteMatch match;
+        Size query = path.find('?');
+        if (query != std::string_view::npos) {
+            path = path.substr(0, query);
+        }
+        if (path.empty() || compiled.empty()) {
+            return match;
+        }
+        Int route = MatchNode(0, path, match);
+        if (route >= 0) {
+            match.route = &routes[static_cast<Size>(route)];
+            match.handlerId = match.route->handlerId;
+        } else {
+            match.captureCount = 0;
+        }
+        return match;
+    }
+
+    Public const StdVector<RadixRoute>& GetRoutes() const {
+        return routes;
+    }
+
+    Public Size GetNodeCount() const {
+        return compiled.size();
+    }
+
+    Public Bool IsEmpty() const {
+        return routes.empty();
+    }
+
+    Public Void Clear() {
+        routes.clear();
+        tree.clear();
+        tree.push_back(BuildNode());
+        Compile();
+    }
+
+    // ---- Build-time tree, rewritten by Insert ----
+
+    Private struct PatternPart {
+        Bool isVariable = false;
+        StdString text;
+    };
+
+    Private struct BuildNode {
+        StdString label;
+        Bool isVariable = false;
+        StdVector<Size> literalChildren;
+        Int variableChild = -1;
+        Int route = -1;
+    };
+
+    // ---- Compiled form read by Match ----
+
+    Private struct CompiledNode {
+        uint32_t labelOffset;
+        uint16_t labelLength;
+        uint16_t edgeCount;
+        uint32_t edgeOffset;
+        int32_t variableChild;
+        int32_t route;
+        Bool isVariable;
+    };
+
+    // Splits a pattern into literal runs and variables; a variable must be a whole segment
+    Private Static Bool ParsePattern(CStdString& pattern, StdVector<PatternPart>& parts, StdVector<StdString>& names) {
+        if (pattern.empty() || pattern[0] != '/') {
+            return false;
+        }
+        PatternPart literal;
+        Size i = 0;
+        while (i < pattern.size()) {
+            if (pattern[i] != '{') {
+                literal.text.push_back(pattern[i]);
+                i++;
+                continue;
+            }
+            Size close = pattern.find('}', i);
+            if (pattern[i - 1] != '/' || close == StdString::npos || close == i + 1 ||
+                (close + 1 < pattern.size() && pattern[close + 1] != '/')) {
+                return false;
+            }
+            if (names.size() == RADIXROUTER_MAX_CAPTURES) {
+                return false;
+            }
+            parts.push_back(literal);
+            literal.text.clear();
+            PatternPart variable;
+            variable.isVariable = true;
+            parts.push_back(variable);
+            names.push_back(pattern.substr(i + 1, close - i - 1));
+            i = close + 1;
+        }
+        if (!literal.text.empty()) {
+            parts.push_back(literal);
+        }
+        return true;
+    }
+
+    // Walks / extends the literal edges below node by text, splitting an edge where
+    // text diverges from its label; returns the node text ends at
+    Private Size InsertLiteral(Size node, StdString text) {
+        while (!text.empty()) {
+            Int next = -1;
+            for (Size child : tree[node].literalChildren) {
+                if (tree[child].label[0] == text[0]) {
+                    next = static_cast<Int>(child);
+                    break;
+                }
+            }
+            if (next < 0) {
+                BuildNode leaf;
+                leaf.label = text;
+                tree.push_back(leaf);
+                tree[node].literalChildren.push_back(tree.size() - 1);
+                return tree.size() - 1;
+            }
+
+            Size child = static_cast<Size>(next);
+            Size common = 0;
+            CStdString& label = tree[child].label;
+            while (common < label.size() && common < text.size() && label[common] == text[common]) {
+                common++;
+            }
+            if (common < label.size()) {
+                // child keeps the tail of its label under a new node holding the shared head
+                BuildNode head;
+                head.label = label.substr(0, common);
+                head.literalChildren.push_back(child);
+                tree[child].label = tree[child].label.substr(common);
+                tree.push_back(head);
+                Size headIndex = tree.size() - 1;
+                for (Size& slot : tree[node].literalChildren) {
+                    if (slot == child) {
+                        slot = headIndex;
+                    }
+                }
+                child = headIndex;
+            }
+            text = text.substr(common);
+            node = child;
+        }
+        return node;
+    }
+
+    Private Size InsertVariable(Size node) {
+        if (tree[node].variableChild < 0) {
+            BuildNode variable;
+            variable.isVariable = true;
+            tree.push_back(variable);
+            tree[node].variableChild = static_cast<Int>(tree.size() - 1);
+        }
+        return static_cast<Size>(tree[node].variableChild);
+    }
+
+    // Lays the tree out depth-first: labels in one buffer, literal edges of a
+    // node next to each other with their first characters in a parallel string
+    Private Void Compile() {
+        compiled.clear();
+        labels.clear();
+        edges.clear();
+        edgeFirstChars.clear();
+        compiled.resize(tree.size());
+        StdVector<Int> order(tree.size(), -1);
+        Size next = 0;
+        Assign(0, order, next);
+        for (Size i = 0; i < tree.size(); i++) {
+            const BuildNode& source = tree[i];
+            CompiledNode& target = compiled[static_cast<Size>(order[i])];
+            target.labelOffset = static_cast<uint32_t>(labels.size());
+            target.labelLength = static_cast<uint16_t>(source.label.size());
+            labels += source.label;
+            target.edgeOffset = static_cast<uint32_t>(edges.size());
+            target.edgeCount = static_cast<uint16_t>(source.literalChildren.size());
+            for (Size child : source.literalChildren) {
+                edges.push_back(static_cast<uint32_t>(order[child]));
+                edgeFirstChars.push_back(tree[child].label[0]);
+            }
+            target.variableChild = source.variableChild < 0 ? -1 : order[static_cast<Size>(source.variableChild)];
+            target.route = source.route;
+            target.isVariable = source.isVariable;
+        }
+    }
+
+    Private Void Assign(Size node, StdVector<Int>& order, Size& next) const {
+        order[node] = static_cast<Int>(next++);
+        for (Size child : tree[node].literalChildren) {
+            Assign(child, order, next);
+        }
+        if (tree[node].variableChild >= 0) {
+            Assign(static_cast<Size>(tree[node].variableChild), order, next);
+        }
+    }
+
+    // rest is the path left after node's own label / segment; returns the matched route or -1
+    Private Int MatchNode(Size index, std::string_view rest, RadixRouteMatch& match) const {
+        const CompiledNode& node = compiled[index];
+        if (rest.empty()) {
+            return node.route;
+        }
+
+        for (Size i = node.edgeOffset, end = node.edgeOffset + node.edgeCount; i < end; i++) {
+            if (edgeFirstChars[i] != rest[0]) {
+                continue;
+            }
+            const CompiledNode& child = compiled[edges[i]];
+            std::string_view label(labels.data() + child.labelOffset, child.labelLength);
+            if (rest.compare(0, label.size(), label) == 0) {
+                Int route = MatchNode(edges[i], rest.substr(label.size()), match);
+                if (route >= 0) {
+                    return route;
+                }
+            }
+            break;
+        }
+
+        if (node.variableChild >= 0) {
+            Size segmentEnd = rest.find('/');
+            std::string_view segment = rest.substr(0, segmentEnd);
+            if (!segment.empty()) {
+                Size slot = match.captureCount++;
+                match.captures[slot] = segment;
+                Int route = MatchNode(static_cast<Size>(node.variableChild), rest.substr(segment.size()), match);
+                if (route >= 0) {
+                    return route;
+                }
+                match.captureCount = slot;
+            }
+        }
+
+        if (rest.size() == 1 && rest[0] == '/' && !node.isVariable) {
+            return node.route;
+        }
+        return -1;
+    }
+
+    Private StdVector<RadixRoute> routes;
+    Private StdVector<BuildNode> tree;
+    Private StdVector<CompiledNode> compiled;
+    Private StdString labels;
+    Private StdVector<uint32_t> edges;
+    Private StdString edgeFirstChars;
+};
+
+#endif // RADIXROUTER_H
@@ -0,0 +1,152 @@
+#ifndef STATICROUTETABLE_H
+#define STATICROUTETABLE_H
+
+#include <StandardDefines.h>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Deepest request path the generated matcher splits; longer paths never match
+#ifndef STATICROUTE_MAX_SEGMENTS
+    #define STATICROUTE_MAX_SEGMENTS 16
+#endif
+
+// Most path variables one route may declare; captures live in a fixed array of this size
+#ifndef STATICROUTE_MAX_CAPTURES
+    #define STATICROUTE_MAX_CAPTURES 8
+#endif
+
+enum class RouteMethod : uint8_t {
+    Get,
+    Post,
+    Put,
+    Delete,
+    Patch,
+    Unknown
+};
+
+inline RouteMethod RouteMethodFromString(std::string_view method) {
+    if (method == "GET") return RouteMethod::Get;
+    if (method == "POST") return RouteMethod::Post;
+    if (method == "PUT") return RouteMethod::Put;
+    if (method == "DELETE") return RouteMethod::Delete;
+    if (method == "PATCH") return RouteMethod::Patch;
+    return RouteMethod::Unknown;
+}
+
+// Switch key of one path segment: length plus first, middle and last byte, so it
+// costs the same for any segment. Generated branches still compare the text, so
+// two literals sharing a key only share a case label.
+// Must match segment_key() in scripts/generate_route_table.py
+constexpr uint32_t RouteSegmentKey(std::string_view segment) {
+    if (segment.empty()) {
+        return 0;
+    }
+    return (static_cast<uint32_t>(segment.size() & 0xFF) << 24) ^
+           (static_cast<uint32_t>(static_cast<uint8_t>(segment[0])) << 16) ^
+           (static_cast<uint32_t>(static_cast<uint8_t>(segment[segment.size() / 2])) << 8) ^
+           static_cast<uint32_t>(static_cast<uint8_t>(segment[segment.size() - 1]));
+}
+
+/**
+ * A request path split into segments, each with its switch key.
+ * "/switch/3/on" is {"switch", "3", "on"}; a single trailing slash is dropped
+ * and remembered, anything from '?' on is ignored.
+ */
+struct RouteSegments {
+    Size count = 0;
+    Bool trailingSlash = false;
+    // Plain offsets rather than string_views, so nothing is initialized per request
+    const char* base = nullptr;
+    uint16_t offsets[STATICROUTE_MAX_SEGMENTS];
+    uint16_t lengths[STATICROUTE_MAX_SEGMENTS];
+    uint32_t keys[STATICROUTE_MAX_SEGMENTS];
+
+    std::string_view View(Size index) const {
+        return std::string_view(base + offsets[index], lengths[index]);
+    }
+
+    /**
+     * @return false for an empty, relative or over-long (64 KiB) path, or one deeper
+     *         than STATICROUTE_MAX_SEGMENTS
+     */
+    Static Bool Split(std::string_view path, RouteSegments& out) {
+        out.count = 0;
+        out.trailingSlash = false;
+        out.base = path.data();
+        if (path.empty() || path[0] != '/' || path.size() > 0xFFFF) {
+            return false;
+        }
+        const char* first = path.data() + 1;
+        const char* last = path.data() + path.size();
+        const char* query = static_cast<const char*>(std::memchr(first, '?', static_cast<Size>(last - first)));
+        if (query != nullptr) {
+            last = query;
+        }
+        const char* start = first;
+        while (start != last) {
+            const char* slash = static_cast<const char*>(std::memchr(start, '/', static_cast<Size>(last - start)));
+            if (slash == nullptr) {
+                return out.Push(start, last);
+            }
+            if (!out.Push(start, slash)) {
+                return false;
+            }
+            start = slash + 1;
+        }
+        out.trailingSlash = start != first;
+        return true;
+    }
+
+    Private Bool Push(const char* start, const char* end) {
+        if (count == STATICROUTE_MAX_SEGMENTS) {
+            return false;
+        }
+        offsets[count] = static_cast<uint16_t>(start - base);
+        lengths[count] = static_cast<uint16_t>(end - start);
+        keys[count] = RouteSegmentKey(std::string_view(start, lengths[count]));
+        count++;
+        return true;
+    }
+};
+
+/**
+ * One route known at build time, emitted by scripts/generate_route_table.py
+ */
+struct StaticRoute {
+    RouteMethod method;
+    const char* pattern;
+    const char* controller;
+    const char* handler;
+    uint8_t segmentCount;
+    uint8_t variableCount;
+};
+
+/**
+ * Result of a generated-table lookup; captures are views into the request path
+ */
+struct StaticRouteMatch {
+    Int routeId = -1;
+    Size captureCount = 0;
+    std::string_view captures[STATICROUTE_MAX_CAPTURES];
+
+    Bool Found() const {
+        return routeId >= 0;
+    }
+
+    // Called by the generated matcher for each variable segment, in path order
+    Void Capture(std::string_view value) {
+        captures[captureCount++] = value;
+    }
+};
+
+// The generated table (GeneratedRouteTable.h) is produced from the @RestController
+// annotations by scripts/generate_route_table.py at configure / pre-build time
+#if __has_include(<GeneratedRouteTable.h>)
+    #include <GeneratedRouteTable.h>
+    #define STATICROUTE_HAS_GENERATED_TABLE 1
+#else
+    #define STATICROUTE_HAS_GENERATED_TABLE 0
+#endif
+
+#endif // STATICROUTETABLE_H
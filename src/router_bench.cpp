@@ -0,0 +1,178 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <EndpointTrie.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "router/RadixRouter.h"
+#include "router/StaticRouteTable.h"
+#include "metrics/RouteMetrics.h"
+#include <memory>
+
+// Router benchmark: EndpointTrie against the generated route table on the
+// app's @RestController routes, with RadixRouter (which serves the routes
+// added at runtime) on the same set. One op resolves every route's sample path
+// once, so ns/op and allocations per op cover the whole table. Startup (route
+// registration) and dispatch are measured separately.
+// The metrics group measures what RouteMetrics adds to every request; the
+// benchmark fails when that exceeds kMetricsBudgetNanos.
+
+#if STATICROUTE_HAS_GENERATED_TABLE
+// A request path for a generated route, with every variable set to 7
+StdString SamplePath(const StaticRoute& route) {
+    StdString path;
+    for (const char* c = route.pattern; *c != '\0'; c++) {
+        if (*c == '{') {
+            path += '7';
+            while (*c != '}') c++;
+        } else {
+            path += *c;
+        }
+    }
+    return path;
+}
+
+Void BenchGeneratedRoutes(BenchReport& report, Bool verbose) {
+    StdVector<StdString> paths;
+    for (const StaticRoute& route : kGeneratedRoutes) {
+        paths.push_back(SamplePath(route));
+    }
+
+    // Startup: what the server does before the first request. The generated
+    // table is constexpr data, so it has no registration step at all.
+    const BenchResult startup[] = {
+        report.Measure("startup", "EndpointTrie insert", kGeneratedRouteCount, 0, [&]() {
+            EndpointTrie trie;
+            for (const StaticRoute& route : kGeneratedRoutes) {
+                trie.Insert(route.pattern);
+            }
+            BenchKeep(trie);
+        }),
+        report.Measure("startup", "RadixRouter insert", kGeneratedRouteCount, 0, [&]() {
+            RadixRouter router;
+            for (Size i = 0; i < kGeneratedRouteCount; i++) {
+                router.Insert(kGeneratedRoutes[i].pattern, static_cast<Int>(i));
+            }
+            BenchKeep(router);
+        }),
+    };
+
+    EndpointTrie trie;
+    RadixRouter router;
+    for (Size i = 0; i < kGeneratedRouteCount; i++) {
+        trie.Insert(kGeneratedRoutes[i].pattern);
+        router.Insert(kGeneratedRoutes[i].pattern, static_cast<Int>(i));
+    }
+
+    // All three must agree before their timings mean anything
+    for (Size i = 0; i < kGeneratedRouteCount; i++) {
+        StaticRouteMatch generated = MatchGeneratedRoute(kGeneratedRoutes[i].method, paths[i]);
+        EndpointMatchResult expected = trie.Search(paths[i]);
+        if (generated.routeId != static_cast<Int>(i) || !expected.found || expected.pattern != kGeneratedRoutes[i].pattern ||
+            router.Match(paths[i]).handlerId != static_cast<Int>(i)) {
+            std::cerr << "Generated table disagrees on " << paths[i] << std::endl;
+        }
+    }
+
+    const BenchResult dispatch[] = {
+        report.Measure("dispatch", "EndpointTrie::Search", paths.size(), 0, [&]() {
+            for (CStdString& path : paths) {
+                EndpointMatchResult result = trie.Search(path);
+                BenchKeep(result);
+            }
+        }),
+        report.Measure("dispatch", "RadixRouter::Match", paths.size(), 0, [&]() {
+            for (CStdString& path : paths) {
+                RadixRouteMatch match = router.Match(path);
+                BenchKeep(match);
+            }
+        }),
+        report.Measure("dispatch", "MatchGeneratedRoute", paths.size(), 0, [&]() {
+            for (Size i = 0; i < kGeneratedRouteCount; i++) {
+                StaticRouteMatch match = MatchGeneratedRoute(kGeneratedRoutes[i].method, paths[i]);
+                BenchKeep(match);
+            }
+        }),
+    };
+    if (verbose) {
+        for (const BenchResult& result : startup) {
+            report.PrintTableRow(result);
+        }
+        std::printf("%-16s %-40s (constexpr, no startup work)\n", "startup", "generated table");
+        for (const BenchResult& result : dispatch) {
+            report.PrintTableRow(result);
+        }
+    }
+}
+#endif
+
+// Per-request cost allowed for recording route metrics
+const double kMetricsBudgetNanos = 1000;
+
+/**
+ * @brief Measure RouteRequestTimer (two clock reads plus RouteMetrics::Record)
+ * @return Overhead in ns per request
+ */
+double BenchRouteMetrics(BenchReport& report, Bool verbose) {
+    std::unique_ptr<RouteMetrics> metrics(new RouteMetrics());
+    metrics->RegisterGeneratedRoutes();
+
+    StdVector<BenchResult> results;
+    results.push_back(report.Measure("metrics", "RouteRequestTimer", 1, 0, [&]() {
+        RouteRequestTimer timer(*metrics, 0);
+        timer.SetStatus(200);
+    }));
+#if STATICROUTE_HAS_GENERATED_TABLE
+    StdVector<StdString> paths;
+    for (const StaticRoute& route : kGeneratedRoutes) {
+        paths.push_back(SamplePath(route));
+    }
+    results.push_back(report.Measure("metrics", "MatchGeneratedRoute + timer", paths.size(), 0, [&]() {
+        for (Size i = 0; i < kGeneratedRouteCount; i++) {
+            RouteRequestTimer timer(*metrics, RouteMetrics::kUnmatchedRoute);
+            StaticRouteMatch match = MatchGeneratedRoute(kGeneratedRoutes[i].method, paths[i]);
+            BenchKeep(match);
+            timer.SetRoute(match.routeId);
+            timer.SetStatus(200);
+        }
+    }));
+#endif
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+    }
+    return results[0].nanosPerOp;
+}
+
+int main(int argc, char* argv[]) {
+    BenchCommandLine commandLine;
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("router_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+#if STATICROUTE_HAS_GENERATED_TABLE
+    BenchGeneratedRoutes(report, verbose);
+#endif
+    double metricsNanos = BenchRouteMetrics(report, verbose);
+    Bool withinBudget = metricsNanos < kMetricsBudgetNanos;
+    if (verbose || !withinBudget) {
+        std::fprintf(verbose ? stdout : stderr, "metrics overhead: %.1f ns/request (budget %.0f ns) %s\n",
+                     metricsNanos, kMetricsBudgetNanos, withinBudget ? "ok" : "OVER BUDGET");
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+    return withinBudget ? 0 : 1;
+}
+
+#endif // ARDUINO
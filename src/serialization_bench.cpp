@@ -0,0 +1,181 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "serializer/MessagePackSerializer.h"
+#include "serializer/NumberFormat.h"
+#include "serializer/StreamingDeserializer.h"
+#include "serialization_tests/SerializationFixtures.h"
+
+using namespace nayan::serializer;
+
+// Serialization benchmark suite. The fixtures are the DTOs of the
+// serialization tests (Person, Address, ProductX, WideDto) in vector, map and
+// nested-container shapes at several sizes. Every case reports ns/op, heap
+// bytes and allocations per op and peak RSS; --json writes the same results
+// as one JSON document for regression tracking.
+
+static const Int kCollectionSizes[] = {1, 10, 100, 1000};
+
+// Encode and decode value with every codec
+template<typename T>
+Void BenchCodecs(BenchReport& report, CStdString& group, Size elements, const T& value, Bool verbose) {
+    StdString json = SerializationUtility::Serialize(value);
+    StdString binary = MessagePackSerializer::Serialize(value);
+
+    const BenchResult results[] = {
+        report.Measure(group, "json serialize", elements, json.size(),
+                        [&]() { BenchKeep(SerializationUtility::Serialize(value)); }),
+        report.Measure(group, "json deserialize", elements, json.size(),
+                        [&]() { BenchKeep(SerializationUtility::Deserialize<T>(json)); }),
+        report.Measure(group, "json stream deserialize", elements, json.size(),
+                        [&]() { BenchKeep(StreamingDeserializer::Deserialize<T>(json)); }),
+        report.Measure(group, "msgpack serialize", elements, binary.size(),
+                        [&]() { BenchKeep(MessagePackSerializer::Serialize(value)); }),
+        report.Measure(group, "msgpack deserialize", elements, binary.size(),
+                        [&]() { BenchKeep(MessagePackSerializer::Deserialize<T>(binary)); }),
+    };
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+    }
+}
+
+// Resolves every key of a wide object once: through the perfect hash, and by the
+// linear compare sweep a field-by-field lookup would do
+Void BenchWideDtoKeyLookup(BenchReport& report, Bool verbose) {
+    typedef SerializableFieldTable<WideDto> Table;
+    StdVector<StdString> keys;
+    for (Size i = 0; i < Table::fieldCount; i++) {
+        keys.push_back(Table::fields[i].name);
+    }
+    keys.push_back("unknownKey");
+
+    BenchResult hashed = report.Measure("field-lookup", "WideDto perfect hash", keys.size(), 0, [&]() {
+        for (CStdString& key : keys) {
+            BenchKeep(FieldLookup<WideDto>::Find(key));
+        }
+    });
+    BenchResult linear = report.Measure("field-lookup", "WideDto linear sweep", keys.size(), 0, [&]() {
+        for (CStdString& key : keys) {
+            const FieldDescriptor<WideDto>* found = nullptr;
+            for (Size i = 0; i < Table::fieldCount && found == nullptr; i++) {
+                if (key == Table::fields[i].name) {
+                    found = &Table::fields[i];
+                }
+            }
+            BenchKeep(found);
+        }
+    });
+    if (verbose) {
+        report.PrintTableRow(hashed);
+        report.PrintTableRow(linear);
+    }
+}
+
+// Number conversion throughput: NumberFormat against the printf / strto* calls it replaced
+Void BenchNumberConversions(BenchReport& report, Bool verbose) {
+    const Size count = 4096;
+    StdVector<double> doubles;
+    StdVector<int64_t> integers;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (Size i = 0; i < count; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        doubles.push_back(static_cast<double>(state % 100000000) / 997.0);
+        integers.push_back(static_cast<int64_t>(state) >> (i % 48));
+    }
+    StdVector<StdString> doubleTexts;
+    StdVector<StdString> integerTexts;
+    for (Size i = 0; i < count; i++) {
+        char buffer[40];
+        doubleTexts.push_back(StdString(buffer, NumberFormat::FormatDouble(doubles[i], buffer)));
+        integerTexts.push_back(StdString(buffer, NumberFormat::FormatInt(integers[i], buffer)));
+    }
+
+    char buffer[40];
+    const BenchResult results[] = {
+        report.Measure("numbers", "format double NumberFormat", count, 0, [&]() {
+            for (double value : doubles) BenchKeep(NumberFormat::FormatDouble(value, buffer));
+        }),
+        report.Measure("numbers", "format double snprintf %.17g", count, 0, [&]() {
+            for (double value : doubles) BenchKeep(std::snprintf(buffer, sizeof(buffer), "%.17g", value));
+        }),
+        report.Measure("numbers", "parse double NumberFormat", count, 0, [&]() {
+            double value = 0;
+            for (CStdString& text : doubleTexts) BenchKeep(NumberFormat::ParseDouble(text, value));
+        }),
+        report.Measure("numbers", "parse double strtod", count, 0, [&]() {
+            for (CStdString& text : doubleTexts) BenchKeep(std::strtod(text.c_str(), nullptr));
+        }),
+        report.Measure("numbers", "format int64 NumberFormat", count, 0, [&]() {
+            for (int64_t value : integers) BenchKeep(NumberFormat::FormatInt(value, buffer));
+        }),
+        report.Measure("numbers", "format int64 snprintf %lld", count, 0, [&]() {
+            for (int64_t value : integers) BenchKeep(std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value)));
+        }),
+        report.Measure("numbers", "parse int64 NumberFormat", count, 0, [&]() {
+            int64_t value = 0;
+            for (CStdString& text : integerTexts) BenchKeep(NumberFormat::ParseInt(text.data(), text.data() + text.size(), value));
+        }),
+        report.Measure("numbers", "parse int64 strtoll", count, 0, [&]() {
+            for (CStdString& text : integerTexts) BenchKeep(std::strtoll(text.c_str(), nullptr, 10));
+        }),
+    };
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+    }
+}
+
+StdString SizedGroup(const char* shape, Int size) {
+    return StdString(shape) + " x" + StdString(std::to_string(size).c_str());
+}
+
+int main(int argc, char* argv[]) {
+    BenchCommandLine commandLine;
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("serialization_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    BenchCodecs(report, "Person", 1, MakeFixturePerson(1), verbose);
+    BenchCodecs(report, "Address", 1, MakeFixtureAddress(1), verbose);
+    BenchCodecs(report, "ProductX", 1, MakeFixtureProductX(1), verbose);
+    BenchCodecs(report, "WideDto", 1, MakeFixtureWideDto(1), verbose);
+    for (Int size : kCollectionSizes) {
+        Size elements = static_cast<Size>(size);
+        BenchCodecs(report, SizedGroup("vector<Person>", size), elements, MakeFixturePersons(size), verbose);
+        BenchCodecs(report, SizedGroup("vector<Address>", size), elements, MakeFixtureAddresses(size), verbose);
+        BenchCodecs(report, SizedGroup("vector<ProductX>", size), elements, MakeFixtureProducts(size), verbose);
+        BenchCodecs(report, SizedGroup("map<string,Person>", size), elements, MakeFixturePersonMap(size), verbose);
+        BenchCodecs(report, SizedGroup("map<string,ProductX>", size), elements, MakeFixtureProductMap(size), verbose);
+        BenchCodecs(report, SizedGroup("map<string,vector<Address>>", size), elements, MakeFixtureAddressBook(size), verbose);
+    }
+    BenchWideDtoKeyLookup(report, verbose);
+    BenchNumberConversions(report, verbose);
+
+    if (verbose) {
+        std::printf("\npeak RSS: %ld KiB\n", BenchPeakRssKb());
+    }
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
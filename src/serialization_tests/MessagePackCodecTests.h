@@ -0,0 +1,361 @@
+#ifndef MESSAGEPACK_CODEC_TESTS_H
+#define MESSAGEPACK_CODEC_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+    #include <vector>
+    #include <map>
+    #include <set>
+    #include <forward_list>
+#else
+    #include <iostream>
+    #include <string>
+    #include <vector>
+    #include <map>
+    #include <set>
+    #include <forward_list>
+    #include <limits>
+    #include <stdexcept>
+#endif
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include "../serializer/MessagePackSerializer.h"
+#include "../serializer/WireFormat.h"
+#include "../tests/TestUtils.h"
+#include "SerializationFixtures.h"
+
+using namespace nayan::serializer;
+
+// Test counters
+static int testsPassed_msgpack = 0;
+static int testsFailed_msgpack = 0;
+
+// ========== HELPERS ==========
+
+// Encodes value with both wire formats and checks each decodes back to it
+template<typename T>
+bool BothCodecsRoundTrip(const T& value) {
+    StdString expected = CanonicalForm(value);
+    StdString json = WireFormatNegotiator::Encode(WireFormat::Json, value);
+    StdString binary = WireFormatNegotiator::Encode(WireFormat::MessagePack, value);
+    if (CanonicalForm(WireFormatNegotiator::Decode<T>(WireFormat::Json, json)) != expected) {
+        std_println("  JSON round trip mismatch");
+        return false;
+    }
+    if (CanonicalForm(WireFormatNegotiator::Decode<T>(WireFormat::MessagePack, binary)) != expected) {
+        std_println("  MessagePack round trip mismatch");
+        return false;
+    }
+    return true;
+}
+
+// JSON -> MessagePack -> JSON must give back the same compact text
+bool TranscodesUnchanged(CStdString& json) {
+    StdString binary;
+    MessagePackWriter writer(binary);
+    MessagePackTranscoder::FromJson(json, writer);
+    MessagePackReader reader(binary);
+    StdString back;
+    MessagePackTranscoder::ToJson(reader, back);
+    return back == json && reader.AtEnd();
+}
+
+// Prints one row of the size table and returns the MessagePack / JSON ratio in percent
+template<typename T>
+Int PrintSizeRow(const char* name, const T& value) {
+    Size jsonBytes = SerializationUtility::Serialize(value).size();
+    Size binaryBytes = MessagePackSerializer::Serialize(value).size();
+    Int percent = jsonBytes == 0 ? 100 : static_cast<Int>(binaryBytes * 100 / jsonBytes);
+    std_print("  ");
+    std_print(name);
+    std_print(": json=");
+    std_print(jsonBytes);
+    std_print(" msgpack=");
+    std_print(binaryBytes);
+    std_print(" (");
+    std_print(percent);
+    std_println("%)");
+    return percent;
+}
+
+// ========== PRIMITIVES ==========
+
+bool TestMessagePackPrimitives() {
+    TEST_START("Test MessagePack Primitives");
+
+    ASSERT(MessagePackSerializer::Serialize<int>(127).size() == 1, "127 should be a positive fixint");
+    ASSERT(MessagePackSerializer::Serialize<int>(128).size() == 2, "128 should be a uint8");
+    ASSERT(MessagePackSerializer::Serialize<int>(-32).size() == 1, "-32 should be a negative fixint");
+    ASSERT(MessagePackSerializer::Serialize<int>(-33).size() == 2, "-33 should be an int8");
+    ASSERT(MessagePackSerializer::Serialize<int>(65535).size() == 3, "65535 should be a uint16");
+    ASSERT(MessagePackSerializer::Serialize<bool>(true).size() == 1, "bool should be one byte");
+
+    ASSERT(BothCodecsRoundTrip<int>(0), "0 should round trip");
+    ASSERT(BothCodecsRoundTrip<int>(-1), "-1 should round trip");
+    ASSERT(BothCodecsRoundTrip<int>(std::numeric_limits<int>::min()), "int min should round trip");
+    ASSERT(BothCodecsRoundTrip<int>(std::numeric_limits<int>::max()), "int max should round trip");
+    ASSERT(MessagePackSerializer::Deserialize<long long>(
+               MessagePackSerializer::Serialize<long long>(std::numeric_limits<long long>::min())) ==
+               std::numeric_limits<long long>::min(),
+           "int64 min should round trip");
+    ASSERT(MessagePackSerializer::Deserialize<unsigned long long>(
+               MessagePackSerializer::Serialize<unsigned long long>(std::numeric_limits<unsigned long long>::max())) ==
+               std::numeric_limits<unsigned long long>::max(),
+           "uint64 max should round trip");
+    ASSERT(MessagePackSerializer::Deserialize<double>(MessagePackSerializer::Serialize<double>(0.1)) == 0.1,
+           "double should round trip bit for bit");
+    ASSERT(MessagePackSerializer::Deserialize<float>(MessagePackSerializer::Serialize<float>(2.5f)) == 2.5f,
+           "float should round trip");
+    ASSERT(BothCodecsRoundTrip<bool>(true), "bool true should round trip");
+    ASSERT(BothCodecsRoundTrip<bool>(false), "bool false should round trip");
+
+    Size lengths[] = {0, 31, 32, 255, 256, 70000};
+    for (Size length : lengths) {
+        StdString text(length, 'x');
+        ASSERT(MessagePackSerializer::Deserialize<StdString>(MessagePackSerializer::Serialize(text)) == text,
+               "string should round trip across every length encoding");
+    }
+    ASSERT(BothCodecsRoundTrip<StdString>(StdString("Hello World")), "string should round trip");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+// ========== ENTITIES AND OPTIONALS ==========
+
+bool TestMessagePackEntities() {
+    TEST_START("Test MessagePack Entities");
+
+    ASSERT(BothCodecsRoundTrip(MakeFixturePerson(1)), "Person should round trip");
+    ASSERT(BothCodecsRoundTrip(MakeFixtureAddress(1)), "Address should round trip");
+    ASSERT(BothCodecsRoundTrip(MakeFixtureProductX(1)), "ProductX should round trip");
+
+    Person partial;
+    partial.id = optional<int>(3);
+    partial.name = optional<StdString>(StdString("Partial Person"));
+    ASSERT(BothCodecsRoundTrip(partial), "partial Person should round trip");
+
+    ASSERT(BothCodecsRoundTrip(optional<int>(123)), "optional<int> with value should round trip");
+    ASSERT(BothCodecsRoundTrip(optional<int>()), "empty optional<int> should round trip");
+    ASSERT(MessagePackSerializer::Serialize(optional<int>()).size() == 1, "empty optional should be a single nil");
+    ASSERT(BothCodecsRoundTrip(optional<Person>(MakeFixturePerson(5))), "optional<Person> should round trip");
+    ASSERT(!MessagePackSerializer::Deserialize<optional<Person>>(MessagePackSerializer::Serialize(optional<Person>())).has_value(),
+           "empty optional<Person> should round trip");
+
+    // Classes with a field table go member by member, not through JSON
+    StdString binary = MessagePackSerializer::Serialize(partial);
+    MessagePackReader reader(binary);
+    ASSERT(reader.ReadMapHeader() == SerializableFieldTable<Person>::fieldCount, "A Person should be a map of its fields");
+    Person decoded = MessagePackSerializer::Deserialize<Person>(binary);
+    ASSERT(decoded.id == partial.id && decoded.name == partial.name && !decoded.age.has_value(),
+           "A Person should decode field by field");
+    StdString extra;
+    MessagePackWriter writer(extra);
+    writer.WriteMapHeader(3);
+    writer.WriteString("unknown");
+    writer.WriteArrayHeader(2);
+    writer.WriteInt(1);
+    writer.WriteInt(2);
+    writer.WriteString("age");
+    writer.WriteInt(41);
+    writer.WriteInt(7);
+    writer.WriteString("ignored");
+    decoded = MessagePackSerializer::Deserialize<Person>(extra);
+    ASSERT(decoded.age == optional<int>(41) && !decoded.name.has_value(), "Unknown keys should be skipped");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+// ========== CONTAINERS ==========
+
+bool TestMessagePackContainers() {
+    TEST_START("Test MessagePack Containers");
+
+    ASSERT(BothCodecsRoundTrip(StdVector<int>{10, 20, 30, 40, 50}), "vector<int> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdList<StdString>{"apple", "banana", "cherry"}), "list<string> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdDeque<double>{3.14, 2.71, 1.41, 0.57}), "deque<double> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdSet<int>{5, 3, 8, 1, 9}), "set<int> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdUnorderedSet<StdString>{"red", "green", "blue"}), "unordered_set<string> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdArray<int, 4>{{1, 2, 3, 4}}), "array<int, 4> should round trip");
+    ASSERT(BothCodecsRoundTrip(std::forward_list<int>{1, 2, 3}), "forward_list<int> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdVector<bool>{true, false, true}), "vector<bool> should round trip");
+    ASSERT(BothCodecsRoundTrip(StdVector<int>()), "empty vector should round trip");
+
+    StdVector<int> large;
+    for (Int i = 0; i < 70000; i++) {
+        large.push_back(i);
+    }
+    ASSERT(MessagePackSerializer::Deserialize<StdVector<int>>(MessagePackSerializer::Serialize(large)) == large,
+           "array32 should round trip");
+
+    ASSERT(BothCodecsRoundTrip(MakeFixtureProducts(100)), "vector<ProductX> should round trip");
+    ASSERT(BothCodecsRoundTrip(MakeFixturePersonMap(20)), "map<string, Person> should round trip");
+    ASSERT(BothCodecsRoundTrip(MakeFixtureAddressBook(3)), "map<string, vector<Address>> should round trip");
+
+    StdMap<int, ProductX> productsById;
+    productsById[1001] = MakeFixtureProductX(1);
+    productsById[1002] = MakeFixtureProductX(2);
+    ASSERT(BothCodecsRoundTrip(productsById), "map<int, ProductX> should round trip");
+
+    StdUnorderedMap<int, Person> personsById;
+    personsById[7] = MakeFixturePerson(7);
+    personsById[8] = MakeFixturePerson(8);
+    ASSERT(BothCodecsRoundTrip(personsById), "unordered_map<int, Person> should round trip");
+
+    typedef StdMap<StdString, int> CountMap;
+    ASSERT(BothCodecsRoundTrip(CountMap()), "empty map should round trip");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+// ========== TRANSCODER AND NEGOTIATION ==========
+
+bool TestMessagePackTranscoder() {
+    TEST_START("Test MessagePack Transcoder");
+
+    ASSERT(TranscodesUnchanged("{\"id\":1,\"name\":\"John \\\"JD\\\" Doe\",\"active\":true,\"salary\":50000.5,\"manager\":null}"),
+           "flat object should transcode unchanged");
+    ASSERT(TranscodesUnchanged("[[1,2],[],{\"a\":[-5,{}]}]"), "nested containers should transcode unchanged");
+
+    // More than 15 members / elements needs the 16-bit headers
+    StdString wide = "{";
+    StdString longArray = "[";
+    for (Int i = 0; i < 40; i++) {
+        if (i > 0) {
+            wide += ",";
+            longArray += ",";
+        }
+        wide += "\"f" + StdString(std::to_string(i).c_str()) + "\":" + StdString(std::to_string(i * 1000).c_str());
+        longArray += StdString(std::to_string(-i).c_str());
+    }
+    wide += "}";
+    longArray += "]";
+    ASSERT(TranscodesUnchanged(wide), "40-member object should transcode unchanged");
+    ASSERT(TranscodesUnchanged(longArray), "40-element array should transcode unchanged");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+bool TestWireFormatNegotiation() {
+    TEST_START("Test Wire Format Negotiation");
+
+    ASSERT(WireFormatNegotiator::FromAccept("") == WireFormat::Json, "missing Accept should use JSON");
+    ASSERT(WireFormatNegotiator::FromAccept("*/*") == WireFormat::Json, "wildcard should use JSON");
+    ASSERT(WireFormatNegotiator::FromAccept("application/msgpack") == WireFormat::MessagePack, "msgpack should be honoured");
+    ASSERT(WireFormatNegotiator::FromAccept("application/json, application/msgpack") == WireFormat::Json,
+           "equal quality should keep JSON");
+    ASSERT(WireFormatNegotiator::FromAccept("application/json;q=0.5, application/x-msgpack") == WireFormat::MessagePack,
+           "higher quality should win");
+    ASSERT(WireFormatNegotiator::FromAccept("application/msgpack;q=0") == WireFormat::Json, "q=0 should be refused");
+    ASSERT(WireFormatNegotiator::FromAccept("text/html") == WireFormat::Json, "unknown types should fall back to JSON");
+    ASSERT(WireFormatNegotiator::FromContentType("Application/MsgPack") == WireFormat::MessagePack,
+           "Content-Type should be case-insensitive");
+    ASSERT(WireFormatNegotiator::FromContentType("application/json; charset=utf-8") == WireFormat::Json,
+           "Content-Type parameters should be ignored");
+    ASSERT(StdString(WireFormatNegotiator::ContentTypeFor(WireFormat::MessagePack)) == "application/msgpack",
+           "msgpack content type should be application/msgpack");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+// ========== SIZE TABLE AND ERROR HANDLING ==========
+
+bool TestMessagePackSizeTable() {
+    TEST_START("Test MessagePack Size Table");
+
+    Int person = PrintSizeRow("Person", MakeFixturePerson(1));
+    Int address = PrintSizeRow("Address", MakeFixtureAddress(1));
+    Int product = PrintSizeRow("ProductX", MakeFixtureProductX(1));
+    Int persons = PrintSizeRow("vector<Person> x100", MakeFixturePersons(100));
+    Int products = PrintSizeRow("vector<ProductX> x100", MakeFixtureProducts(100));
+    Int personMap = PrintSizeRow("map<string, Person> x100", MakeFixturePersonMap(100));
+    Int addressBook = PrintSizeRow("map<string, vector<Address>> x50", MakeFixtureAddressBook(50));
+    Int numbers = PrintSizeRow("vector<int> x1000", StdVector<int>(1000, 500));
+
+    ASSERT(person < 100 && address < 100 && product < 100, "single entities should be smaller than JSON");
+    ASSERT(persons < 100 && products < 100 && personMap < 100 && addressBook < 100,
+           "entity collections should be smaller than JSON");
+    ASSERT(numbers < 100, "integer arrays should be smaller than JSON");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+bool TestMessagePackRejectsMalformedInput() {
+    TEST_START("Test MessagePack Rejects Malformed Input");
+
+    StdString valid = MessagePackSerializer::Serialize(StdVector<int>{1, 2, 300});
+    StdString malformed[] = {
+        valid.substr(0, valid.size() - 1),      // truncated uint16
+        valid + StdString(1, '\x01'),           // trailing byte
+        StdString("\x93\x01\xa1", 3),           // array element is an unterminated string
+        StdString(1, '\xc1'),                   // reserved marker
+    };
+    Int rejected = 0;
+    for (CStdString& input : malformed) {
+        try {
+            MessagePackSerializer::Deserialize<StdVector<int>>(input);
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+    ASSERT(rejected == 4, "Every malformed input should be rejected");
+
+    StdString empty;
+    MessagePackReader reader(empty);
+    Bool failed = false;
+    try {
+        reader.ReadDouble();
+    } catch (const std::runtime_error&) {
+        failed = true;
+    }
+    ASSERT(failed, "Reading a double past the end should fail");
+
+    testsPassed_msgpack++;
+    return true;
+}
+
+// Main test runner function
+int RunAllMessagePackCodecTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  MessagePackCodec Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_msgpack = 0;
+    testsFailed_msgpack = 0;
+
+    if (!TestMessagePackPrimitives()) testsFailed_msgpack++;
+    if (!TestMessagePackEntities()) testsFailed_msgpack++;
+    if (!TestMessagePackContainers()) testsFailed_msgpack++;
+    if (!TestMessagePackTranscoder()) testsFailed_msgpack++;
+    if (!TestWireFormatNegotiation()) testsFailed_msgpack++;
+    if (!TestMessagePackSizeTable()) testsFailed_msgpack++;
+    if (!TestMessagePackRejectsMalformedInput()) testsFailed_msgpack++;
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_msgpack);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_msgpack);
+    std_print("Total Tests: ");
+    std_println(testsPassed_msgpack + testsFailed_msgpack);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_msgpack;
+}
+
+#endif // MESSAGEPACK_CODEC_TESTS_H
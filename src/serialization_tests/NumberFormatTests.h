@@ -0,0 +1,262 @@
+#ifndef NUMBER_FORMAT_TESTS_H
+#define NUMBER_FORMAT_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+    #include <clocale>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <StandardDefines.h>
+#include "../serializer/NumberFormat.h"
+#include "../tests/TestUtils.h"
+
+// Test counters
+static int testsPassed_numberFormat = 0;
+static int testsFailed_numberFormat = 0;
+
+// Random doubles checked by the fuzz test; kept small on the device
+#ifdef ARDUINO
+static const Size kDoubleFuzzIterations = 2000;
+#else
+static const Size kDoubleFuzzIterations = 1000000;
+#endif
+
+// ========== HELPERS ==========
+
+// xorshift64*, fixed seed so failures reproduce
+inline uint64_t NextFuzzBits(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+inline double DoubleFromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline StdString FormatDoubleText(double value) {
+    StdString text;
+    NumberFormat::AppendDouble(value, text);
+    return text;
+}
+
+// Formats value, parses it back and checks the bits are identical and the text
+// is no longer than the 17-digit form
+inline Bool DoubleRoundTrips(double value) {
+    char buffer[NumberFormat::kMaxDoubleChars];
+    Size length = NumberFormat::FormatDouble(value, buffer);
+    double parsed = 0;
+    if (NumberFormat::ParseDouble(buffer, buffer + length, parsed) != length) {
+        return false;
+    }
+    if (std::memcmp(&parsed, &value, sizeof(value)) != 0) {
+        return false;
+    }
+    char longest[40];
+    Int longestLength = std::snprintf(longest, sizeof(longest), "%.17g", value);
+    return length <= static_cast<Size>(longestLength) + 1;
+}
+
+// ========== INTEGERS ==========
+
+bool TestFormatIntegers() {
+    TEST_START("Test Format Integers");
+
+    char buffer[NumberFormat::kMaxIntegerChars];
+    ASSERT(StdString(buffer, NumberFormat::FormatInt(0, buffer)) == "0", "0 should format as 0");
+    ASSERT(StdString(buffer, NumberFormat::FormatInt(-7, buffer)) == "-7", "-7 should format as -7");
+    ASSERT(StdString(buffer, NumberFormat::FormatInt(INT64_MIN, buffer)) == "-9223372036854775808",
+           "INT64_MIN should format without overflow");
+    ASSERT(StdString(buffer, NumberFormat::FormatUInt(UINT64_MAX, buffer)) == "18446744073709551615",
+           "UINT64_MAX should use all 20 digits");
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    Bool allMatch = true;
+    for (Int i = 0; i < 100000 && allMatch; i++) {
+        int64_t value = static_cast<int64_t>(NextFuzzBits(state)) >> (i % 64);
+        allMatch = StdString(buffer, NumberFormat::FormatInt(value, buffer)) == StdString(std::to_string(value).c_str());
+    }
+    ASSERT(allMatch, "Random integers should match std::to_string");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+
+bool TestParseIntegers() {
+    TEST_START("Test Parse Integers");
+
+    int64_t value = 0;
+    uint64_t unsignedValue = 0;
+    CStdString minText = "-9223372036854775808";
+    CStdString maxText = "18446744073709551615";
+    CStdString tooLarge = "9223372036854775808";
+    CStdString partial = "42.5";
+
+    ASSERT(NumberFormat::ParseInt(minText.data(), minText.data() + minText.size(), value) == minText.size() &&
+               value == INT64_MIN,
+           "INT64_MIN should parse");
+    ASSERT(NumberFormat::ParseUInt(maxText.data(), maxText.data() + maxText.size(), unsignedValue) == maxText.size() &&
+               unsignedValue == UINT64_MAX,
+           "UINT64_MAX should parse");
+    ASSERT(NumberFormat::ParseInt(tooLarge.data(), tooLarge.data() + tooLarge.size(), value) == 0,
+           "Signed overflow should be rejected");
+    ASSERT(NumberFormat::ParseInt(partial.data(), partial.data() + partial.size(), value) == 2 && value == 42,
+           "Parsing should stop at the decimal point");
+    ASSERT(NumberFormat::ParseInt(partial.data(), partial.data(), value) == 0, "Empty input should be rejected");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+
+// ========== DOUBLES ==========
+
+bool TestFormatDoubleShortest() {
+    TEST_START("Test Format Double Shortest");
+
+    ASSERT(FormatDoubleText(0.1) == "0.1", "0.1 should format as 0.1");
+    ASSERT(FormatDoubleText(3.14159) == "3.14159", "3.14159 should keep only its own digits");
+    ASSERT(FormatDoubleText(50000.5) == "50000.5", "50000.5 should format as 50000.5");
+    ASSERT(FormatDoubleText(100.0) == "100", "100.0 should format as 100");
+    ASSERT(FormatDoubleText(-0.0) == "-0", "-0.0 should keep its sign");
+    ASSERT(FormatDoubleText(1e21) == "1e+21", "1e21 should use an exponent");
+    ASSERT(FormatDoubleText(0.1 + 0.2) == "0.30000000000000004", "0.1 + 0.2 should need 17 digits");
+    ASSERT(FormatDoubleText(std::numeric_limits<double>::quiet_NaN()) == "nan", "NaN should format as nan");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+
+// Round trips every binary exponent with edge-case mantissas, then random bit patterns
+bool TestDoubleRoundTripFuzz() {
+    TEST_START("Test Double Round Trip Fuzz");
+
+    const uint64_t mantissaMask = (1ULL << 52) - 1;
+    const uint64_t mantissas[] = {0, 1, 2, mantissaMask, mantissaMask - 1, 1ULL << 51, 0x5555555555555ULL, 0xAAAAAAAAAAAAAULL};
+    Bool exponentsPass = true;
+    for (uint64_t exponent = 0; exponent < 2047 && exponentsPass; exponent++) {
+        for (uint64_t mantissa : mantissas) {
+            for (uint64_t sign = 0; sign < 2; sign++) {
+                exponentsPass = exponentsPass && DoubleRoundTrips(DoubleFromBits((sign << 63) | (exponent << 52) | mantissa));
+            }
+        }
+    }
+    ASSERT(exponentsPass, "Every exponent, including subnormals, should round trip");
+
+    ASSERT(DoubleRoundTrips(std::numeric_limits<double>::max()), "Largest double should round trip");
+    ASSERT(DoubleRoundTrips(std::numeric_limits<double>::denorm_min()), "Smallest subnormal should round trip");
+    ASSERT(DoubleRoundTrips(std::numeric_limits<double>::epsilon()), "Epsilon should round trip");
+
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    Size checked = 0;
+    Size failures = 0;
+    while (checked < kDoubleFuzzIterations) {
+        double value = DoubleFromBits(NextFuzzBits(state));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        if (!DoubleRoundTrips(value)) {
+            failures++;
+        }
+        checked++;
+    }
+    ASSERT(failures == 0, "Random doubles should round trip bit for bit");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+
+bool TestParseDouble() {
+    TEST_START("Test Parse Double");
+
+    double value = 0;
+    ASSERT(NumberFormat::ParseDouble(StdString("3.14159"), value) == 7 && value == 3.14159, "3.14159 should parse");
+    ASSERT(NumberFormat::ParseDouble(StdString("-2.5e-3"), value) == 7 && value == -2.5e-3, "Exponent should parse");
+    ASSERT(NumberFormat::ParseDouble(StdString("1e400"), value) == 5 && std::isinf(value), "Overflow should give infinity");
+    ASSERT(NumberFormat::ParseDouble(StdString("12,5"), value) == 2 && value == 12.0, "Comma should end the number");
+    ASSERT(NumberFormat::ParseDouble(StdString("abc"), value) == 0, "Non-numbers should be rejected");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+
+#ifndef ARDUINO
+// Formatting and parsing must not follow LC_NUMERIC (e.g. a decimal comma)
+bool TestNumberFormatIgnoresLocale() {
+    TEST_START("Test Number Format Ignores Locale");
+
+    StdString previous = std::setlocale(LC_NUMERIC, nullptr);
+    const char* candidates[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8"};
+    Bool switched = false;
+    for (const char* name : candidates) {
+        if (std::setlocale(LC_NUMERIC, name) != nullptr) {
+            switched = true;
+            break;
+        }
+    }
+    if (!switched) {
+        std_println("  no decimal-comma locale installed, checking the C locale only");
+    }
+
+    double parsed = 0;
+    Size consumed = NumberFormat::ParseDouble(StdString("1.5"), parsed);
+    StdString formatted = FormatDoubleText(1.5);
+    std::setlocale(LC_NUMERIC, previous.c_str());
+
+    ASSERT(formatted == "1.5", "Formatting should always use a decimal point");
+    ASSERT(consumed == 3 && parsed == 1.5, "Parsing should always accept a decimal point");
+
+    testsPassed_numberFormat++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllNumberFormatTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  NumberFormat Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_numberFormat = 0;
+    testsFailed_numberFormat = 0;
+
+    if (!TestFormatIntegers()) testsFailed_numberFormat++;
+    if (!TestParseIntegers()) testsFailed_numberFormat++;
+    if (!TestFormatDoubleShortest()) testsFailed_numberFormat++;
+    if (!TestDoubleRoundTripFuzz()) testsFailed_numberFormat++;
+    if (!TestParseDouble()) testsFailed_numberFormat++;
+#ifndef ARDUINO
+    if (!TestNumberFormatIgnoresLocale()) testsFailed_numberFormat++;
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_numberFormat);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_numberFormat);
+    std_print("Total Tests: ");
+    std_println(testsPassed_numberFormat + testsFailed_numberFormat);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_numberFormat;
+}
+
+#endif // NUMBER_FORMAT_TESTS_H
@@ -0,0 +1,188 @@
+#ifndef SERIALIZATION_FIXTURES_H
+#define SERIALIZATION_FIXTURES_H
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <string>
+#include "Person.h"
+#include "Address.h"
+#include "ProductX.h"
+#include "WideDto.h"
+
+// Shared builders for the Person / Address / ProductX / WideDto fixtures used by the
+// serialization suites. Values are derived from the index so collections of
+// any size can be generated deterministically.
+
+inline Person MakeFixturePerson(Int index) {
+    Person person;
+    person.id = optional<int>(index);
+    person.name = optional<StdString>(StdString("Person ") + StdString(std::to_string(index).c_str()));
+    person.age = optional<int>(20 + index % 50);
+    person.isActive = optional<bool>(index % 2 == 0);
+    person.salary = optional<double>(40000.0 + index * 125.5);
+    return person;
+}
+
+inline Address MakeFixtureAddress(Int index) {
+    Address address;
+    address.street = optional<StdString>(StdString(std::to_string(100 + index).c_str()) + StdString(" Main St"));
+    address.city = optional<StdString>(index % 2 == 0 ? StdString("New York") : StdString("Boston"));
+    address.state = optional<StdString>(index % 2 == 0 ? StdString("NY") : StdString("MA"));
+    address.zipCode = optional<int>(10000 + index);
+    address.isPrimary = optional<bool>(index == 0);
+    return address;
+}
+
+inline ProductX MakeFixtureProductX(Int index) {
+    ProductX product;
+    product.productId = optional<int>(1000 + index);
+    product.productName = optional<StdString>(StdString("Product ") + StdString(std::to_string(index).c_str()));
+    product.price = optional<double>(9.99 + index);
+    product.quantity = optional<int>(index * 3);
+    product.inStock = optional<bool>(index % 3 != 0);
+    return product;
+}
+
+// Every one of the 50 fields set, so lookups cover the whole table
+inline WideDto MakeFixtureWideDto(Int index) {
+    WideDto dto;
+    dto.orderId = optional<int>(index);
+    dto.customerName = optional<StdString>(StdString("customerName ") + StdString(std::to_string(index).c_str()));
+    dto.isPriority = optional<bool>((index + 2) % 2 == 0);
+    dto.totalAmount = optional<double>(index * 0.5 + 3.25);
+    dto.itemCount = optional<int>(index + 4);
+    dto.shippingStreet = optional<StdString>(StdString("shippingStreet ") + StdString(std::to_string(index).c_str()));
+    dto.isGift = optional<bool>((index + 6) % 2 == 0);
+    dto.discountRate = optional<double>(index * 0.5 + 7.25);
+    dto.warehouseId = optional<int>(index + 8);
+    dto.shippingCity = optional<StdString>(StdString("shippingCity ") + StdString(std::to_string(index).c_str()));
+    dto.isInsured = optional<bool>((index + 10) % 2 == 0);
+    dto.taxAmount = optional<double>(index * 0.5 + 11.25);
+    dto.carrierId = optional<int>(index + 12);
+    dto.shippingState = optional<StdString>(StdString("shippingState ") + StdString(std::to_string(index).c_str()));
+    dto.isFragile = optional<bool>((index + 14) % 2 == 0);
+    dto.weightKg = optional<double>(index * 0.5 + 15.25);
+    dto.packageCount = optional<int>(index + 16);
+    dto.shippingZip = optional<StdString>(StdString("shippingZip ") + StdString(std::to_string(index).c_str()));
+    dto.isExpress = optional<bool>((index + 18) % 2 == 0);
+    dto.lengthCm = optional<double>(index * 0.5 + 19.25);
+    dto.routeId = optional<int>(index + 20);
+    dto.billingStreet = optional<StdString>(StdString("billingStreet ") + StdString(std::to_string(index).c_str()));
+    dto.isPaid = optional<bool>((index + 22) % 2 == 0);
+    dto.widthCm = optional<double>(index * 0.5 + 23.25);
+    dto.invoiceNumber = optional<int>(index + 24);
+    dto.billingCity = optional<StdString>(StdString("billingCity ") + StdString(std::to_string(index).c_str()));
+    dto.isRefundable = optional<bool>((index + 26) % 2 == 0);
+    dto.heightCm = optional<double>(index * 0.5 + 27.25);
+    dto.loyaltyPoints = optional<int>(index + 28);
+    dto.billingState = optional<StdString>(StdString("billingState ") + StdString(std::to_string(index).c_str()));
+    dto.isSubscribed = optional<bool>((index + 30) % 2 == 0);
+    dto.volumeLiters = optional<double>(index * 0.5 + 31.25);
+    dto.retryCount = optional<int>(index + 32);
+    dto.billingZip = optional<StdString>(StdString("billingZip ") + StdString(std::to_string(index).c_str()));
+    dto.isTracked = optional<bool>((index + 34) % 2 == 0);
+    dto.handlingFee = optional<double>(index * 0.5 + 35.25);
+    dto.regionCode = optional<int>(index + 36);
+    dto.contactEmail = optional<StdString>(StdString("contactEmail ") + StdString(std::to_string(index).c_str()));
+    dto.isVerified = optional<bool>((index + 38) % 2 == 0);
+    dto.exchangeRate = optional<double>(index * 0.5 + 39.25);
+    dto.channelId = optional<int>(index + 40);
+    dto.contactPhone = optional<StdString>(StdString("contactPhone ") + StdString(std::to_string(index).c_str()));
+    dto.isArchived = optional<bool>((index + 42) % 2 == 0);
+    dto.latitude = optional<double>(index * 0.5 + 43.25);
+    dto.priorityLevel = optional<int>(index + 44);
+    dto.couponCode = optional<StdString>(StdString("couponCode ") + StdString(std::to_string(index).c_str()));
+    dto.isReturned = optional<bool>((index + 46) % 2 == 0);
+    dto.longitude = optional<double>(index * 0.5 + 47.25);
+    dto.batchNumber = optional<int>(index + 48);
+    dto.notes = optional<StdString>(StdString("notes ") + StdString(std::to_string(index).c_str()));
+    return dto;
+}
+
+inline StdVector<Person> MakeFixturePersons(Int count) {
+    StdVector<Person> persons;
+    persons.reserve(count);
+    for (Int i = 0; i < count; i++) {
+        persons.push_back(MakeFixturePerson(i));
+    }
+    return persons;
+}
+
+inline StdVector<Address> MakeFixtureAddresses(Int count) {
+    StdVector<Address> addresses;
+    addresses.reserve(count);
+    for (Int i = 0; i < count; i++) {
+        addresses.push_back(MakeFixtureAddress(i));
+    }
+    return addresses;
+}
+
+inline StdVector<ProductX> MakeFixtureProducts(Int count) {
+    StdVector<ProductX> products;
+    products.reserve(count);
+    for (Int i = 0; i < count; i++) {
+        products.push_back(MakeFixtureProductX(i));
+    }
+    return products;
+}
+
+inline StdMap<StdString, Person> MakeFixturePersonMap(Int count) {
+    StdMap<StdString, Person> persons;
+    for (Int i = 0; i < count; i++) {
+        persons[StdString("p") + StdString(std::to_string(i).c_str())] = MakeFixturePerson(i);
+    }
+    return persons;
+}
+
+inline StdMap<StdString, ProductX> MakeFixtureProductMap(Int count) {
+    StdMap<StdString, ProductX> products;
+    for (Int i = 0; i < count; i++) {
+        products[StdString("sku") + StdString(std::to_string(i).c_str())] = MakeFixtureProductX(i);
+    }
+    return products;
+}
+
+// Nested container case: each key holds a short list of addresses
+inline StdMap<StdString, StdVector<Address>> MakeFixtureAddressBook(Int count) {
+    StdMap<StdString, StdVector<Address>> book;
+    for (Int i = 0; i < count; i++) {
+        StdVector<Address>& addresses = book[StdString("owner") + StdString(std::to_string(i).c_str())];
+        addresses.push_back(MakeFixtureAddress(i));
+        addresses.push_back(MakeFixtureAddress(i + 1));
+    }
+    return book;
+}
+
+// Order-independent text form of a value, used to compare results of unordered containers
+template<typename T>
+StdString CanonicalForm(const T& value) {
+    return nayan::serializer::SerializationUtility::Serialize(value);
+}
+
+template<typename T>
+StdString CanonicalForm(const StdUnorderedSet<T>& value) {
+    StdSet<StdString> ordered;
+    for (const T& element : value) {
+        ordered.insert(CanonicalForm(element));
+    }
+    StdString result;
+    for (CStdString& element : ordered) {
+        result += element + "|";
+    }
+    return result;
+}
+
+template<typename K, typename V>
+StdString CanonicalForm(const StdUnorderedMap<K, V>& value) {
+    StdMap<StdString, StdString> ordered;
+    for (const auto& entry : value) {
+        ordered[CanonicalForm(entry.first)] = CanonicalForm(entry.second);
+    }
+    StdString result;
+    for (const auto& entry : ordered) {
+        result += entry.first + "=" + entry.second + "|";
+    }
+    return result;
+}
+
+#endif // SERIALIZATION_FIXTURES_H
@@ -0,0 +1,500 @@
+#ifndef STREAMING_DESERIALIZER_TESTS_H
+#define STREAMING_DESERIALIZER_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+    #include <vector>
+    #include <map>
+    #include <set>
+    #include <forward_list>
+#else
+    #include <iostream>
+    #include <string>
+    #include <vector>
+    #include <map>
+    #include <set>
+    #include <forward_list>
+    #include <stdexcept>
+#endif
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include "../serializer/StreamingDeserializer.h"
+#include "../tests/TestUtils.h"
+#include "SerializationFixtures.h"
+
+using namespace nayan::serializer;
+
+// Test counters
+static int testsPassed_streaming = 0;
+static int testsFailed_streaming = 0;
+
+// Chunk sizes every case is streamed with; 1 puts every token on a chunk boundary
+static const Size kStreamingChunkSizes[] = {1, 3, 16, 256};
+
+// ========== HELPERS ==========
+
+// Streams json at every chunk size and checks the result matches what
+// SerializationUtility::Deserialize produces for the same input
+template<typename T>
+bool StreamMatchesSerializationUtility(CStdString& json) {
+    StdString expected = CanonicalForm(SerializationUtility::Deserialize<T>(json));
+    for (Size chunkSize : kStreamingChunkSizes) {
+        StringChunkSource source(json, chunkSize);
+        T streamed = StreamingDeserializer::Deserialize<T>(source);
+        if (CanonicalForm(streamed) != expected) {
+            std_print("  mismatch at chunk size ");
+            std_println(chunkSize);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Serializes value with SerializationUtility, then streams it back
+template<typename T>
+bool StreamRoundTripMatches(const T& value) {
+    StdString json = SerializationUtility::Serialize(value);
+    StdString expected = CanonicalForm(value);
+    for (Size chunkSize : kStreamingChunkSizes) {
+        StringChunkSource source(json, chunkSize);
+        T streamed = StreamingDeserializer::Deserialize<T>(source);
+        if (CanonicalForm(streamed) != expected) {
+            std_print("  mismatch at chunk size ");
+            std_println(chunkSize);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== PRIMITIVE ROUND TRIPS ==========
+
+bool TestStreamPrimitives() {
+    TEST_START("Test Stream Primitives");
+
+    ASSERT(StreamRoundTripMatches<int>(42), "int should round trip");
+    ASSERT(StreamRoundTripMatches<double>(3.14159), "double should round trip");
+    ASSERT(StreamRoundTripMatches<bool>(true), "bool true should round trip");
+    ASSERT(StreamRoundTripMatches<bool>(false), "bool false should round trip");
+    ASSERT(StreamRoundTripMatches<StdString>(StdString("Hello World")), "raw string should round trip");
+    ASSERT(StreamMatchesSerializationUtility<StdString>("\"Hello World\""), "quoted string should match");
+    ASSERT(StreamMatchesSerializationUtility<bool>("1"), "bool from 1 should match");
+    ASSERT(StreamMatchesSerializationUtility<bool>("0"), "bool from 0 should match");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== ENTITY ROUND TRIPS ==========
+
+bool TestStreamEntities() {
+    TEST_START("Test Stream Entities");
+
+    ASSERT(StreamRoundTripMatches(MakeFixturePerson(1)), "Person should round trip");
+    ASSERT(StreamRoundTripMatches(MakeFixtureAddress(1)), "Address should round trip");
+    ASSERT(StreamRoundTripMatches(MakeFixtureProductX(1)), "ProductX should round trip");
+
+    Person partial;
+    partial.id = optional<int>(3);
+    partial.name = optional<StdString>(StdString("Partial Person"));
+    ASSERT(StreamRoundTripMatches(partial), "partial Person should round trip");
+
+    ASSERT(StreamMatchesSerializationUtility<Person>(
+               "{\"id\":1,\"name\":\"John Doe\",\"age\":30,\"isActive\":true,\"salary\":50000.50}"),
+           "Person literal should match");
+    ASSERT(StreamMatchesSerializationUtility<Address>(
+               "{\"street\":\"123 Main St\",\"city\":\"New York\",\"state\":\"NY\",\"zipCode\":10001,\"isPrimary\":true}"),
+           "Address literal should match");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== OPTIONAL ROUND TRIPS ==========
+
+bool TestStreamOptionals() {
+    TEST_START("Test Stream Optionals");
+
+    ASSERT(StreamRoundTripMatches(optional<int>(123)), "optional<int> with value should round trip");
+    ASSERT(StreamRoundTripMatches(optional<int>()), "empty optional<int> should round trip");
+    ASSERT(StreamMatchesSerializationUtility<optional<int>>("null"), "optional<int> from null should match");
+    ASSERT(StreamMatchesSerializationUtility<optional<int>>(""), "optional<int> from empty input should match");
+    ASSERT(StreamMatchesSerializationUtility<optional<StdString>>("\"Hello World\""), "optional<string> should match");
+    ASSERT(StreamRoundTripMatches(optional<Person>(MakeFixturePerson(5))), "optional<Person> should round trip");
+    ASSERT(StreamMatchesSerializationUtility<optional<Person>>("null"), "optional<Person> from null should match");
+    ASSERT(StreamRoundTripMatches(optional<ProductX>(MakeFixtureProductX(101))), "optional<ProductX> should round trip");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== SEQUENTIAL CONTAINER ROUND TRIPS ==========
+
+bool TestStreamSequentialContainers() {
+    TEST_START("Test Stream Sequential Containers");
+
+    ASSERT(StreamRoundTripMatches(StdVector<int>{10, 20, 30, 40, 50}), "vector<int> should round trip");
+    ASSERT(StreamRoundTripMatches(StdList<StdString>{"apple", "banana", "cherry"}), "list<string> should round trip");
+    ASSERT(StreamRoundTripMatches(StdDeque<double>{3.14, 2.71, 1.41, 0.57}), "deque<double> should round trip");
+    ASSERT(StreamRoundTripMatches(StdSet<int>{5, 3, 8, 1, 9}), "set<int> should round trip");
+    ASSERT(StreamRoundTripMatches(StdUnorderedSet<StdString>{"red", "green", "blue"}), "unordered_set<string> should round trip");
+    ASSERT(StreamRoundTripMatches(StdArray<int, 4>{{1, 2, 3, 4}}), "array<int, 4> should round trip");
+    ASSERT(StreamRoundTripMatches(std::forward_list<int>{1, 2, 3}), "forward_list<int> should round trip");
+    ASSERT(StreamRoundTripMatches(StdVector<bool>{true, false, true, true, false}), "vector<bool> should round trip");
+    ASSERT(StreamRoundTripMatches(StdVector<int>()), "empty vector should round trip");
+    ASSERT(StreamMatchesSerializationUtility<StdVector<int>>("[]"), "empty array literal should match");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== ENTITY CONTAINER ROUND TRIPS ==========
+
+bool TestStreamEntityContainers() {
+    TEST_START("Test Stream Entity Containers");
+
+    ASSERT(StreamRoundTripMatches(MakeFixtureProducts(4)), "vector<ProductX> should round trip");
+    ASSERT(StreamRoundTripMatches(MakeFixtureProducts(100)), "large vector<ProductX> should round trip");
+
+    StdList<Person> persons;
+    persons.push_back(MakeFixturePerson(101));
+    persons.push_back(MakeFixturePerson(102));
+    ASSERT(StreamRoundTripMatches(persons), "list<Person> should round trip");
+
+    StdDeque<Address> addresses;
+    addresses.push_back(MakeFixtureAddress(0));
+    addresses.push_back(MakeFixtureAddress(1));
+    ASSERT(StreamRoundTripMatches(addresses), "deque<Address> should round trip");
+
+    StdArray<Address, 3> addressArray = {{MakeFixtureAddress(0), MakeFixtureAddress(1), MakeFixtureAddress(2)}};
+    ASSERT(StreamRoundTripMatches(addressArray), "array<Address, 3> should round trip");
+
+    StdVector<Person> emptyFields(2);
+    ASSERT(StreamRoundTripMatches(emptyFields), "vector<Person> with empty fields should round trip");
+
+    ASSERT(StreamMatchesSerializationUtility<StdDeque<Address>>("["
+               "{\"street\":\"123 Main St\",\"city\":\"New York\",\"state\":\"NY\",\"zipCode\":\"10001\",\"isPrimary\":true},"
+               "{\"street\":\"456 Oak Ave\",\"city\":\"Los Angeles\",\"state\":\"CA\",\"zipCode\":\"90001\",\"isPrimary\":false}"
+               "]"),
+           "deque<Address> literal should match");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== ASSOCIATIVE CONTAINER ROUND TRIPS ==========
+
+bool TestStreamAssociativeContainers() {
+    TEST_START("Test Stream Associative Containers");
+
+    StdMap<StdString, int> counts;
+    counts["apple"] = 10;
+    counts["banana"] = 20;
+    counts["cherry"] = 30;
+    ASSERT(StreamRoundTripMatches(counts), "map<string, int> should round trip");
+
+    StdMap<int, ProductX> productsById;
+    productsById[1001] = MakeFixtureProductX(1);
+    productsById[1002] = MakeFixtureProductX(2);
+    ASSERT(StreamRoundTripMatches(productsById), "map<int, ProductX> should round trip");
+
+    StdUnorderedMap<StdString, StdString> strings;
+    strings["key1"] = "value1";
+    strings["key2"] = "value2";
+    ASSERT(StreamRoundTripMatches(strings), "unordered_map<string, string> should round trip");
+
+    ASSERT(StreamRoundTripMatches(MakeFixturePersonMap(3)), "map<string, Person> should round trip");
+
+    StdMap<int, Address> addressesById;
+    addressesById[1] = MakeFixtureAddress(1);
+    addressesById[2] = MakeFixtureAddress(2);
+    ASSERT(StreamRoundTripMatches(addressesById), "map<int, Address> should round trip");
+
+    StdUnorderedMap<StdString, ProductX> productsByName;
+    productsByName["prod1"] = MakeFixtureProductX(1);
+    productsByName["prod2"] = MakeFixtureProductX(2);
+    ASSERT(StreamRoundTripMatches(productsByName), "unordered_map<string, ProductX> should round trip");
+
+    StdUnorderedMap<int, Person> personsById;
+    personsById[7] = MakeFixturePerson(7);
+    personsById[8] = MakeFixturePerson(8);
+    ASSERT(StreamRoundTripMatches(personsById), "unordered_map<int, Person> should round trip");
+
+    ASSERT(StreamRoundTripMatches(MakeFixtureAddressBook(3)), "map<string, vector<Address>> should round trip");
+
+    StdMap<int, StdList<ProductX>> productLists;
+    productLists[1].push_back(MakeFixtureProductX(1));
+    productLists[2].push_back(MakeFixtureProductX(2));
+    productLists[2].push_back(MakeFixtureProductX(3));
+    ASSERT(StreamRoundTripMatches(productLists), "map<int, list<ProductX>> should round trip");
+
+    typedef StdMap<StdString, int> CountMap;
+    ASSERT(StreamRoundTripMatches(CountMap()), "empty map should round trip");
+    ASSERT(StreamMatchesSerializationUtility<CountMap>("{}"), "empty object literal should match");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== SERIALIZATION UTILITY FIXTURES ==========
+
+// Every JSON input SerializationUtilityTests deserializes, streamed at every
+// chunk size, so the two deserializers are held to the same fixtures
+bool TestStreamSerializationUtilityFixtures() {
+    TEST_START("Test Stream SerializationUtility Fixtures");
+
+    ASSERT(StreamMatchesSerializationUtility<int>("42"), "int fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<double>("3.14159"), "double fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<bool>("true"), "bool true fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<bool>("false"), "bool false fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdString>("Hello World"), "raw string fixture should match");
+
+    ASSERT(StreamMatchesSerializationUtility<Person>("{\"id\":3,\"name\":\"Partial Person\"}"),
+           "partial Person fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<ProductX>(
+               "{\"productId\":101,\"productName\":\"Laptop\",\"price\":999.99,\"quantity\":50,\"inStock\":true}"),
+           "ProductX fixture should match");
+
+    ASSERT(StreamMatchesSerializationUtility<optional<int>>("42"), "optional<int> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<optional<Person>>(
+               "{\"id\":1,\"name\":\"John Doe\",\"age\":30,\"isActive\":true}"),
+           "optional<Person> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<optional<ProductX>>(
+               "{\"productId\":101,\"productName\":\"Laptop\",\"price\":999.99,\"quantity\":50,\"inStock\":true}"),
+           "optional<ProductX> fixture should match");
+
+    ASSERT(StreamMatchesSerializationUtility<StdVector<int>>("[10,20,30,40,50]"), "vector<int> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdList<StdString>>("[\"apple\",\"banana\",\"cherry\"]"),
+           "list<string> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdDeque<double>>("[3.14,2.71,1.41,0.57]"), "deque<double> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdSet<int>>("[5,3,8,1,9]"), "set<int> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdUnorderedSet<StdString>>("[\"red\",\"green\",\"blue\"]"),
+           "unordered_set<string> fixture should match");
+    typedef StdArray<int, 4> IntArray;
+    ASSERT(StreamMatchesSerializationUtility<IntArray>("[1,2,3,4]"), "array<int, 4> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdVector<bool>>("[true,false,true,true,false]"),
+           "vector<bool> fixture should match");
+
+    ASSERT(StreamMatchesSerializationUtility<StdVector<ProductX>>("["
+               "{\"productId\":401,\"productName\":\"Keyboard\",\"price\":79.99,\"quantity\":50,\"inStock\":true},"
+               "{\"productId\":402,\"productName\":\"Mouse\",\"price\":29.99,\"quantity\":100,\"inStock\":true},"
+               "{\"productId\":403,\"productName\":\"Monitor\",\"price\":299.99,\"quantity\":20,\"inStock\":false},"
+               "{\"productId\":404,\"productName\":\"Speaker\",\"price\":149.50,\"quantity\":30,\"inStock\":true}"
+               "]"),
+           "vector<ProductX> fixture should match");
+    ASSERT(StreamMatchesSerializationUtility<StdList<Person>>("["
+               "{\"id\":101,\"name\":\"Alice\",\"age\":30,\"isActive\":true,\"salary\":50000.0},"
+               "{\"id\":102,\"name\":\"Bob\",\"age\":25,\"isActive\":false,\"salary\":45000.0}"
+               "]"),
+           "list<Person> fixture should match");
+    typedef StdArray<Address, 3> AddressArray;
+    ASSERT(StreamMatchesSerializationUtility<AddressArray>("["
+               "{\"street\":\"100 First St\",\"city\":\"Boston\",\"state\":\"MA\",\"zipCode\":\"02101\",\"isPrimary\":true},"
+               "{\"street\":\"200 Second St\",\"city\":\"Chicago\",\"state\":\"IL\",\"zipCode\":\"60601\",\"isPrimary\":false},"
+               "{\"street\":\"300 Third St\",\"city\":\"Houston\",\"state\":\"TX\",\"zipCode\":\"77001\",\"isPrimary\":false}"
+               "]"),
+           "array<Address, 3> fixture should match");
+
+    typedef StdMap<StdString, int> CountMap;
+    ASSERT(StreamMatchesSerializationUtility<CountMap>("{\"apple\":10,\"banana\":20,\"cherry\":30}"),
+           "map<string, int> fixture should match");
+    typedef StdMap<StdString, ProductX> ProductMap;
+    ASSERT(StreamMatchesSerializationUtility<ProductMap>("{"
+               "\"1001\":{\"productId\":1001,\"productName\":\"Laptop\",\"price\":999.99,\"quantity\":5,\"inStock\":true},"
+               "\"1002\":{\"productId\":1002,\"productName\":\"Phone\",\"price\":699.99,\"quantity\":10,\"inStock\":true}"
+               "}"),
+           "map<string, ProductX> fixture should match");
+    typedef StdMap<StdString, Person> PersonMap;
+    ASSERT(StreamMatchesSerializationUtility<PersonMap>("{"
+               "\"alice\":{\"id\":201,\"name\":\"Alice Smith\",\"age\":28,\"isActive\":true,\"salary\":55000.0},"
+               "\"bob\":{\"id\":202,\"name\":\"Bob Jones\",\"age\":35,\"isActive\":true,\"salary\":60000.0}"
+               "}"),
+           "map<string, Person> fixture should match");
+    typedef StdUnorderedMap<StdString, StdString> StringMap;
+    ASSERT(StreamMatchesSerializationUtility<StringMap>("{\"key1\":\"value1\",\"key2\":\"value2\",\"key3\":\"value3\"}"),
+           "unordered_map<string, string> fixture should match");
+    typedef StdUnorderedMap<StdString, ProductX> ProductsByName;
+    ASSERT(StreamMatchesSerializationUtility<ProductsByName>("{"
+               "\"prod1\":{\"productId\":501,\"productName\":\"Tablet\",\"price\":399.99,\"quantity\":15,\"inStock\":true},"
+               "\"prod2\":{\"productId\":502,\"productName\":\"Watch\",\"price\":199.99,\"quantity\":25,\"inStock\":true}"
+               "}"),
+           "unordered_map<string, ProductX> fixture should match");
+
+    // Shapes SerializationUtilityTests only serializes
+    StdDeque<Person> people;
+    people.push_back(MakeFixturePerson(1));
+    people.push_back(MakeFixturePerson(2));
+    ASSERT(StreamRoundTripMatches(people), "deque<Person> should round trip");
+    ASSERT(StreamRoundTripMatches(MakeFixtureProductMap(3)), "map<string, ProductX> should round trip");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== GENERATED FIELD TABLES ==========
+
+bool TestStreamFieldTables() {
+    TEST_START("Test Stream Field Tables");
+
+    typedef SerializableFieldTable<WideDto> WideTable;
+    ASSERT(SerializableFieldTable<Person>::available, "Person should have a generated field table");
+    ASSERT(WideTable::available && WideTable::fieldCount == 50, "WideDto table should list all 50 fields");
+
+    Bool allFound = true;
+    for (Size i = 0; i < WideTable::fieldCount; i++) {
+        const FieldDescriptor<WideDto>& field = WideTable::fields[i];
+        allFound = allFound && FieldLookup<WideDto>::Find(field.name, field.length) == &field;
+    }
+    ASSERT(allFound, "Every key should hash to its own field");
+    ASSERT(FieldLookup<WideDto>::Find(StdString("notAField")) == nullptr, "Unknown keys should not match");
+    ASSERT(FieldLookup<Person>::Find(StdString("ids")) == nullptr, "Keys sharing a prefix should not match");
+
+    ASSERT(StreamRoundTripMatches(MakeFixtureWideDto(3)), "WideDto should round trip");
+    ASSERT(StreamMatchesSerializationUtility<Person>(
+               "{\"extra\":{\"nested\":[1,2]},\"name\":\"Jane\",\"id\":9,\"unused\":null,\"age\":41}"),
+           "Unknown keys should be skipped in any position");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// ========== BOUNDED MEMORY AND ERROR HANDLING ==========
+
+// Walks a large array one element at a time and checks the per-element buffer
+// never grows beyond a single element
+bool TestStreamBoundedMemory() {
+    TEST_START("Test Stream Bounded Memory");
+
+    const Int count = 5000;
+    StdString json = SerializationUtility::Serialize(MakeFixturePersons(count));
+    StdString singleElement = SerializationUtility::Serialize(MakeFixturePerson(count));
+
+    StringChunkSource source(json, 64);
+    JsonPullParser parser(source, 64, 128);
+    ASSERT(parser.Next() == JsonToken::BeginArray, "Input should start with an array");
+
+    Int elements = 0;
+    Size largestCapture = 0;
+    StdString& capture = parser.GetCaptureBuffer();
+    for (JsonToken token = parser.Next(); token != JsonToken::EndArray; token = parser.Next()) {
+        capture.clear();
+        parser.CaptureValue(token, capture);
+        if (capture.size() > largestCapture) {
+            largestCapture = capture.size();
+        }
+        elements++;
+    }
+
+    ASSERT(elements == count, "Every element should be visited");
+    ASSERT(largestCapture <= singleElement.size() + 16, "Per-element buffer should stay at one element");
+    ASSERT(parser.Next() == JsonToken::End, "Input should end after the array");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+bool TestStreamRejectsMalformedInput() {
+    TEST_START("Test Stream Rejects Malformed Input");
+
+    const char* malformed[] = {"[1,]", "[1 2]", "{\"a\" 1}", "{\"a\":1", "[1]x", "tru", "[\"unterminated]"};
+    Int rejected = 0;
+    for (const char* input : malformed) {
+        try {
+            StreamingDeserializer::Deserialize<StdVector<int>>(StdString(input));
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+    ASSERT(rejected == 7, "Every malformed input should be rejected");
+
+    // Numbers follow the JSON grammar, not just its characters
+    const char* badNumbers[] = {"[01]", "[1.]", "[-]", "[1e]", "[1e+]", "[1.2.3]", "[--1]", "[1-2]", "[1e5e1]", "[-.5]"};
+    rejected = 0;
+    for (const char* input : badNumbers) {
+        try {
+            StreamingDeserializer::Deserialize<StdVector<double>>(StdString(input));
+        } catch (const std::runtime_error&) {
+            rejected++;
+        }
+    }
+    ASSERT(rejected == 10, "Every malformed number should be rejected");
+    StdVector<double> numbers = StreamingDeserializer::Deserialize<StdVector<double>>(StdString("[0,-0,1.5e3,-2E-2,10,0.25e+1]"));
+    ASSERT(numbers.size() == 6 && numbers[2] == 1500 && numbers[3] == -0.02 && numbers[5] == 2.5,
+           "Well-formed numbers should be accepted");
+
+    // The error names where parsing stopped, also when the input arrives in pieces
+    const StdString leadingZero = "[1, 2, 01]";
+    for (Size chunk : {Size(0), Size(1), Size(3)}) {
+        StringChunkSource source(leadingZero, chunk);
+        StdString message;
+        try {
+            StreamingDeserializer::Deserialize<StdVector<int>>(source);
+        } catch (const std::runtime_error& error) {
+            message = error.what();
+        }
+        ASSERT(message.find("invalid number at offset 8") != StdString::npos, "The error should give the offset of the bad digit");
+    }
+
+    StreamingDeserializerOptions options;
+    options.maxTokenLength = 8;
+    Bool tokenLimitHit = false;
+    try {
+        StreamingDeserializer::Deserialize<StdVector<StdString>>(StdString("[\"far too long for the limit\"]"), options);
+    } catch (const std::runtime_error&) {
+        tokenLimitHit = true;
+    }
+    ASSERT(tokenLimitHit, "Tokens longer than maxTokenLength should be rejected");
+
+    testsPassed_streaming++;
+    return true;
+}
+
+// Main test runner function
+int RunAllStreamingDeserializerTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  StreamingDeserializer Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_streaming = 0;
+    testsFailed_streaming = 0;
+
+    if (!TestStreamPrimitives()) testsFailed_streaming++;
+    if (!TestStreamEntities()) testsFailed_streaming++;
+    if (!TestStreamOptionals()) testsFailed_streaming++;
+    if (!TestStreamSequentialContainers()) testsFailed_streaming++;
+    if (!TestStreamEntityContainers()) testsFailed_streaming++;
+    if (!TestStreamAssociativeContainers()) testsFailed_streaming++;
+    if (!TestStreamSerializationUtilityFixtures()) testsFailed_streaming++;
+    if (!TestStreamFieldTables()) testsFailed_streaming++;
+    if (!TestStreamBoundedMemory()) testsFailed_streaming++;
+    if (!TestStreamRejectsMalformedInput()) testsFailed_streaming++;
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_streaming);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_streaming);
+    std_print("Total Tests: ");
+    std_println(testsPassed_streaming + testsFailed_streaming);
+    std_println("========================================");
+    std_println("");
+
+    if (testsFailed_streaming == 0) {
+        std_println("✅ All streaming deserializer tests passed!");
+        return 0;
+    } else {
+        std_println("❌ Some streaming deserializer tests failed!");
+        return 1;
+    }
+}
+
+#endif // STREAMING_DESERIALIZER_TESTS_H
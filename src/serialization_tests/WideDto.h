@@ -0,0 +1,62 @@
+#ifndef WIDEDTO_H
+#define WIDEDTO_H
+
+#include <StandardDefines.h>
+#include <ArduinoJson.h>
+
+// 50 optional fields, used to measure per-key lookup cost on wide objects
+/* @Serializable */
+class WideDto {
+    Public optional<int> orderId;
+    Public optional<StdString> customerName;
+    Public optional<bool> isPriority;
+    Public optional<double> totalAmount;
+    Public optional<int> itemCount;
+    Public optional<StdString> shippingStreet;
+    Public optional<bool> isGift;
+    Public optional<double> discountRate;
+    Public optional<int> warehouseId;
+    Public optional<StdString> shippingCity;
+    Public optional<bool> isInsured;
+    Public optional<double> taxAmount;
+    Public optional<int> carrierId;
+    Public optional<StdString> shippingState;
+    Public optional<bool> isFragile;
+    Public optional<double> weightKg;
+    Public optional<int> packageCount;
+    Public optional<StdString> shippingZip;
+    Public optional<bool> isExpress;
+    Public optional<double> lengthCm;
+    Public optional<int> routeId;
+    Public optional<StdString> billingStreet;
+    Public optional<bool> isPaid;
+    Public optional<double> widthCm;
+    Public optional<int> invoiceNumber;
+    Public optional<StdString> billingCity;
+    Public optional<bool> isRefundable;
+    Public optional<double> heightCm;
+    Public optional<int> loyaltyPoints;
+    Public optional<StdString> billingState;
+    Public optional<bool> isSubscribed;
+    Public optional<double> volumeLiters;
+    Public optional<int> retryCount;
+    Public optional<StdString> billingZip;
+    Public optional<bool> isTracked;
+    Public optional<double> handlingFee;
+    Public optional<int> regionCode;
+    Public optional<StdString> contactEmail;
+    Public optional<bool> isVerified;
+    Public optional<double> exchangeRate;
+    Public optional<int> channelId;
+    Public optional<StdString> contactPhone;
+    Public optional<bool> isArchived;
+    Public optional<double> latitude;
+    Public optional<int> priorityLevel;
+    Public optional<StdString> couponCode;
+    Public optional<bool> isReturned;
+    Public optional<double> longitude;
+    Public optional<int> batchNumber;
+    Public optional<StdString> notes;
+};
+
+#endif // WIDEDTO_H
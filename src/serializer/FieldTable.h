@@ -0,0 +1,137 @@
+#ifndef FIELDTABLE_H
+#define FIELDTABLE_H
+
+#include <StandardDefines.h>
+#include <cstdint>
+#include "JsonPullParser.h"
+
+class StreamingDeserializerOptions;
+
+// 1 in test and benchmark targets: also include the field tables of the test fixtures
+#ifndef FIELDTABLE_TEST_FIXTURES
+#define FIELDTABLE_TEST_FIXTURES 0
+#endif
+
+/**
+ * Compile-time field metadata for serializable classes.
+ *
+ * scripts/generate_field_tables.py scans the sources for serializable classes
+ * and emits one SerializableFieldTable specialization per class: a constexpr
+ * array of FieldDescriptor plus a perfect hash from JSON key to field index.
+ * The hash has two levels (hash-and-displace): the key's FNV-1a hash picks a
+ * bucket, and the bucket's displacement remixes the same hash into a slot that
+ * no other key uses. Lookup is one pass over the key, two array reads and one
+ * compare to reject unknown keys, whatever the number of fields.
+ *
+ * Each table also reaches the members themselves, for codecs other than the
+ * streaming JSON reader:
+ *
+ *     ForEachField(visitor)       visitor(fields[i], &T::member) for every field, in order
+ *     VisitField(index, visitor)  visitor(&T::member) for fields[index]
+ */
+
+// Slot value meaning "no field"
+static constexpr uint8_t kEmptyFieldSlot = 0xFF;
+
+// FNV-1a over the key; must match field_key_hash() in the generator
+constexpr uint32_t FieldKeyHash(const char* key, Size length) {
+    uint32_t hash = 2166136261u;
+    for (Size i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Remixes a key hash with a bucket displacement; must match field_slot_mix() in the generator
+constexpr uint32_t FieldSlotMix(uint32_t hash, uint32_t displacement) {
+    hash += displacement * 0x9E3779B9u;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ * One field of a serializable class T
+ */
+template<typename T>
+struct FieldDescriptor {
+    typedef Void (*ReadFn)(JsonPullParser&, JsonToken, T&, const StreamingDeserializerOptions&);
+
+    // JSON key
+    const char* name;
+    Size length;
+
+    // Parses the field's value into its member of T
+    ReadFn read;
+};
+
+// No table for T: the streaming reader falls back to SerializationUtility.
+// Generated specializations define fields, slots, displacements and their counts.
+template<typename T>
+struct SerializableFieldTable {
+    Static constexpr Bool available = false;
+};
+
+/**
+ * Key lookup through a generated SerializableFieldTable
+ */
+template<typename T>
+class FieldLookup {
+    typedef SerializableFieldTable<T> Table;
+
+    /**
+     * @brief Field for a JSON key
+     * @return Descriptor, or nullptr when T has no such field
+     */
+    Public Static const FieldDescriptor<T>* Find(const char* key, Size length) {
+        uint8_t index = Table::slots[SlotFor(key, length)];
+        if (index == kEmptyFieldSlot) {
+            return nullptr;
+        }
+        const FieldDescriptor<T>& field = Table::fields[index];
+        if (field.length != length || !KeysEqual(field.name, key, length)) {
+            return nullptr;
+        }
+        return &field;
+    }
+
+    Public Static const FieldDescriptor<T>* Find(CStdString& key) {
+        return Find(key.data(), key.size());
+    }
+
+    /**
+     * @brief Check that every field hashes to its own slot
+     * Evaluated by a static_assert in the generated header, so a generator and
+     * runtime hash that disagree fail the build instead of losing fields.
+     */
+    Public Static constexpr Bool IsPerfect() {
+        for (Size i = 0; i < Table::fieldCount; i++) {
+            const FieldDescriptor<T>& field = Table::fields[i];
+            if (Table::slots[SlotFor(field.name, field.length)] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Private Static constexpr Size SlotFor(const char* key, Size length) {
+        uint32_t hash = FieldKeyHash(key, length);
+        uint32_t displacement = Table::displacements[hash % Table::bucketCount];
+        return FieldSlotMix(hash, displacement) & (Table::slotCount - 1);
+    }
+
+    Private Static Bool KeysEqual(const char* a, const char* b, Size length) {
+        for (Size i = 0; i < length; i++) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // FIELDTABLE_H
@@ -0,0 +1,81 @@
+#ifndef IJSONCHUNKSOURCE_H
+#define IJSONCHUNKSOURCE_H
+
+#include <StandardDefines.h>
+
+/**
+ * Chunked input for the streaming JSON parser.
+ * Implementations hand out the request body a piece at a time (socket reads,
+ * file reads, an in-memory string), so the parser never needs the whole body.
+ */
+DefineStandardPointers(IJsonChunkSource)
+class IJsonChunkSource {
+    Public Virtual ~IJsonChunkSource() = default;
+
+    /**
+     * @brief Read the next chunk of input
+     * @param buffer Destination buffer
+     * @param capacity Maximum number of bytes to write into buffer
+     * @return Number of bytes written, 0 once the input is exhausted
+     */
+    Public Virtual Size Read(char* buffer, Size capacity) = 0;
+
+    /**
+     * @brief Lend the rest of the input in place instead of copying it
+     * Sources whose input already sits in memory override this, so the
+     * parser reads it where it is.
+     * @param data Set to the first byte lent
+     * @return Number of bytes lent (and consumed), 0 when Read() must be used
+     */
+    Public Virtual Size Borrow(const char*& data) {
+        (Void)data;
+        return 0;
+    }
+};
+
+/**
+ * Chunk source over an in-memory string, such as a request body viewed in
+ * the connection's arena. Without maxChunkSize the parser reads the string
+ * in place; maxChunkSize limits how much a single Read hands out, which lets
+ * tests exercise token boundaries that fall between chunks.
+ */
+class StringChunkSource final : public IJsonChunkSource {
+    Private const char* data;
+    Private Size length;
+    Private Size position;
+    Private Size maxChunkSize;
+
+    Public StringChunkSource(const char* data, Size length, Size maxChunkSize = 0)
+        : data(data), length(length), position(0), maxChunkSize(maxChunkSize) {}
+
+    Public explicit StringChunkSource(CStdString& input, Size maxChunkSize = 0)
+        : StringChunkSource(input.data(), input.size(), maxChunkSize) {}
+
+    // The source only borrows its input, so temporaries are rejected
+    Public StringChunkSource(StdString&& input, Size maxChunkSize = 0) = delete;
+
+    Public Virtual Size Read(char* buffer, Size capacity) override {
+        Size remaining = length - position;
+        Size count = remaining < capacity ? remaining : capacity;
+        if (maxChunkSize > 0 && count > maxChunkSize) {
+            count = maxChunkSize;
+        }
+        for (Size i = 0; i < count; i++) {
+            buffer[i] = data[position + i];
+        }
+        position += count;
+        return count;
+    }
+
+    Public Virtual Size Borrow(const char*& borrowed) override {
+        if (maxChunkSize > 0) {
+            return 0;
+        }
+        borrowed = data + position;
+        Size count = length - position;
+        position = length;
+        return count;
+    }
+};
+
+#endif // IJSONCHUNKSOURCE_H
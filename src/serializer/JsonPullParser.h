@@ -0,0 +1,608 @@
+#ifndef JSONPULLPARSER_H
+#define JSONPULLPARSER_H
+
+#include <StandardDefines.h>
+#include <stdexcept>
+#include "IJsonChunkSource.h"
+
+// Tokens produced by JsonPullParser::Next()
+enum class JsonToken {
+    BeginObject,
+    EndObject,
+    BeginArray,
+    EndArray,
+    Key,        // Object member name, text available through GetText()
+    String,     // String value, unescaped text available through GetText()
+    Number,     // Number value, raw text available through GetText()
+    True,
+    False,
+    Null,
+    End         // End of input
+};
+
+/**
+ * Pull parser over a chunked JSON input.
+ *
+ * Memory use is fixed by the constructor arguments: one input window of
+ * chunkSize bytes (none when the source can lend its input in place), one token buffer capped at maxTokenLength and a nesting
+ * stack of kMaxDepth entries. Nothing grows with the number of array elements
+ * or object members, so arbitrarily long arrays can be consumed element by
+ * element. Malformed input and limit violations throw std::runtime_error
+ * giving the input offset where parsing stopped.
+ */
+class JsonPullParser {
+    Public Static const Size kDefaultChunkSize = 256;
+    Public Static const Size kDefaultMaxTokenLength = 1024;
+    Public Static const Size kMaxDepth = 32;
+
+    Private enum class State {
+        ValueExpected,          // Top level, after ':' or after ',' inside an array
+        ValueOrEndExpected,     // Right after '['
+        KeyExpected,            // After ',' inside an object
+        KeyOrEndExpected,       // Right after '{'
+        AfterValue,             // After a complete value
+        Done
+    };
+
+    Private IJsonChunkSource& source;
+    // Points into windowStorage, or into the source's own memory when it lends it
+    Private const char* window;
+    Private StdString windowStorage;
+    Private Size chunkSize;
+    Private Size windowPosition;
+    Private Size windowLength;
+    // Input offset of window[0]
+    Private Size windowOffset;
+    Private Bool sourceExhausted;
+
+    Private StdString text;
+    Private StdString captureBuffer;
+    Private Size maxTokenLength;
+
+    Private char containers[kMaxDepth];
+    Private Size depth;
+    Private State state;
+
+    Private Bool hasPeeked;
+    Private JsonToken peekedToken;
+
+    /**
+     * @brief Create a parser reading from source
+     * @param source Chunked input
+     * @param chunkSize Size of the input window filled on each source read
+     * @param maxTokenLength Longest string, key or number accepted
+     */
+    Public explicit JsonPullParser(IJsonChunkSource& source,
+                                   Size chunkSize = kDefaultChunkSize,
+                                   Size maxTokenLength = kDefaultMaxTokenLength)
+        : source(source), window(nullptr), chunkSize(chunkSize > 0 ? chunkSize : 1), windowPosition(0), windowLength(0),
+          windowOffset(0), sourceExhausted(false), maxTokenLength(maxTokenLength), depth(0), state(State::ValueExpected),
+          hasPeeked(false), peekedToken(JsonToken::End) {
+        // text is not reserved: short keys and numbers fit its inline buffer
+    }
+
+    /**
+     * @brief Advance to the next token
+     * @return The token; JsonToken::End once the top-level value is complete
+     */
+    Public JsonToken Next() {
+        if (hasPeeked) {
+            hasPeeked = false;
+            return peekedToken;
+        }
+        return ReadToken();
+    }
+
+    /**
+     * @brief Look at the next token without consuming it
+     * Overwrites GetText() with the text of the peeked token.
+     */
+    Public JsonToken Peek() {
+        if (!hasPeeked) {
+            peekedToken = ReadToken();
+            hasPeeked = true;
+        }
+        return peekedToken;
+    }
+
+    /**
+     * @brief Text of the last Key, String or Number token
+     */
+    Public CStdString& GetText() const {
+        return text;
+    }
+
+    /**
+     * @brief Input bytes read so far; error messages report it as the offset
+     */
+    Public Size GetOffset() const {
+        return windowOffset + windowPosition;
+    }
+
+    /**
+     * @brief Current nesting depth (0 at top level)
+     */
+    Public Size GetDepth() const {
+        return depth;
+    }
+
+    /**
+     * @brief Reusable scratch buffer for CaptureValue callers
+     */
+    Public StdString& GetCaptureBuffer() {
+        return captureBuffer;
+    }
+
+    /**
+     * @brief Skip the value that starts with token
+     * @param token Token just returned by Next()
+     */
+    Public Void SkipValue(JsonToken token) {
+        if (token != JsonToken::BeginObject && token != JsonToken::BeginArray) {
+            return;
+        }
+        Size targetDepth = depth - 1;
+        while (depth > targetDepth) {
+            if (Next() == JsonToken::End) {
+                Fail("unexpected end of input while skipping value");
+            }
+        }
+    }
+
+    /**
+     * @brief Re-emit the value that starts with token as compact JSON
+     * Used to hand a single array element or member to a whole-value parser
+     * while the surrounding document keeps streaming.
+     * @param token Token just returned by Next()
+     * @param out Receives the JSON text (appended)
+     * @param maxLength Longest value accepted, 0 for no limit
+     */
+    Public Void CaptureValue(JsonToken token, StdString& out, Size maxLength = 0) {
+        Size targetDepth = (token == JsonToken::BeginObject || token == JsonToken::BeginArray) ? depth - 1 : depth;
+        Size start = out.size();
+        while (true) {
+            AppendToken(token, out);
+            if (maxLength > 0 && out.size() - start > maxLength) {
+                Fail("captured value exceeds limit");
+            }
+            if (depth == targetDepth) {
+                return;
+            }
+            token = Next();
+            if (token == JsonToken::End) {
+                Fail("unexpected end of input while capturing value");
+            }
+        }
+    }
+
+    /**
+     * @brief First non-whitespace character of the remaining input, or -1 at end
+     * Only meaningful before the first token has been read.
+     */
+    Public Int PeekSignificantChar() {
+        SkipWhitespace();
+        return PeekChar();
+    }
+
+    /**
+     * @brief Append all remaining input to out without tokenizing it
+     * Only meaningful before the first token has been read.
+     */
+    Public Void ReadRemainingRaw(StdString& out) {
+        while (true) {
+            if (windowPosition < windowLength) {
+                out.append(window + windowPosition, windowLength - windowPosition);
+                windowPosition = windowLength;
+            }
+            if (!Fill()) {
+                break;
+            }
+        }
+        state = State::Done;
+    }
+
+    /**
+     * @brief Append text as a quoted, escaped JSON string
+     */
+    Public Static Void AppendQuoted(CStdString& value, StdString& out) {
+        static const char hex[] = "0123456789abcdef";
+        out.push_back('"');
+        for (char c : value) {
+            unsigned char uc = static_cast<unsigned char>(c);
+            switch (c) {
+                case '"': out.append("\\\""); break;
+                case '\\': out.append("\\\\"); break;
+                case '\b': out.append("\\b"); break;
+                case '\f': out.append("\\f"); break;
+                case '\n': out.append("\\n"); break;
+                case '\r': out.append("\\r"); break;
+                case '\t': out.append("\\t"); break;
+                default:
+                    if (uc < 0x20) {
+                        out.append("\\u00");
+                        out.push_back(hex[uc >> 4]);
+                        out.push_back(hex[uc & 0x0F]);
+                    } else {
+                        out.push_back(c);
+                    }
+                    break;
+            }
+        }
+        out.push_back('"');
+    }
+
+    Private Void AppendToken(JsonToken token, StdString& out) {
+        Bool isClosing = token == JsonToken::EndObject || token == JsonToken::EndArray;
+        if (!isClosing && !out.empty()) {
+            char last = out.back();
+            if (last != '{' && last != '[' && last != ':') {
+                out.push_back(',');
+            }
+        }
+        switch (token) {
+            case JsonToken::BeginObject: out.push_back('{'); break;
+            case JsonToken::EndObject: out.push_back('}'); break;
+            case JsonToken::BeginArray: out.push_back('['); break;
+            case JsonToken::EndArray: out.push_back(']'); break;
+            case JsonToken::Key: AppendQuoted(text, out); out.push_back(':'); break;
+            case JsonToken::String: AppendQuoted(text, out); break;
+            case JsonToken::Number: out.append(text); break;
+            case JsonToken::True: out.append("true"); break;
+            case JsonToken::False: out.append("false"); break;
+            case JsonToken::Null: out.append("null"); break;
+            case JsonToken::End: break;
+        }
+    }
+
+    Private Bool Fill() {
+        if (sourceExhausted) {
+            return false;
+        }
+        windowOffset += windowLength;
+        windowPosition = 0;
+        windowLength = source.Borrow(window);
+        if (windowLength > 0) {
+            // What is lent is the whole rest of the input
+            sourceExhausted = true;
+            return true;
+        }
+        // Allocated on first use, so parsing a lent input allocates no window
+        if (windowStorage.empty()) {
+            windowStorage.assign(chunkSize, '\0');
+        }
+        windowLength = source.Read(&windowStorage[0], windowStorage.size());
+        window = windowStorage.data();
+        if (windowLength == 0) {
+            sourceExhausted = true;
+            return false;
+        }
+        return true;
+    }
+
+    Private Int PeekChar() {
+        if (windowPosition >= windowLength && !Fill()) {
+            return -1;
+        }
+        return static_cast<unsigned char>(window[windowPosition]);
+    }
+
+    Private Int GetChar() {
+        Int c = PeekChar();
+        if (c >= 0) {
+            windowPosition++;
+        }
+        return c;
+    }
+
+    Private Void SkipWhitespace() {
+        while (true) {
+            Int c = PeekChar();
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                return;
+            }
+            windowPosition++;
+        }
+    }
+
+    Private [[noreturn]] Void Fail(const char* message) {
+        throw std::runtime_error(StdString("JsonPullParser: ") + message + " at offset " + std::to_string(GetOffset()));
+    }
+
+    Private Void Push(char container) {
+        if (depth >= kMaxDepth) {
+            Fail("nesting too deep");
+        }
+        containers[depth++] = container;
+    }
+
+    Private Void AppendTextChar(char c) {
+        if (text.size() >= maxTokenLength) {
+            Fail("token exceeds maximum length");
+        }
+        text.push_back(c);
+    }
+
+    Private Void AppendUtf8(UInt codePoint) {
+        if (codePoint < 0x80) {
+            AppendTextChar(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            AppendTextChar(static_cast<char>(0xC0 | (codePoint >> 6)));
+            AppendTextChar(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            AppendTextChar(static_cast<char>(0xE0 | (codePoint >> 12)));
+            AppendTextChar(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            AppendTextChar(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            AppendTextChar(static_cast<char>(0xF0 | (codePoint >> 18)));
+            AppendTextChar(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            AppendTextChar(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            AppendTextChar(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    Private UInt ReadHex4() {
+        UInt value = 0;
+        for (Int i = 0; i < 4; i++) {
+            Int c = GetChar();
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<UInt>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<UInt>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<UInt>(c - 'A' + 10);
+            } else {
+                Fail("invalid \\u escape");
+            }
+        }
+        return value;
+    }
+
+    // Reads a string body; the opening quote has already been consumed
+    Private Void ReadString() {
+        text.clear();
+        while (true) {
+            // Copy runs of plain characters straight out of the window
+            while (windowPosition < windowLength) {
+                char c = window[windowPosition];
+                if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                    break;
+                }
+                AppendTextChar(c);
+                windowPosition++;
+            }
+            Int c = GetChar();
+            if (c < 0) {
+                Fail("unterminated string");
+            }
+            if (c == '"') {
+                return;
+            }
+            if (c < 0x20) {
+                Fail("control character in string");
+            }
+            if (c != '\\') {
+                AppendTextChar(static_cast<char>(c));
+                continue;
+            }
+            Int escaped = GetChar();
+            switch (escaped) {
+                case '"': AppendTextChar('"'); break;
+                case '\\': AppendTextChar('\\'); break;
+                case '/': AppendTextChar('/'); break;
+                case 'b': AppendTextChar('\b'); break;
+                case 'f': AppendTextChar('\f'); break;
+                case 'n': AppendTextChar('\n'); break;
+                case 'r': AppendTextChar('\r'); break;
+                case 't': AppendTextChar('\t'); break;
+                case 'u': {
+                    UInt codePoint = ReadHex4();
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        if (GetChar() != '\\' || GetChar() != 'u') {
+                            Fail("unpaired surrogate");
+                        }
+                        UInt low = ReadHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            Fail("unpaired surrogate");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(codePoint);
+                    break;
+                }
+                default:
+                    Fail("invalid escape sequence");
+            }
+        }
+    }
+
+    // -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+    Private Void ReadNumber() {
+        text.clear();
+        if (PeekChar() == '-') {
+            TakeNumberChar();
+        }
+        Int c = PeekChar();
+        if (c == '0') {
+            TakeNumberChar();
+        } else if (ReadDigits() == 0) {
+            Fail("invalid number");
+        }
+        if (PeekChar() == '.') {
+            TakeNumberChar();
+            if (ReadDigits() == 0) {
+                Fail("invalid number");
+            }
+        }
+        c = PeekChar();
+        if (c == 'e' || c == 'E') {
+            TakeNumberChar();
+            c = PeekChar();
+            if (c == '+' || c == '-') {
+                TakeNumberChar();
+            }
+            if (ReadDigits() == 0) {
+                Fail("invalid number");
+            }
+        }
+        // e.g. "01", "1.2.3" or "1e5e"
+        c = PeekChar();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            Fail("invalid number");
+        }
+    }
+
+    Private Size ReadDigits() {
+        Size count = 0;
+        for (Int c = PeekChar(); c >= '0' && c <= '9'; c = PeekChar()) {
+            TakeNumberChar();
+            count++;
+        }
+        return count;
+    }
+
+    Private Void TakeNumberChar() {
+        AppendTextChar(static_cast<char>(window[windowPosition]));
+        windowPosition++;
+    }
+
+    Private Void ExpectLiteral(const char* rest) {
+        for (const char* p = rest; *p != '\0'; p++) {
+            if (GetChar() != *p) {
+                Fail("invalid literal");
+            }
+        }
+    }
+
+    Private JsonToken ReadValue(Int c) {
+        switch (c) {
+            case '{':
+                windowPosition++;
+                Push('o');
+                state = State::KeyOrEndExpected;
+                return JsonToken::BeginObject;
+            case '[':
+                windowPosition++;
+                Push('a');
+                state = State::ValueOrEndExpected;
+                return JsonToken::BeginArray;
+            case '"':
+                windowPosition++;
+                ReadString();
+                state = State::AfterValue;
+                return JsonToken::String;
+            case 't':
+                windowPosition++;
+                ExpectLiteral("rue");
+                state = State::AfterValue;
+                return JsonToken::True;
+            case 'f':
+                windowPosition++;
+                ExpectLiteral("alse");
+                state = State::AfterValue;
+                return JsonToken::False;
+            case 'n':
+                windowPosition++;
+                ExpectLiteral("ull");
+                state = State::AfterValue;
+                return JsonToken::Null;
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    ReadNumber();
+                    state = State::AfterValue;
+                    return JsonToken::Number;
+                }
+                Fail("unexpected character");
+        }
+    }
+
+    Private JsonToken ReadKey() {
+        windowPosition++;
+        ReadString();
+        SkipWhitespace();
+        if (GetChar() != ':') {
+            Fail("expected ':' after object key");
+        }
+        state = State::ValueExpected;
+        return JsonToken::Key;
+    }
+
+    Private JsonToken Close(JsonToken token) {
+        windowPosition++;
+        depth--;
+        state = depth == 0 ? State::Done : State::AfterValue;
+        return token;
+    }
+
+    Private JsonToken ReadToken() {
+        while (true) {
+            SkipWhitespace();
+            Int c = PeekChar();
+            switch (state) {
+                case State::Done:
+                    if (c >= 0) {
+                        Fail("trailing characters after value");
+                    }
+                    return JsonToken::End;
+
+                case State::ValueExpected:
+                    if (c < 0) {
+                        if (depth == 0) {
+                            state = State::Done;
+                            return JsonToken::End;
+                        }
+                        Fail("unexpected end of input");
+                    }
+                    {
+                        JsonToken token = ReadValue(c);
+                        if (depth == 0 && state == State::AfterValue) {
+                            state = State::Done;
+                        }
+                        return token;
+                    }
+
+                case State::ValueOrEndExpected:
+                    if (c == ']') {
+                        return Close(JsonToken::EndArray);
+                    }
+                    if (c < 0) {
+                        Fail("unexpected end of input");
+                    }
+                    return ReadValue(c);
+
+                case State::KeyOrEndExpected:
+                    if (c == '}') {
+                        return Close(JsonToken::EndObject);
+                    }
+                    if (c != '"') {
+                        Fail("expected object key");
+                    }
+                    return ReadKey();
+
+                case State::KeyExpected:
+                    if (c != '"') {
+                        Fail("expected object key");
+                    }
+                    return ReadKey();
+
+                case State::AfterValue: {
+                    char container = containers[depth - 1];
+                    if (c == ',') {
+                        windowPosition++;
+                        state = container == 'o' ? State::KeyExpected : State::ValueExpected;
+                        continue;
+                    }
+                    if (c == '}' && container == 'o') {
+                        return Close(JsonToken::EndObject);
+                    }
+                    if (c == ']' && container == 'a') {
+                        return Close(JsonToken::EndArray);
+                    }
+                    Fail(c < 0 ? "unexpected end of input" : "expected ',' or closing bracket");
+                }
+            }
+        }
+    }
+};
+
+#endif // JSONPULLPARSER_H
@@ -0,0 +1,582 @@
+#ifndef MESSAGEPACK_H
+#define MESSAGEPACK_H
+
+#include <StandardDefines.h>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include "IJsonChunkSource.h"
+#include "JsonPullParser.h"
+#include "NumberFormat.h"
+
+// Wire types as seen by MessagePackReader::PeekType()
+enum class MessagePackType {
+    Nil,
+    Boolean,
+    Integer,
+    Float,
+    String,
+    Binary,
+    Array,
+    Map,
+    Extension,
+    End         // No more input
+};
+
+/**
+ * Appends MessagePack-encoded values to a byte string.
+ * Integers and containers always use the smallest encoding that fits.
+ */
+class MessagePackWriter {
+    Private StdString& out;
+
+    Public explicit MessagePackWriter(StdString& out) : out(out) {}
+
+    Public StdString& GetBuffer() {
+        return out;
+    }
+
+    Public Void WriteNil() {
+        out.push_back(static_cast<char>(0xC0));
+    }
+
+    Public Void WriteBool(Bool value) {
+        out.push_back(static_cast<char>(value ? 0xC3 : 0xC2));
+    }
+
+    Public Void WriteInt(int64_t value) {
+        if (value >= 0) {
+            WriteUInt(static_cast<uint64_t>(value));
+        } else if (value >= -32) {
+            out.push_back(static_cast<char>(static_cast<uint8_t>(value)));
+        } else if (value >= INT8_MIN) {
+            out.push_back(static_cast<char>(0xD0));
+            out.push_back(static_cast<char>(static_cast<uint8_t>(value)));
+        } else if (value >= INT16_MIN) {
+            out.push_back(static_cast<char>(0xD1));
+            WriteBigEndian(static_cast<uint16_t>(value), 2);
+        } else if (value >= INT32_MIN) {
+            out.push_back(static_cast<char>(0xD2));
+            WriteBigEndian(static_cast<uint32_t>(value), 4);
+        } else {
+            out.push_back(static_cast<char>(0xD3));
+            WriteBigEndian(static_cast<uint64_t>(value), 8);
+        }
+    }
+
+    Public Void WriteUInt(uint64_t value) {
+        if (value <= 0x7F) {
+            out.push_back(static_cast<char>(value));
+        } else if (value <= 0xFF) {
+            out.push_back(static_cast<char>(0xCC));
+            out.push_back(static_cast<char>(value));
+        } else if (value <= 0xFFFF) {
+            out.push_back(static_cast<char>(0xCD));
+            WriteBigEndian(value, 2);
+        } else if (value <= 0xFFFFFFFFULL) {
+            out.push_back(static_cast<char>(0xCE));
+            WriteBigEndian(value, 4);
+        } else {
+            out.push_back(static_cast<char>(0xCF));
+            WriteBigEndian(value, 8);
+        }
+    }
+
+    Public Void WriteFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out.push_back(static_cast<char>(0xCA));
+        WriteBigEndian(bits, 4);
+    }
+
+    Public Void WriteDouble(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out.push_back(static_cast<char>(0xCB));
+        WriteBigEndian(bits, 8);
+    }
+
+    Public Void WriteString(const char* data, Size length) {
+        if (length < 32) {
+            out.push_back(static_cast<char>(0xA0 | length));
+        } else if (length <= 0xFF) {
+            out.push_back(static_cast<char>(0xD9));
+            out.push_back(static_cast<char>(length));
+        } else if (length <= 0xFFFF) {
+            out.push_back(static_cast<char>(0xDA));
+            WriteBigEndian(length, 2);
+        } else {
+            out.push_back(static_cast<char>(0xDB));
+            WriteBigEndian(length, 4);
+        }
+        out.append(data, length);
+    }
+
+    Public Void WriteString(CStdString& value) {
+        WriteString(value.data(), value.size());
+    }
+
+    Public Void WriteArrayHeader(Size count) {
+        WriteContainerHeader(count, 0x90, 0xDC, 0xDD);
+    }
+
+    Public Void WriteMapHeader(Size count) {
+        WriteContainerHeader(count, 0x80, 0xDE, 0xDF);
+    }
+
+    /**
+     * @brief Reserve a header for a container whose size is not known yet
+     * @return Position to pass to PatchContainerHeader once the elements are written
+     */
+    Public Size BeginContainer() {
+        Size position = out.size();
+        out.append(5, '\0');
+        return position;
+    }
+
+    /**
+     * @brief Fill in a header reserved by BeginContainer, shrinking it to the smallest encoding
+     */
+    Public Void PatchContainerHeader(Size position, Bool isMap, Size count) {
+        StdString header;
+        MessagePackWriter headerWriter(header);
+        if (isMap) {
+            headerWriter.WriteMapHeader(count);
+        } else {
+            headerWriter.WriteArrayHeader(count);
+        }
+        out.replace(position, 5, header);
+    }
+
+    Private Void WriteContainerHeader(Size count, uint8_t fixBase, uint8_t marker16, uint8_t marker32) {
+        if (count < 16) {
+            out.push_back(static_cast<char>(fixBase | count));
+        } else if (count <= 0xFFFF) {
+            out.push_back(static_cast<char>(marker16));
+            WriteBigEndian(count, 2);
+        } else {
+            out.push_back(static_cast<char>(marker32));
+            WriteBigEndian(count, 4);
+        }
+    }
+
+    Private Void WriteBigEndian(uint64_t value, Int bytes) {
+        for (Int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+};
+
+/**
+ * Reads MessagePack values from a byte range.
+ * Type mismatches and truncated input throw std::runtime_error.
+ */
+class MessagePackReader {
+    Public Static const Size kMaxDepth = 32;
+
+    Private const uint8_t* data;
+    Private Size length;
+    Private Size position;
+
+    Public MessagePackReader(const char* data, Size length)
+        : data(reinterpret_cast<const uint8_t*>(data)), length(length), position(0) {}
+
+    Public explicit MessagePackReader(CStdString& input) : MessagePackReader(input.data(), input.size()) {}
+
+    Public MessagePackReader(StdString&& input, Size = 0) = delete;
+
+    Public Bool AtEnd() const {
+        return position >= length;
+    }
+
+    Public Size GetPosition() const {
+        return position;
+    }
+
+    Public MessagePackType PeekType() const {
+        if (position >= length) {
+            return MessagePackType::End;
+        }
+        uint8_t marker = data[position];
+        if (marker <= 0x7F || marker >= 0xE0) return MessagePackType::Integer;
+        if (marker <= 0x8F) return MessagePackType::Map;
+        if (marker <= 0x9F) return MessagePackType::Array;
+        if (marker <= 0xBF) return MessagePackType::String;
+        switch (marker) {
+            case 0xC0: return MessagePackType::Nil;
+            case 0xC2:
+            case 0xC3: return MessagePackType::Boolean;
+            case 0xC4:
+            case 0xC5:
+            case 0xC6: return MessagePackType::Binary;
+            case 0xCA:
+            case 0xCB: return MessagePackType::Float;
+            case 0xCC: case 0xCD: case 0xCE: case 0xCF:
+            case 0xD0: case 0xD1: case 0xD2: case 0xD3: return MessagePackType::Integer;
+            case 0xD9: case 0xDA: case 0xDB: return MessagePackType::String;
+            case 0xDC: case 0xDD: return MessagePackType::Array;
+            case 0xDE: case 0xDF: return MessagePackType::Map;
+            default: return MessagePackType::Extension;
+        }
+    }
+
+    // True when the next value is an unsigned integer too large for int64_t
+    Public Bool IsLargeUnsigned() const {
+        return length - position > 8 && data[position] == 0xCF && (data[position + 1] & 0x80) != 0;
+    }
+
+    Public Void ReadNil() {
+        Expect(0xC0, "nil");
+    }
+
+    Public Bool ReadBool() {
+        uint8_t marker = Take();
+        if (marker == 0xC3) return true;
+        if (marker == 0xC2) return false;
+        Fail("expected boolean");
+    }
+
+    Public int64_t ReadInt() {
+        uint8_t marker = Take();
+        if (marker <= 0x7F) return marker;
+        if (marker >= 0xE0) return static_cast<int8_t>(marker);
+        switch (marker) {
+            case 0xCC: return static_cast<int64_t>(ReadBigEndian(1));
+            case 0xCD: return static_cast<int64_t>(ReadBigEndian(2));
+            case 0xCE: return static_cast<int64_t>(ReadBigEndian(4));
+            case 0xCF: return static_cast<int64_t>(ReadBigEndian(8));
+            case 0xD0: return static_cast<int8_t>(ReadBigEndian(1));
+            case 0xD1: return static_cast<int16_t>(ReadBigEndian(2));
+            case 0xD2: return static_cast<int32_t>(ReadBigEndian(4));
+            case 0xD3: return static_cast<int64_t>(ReadBigEndian(8));
+            case 0xCA: return static_cast<int64_t>(ReadFloatBody());
+            case 0xCB: return static_cast<int64_t>(ReadDoubleBody());
+            default: Fail("expected integer");
+        }
+    }
+
+    Public uint64_t ReadUInt() {
+        if (position < length && data[position] == 0xCF) {
+            position++;
+            return ReadBigEndian(8);
+        }
+        return static_cast<uint64_t>(ReadInt());
+    }
+
+    Public double ReadDouble() {
+        Require(1);
+        uint8_t marker = data[position];
+        if (marker == 0xCA) {
+            position++;
+            return ReadFloatBody();
+        }
+        if (marker == 0xCB) {
+            position++;
+            return ReadDoubleBody();
+        }
+        if (marker == 0xCF) {
+            return static_cast<double>(ReadUInt());
+        }
+        return static_cast<double>(ReadInt());
+    }
+
+    Public Void ReadString(StdString& value) {
+        Size size = ReadStringLength();
+        Require(size);
+        value.assign(reinterpret_cast<const char*>(data + position), size);
+        position += size;
+    }
+
+    Public Size ReadArrayHeader() {
+        uint8_t marker = Take();
+        if ((marker & 0xF0) == 0x90) return marker & 0x0F;
+        if (marker == 0xDC) return static_cast<Size>(ReadBigEndian(2));
+        if (marker == 0xDD) return static_cast<Size>(ReadBigEndian(4));
+        Fail("expected array");
+    }
+
+    Public Size ReadMapHeader() {
+        uint8_t marker = Take();
+        if ((marker & 0xF0) == 0x80) return marker & 0x0F;
+        if (marker == 0xDE) return static_cast<Size>(ReadBigEndian(2));
+        if (marker == 0xDF) return static_cast<Size>(ReadBigEndian(4));
+        Fail("expected map");
+    }
+
+    /**
+     * @brief Skip one complete value, including nested containers
+     */
+    Public Void Skip() {
+        SkipValue(0);
+    }
+
+    Private Void SkipValue(Size depth) {
+        if (depth > kMaxDepth) {
+            Fail("nesting too deep");
+        }
+        switch (PeekType()) {
+            case MessagePackType::Nil:
+            case MessagePackType::Boolean:
+                position++;
+                break;
+            case MessagePackType::Integer:
+                ReadUInt();
+                break;
+            case MessagePackType::Float:
+                ReadDouble();
+                break;
+            case MessagePackType::String: {
+                Size size = ReadStringLength();
+                Require(size);
+                position += size;
+                break;
+            }
+            case MessagePackType::Array: {
+                Size count = ReadArrayHeader();
+                for (Size i = 0; i < count; i++) {
+                    SkipValue(depth + 1);
+                }
+                break;
+            }
+            case MessagePackType::Map: {
+                Size count = ReadMapHeader();
+                for (Size i = 0; i < count * 2; i++) {
+                    SkipValue(depth + 1);
+                }
+                break;
+            }
+            default:
+                Fail("unsupported type");
+        }
+    }
+
+    Private Size ReadStringLength() {
+        uint8_t marker = Take();
+        if ((marker & 0xE0) == 0xA0) return marker & 0x1F;
+        if (marker == 0xD9) return static_cast<Size>(ReadBigEndian(1));
+        if (marker == 0xDA) return static_cast<Size>(ReadBigEndian(2));
+        if (marker == 0xDB) return static_cast<Size>(ReadBigEndian(4));
+        Fail("expected string");
+    }
+
+    Private float ReadFloatBody() {
+        uint32_t bits = static_cast<uint32_t>(ReadBigEndian(4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    Private double ReadDoubleBody() {
+        uint64_t bits = ReadBigEndian(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    Private uint8_t Take() {
+        Require(1);
+        return data[position++];
+    }
+
+    Private Void Expect(uint8_t marker, const char* what) {
+        if (Take() != marker) {
+            Fail(what);
+        }
+    }
+
+    Private Void Require(Size count) {
+        if (count > length - position) {
+            Fail("truncated input");
+        }
+    }
+
+    Private uint64_t ReadBigEndian(Int bytes) {
+        Require(static_cast<Size>(bytes));
+        uint64_t value = 0;
+        for (Int i = 0; i < bytes; i++) {
+            value = (value << 8) | data[position++];
+        }
+        return value;
+    }
+
+    Private [[noreturn]] Void Fail(const char* message) const {
+        throw std::runtime_error(StdString("MessagePackReader: ") + message);
+    }
+};
+
+/**
+ * Converts between JSON text and MessagePack.
+ * Used for serializable classes, whose field layout is only known to
+ * SerializationUtility: their JSON form is transcoded, so both wire formats
+ * carry exactly the same fields and names.
+ */
+class MessagePackTranscoder {
+    /**
+     * @brief Transcode one JSON value (the whole input) into MessagePack
+     */
+    Public Static Void FromJson(CStdString& json, MessagePackWriter& writer) {
+        StringChunkSource source(json);
+        JsonPullParser parser(source);
+        JsonToken token = parser.Next();
+        if (token == JsonToken::End) {
+            writer.WriteNil();
+            return;
+        }
+        FromJsonValue(parser, token, writer);
+    }
+
+    /**
+     * @brief Transcode one value from the parser into MessagePack
+     * @param token First token of the value, already consumed
+     */
+    Public Static Void FromJsonValue(JsonPullParser& parser, JsonToken token, MessagePackWriter& writer) {
+        Size headers[JsonPullParser::kMaxDepth];
+        Size counts[JsonPullParser::kMaxDepth];
+        Bool isMap[JsonPullParser::kMaxDepth];
+        Size level = 0;
+        while (true) {
+            switch (token) {
+                case JsonToken::BeginObject:
+                case JsonToken::BeginArray:
+                    if (level > 0) counts[level - 1]++;
+                    headers[level] = writer.BeginContainer();
+                    counts[level] = 0;
+                    isMap[level] = token == JsonToken::BeginObject;
+                    level++;
+                    break;
+                case JsonToken::EndObject:
+                case JsonToken::EndArray:
+                    level--;
+                    writer.PatchContainerHeader(headers[level], isMap[level], counts[level]);
+                    break;
+                case JsonToken::Key:
+                    writer.WriteString(parser.GetText());
+                    break;
+                default:
+                    if (level > 0) counts[level - 1]++;
+                    WriteScalar(parser, token, writer);
+                    break;
+            }
+            if (level == 0) {
+                return;
+            }
+            token = parser.Next();
+        }
+    }
+
+    /**
+     * @brief Transcode one MessagePack value into JSON text (appended to out)
+     */
+    Public Static Void ToJson(MessagePackReader& reader, StdString& out) {
+        ToJsonValue(reader, out, 0);
+    }
+
+    Private Static Void WriteScalar(JsonPullParser& parser, JsonToken token, MessagePackWriter& writer) {
+        switch (token) {
+            case JsonToken::String:
+                writer.WriteString(parser.GetText());
+                break;
+            case JsonToken::True:
+                writer.WriteBool(true);
+                break;
+            case JsonToken::False:
+                writer.WriteBool(false);
+                break;
+            case JsonToken::Null:
+                writer.WriteNil();
+                break;
+            case JsonToken::Number: {
+                CStdString& text = parser.GetText();
+                const char* first = text.data();
+                const char* last = first + text.size();
+                int64_t signedValue = 0;
+                uint64_t unsignedValue = 0;
+                double floatValue = 0;
+                if (text[0] == '-' && NumberFormat::ParseInt(first, last, signedValue) == text.size()) {
+                    writer.WriteInt(signedValue);
+                } else if (text[0] != '-' && NumberFormat::ParseUInt(first, last, unsignedValue) == text.size()) {
+                    writer.WriteUInt(unsignedValue);
+                } else {
+                    // Decimals, exponents and integers beyond 64 bits
+                    NumberFormat::ParseDouble(first, last, floatValue);
+                    writer.WriteDouble(floatValue);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    Private Static Void ToJsonValue(MessagePackReader& reader, StdString& out, Size depth) {
+        if (depth > MessagePackReader::kMaxDepth) {
+            throw std::runtime_error("MessagePackTranscoder: nesting too deep");
+        }
+        switch (reader.PeekType()) {
+            case MessagePackType::Nil:
+                reader.ReadNil();
+                out.append("null");
+                break;
+            case MessagePackType::Boolean:
+                out.append(reader.ReadBool() ? "true" : "false");
+                break;
+            case MessagePackType::Integer:
+                if (reader.IsLargeUnsigned()) {
+                    NumberFormat::AppendUInt(reader.ReadUInt(), out);
+                } else {
+                    NumberFormat::AppendInt(reader.ReadInt(), out);
+                }
+                break;
+            case MessagePackType::Float: {
+                double value = reader.ReadDouble();
+                if (std::isfinite(value)) {
+                    NumberFormat::AppendDouble(value, out);
+                } else {
+                    out.append("null");
+                }
+                break;
+            }
+            case MessagePackType::String: {
+                StdString text;
+                reader.ReadString(text);
+                JsonPullParser::AppendQuoted(text, out);
+                break;
+            }
+            case MessagePackType::Array: {
+                Size count = reader.ReadArrayHeader();
+                out.push_back('[');
+                for (Size i = 0; i < count; i++) {
+                    if (i > 0) out.push_back(',');
+                    ToJsonValue(reader, out, depth + 1);
+                }
+                out.push_back(']');
+                break;
+            }
+            case MessagePackType::Map: {
+                Size count = reader.ReadMapHeader();
+                out.push_back('{');
+                for (Size i = 0; i < count; i++) {
+                    if (i > 0) out.push_back(',');
+                    if (reader.PeekType() == MessagePackType::String) {
+                        ToJsonValue(reader, out, depth + 1);
+                    } else {
+                        // JSON member names are strings, so non-string keys are quoted
+                        StdString key;
+                        ToJsonValue(reader, key, depth + 1);
+                        JsonPullParser::AppendQuoted(key, out);
+                    }
+                    out.push_back(':');
+                    ToJsonValue(reader, out, depth + 1);
+                }
+                out.push_back('}');
+                break;
+            }
+            default:
+                throw std::runtime_error("MessagePackTranscoder: unsupported type");
+        }
+    }
+};
+
+#endif // MESSAGEPACK_H
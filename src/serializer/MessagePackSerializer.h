@@ -0,0 +1,418 @@
+#ifndef MESSAGEPACKSERIALIZER_H
+#define MESSAGEPACKSERIALIZER_H
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <array>
+#include <forward_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "MessagePack.h"
+#include "StreamingDeserializer.h"
+
+// Writes / reads one value of type T as MessagePack. Specializations below cover
+// primitives, optional, the STL containers and serializable classes with a
+// generated field table natively; everything else falls through to the
+// primary template.
+template<typename T, typename Enable = void>
+struct MessagePackCodec {
+    // Enums and serializable classes without a field table: SerializationUtility
+    // owns the layout, so the JSON form is transcoded. Field names and omitted fields match JSON exactly.
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        MessagePackTranscoder::FromJson(nayan::serializer::SerializationUtility::Serialize(value), writer);
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        StdString json;
+        if (reader.PeekType() == MessagePackType::Nil) {
+            reader.ReadNil();
+        } else {
+            MessagePackTranscoder::ToJson(reader, json);
+        }
+        out = nayan::serializer::SerializationUtility::Deserialize<T>(json);
+    }
+};
+
+namespace msgpack_detail {
+
+    template<typename T> struct IsArray : std::false_type {};
+    template<typename T, std::size_t N> struct IsArray<std::array<T, N>> : std::true_type {};
+
+    template<typename T> struct IsForwardList : std::false_type {};
+    template<typename T, typename A> struct IsForwardList<std::forward_list<T, A>> : std::true_type {};
+
+    template<typename K>
+    inline Void WriteKey(MessagePackWriter& writer, const K& key) {
+        if constexpr (std::is_same<K, StdString>::value) {
+            writer.WriteString(key);
+        } else if constexpr (std::is_integral<K>::value || std::is_floating_point<K>::value) {
+            MessagePackCodec<K>::Write(writer, key);
+        } else {
+            writer.WriteString(nayan::serializer::SerializationUtility::Serialize(key));
+        }
+    }
+
+    // Keys written by the JSON transcoder are always strings, native ones may be numbers
+    template<typename K>
+    inline K ReadKey(MessagePackReader& reader) {
+        if (reader.PeekType() == MessagePackType::String) {
+            StdString text;
+            reader.ReadString(text);
+            return streaming_detail::ConvertKey<K>(text);
+        }
+        K key;
+        MessagePackCodec<K>::Read(reader, key);
+        return key;
+    }
+
+    // Containers are written with their element count first
+    template<typename C>
+    inline Void WriteElements(MessagePackWriter& writer, const C& container, Size count) {
+        writer.WriteArrayHeader(count);
+        for (const auto& element : container) {
+            MessagePackCodec<typename C::value_type>::Write(writer, element);
+        }
+    }
+
+    // A nil container decodes as empty, like JSON null
+    inline Bool ReadNilContainer(MessagePackReader& reader) {
+        if (reader.PeekType() == MessagePackType::Nil) {
+            reader.ReadNil();
+            return true;
+        }
+        return false;
+    }
+}
+
+template<>
+struct MessagePackCodec<bool> {
+    Static Void Write(MessagePackWriter& writer, const bool& value) {
+        writer.WriteBool(value);
+    }
+
+    Static Void Read(MessagePackReader& reader, bool& out) {
+        switch (reader.PeekType()) {
+            case MessagePackType::Boolean:
+                out = reader.ReadBool();
+                break;
+            case MessagePackType::Integer:
+                out = reader.ReadInt() != 0;
+                break;
+            case MessagePackType::String: {
+                StdString text;
+                reader.ReadString(text);
+                out = text == "true" || (text != "false" && !text.empty() && text != "0");
+                break;
+            }
+            default:
+                reader.Skip();
+                out = false;
+                break;
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        if (std::is_signed<T>::value) {
+            writer.WriteInt(static_cast<int64_t>(value));
+        } else {
+            writer.WriteUInt(static_cast<uint64_t>(value));
+        }
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        switch (reader.PeekType()) {
+            case MessagePackType::Integer:
+                out = std::is_signed<T>::value ? static_cast<T>(reader.ReadInt()) : static_cast<T>(reader.ReadUInt());
+                break;
+            case MessagePackType::Float:
+                out = static_cast<T>(reader.ReadDouble());
+                break;
+            case MessagePackType::Boolean:
+                out = reader.ReadBool() ? 1 : 0;
+                break;
+            case MessagePackType::String: {
+                StdString text;
+                reader.ReadString(text);
+                out = streaming_detail::ParseInteger<T>(text);
+                break;
+            }
+            default:
+                reader.Skip();
+                out = T();
+                break;
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        if (std::is_same<T, float>::value) {
+            writer.WriteFloat(static_cast<float>(value));
+        } else {
+            writer.WriteDouble(static_cast<double>(value));
+        }
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        switch (reader.PeekType()) {
+            case MessagePackType::Integer:
+            case MessagePackType::Float:
+                out = static_cast<T>(reader.ReadDouble());
+                break;
+            case MessagePackType::String: {
+                StdString text;
+                reader.ReadString(text);
+                out = static_cast<T>(streaming_detail::ParseFloating(text));
+                break;
+            }
+            default:
+                reader.Skip();
+                out = T();
+                break;
+        }
+    }
+};
+
+template<>
+struct MessagePackCodec<StdString> {
+    Static Void Write(MessagePackWriter& writer, CStdString& value) {
+        writer.WriteString(value);
+    }
+
+    Static Void Read(MessagePackReader& reader, StdString& out) {
+        switch (reader.PeekType()) {
+            case MessagePackType::String:
+                reader.ReadString(out);
+                break;
+            case MessagePackType::Nil:
+                reader.ReadNil();
+                out.clear();
+                break;
+            default:
+                // Numbers and nested values keep their JSON text, as with SerializationUtility
+                out.clear();
+                MessagePackTranscoder::ToJson(reader, out);
+                break;
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<optional<T>> {
+    Static Void Write(MessagePackWriter& writer, const optional<T>& value) {
+        if (value.has_value()) {
+            MessagePackCodec<T>::Write(writer, *value);
+        } else {
+            writer.WriteNil();
+        }
+    }
+
+    Static Void Read(MessagePackReader& reader, optional<T>& out) {
+        if (reader.PeekType() == MessagePackType::Nil) {
+            reader.ReadNil();
+            out.reset();
+            return;
+        }
+        T value;
+        MessagePackCodec<T>::Read(reader, value);
+        out = std::move(value);
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<streaming_detail::IsBackInsertSequence<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        msgpack_detail::WriteElements(writer, value, value.size());
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out.clear();
+        if (msgpack_detail::ReadNilContainer(reader)) {
+            return;
+        }
+        Size count = reader.ReadArrayHeader();
+        for (Size i = 0; i < count; i++) {
+            typename T::value_type element{};
+            MessagePackCodec<typename T::value_type>::Read(reader, element);
+            out.push_back(std::move(element));
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<msgpack_detail::IsForwardList<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        msgpack_detail::WriteElements(writer, value, static_cast<Size>(std::distance(value.begin(), value.end())));
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out.clear();
+        if (msgpack_detail::ReadNilContainer(reader)) {
+            return;
+        }
+        Size count = reader.ReadArrayHeader();
+        auto tail = out.before_begin();
+        for (Size i = 0; i < count; i++) {
+            typename T::value_type element{};
+            MessagePackCodec<typename T::value_type>::Read(reader, element);
+            tail = out.insert_after(tail, std::move(element));
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<msgpack_detail::IsArray<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        msgpack_detail::WriteElements(writer, value, value.size());
+    }
+
+    // Missing elements keep their default value, extra elements are skipped
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out = T{};
+        if (msgpack_detail::ReadNilContainer(reader)) {
+            return;
+        }
+        Size count = reader.ReadArrayHeader();
+        for (Size i = 0; i < count; i++) {
+            if (i < out.size()) {
+                MessagePackCodec<typename T::value_type>::Read(reader, out[i]);
+            } else {
+                reader.Skip();
+            }
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<streaming_detail::IsSet<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        msgpack_detail::WriteElements(writer, value, value.size());
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out.clear();
+        if (msgpack_detail::ReadNilContainer(reader)) {
+            return;
+        }
+        Size count = reader.ReadArrayHeader();
+        for (Size i = 0; i < count; i++) {
+            typename T::value_type element{};
+            MessagePackCodec<typename T::value_type>::Read(reader, element);
+            out.insert(std::move(element));
+        }
+    }
+};
+
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<streaming_detail::IsMap<T>::value>::type> {
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        writer.WriteMapHeader(value.size());
+        for (const auto& entry : value) {
+            msgpack_detail::WriteKey(writer, entry.first);
+            MessagePackCodec<typename T::mapped_type>::Write(writer, entry.second);
+        }
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out.clear();
+        if (msgpack_detail::ReadNilContainer(reader)) {
+            return;
+        }
+        Size count = reader.ReadMapHeader();
+        for (Size i = 0; i < count; i++) {
+            typename T::key_type key = msgpack_detail::ReadKey<typename T::key_type>(reader);
+            typename T::mapped_type value{};
+            MessagePackCodec<typename T::mapped_type>::Read(reader, value);
+            out[std::move(key)] = std::move(value);
+        }
+    }
+};
+
+// Serializable classes with a generated field table: a map from each field's JSON
+// key to its value, member by member. Unknown keys are skipped, missing ones keep
+// the default, so bodies round trip with the transcoded form.
+template<typename T>
+struct MessagePackCodec<T, typename std::enable_if<SerializableFieldTable<T>::available>::type> {
+    typedef SerializableFieldTable<T> Table;
+
+    Static Void Write(MessagePackWriter& writer, const T& value) {
+        writer.WriteMapHeader(Table::fieldCount);
+        Table::ForEachField([&](const FieldDescriptor<T>& field, auto member) {
+            writer.WriteString(field.name, field.length);
+            MessagePackCodec<typename std::decay<decltype(value.*member)>::type>::Write(writer, value.*member);
+        });
+    }
+
+    Static Void Read(MessagePackReader& reader, T& out) {
+        out = T();
+        if (reader.PeekType() != MessagePackType::Map) {
+            reader.Skip();
+            return;
+        }
+        Size count = reader.ReadMapHeader();
+        StdString key;
+        for (Size i = 0; i < count; i++) {
+            const FieldDescriptor<T>* field = nullptr;
+            if (reader.PeekType() == MessagePackType::String) {
+                reader.ReadString(key);
+                field = FieldLookup<T>::Find(key);
+            } else {
+                reader.Skip();
+            }
+            if (field == nullptr) {
+                reader.Skip();
+                continue;
+            }
+            Table::VisitField(static_cast<Size>(field - Table::fields), [&](auto member) {
+                MessagePackCodec<typename std::decay<decltype(out.*member)>::type>::Read(reader, out.*member);
+            });
+        }
+    }
+};
+
+/**
+ * MessagePack counterpart of SerializationUtility.
+ * Accepts the same types (serializable classes, enums, primitives, optional and
+ * the STL containers) and produces a compact binary body instead of JSON text.
+ */
+class MessagePackSerializer {
+    /**
+     * @brief Encode a value as MessagePack
+     * @param value Value to encode
+     * @return Encoded bytes
+     */
+    Public template<typename T>
+    Static StdString Serialize(const T& value) {
+        StdString out;
+        MessagePackWriter writer(out);
+        MessagePackCodec<T>::Write(writer, value);
+        return out;
+    }
+
+    /**
+     * @brief Decode a MessagePack body
+     * @param input Encoded bytes; an empty body yields a default-constructed value
+     * @return Decoded value
+     * @throws std::runtime_error on malformed input or trailing bytes
+     */
+    Public template<typename T>
+    Static T Deserialize(CStdString& input) {
+        T value{};
+        if (input.empty()) {
+            return value;
+        }
+        MessagePackReader reader(input);
+        MessagePackCodec<T>::Read(reader, value);
+        if (!reader.AtEnd()) {
+            throw std::runtime_error("MessagePackSerializer: unexpected data after value");
+        }
+        return value;
+    }
+};
+
+#endif // MESSAGEPACKSERIALIZER_H
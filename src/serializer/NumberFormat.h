@@ -0,0 +1,329 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <StandardDefines.h>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if __has_include(<charconv>)
+    #include <charconv>
+#endif
+
+// Floating-point to_chars / from_chars arrived after integer support (GCC 11);
+// older toolchains such as the ESP32 one use the snprintf / strtod fallback below
+#ifndef NUMBERFORMAT_HAS_FLOAT_CHARCONV
+    #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        #define NUMBERFORMAT_HAS_FLOAT_CHARCONV 1
+    #else
+        #define NUMBERFORMAT_HAS_FLOAT_CHARCONV 0
+    #endif
+#endif
+
+/**
+ * Locale-independent, allocation-free number conversions for the serializers.
+ *
+ * Doubles are written in the shortest form that parses back to the same bits
+ * (std::to_chars where available, otherwise the shortest of %.15g / %.16g /
+ * %.17g that round-trips). Parsing accepts JSON number syntax and reports how
+ * many characters it consumed; 0 means nothing could be parsed.
+ */
+class NumberFormat {
+    // Buffer sizes callers must provide
+    Public Static constexpr Size kMaxIntegerChars = 21;
+    Public Static constexpr Size kMaxDoubleChars = 32;
+
+    /**
+     * @brief Write a signed integer
+     * @param out At least kMaxIntegerChars bytes, not NUL-terminated
+     * @return Number of characters written
+     */
+    Public Static Size FormatInt(int64_t value, char* out) {
+        if (value < 0) {
+            out[0] = '-';
+            // Negate in unsigned arithmetic so INT64_MIN does not overflow
+            return 1 + FormatUInt(0 - static_cast<uint64_t>(value), out + 1);
+        }
+        return FormatUInt(static_cast<uint64_t>(value), out);
+    }
+
+    /**
+     * @brief Write an unsigned integer
+     * @param out At least kMaxIntegerChars bytes, not NUL-terminated
+     * @return Number of characters written
+     */
+    Public Static Size FormatUInt(uint64_t value, char* out) {
+        static const char kDigitPairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        char reversed[kMaxIntegerChars];
+        Size length = 0;
+        while (value >= 100) {
+            Size pair = static_cast<Size>(value % 100) * 2;
+            value /= 100;
+            reversed[length++] = kDigitPairs[pair + 1];
+            reversed[length++] = kDigitPairs[pair];
+        }
+        if (value >= 10) {
+            Size pair = static_cast<Size>(value) * 2;
+            reversed[length++] = kDigitPairs[pair + 1];
+            reversed[length++] = kDigitPairs[pair];
+        } else {
+            reversed[length++] = static_cast<char>('0' + value);
+        }
+        for (Size i = 0; i < length; i++) {
+            out[i] = reversed[length - 1 - i];
+        }
+        return length;
+    }
+
+    /**
+     * @brief Write a double in its shortest round-trip form
+     * Non-finite values are written as nan / inf / -inf; JSON writers map them to null.
+     * @param out At least kMaxDoubleChars bytes, not NUL-terminated
+     * @return Number of characters written
+     */
+    Public Static Size FormatDouble(double value, char* out) {
+        if (std::isnan(value)) {
+            std::memcpy(out, "nan", 3);
+            return 3;
+        }
+        if (std::isinf(value)) {
+            return value < 0 ? CopyLiteral("-inf", out) : CopyLiteral("inf", out);
+        }
+#if NUMBERFORMAT_HAS_FLOAT_CHARCONV
+        return static_cast<Size>(std::to_chars(out, out + kMaxDoubleChars, value).ptr - out);
+#else
+        char buffer[kMaxDoubleChars + 8];
+        Int length = 0;
+        for (Int precision = 15; precision <= 17; precision++) {
+            length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            NormalizeDecimalPoint(buffer, static_cast<Size>(length));
+            double parsed = 0;
+            if (precision == 17 || (ParseDouble(buffer, buffer + length, parsed) == static_cast<Size>(length) && parsed == value)) {
+                break;
+            }
+        }
+        return ShorterNotation(buffer, static_cast<Size>(length), out);
+#endif
+    }
+
+    Public Static Void AppendInt(int64_t value, StdString& out) {
+        char buffer[kMaxIntegerChars];
+        out.append(buffer, FormatInt(value, buffer));
+    }
+
+    Public Static Void AppendUInt(uint64_t value, StdString& out) {
+        char buffer[kMaxIntegerChars];
+        out.append(buffer, FormatUInt(value, buffer));
+    }
+
+    Public Static Void AppendDouble(double value, StdString& out) {
+        char buffer[kMaxDoubleChars];
+        out.append(buffer, FormatDouble(value, buffer));
+    }
+
+    /**
+     * @brief Parse an optionally negative decimal integer
+     * @return Characters consumed, 0 on no digits or overflow
+     */
+    Public Static Size ParseInt(const char* first, const char* last, int64_t& value) {
+        Bool negative = first != last && *first == '-';
+        uint64_t magnitude = 0;
+        Size digits = ParseDigits(first + (negative ? 1 : 0), last, magnitude);
+        if (digits == 0) {
+            return 0;
+        }
+        uint64_t limit = negative ? static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(INT64_MAX);
+        if (magnitude > limit) {
+            return 0;
+        }
+        value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+        return digits + (negative ? 1 : 0);
+    }
+
+    /**
+     * @brief Parse a non-negative decimal integer
+     * @return Characters consumed, 0 on no digits or overflow
+     */
+    Public Static Size ParseUInt(const char* first, const char* last, uint64_t& value) {
+        return ParseDigits(first, last, value);
+    }
+
+    /**
+     * @brief Parse a JSON number as a double
+     * @return Characters consumed, 0 when no number could be parsed
+     */
+    Public Static Size ParseDouble(const char* first, const char* last, double& value) {
+#if NUMBERFORMAT_HAS_FLOAT_CHARCONV
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            // Keep strtod's behavior: overflow is +/-inf, underflow is 0
+            value = std::strtod(StdString(first, result.ptr).c_str(), nullptr);
+            return static_cast<Size>(result.ptr - first);
+        }
+        return result.ec == std::errc() ? static_cast<Size>(result.ptr - first) : 0;
+#else
+        // strtod needs a terminated, locale-specific copy
+        Size length = static_cast<Size>(last - first);
+        char buffer[64];
+        StdString overflow;
+        char* text = buffer;
+        if (length >= sizeof(buffer)) {
+            overflow.assign(first, length);
+            text = &overflow[0];
+        } else {
+            std::memcpy(buffer, first, length);
+            buffer[length] = '\0';
+        }
+        // Swap in the locale's decimal point, and stop at a literal one so "12,5" is still 12
+        char point = LocaleDecimalPoint();
+        if (point != '.') {
+            for (Size i = 0; i < length; i++) {
+                if (text[i] == point) {
+                    text[i] = '\0';
+                    break;
+                }
+                if (text[i] == '.') {
+                    text[i] = point;
+                }
+            }
+        }
+        char* end = nullptr;
+        value = std::strtod(text, &end);
+        return static_cast<Size>(end - text);
+#endif
+    }
+
+    Public Static Size ParseDouble(CStdString& text, double& value) {
+        return ParseDouble(text.data(), text.data() + text.size(), value);
+    }
+
+    Private Static Size ParseDigits(const char* first, const char* last, uint64_t& value) {
+        uint64_t result = 0;
+        const char* cursor = first;
+        while (cursor != last && *cursor >= '0' && *cursor <= '9') {
+            uint64_t digit = static_cast<uint64_t>(*cursor - '0');
+            if (result > (UINT64_MAX - digit) / 10) {
+                return 0;
+            }
+            result = result * 10 + digit;
+            cursor++;
+        }
+        if (cursor == first) {
+            return 0;
+        }
+        value = result;
+        return static_cast<Size>(cursor - first);
+    }
+
+    Private Static Size CopyLiteral(const char* literal, char* out) {
+        Size length = std::strlen(literal);
+        std::memcpy(out, literal, length);
+        return length;
+    }
+
+    // Rewrites %g output as fixed or scientific, whichever is shorter (fixed on a tie),
+    // so the fallback picks the same notation as std::to_chars
+    Private Static Size ShorterNotation(const char* text, Size length, char* out) {
+        Size position = 0;
+        Bool negative = text[0] == '-';
+        if (negative) {
+            position++;
+        }
+        char digits[24] = {};
+        Size digitCount = 0;
+        Int pointIndex = -1;
+        Int exponent = 0;
+        for (; position < length; position++) {
+            char c = text[position];
+            if (c == '.') {
+                pointIndex = static_cast<Int>(digitCount);
+            } else if (c == 'e' || c == 'E') {
+                exponent = std::atoi(text + position + 1);
+                break;
+            } else {
+                digits[digitCount++] = c;
+            }
+        }
+        if (pointIndex < 0) {
+            pointIndex = static_cast<Int>(digitCount);
+        }
+        // Drop leading zeros ("0.001") and trailing zeros ("1500"), keeping one digit for zero
+        Size start = 0;
+        while (start + 1 < digitCount && digits[start] == '0') {
+            start++;
+            pointIndex--;
+        }
+        while (digitCount > start + 1 && digits[digitCount - 1] == '0') {
+            digitCount--;
+        }
+        Size count = digitCount - start;
+        // value = 0.d1d2d3... * 10^decimalPoint
+        Int decimalPoint = pointIndex + exponent;
+        if (count == 1 && digits[start] == '0') {
+            decimalPoint = 1;
+        }
+
+        char fixed[kMaxDoubleChars + 340];
+        Size fixedLength = 0;
+        if (negative) fixed[fixedLength++] = '-';
+        if (decimalPoint <= 0) {
+            fixed[fixedLength++] = '0';
+            fixed[fixedLength++] = '.';
+            for (Int i = 0; i < -decimalPoint; i++) fixed[fixedLength++] = '0';
+            for (Size i = start; i < digitCount; i++) fixed[fixedLength++] = digits[i];
+        } else {
+            for (Int i = 0; i < decimalPoint || static_cast<Size>(i) < count; i++) {
+                if (i == decimalPoint) fixed[fixedLength++] = '.';
+                fixed[fixedLength++] = static_cast<Size>(i) < count ? digits[start + i] : '0';
+            }
+        }
+
+        char scientific[kMaxDoubleChars];
+        Size scientificLength = 0;
+        if (negative) scientific[scientificLength++] = '-';
+        scientific[scientificLength++] = digits[start];
+        if (count > 1) {
+            scientific[scientificLength++] = '.';
+            for (Size i = start + 1; i < digitCount; i++) scientific[scientificLength++] = digits[i];
+        }
+        Int scientificExponent = decimalPoint - 1;
+        scientificLength += static_cast<Size>(std::snprintf(scientific + scientificLength, sizeof(scientific) - scientificLength,
+                                                            "e%c%02d", scientificExponent < 0 ? '-' : '+',
+                                                            scientificExponent < 0 ? -scientificExponent : scientificExponent));
+
+        if (fixedLength <= scientificLength) {
+            std::memcpy(out, fixed, fixedLength);
+            return fixedLength;
+        }
+        std::memcpy(out, scientific, scientificLength);
+        return scientificLength;
+    }
+
+    Private Static char LocaleDecimalPoint() {
+        const std::lconv* conventions = std::localeconv();
+        return conventions != nullptr && conventions->decimal_point != nullptr && conventions->decimal_point[0] != '\0'
+            ? conventions->decimal_point[0]
+            : '.';
+    }
+
+    Private Static Void NormalizeDecimalPoint(char* text, Size length) {
+        char point = LocaleDecimalPoint();
+        if (point == '.') {
+            return;
+        }
+        for (Size i = 0; i < length; i++) {
+            if (text[i] == point) {
+                text[i] = '.';
+            }
+        }
+    }
+};
+
+#endif // NUMBERFORMAT_H
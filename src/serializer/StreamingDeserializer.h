@@ -0,0 +1,403 @@
+#ifndef STREAMINGDESERIALIZER_H
+#define STREAMINGDESERIALIZER_H
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "IJsonChunkSource.h"
+#include "JsonPullParser.h"
+#include "FieldTable.h"
+#include "NumberFormat.h"
+
+/**
+ * Limits applied while streaming a request body
+ */
+class StreamingDeserializerOptions {
+    // Bytes requested from the chunk source per read
+    Public Size chunkSize = JsonPullParser::kDefaultChunkSize;
+
+    // Longest single string, key or number
+    Public Size maxTokenLength = JsonPullParser::kDefaultMaxTokenLength;
+
+    // Longest single element handed to SerializationUtility (see JsonStreamReader)
+    Public Size maxElementLength = 4096;
+};
+
+// Reads one value of type T from the parser. token is the first token of the value,
+// already consumed by the caller. Specializations below cover primitives, optional
+// and the STL containers; everything else falls through to the primary template.
+template<typename T, typename Enable = void>
+struct JsonStreamReader {
+    // Serializable classes and enums: only this one element is materialized and
+    // parsed by SerializationUtility, the enclosing array or map keeps streaming.
+    Static Void Read(JsonPullParser& parser, JsonToken token, T& out, const StreamingDeserializerOptions& options) {
+        StdString& capture = parser.GetCaptureBuffer();
+        capture.clear();
+        parser.CaptureValue(token, capture, options.maxElementLength);
+        out = nayan::serializer::SerializationUtility::Deserialize<T>(capture);
+    }
+};
+
+namespace streaming_detail {
+
+    inline Bool IsScalar(JsonToken token) {
+        return token == JsonToken::Number || token == JsonToken::String;
+    }
+
+    // Integers written as decimals or exponents ("3.0", "1e3") are truncated, out of range values clamp
+    template<typename T>
+    inline T ParseInteger(CStdString& text) {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        if (std::is_signed<T>::value) {
+            int64_t value = 0;
+            if (NumberFormat::ParseInt(first, last, value) == text.size()) {
+                return static_cast<T>(value);
+            }
+        } else {
+            uint64_t value = 0;
+            if (NumberFormat::ParseUInt(first, last, value) == text.size()) {
+                return static_cast<T>(value);
+            }
+        }
+        double value = 0;
+        if (NumberFormat::ParseDouble(first, last, value) == 0 || std::isnan(value)) {
+            return T();
+        }
+        const double lowest = static_cast<double>(std::numeric_limits<T>::lowest());
+        const double highest = static_cast<double>(std::numeric_limits<T>::max());
+        if (value <= lowest) {
+            return std::numeric_limits<T>::lowest();
+        }
+        if (value >= highest) {
+            return std::numeric_limits<T>::max();
+        }
+        return static_cast<T>(value);
+    }
+
+    inline double ParseFloating(CStdString& text) {
+        double value = 0;
+        NumberFormat::ParseDouble(text, value);
+        return value;
+    }
+
+    template<typename T> struct IsOptional : std::false_type {};
+    template<typename T> struct IsOptional<optional<T>> : std::true_type {};
+
+    // Sequences filled with push_back
+    template<typename T> struct IsBackInsertSequence : std::false_type {};
+    template<typename T, typename A> struct IsBackInsertSequence<std::vector<T, A>> : std::true_type {};
+    template<typename T, typename A> struct IsBackInsertSequence<std::list<T, A>> : std::true_type {};
+    template<typename T, typename A> struct IsBackInsertSequence<std::deque<T, A>> : std::true_type {};
+
+    // Sets filled with insert
+    template<typename T> struct IsSet : std::false_type {};
+    template<typename T, typename C, typename A> struct IsSet<std::set<T, C, A>> : std::true_type {};
+    template<typename T, typename H, typename E, typename A> struct IsSet<std::unordered_set<T, H, E, A>> : std::true_type {};
+
+    // Maps keyed by JSON object member names
+    template<typename T> struct IsMap : std::false_type {};
+    template<typename K, typename V, typename C, typename A> struct IsMap<std::map<K, V, C, A>> : std::true_type {};
+    template<typename K, typename V, typename H, typename E, typename A> struct IsMap<std::unordered_map<K, V, H, E, A>> : std::true_type {};
+
+    template<typename K>
+    inline K ConvertKey(CStdString& text) {
+        if constexpr (std::is_same<K, StdString>::value) {
+            return text;
+        } else if constexpr (std::is_integral<K>::value) {
+            return ParseInteger<K>(text);
+        } else if constexpr (std::is_floating_point<K>::value) {
+            return static_cast<K>(ParseFloating(text));
+        } else {
+            return nayan::serializer::SerializationUtility::Deserialize<K>(text);
+        }
+    }
+
+    inline Void ExpectToken(JsonToken actual, JsonToken expected, const char* what) {
+        if (actual != expected) {
+            throw std::runtime_error(StdString("StreamingDeserializer: expected ") + what);
+        }
+    }
+}
+
+template<>
+struct JsonStreamReader<bool> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, bool& out, const StreamingDeserializerOptions&) {
+        if (token == JsonToken::True || token == JsonToken::False) {
+            out = token == JsonToken::True;
+        } else if (streaming_detail::IsScalar(token)) {
+            CStdString& text = parser.GetText();
+            out = text == "true" || (text != "false" && !text.empty() && text != "0");
+        } else {
+            parser.SkipValue(token);
+            out = false;
+        }
+    }
+};
+
+template<typename T>
+struct JsonStreamReader<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, T& out, const StreamingDeserializerOptions&) {
+        if (streaming_detail::IsScalar(token)) {
+            out = streaming_detail::ParseInteger<T>(parser.GetText());
+        } else if (token == JsonToken::True || token == JsonToken::False) {
+            out = token == JsonToken::True ? 1 : 0;
+        } else {
+            parser.SkipValue(token);
+            out = T();
+        }
+    }
+};
+
+template<typename T>
+struct JsonStreamReader<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, T& out, const StreamingDeserializerOptions&) {
+        if (streaming_detail::IsScalar(token)) {
+            out = static_cast<T>(streaming_detail::ParseFloating(parser.GetText()));
+        } else {
+            parser.SkipValue(token);
+            out = T();
+        }
+    }
+};
+
+template<>
+struct JsonStreamReader<StdString> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, StdString& out, const StreamingDeserializerOptions&) {
+        switch (token) {
+            case JsonToken::String:
+            case JsonToken::Number:
+                out = parser.GetText();
+                break;
+            case JsonToken::True:
+                out = "true";
+                break;
+            case JsonToken::False:
+                out = "false";
+                break;
+            default:
+                parser.SkipValue(token);
+                out.clear();
+                break;
+        }
+    }
+};
+
+template<typename T>
+struct JsonStreamReader<optional<T>> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, optional<T>& out, const StreamingDeserializerOptions& options) {
+        if (token == JsonToken::Null) {
+            out.reset();
+            return;
+        }
+        T value{};
+        JsonStreamReader<T>::Read(parser, token, value, options);
+        out = std::move(value);
+    }
+};
+
+template<typename C>
+struct JsonStreamReader<C, typename std::enable_if<streaming_detail::IsBackInsertSequence<C>::value>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, C& out, const StreamingDeserializerOptions& options) {
+        out.clear();
+        if (token == JsonToken::Null) {
+            return;
+        }
+        streaming_detail::ExpectToken(token, JsonToken::BeginArray, "array");
+        for (JsonToken next = parser.Next(); next != JsonToken::EndArray; next = parser.Next()) {
+            typename C::value_type value{};
+            JsonStreamReader<typename C::value_type>::Read(parser, next, value, options);
+            out.push_back(std::move(value));
+        }
+    }
+};
+
+template<typename T, typename A>
+struct JsonStreamReader<std::forward_list<T, A>> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, std::forward_list<T, A>& out, const StreamingDeserializerOptions& options) {
+        out.clear();
+        if (token == JsonToken::Null) {
+            return;
+        }
+        streaming_detail::ExpectToken(token, JsonToken::BeginArray, "array");
+        auto tail = out.before_begin();
+        for (JsonToken next = parser.Next(); next != JsonToken::EndArray; next = parser.Next()) {
+            T value{};
+            JsonStreamReader<T>::Read(parser, next, value, options);
+            tail = out.insert_after(tail, std::move(value));
+        }
+    }
+};
+
+template<typename T, std::size_t N>
+struct JsonStreamReader<std::array<T, N>> {
+    // Extra elements are skipped, missing ones keep their default value
+    Static Void Read(JsonPullParser& parser, JsonToken token, std::array<T, N>& out, const StreamingDeserializerOptions& options) {
+        out.fill(T{});
+        if (token == JsonToken::Null) {
+            return;
+        }
+        streaming_detail::ExpectToken(token, JsonToken::BeginArray, "array");
+        Size index = 0;
+        for (JsonToken next = parser.Next(); next != JsonToken::EndArray; next = parser.Next()) {
+            if (index < N) {
+                JsonStreamReader<T>::Read(parser, next, out[index++], options);
+            } else {
+                parser.SkipValue(next);
+            }
+        }
+    }
+};
+
+template<typename C>
+struct JsonStreamReader<C, typename std::enable_if<streaming_detail::IsSet<C>::value>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, C& out, const StreamingDeserializerOptions& options) {
+        out.clear();
+        if (token == JsonToken::Null) {
+            return;
+        }
+        streaming_detail::ExpectToken(token, JsonToken::BeginArray, "array");
+        for (JsonToken next = parser.Next(); next != JsonToken::EndArray; next = parser.Next()) {
+            typename C::value_type value{};
+            JsonStreamReader<typename C::value_type>::Read(parser, next, value, options);
+            out.insert(std::move(value));
+        }
+    }
+};
+
+template<typename C>
+struct JsonStreamReader<C, typename std::enable_if<streaming_detail::IsMap<C>::value>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, C& out, const StreamingDeserializerOptions& options) {
+        out.clear();
+        if (token == JsonToken::Null) {
+            return;
+        }
+        streaming_detail::ExpectToken(token, JsonToken::BeginObject, "object");
+        for (JsonToken next = parser.Next(); next != JsonToken::EndObject; next = parser.Next()) {
+            typename C::key_type key = streaming_detail::ConvertKey<typename C::key_type>(parser.GetText());
+            typename C::mapped_type value{};
+            JsonStreamReader<typename C::mapped_type>::Read(parser, parser.Next(), value, options);
+            out[std::move(key)] = std::move(value);
+        }
+    }
+};
+
+// Reads one member of T; the generated field tables point at these
+template<typename T, typename M, M T::*Member>
+struct FieldMemberReader {
+    Static Void Read(JsonPullParser& parser, JsonToken token, T& out, const StreamingDeserializerOptions& options) {
+        JsonStreamReader<M>::Read(parser, token, out.*Member, options);
+    }
+};
+
+// Serializable classes with a generated field table: one pass over the object,
+// each key dispatched to its field through the perfect hash, unknown keys skipped
+template<typename T>
+struct JsonStreamReader<T, typename std::enable_if<SerializableFieldTable<T>::available>::type> {
+    Static Void Read(JsonPullParser& parser, JsonToken token, T& out, const StreamingDeserializerOptions& options) {
+        out = T();
+        if (token != JsonToken::BeginObject) {
+            parser.SkipValue(token);
+            return;
+        }
+        for (JsonToken next = parser.Next(); next != JsonToken::EndObject; next = parser.Next()) {
+            const FieldDescriptor<T>* field = FieldLookup<T>::Find(parser.GetText());
+            JsonToken value = parser.Next();
+            if (field != nullptr) {
+                field->read(parser, value, out, options);
+            } else {
+                parser.SkipValue(value);
+            }
+        }
+    }
+};
+
+/**
+ * Streaming counterpart of SerializationUtility::Deserialize<T>.
+ *
+ * Reads the body from an IJsonChunkSource through JsonPullParser and fills the
+ * result incrementally. Containers are populated element by element, so peak
+ * memory is the result itself plus the parser's fixed buffers and the largest
+ * single element, instead of the whole body plus a JsonDocument of it.
+ *
+ * Top-level quirks of SerializationUtility are kept so the two are
+ * interchangeable: an empty body yields a default value (empty optional), and
+ * a top-level string may be either quoted JSON or raw text.
+ */
+class StreamingDeserializer {
+    /**
+     * @brief Deserialize a value of type T from a chunked source
+     * @param source Body input
+     * @param options Buffer sizes and limits
+     * @return The deserialized value
+     */
+    Public template<typename T>
+    Static T Deserialize(IJsonChunkSource& source, const StreamingDeserializerOptions& options = StreamingDeserializerOptions()) {
+        JsonPullParser parser(source, options.chunkSize, options.maxTokenLength);
+        T result{};
+        ReadTopLevel(parser, result, options);
+        if (parser.Next() != JsonToken::End) {
+            throw std::runtime_error("StreamingDeserializer: trailing data after value");
+        }
+        return result;
+    }
+
+    /**
+     * @brief Deserialize a value of type T from memory, e.g. a request body view
+     * The input is parsed in place, without copying it into the parser's window.
+     */
+    Public template<typename T>
+    Static T Deserialize(std::string_view input, const StreamingDeserializerOptions& options = StreamingDeserializerOptions()) {
+        StringChunkSource source(input.data(), input.size());
+        return Deserialize<T>(source, options);
+    }
+
+    Private template<typename T>
+    Static Void ReadTopLevel(JsonPullParser& parser, T& out, const StreamingDeserializerOptions& options) {
+        JsonToken token = parser.Next();
+        if (token == JsonToken::End) {
+            return;
+        }
+        JsonStreamReader<T>::Read(parser, token, out, options);
+    }
+
+    Private Static Void ReadTopLevel(JsonPullParser& parser, StdString& out, const StreamingDeserializerOptions& options) {
+        if (parser.PeekSignificantChar() != '"') {
+            parser.ReadRemainingRaw(out);
+            return;
+        }
+        JsonStreamReader<StdString>::Read(parser, parser.Next(), out, options);
+    }
+
+    Private template<typename T>
+    Static Void ReadTopLevel(JsonPullParser& parser, optional<T>& out, const StreamingDeserializerOptions& options) {
+        Int first = parser.PeekSignificantChar();
+        if (first < 0) {
+            out.reset();
+            return;
+        }
+        if (first == 'n') {
+            JsonStreamReader<optional<T>>::Read(parser, parser.Next(), out, options);
+            return;
+        }
+        T value{};
+        ReadTopLevel(parser, value, options);
+        out = std::move(value);
+    }
+};
+
+// Field tables from scripts/generate_field_tables.py (CMake and the PlatformIO
+// pre-script put them on the include path). They reference the readers above,
+// so they are pulled in last; the test fixtures' only where asked for.
+#if __has_include(<SerializableFieldTables.h>)
+#include <SerializableFieldTables.h>
+#endif
+#if FIELDTABLE_TEST_FIXTURES && __has_include(<SerializableTestFieldTables.h>)
+#include <SerializableTestFieldTables.h>
+#endif
+
+#endif // STREAMINGDESERIALIZER_H
@@ -0,0 +1,136 @@
+#ifndef WIREFORMAT_H
+#define WIREFORMAT_H
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <cctype>
+#include <string_view>
+#include "MessagePackSerializer.h"
+#include "NumberFormat.h"
+
+// Body encodings a request or response can use
+enum class WireFormat {
+    Json,
+    MessagePack
+};
+
+/**
+ * Picks the body encoding from Content-Type / Accept headers and
+ * encodes / decodes bodies in that format.
+ * JSON stays the default whenever a header is missing or not understood.
+ */
+class WireFormatNegotiator {
+    Public Static constexpr const char* kJsonContentType = "application/json";
+    Public Static constexpr const char* kMessagePackContentType = "application/msgpack";
+
+    /**
+     * @brief Content-Type header value for a format
+     */
+    Public Static const char* ContentTypeFor(WireFormat format) {
+        return format == WireFormat::MessagePack ? kMessagePackContentType : kJsonContentType;
+    }
+
+    /**
+     * @brief Format of a request body from its Content-Type header
+     * @param contentType Header value, parameters such as charset are ignored
+     */
+    Public Static WireFormat FromContentType(std::string_view contentType) {
+        Size end = contentType.find(';');
+        WireFormat format = WireFormat::Json;
+        ParseMediaType(contentType, 0, end == std::string_view::npos ? contentType.size() : end, format);
+        return format;
+    }
+
+    /**
+     * @brief Response format from an Accept header
+     * The supported media range with the highest q-value wins; ties keep JSON.
+     * @param accept Header value, e.g. "application/msgpack, application/json;q=0.5"
+     */
+    Public Static WireFormat FromAccept(std::string_view accept) {
+        double jsonQuality = accept.empty() ? 1.0 : -1.0;
+        double messagePackQuality = -1.0;
+        Size start = 0;
+        while (start < accept.size()) {
+            Size end = accept.find(',', start);
+            if (end == std::string_view::npos) {
+                end = accept.size();
+            }
+            Size parameters = accept.find(';', start);
+            Size typeEnd = parameters < end ? parameters : end;
+            double quality = parameters < end ? ParseQuality(accept, parameters, end) : 1.0;
+
+            WireFormat format = WireFormat::Json;
+            if (ParseMediaType(accept, start, typeEnd, format)) {
+                double& best = format == WireFormat::MessagePack ? messagePackQuality : jsonQuality;
+                best = quality > best ? quality : best;
+            }
+            start = end + 1;
+        }
+        return messagePackQuality > 0.0 && messagePackQuality > jsonQuality ? WireFormat::MessagePack : WireFormat::Json;
+    }
+
+    /**
+     * @brief Encode a value in the given format
+     */
+    Public template<typename T>
+    Static StdString Encode(WireFormat format, const T& value) {
+        if (format == WireFormat::MessagePack) {
+            return MessagePackSerializer::Serialize(value);
+        }
+        return nayan::serializer::SerializationUtility::Serialize(value);
+    }
+
+    /**
+     * @brief Decode a body in the given format
+     */
+    Public template<typename T>
+    Static T Decode(WireFormat format, CStdString& body) {
+        if (format == WireFormat::MessagePack) {
+            return MessagePackSerializer::Deserialize<T>(body);
+        }
+        return nayan::serializer::SerializationUtility::Deserialize<T>(body);
+    }
+
+    // Matches [start, end) against the supported media types; wildcards count as JSON
+    Private Static Bool ParseMediaType(std::string_view header, Size start, Size end, WireFormat& format) {
+        while (start < end && std::isspace(static_cast<unsigned char>(header[start]))) start++;
+        while (end > start && std::isspace(static_cast<unsigned char>(header[end - 1]))) end--;
+        std::string_view type = header.substr(start, end - start);
+        if (TypeIs(type, "application/msgpack") || TypeIs(type, "application/x-msgpack") || TypeIs(type, "application/vnd.msgpack")) {
+            format = WireFormat::MessagePack;
+            return true;
+        }
+        if (TypeIs(type, "application/json") || TypeIs(type, "application/*") || TypeIs(type, "*/*")) {
+            format = WireFormat::Json;
+            return true;
+        }
+        return false;
+    }
+
+    // Media types are case-insensitive; lowerCase is
+    Private Static Bool TypeIs(std::string_view type, std::string_view lowerCase) {
+        if (type.size() != lowerCase.size()) {
+            return false;
+        }
+        for (Size i = 0; i < type.size(); i++) {
+            if (std::tolower(static_cast<unsigned char>(type[i])) != lowerCase[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reads "q=<value>" from the parameters in [start, end); 1.0 when absent
+    Private Static double ParseQuality(std::string_view header, Size start, Size end) {
+        Size q = header.find("q=", start);
+        if (q == std::string_view::npos || q >= end) {
+            return 1.0;
+        }
+        double quality = 1.0;
+        const char* first = header.data() + q + 2;
+        NumberFormat::ParseDouble(first, header.data() + end, quality);
+        return quality;
+    }
+};
+
+#endif // WIREFORMAT_H
@@ -0,0 +1,282 @@
+#ifndef APPREQUESTHANDLER_H
+#define APPREQUESTHANDLER_H
+
+#include <StandardDefines.h>
+#include "HttpCompression.h"
+#include "HttpMessage.h"
+#include "../router/StaticRouteTable.h"
+
+#if STATICROUTE_HAS_GENERATED_TABLE && __has_include(<GeneratedRouteAdapters.h>)
+#include <GeneratedRouteAdapters.h>
+#include <SerializationUtility.h>
+#include "../errors/ErrorResponse.h"
+#include "../controller/ExceptionTestController.h"
+#include "../controller/MetricsController.h"
+#include "../controller/ResponseEntityController.h"
+#include "../controller/SwitchController.h"
+#include "../metrics/RouteMetrics.h"
+#include "../router/RadixRouter.h"
+#include "../serializer/WireFormat.h"
+#include "../service/ISwitchService.h"
+#include <deque>
+#include <functional>
+#include <type_traits>
+
+#define APPREQUESTHANDLER_AVAILABLE 1
+
+/**
+ * Serves the switch, metrics, exception-test and ResponseEntity routes for
+ * ThreadedHttpServer and SelectHttpServer, matched with the generated route
+ * table and answered by the controllers through the generated adapters, which
+ * parse the path variables and invoke the handler method. Whatever a handler
+ * throws is mapped by the ExceptionResponseRegistry. Entities are written as
+ * JSON, or as MessagePack when the Accept header prefers it (see
+ * WireFormatNegotiator); text bodies and the metrics keep their own formats.
+ *
+ * Handle() is safe to call from several workers at once: the controllers
+ * hold no state of their own and the services they call lock per device
+ * (see SwitchService). Routes whose handlers take a request body
+ * (MyController) are left to the framework's listener and get 404 here.
+ *
+ * Routes known only at runtime, which the generated table cannot hold, are
+ * added with AddRoute() and matched by a RadixRouter when the table misses.
+ */
+class AppRequestHandler {
+    // Answers a route added with AddRoute(); the match's captures hold its path variables
+    Public typedef std::function<Void(const HttpServerRequest&, const RadixRouteMatch&, HttpServerResponse&)> RouteHandler;
+
+    Private Static constexpr const char* kNotFoundBody = "{\"error\":\"Not Found\"}";
+    Private Static constexpr Size kRouteMethodCount = static_cast<Size>(RouteMethod::Unknown);
+
+    Private struct RuntimeRoute {
+        RouteHandler handler;
+        Int metricsId;
+    };
+
+    Private ISwitchControllerPtr switches;
+    Private IMetricsControllerPtr metrics;
+    Private IExceptionTestControllerPtr exceptions;
+    Private IResponseEntityControllerPtr entities;
+    Private const ExceptionResponseRegistry& errors;
+    // One router per method; their handler ids index runtimeRoutes
+    Private RadixRouter runtimeRouters[kRouteMethodCount];
+    Private StdVector<RuntimeRoute> runtimeRoutes;
+
+    Public explicit AppRequestHandler(ISwitchServicePtr service,
+                                      const ExceptionResponseRegistry& registry = ExceptionResponseRegistry::Default())
+        : switches(std::make_shared<SwitchController>(std::move(service))),
+          metrics(std::make_shared<MetricsController>()),
+          exceptions(std::make_shared<ExceptionTestController>()),
+          entities(std::make_shared<ResponseEntityController>()),
+          errors(registry) {}
+
+    Public HttpServerResponse Handle(const HttpServerRequest& request) const {
+        HttpServerResponse response;
+        Handle(request, response);
+        return response;
+    }
+
+    /**
+     * @brief Fill response in place, as the servers' HttpResponseWriter hands it out
+     * Fixed bodies are written into the response's reused buffer; serialized
+     * ones are moved in.
+     */
+    Public Void Handle(const HttpServerRequest& request, HttpServerResponse& response) const {
+        RouteMethod method = RouteMethodFromString(request.method);
+        StaticRouteMatch match = MatchGeneratedRoute(method, request.Path());
+        if (!match.Found() && !runtimeRoutes.empty() && method != RouteMethod::Unknown) {
+            RadixRouteMatch runtimeMatch = runtimeRouters[static_cast<Size>(method)].Match(request.Path());
+            if (runtimeMatch.Found()) {
+                const RuntimeRoute& route = runtimeRoutes[static_cast<Size>(runtimeMatch.handlerId)];
+                RouteRequestTimer timer(RouteMetrics::Global(), route.metricsId);
+                Respond([&]() { route.handler(request, runtimeMatch, response); }, response);
+                timer.SetStatus(static_cast<uint32_t>(response.status));
+                return;
+            }
+        }
+        RouteRequestTimer timer(RouteMetrics::Global(), match.Found() ? match.routeId : RouteMetrics::kUnmatchedRoute);
+        const std::string_view* accept = request.Header("accept");
+        WireFormat format = accept != nullptr ? WireFormatNegotiator::FromAccept(*accept) : WireFormat::Json;
+        Respond([&]() { Dispatch(match, format, response); }, response);
+        timer.SetStatus(static_cast<uint32_t>(response.status));
+    }
+
+    /**
+     * @brief Serve a route the generated table does not have, e.g. one a plugin registers
+     * Generated routes win over runtime ones; adding a pattern again replaces
+     * its handler. Whatever the handler throws is mapped like a controller's.
+     * The route gets its own metrics id while ROUTEMETRICS_SPARE_ROUTES last
+     * and is counted as unmatched after that. Call before the server starts.
+     * @param pattern Path pattern, e.g. "/plugins/{name}/status"
+     * @return false when the method is Unknown or the pattern is malformed
+     */
+    Public Bool AddRoute(RouteMethod method, CStdString& pattern, RouteHandler handler) {
+        if (method == RouteMethod::Unknown ||
+            !runtimeRouters[static_cast<Size>(method)].Insert(pattern, static_cast<Int>(runtimeRoutes.size()))) {
+            return false;
+        }
+        Int metricsId = RouteMetrics::Global().RegisterRoute(RouteMetrics::RouteMethodName(method), KeepPattern(pattern));
+        runtimeRoutes.push_back({std::move(handler), metricsId < 0 ? RouteMetrics::kUnmatchedRoute : metricsId});
+        return true;
+    }
+
+    /**
+     * @brief Register the JSON bodies of the routes that always answer the same
+     * The ResponseEntity and exception-test routes and the 404 body are
+     * rendered once, outside the route metrics, so compression serves them
+     * from its cache. Call before the server starts.
+     */
+    Public Void AddConstantBodies(HttpCompression& compression) const {
+        const char* const kFixedRoutes[] = {
+            "/response-entity/string", "/response-entity/int", "/response-entity/order",
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+            "/exception-test/runtime-error", "/exception-test/logic-error", "/exception-test/string-exception",
+            "/exception-test/int-exception", "/exception-test/custom-exception",
+#endif
+            "/exception-test/expected-error"};
+        HttpServerResponse response;
+        for (const char* path : kFixedRoutes) {
+            response.Reset();
+            StaticRouteMatch match = MatchGeneratedRoute(RouteMethod::Get, path);
+            Respond([&]() { Dispatch(match, WireFormat::Json, response); }, response);
+            compression.AddConstant(response.body);
+        }
+        compression.AddConstant(kNotFoundBody);
+    }
+
+    // Run dispatch, with whatever the handler throws mapped to its error response
+    Private template<typename Dispatcher>
+    Void Respond(Dispatcher&& dispatch, HttpServerResponse& response) const {
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+        ErrorResponse error;
+        optional<Bool> handled = errors.Invoke([&]() {
+            dispatch();
+            return true;
+        }, error);
+        if (!handled.has_value()) {
+            response.Reset();
+            response.status = static_cast<Int>(error.status);
+            response.body = std::move(error.body);
+            response.contentType = "application/json";
+        }
+#else
+        dispatch();
+#endif
+    }
+
+    // RouteMetrics::Global() keeps the pattern's pointer for good, so the text is never freed
+    Private Static const char* KeepPattern(CStdString& pattern) {
+        static std::deque<StdString>* patterns = new std::deque<StdString>();
+        patterns->push_back(pattern);
+        return patterns->back().c_str();
+    }
+
+    Private Void Dispatch(const StaticRouteMatch& match, WireFormat format, HttpServerResponse& response) const {
+        if (!match.Found()) {
+            Status(response, 404, kNotFoundBody);
+            return;
+        }
+        switch (static_cast<GeneratedRouteId>(match.routeId)) {
+            case GeneratedRouteId::SwitchController_TurnOnSwitch:
+                Serve<SwitchController_TurnOnSwitch_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::SwitchController_TurnOffSwitch:
+                Serve<SwitchController_TurnOffSwitch_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::SwitchController_ToggleSwitch:
+                Serve<SwitchController_ToggleSwitch_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::SwitchController_SetSwitchState:
+                Serve<SwitchController_SetSwitchState_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::SwitchController_GetSwitchStateById:
+                Serve<SwitchController_GetSwitchStateById_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::SwitchController_GetAllSwitchState:
+                Serve<SwitchController_GetAllSwitchState_Adapter>(*switches, match, format, response);
+                return;
+            case GeneratedRouteId::MetricsController_GetMetrics:
+                Serve<MetricsController_GetMetrics_Adapter>(*metrics, match, format, response);
+                response.contentType = "text/plain; version=0.0.4";
+                return;
+            case GeneratedRouteId::MetricsController_GetBinaryMetrics:
+                Serve<MetricsController_GetBinaryMetrics_Adapter>(*metrics, match, format, response);
+                response.contentType = "application/octet-stream";
+                return;
+            case GeneratedRouteId::ExceptionTestController_ThrowRuntimeException:
+                Serve<ExceptionTestController_ThrowRuntimeException_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ExceptionTestController_ThrowLogicException:
+                Serve<ExceptionTestController_ThrowLogicException_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ExceptionTestController_ThrowStringException:
+                Serve<ExceptionTestController_ThrowStringException_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ExceptionTestController_ThrowIntException:
+                Serve<ExceptionTestController_ThrowIntException_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ExceptionTestController_ThrowCustomException:
+                Serve<ExceptionTestController_ThrowCustomException_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ExceptionTestController_ReturnExpectedError:
+                Serve<ExceptionTestController_ReturnExpectedError_Adapter>(*exceptions, match, format, response);
+                return;
+            case GeneratedRouteId::ResponseEntityController_GetStringResponse:
+                Serve<ResponseEntityController_GetStringResponse_Adapter>(*entities, match, format, response);
+                return;
+            case GeneratedRouteId::ResponseEntityController_GetIntResponse:
+                Serve<ResponseEntityController_GetIntResponse_Adapter>(*entities, match, format, response);
+                return;
+            case GeneratedRouteId::ResponseEntityController_GetOrderResponse:
+                Serve<ResponseEntityController_GetOrderResponse_Adapter>(*entities, match, format, response);
+                return;
+            case GeneratedRouteId::ResponseEntityController_GetVoidResponse:
+                Serve<ResponseEntityController_GetVoidResponse_Adapter>(*entities, match, format, response);
+                return;
+            default:
+                Status(response, 404, kNotFoundBody);
+                return;
+        }
+    }
+
+    // 400 when a path variable does not parse, else the handler's ResponseEntity;
+    // a ResponseEntity<Void> is sent with an empty body
+    Private template<typename Adapter, typename Controller>
+    Static Void Serve(Controller& controller, const StaticRouteMatch& match, WireFormat format, HttpServerResponse& response) {
+        typename Adapter::PathVariables variables;
+        PathVariableFailure failure;
+        if (!Adapter::Parse(match, variables, failure)) {
+            Status(response, 400, failure.Message());
+            return;
+        }
+        auto entity = Adapter::Invoke(controller, variables);
+        response.status = static_cast<Int>(entity.GetStatusCode());
+        if constexpr (std::is_same<decltype(entity), ResponseEntity<Void>>::value) {
+            response.body.clear();
+        } else {
+            Body(entity.GetBody(), format, response);
+        }
+    }
+
+    Private template<typename T>
+    Static Void Body(const T& body, WireFormat format, HttpServerResponse& response) {
+        response.body = WireFormatNegotiator::Encode(format, body);
+        response.contentType = WireFormatNegotiator::ContentTypeFor(format);
+    }
+
+    // Text bodies, the metrics and the test controllers' messages, go out as they are
+    Private Static Void Body(CStdString& body, WireFormat, HttpServerResponse& response) {
+        response.body = body;
+    }
+
+    Private Static Void Status(HttpServerResponse& response, Int status, std::string_view body) {
+        response.status = status;
+        response.body.assign(body.data(), body.size());
+    }
+};
+
+#else
+    #define APPREQUESTHANDLER_AVAILABLE 0
+#endif
+
+#endif // APPREQUESTHANDLER_H
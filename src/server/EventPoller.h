@@ -0,0 +1,222 @@
+#ifndef ARDUINO
+#ifndef EVENTPOLLER_H
+#define EVENTPOLLER_H
+
+#include <StandardDefines.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <unistd.h>
+#include <unordered_map>
+
+// Define as 0 to use poll() on Linux as well
+#ifndef EVENTPOLLER_EPOLL
+    #if defined(__linux__)
+        #define EVENTPOLLER_EPOLL 1
+    #else
+        #define EVENTPOLLER_EPOLL 0
+    #endif
+#endif
+
+#if EVENTPOLLER_EPOLL
+    #include <sys/epoll.h>
+#endif
+
+/**
+ * Readiness notification for ThreadedHttpServer: epoll on Linux, poll()
+ * elsewhere (macOS).
+ *
+ * Sockets are either watched, reported every time they are readable (the
+ * listener), or armed, reported once and then ignored until armed again.
+ * Arming is what lets a worker own a connection while it serves it: the
+ * poller cannot hand the same connection to a second worker meanwhile.
+ * Arm() and Forget() may be called from any thread while Wait() runs.
+ */
+class EventPoller {
+#if EVENTPOLLER_EPOLL
+    Private Int epollFd = -1;
+#else
+    Private struct Entry {
+        void* data;
+        Bool persistent;
+        Bool armed;
+    };
+
+    Private std::mutex mutex;
+    Private std::unordered_map<Int, Entry> entries;
+    Private StdVector<pollfd> pollFds;
+    Private StdVector<void*> pollData;
+#endif
+    // Written by Wake() (and, with poll(), by Arm()) to interrupt Wait()
+    Private Int wakeFds[2] = {-1, -1};
+
+    Public EventPoller() = default;
+
+    EventPoller(const EventPoller&) = delete;
+    EventPoller& operator=(const EventPoller&) = delete;
+
+    Public ~EventPoller() {
+        Close();
+    }
+
+    Public Bool Open() {
+        if (pipe(wakeFds) != 0) {
+            return false;
+        }
+        fcntl(wakeFds[0], F_SETFL, fcntl(wakeFds[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(wakeFds[1], F_SETFL, fcntl(wakeFds[1], F_GETFL, 0) | O_NONBLOCK);
+#if EVENTPOLLER_EPOLL
+        epollFd = epoll_create1(0);
+        if (epollFd < 0) {
+            Close();
+            return false;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFds[0], &event);
+#endif
+        return true;
+    }
+
+    Public Void Close() {
+#if EVENTPOLLER_EPOLL
+        if (epollFd >= 0) {
+            close(epollFd);
+            epollFd = -1;
+        }
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+#endif
+        for (Int& fd : wakeFds) {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    /**
+     * @brief Report fd every time it is readable, until Forget()
+     */
+    Public Bool Watch(Int fd, void* data) {
+#if EVENTPOLLER_EPOLL
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = data;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[fd] = Entry{data, true, true};
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Report fd once, the next time it is readable
+     * @param added false the first time, true when re-arming after a report
+     */
+    Public Bool Arm(Int fd, void* data, Bool added) {
+#if EVENTPOLLER_EPOLL
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = data;
+        return epoll_ctl(epollFd, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+        (Void)added;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries[fd] = Entry{data, false, true};
+        }
+        Wake();
+        return true;
+#endif
+    }
+
+    // Call before closing fd, so a reused descriptor number is not confused with it
+    Public Void Forget(Int fd) {
+#if EVENTPOLLER_EPOLL
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(fd);
+#endif
+    }
+
+    Public Void Wake() {
+        char byte = 0;
+        ssize_t written = write(wakeFds[1], &byte, 1);
+        (Void)written;
+    }
+
+    /**
+     * @brief Wait for readable sockets
+     * @param ready Receives the data pointer of each reported socket
+     * @param timeoutMs -1 to wait until something is ready or Wake() is called
+     * @return Number of entries written to ready; may be 0 after Wake()
+     */
+    Public Int Wait(void** ready, Int capacity, Int timeoutMs) {
+#if EVENTPOLLER_EPOLL
+        epoll_event events[64];
+        Int limit = capacity < 64 ? capacity : 64;
+        Int count = epoll_wait(epollFd, events, limit, timeoutMs);
+        Int reported = 0;
+        for (Int i = 0; i < count; i++) {
+            if (events[i].data.ptr == nullptr) {
+                DrainWake();
+            } else {
+                ready[reported++] = events[i].data.ptr;
+            }
+        }
+        return reported;
+#else
+        pollFds.clear();
+        pollData.clear();
+        pollFds.push_back(pollfd{wakeFds[0], POLLIN, 0});
+        pollData.push_back(nullptr);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : entries) {
+                if (entry.second.armed) {
+                    pollFds.push_back(pollfd{entry.first, POLLIN, 0});
+                    pollData.push_back(entry.second.data);
+                }
+            }
+        }
+        if (poll(pollFds.data(), static_cast<nfds_t>(pollFds.size()), timeoutMs) <= 0) {
+            return 0;
+        }
+        if (pollFds[0].revents != 0) {
+            DrainWake();
+        }
+        Int reported = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Size i = 1; i < pollFds.size() && reported < capacity; i++) {
+            if (pollFds[i].revents == 0) {
+                continue;
+            }
+            auto entry = entries.find(pollFds[i].fd);
+            // Forgotten or re-armed for another connection while poll() ran
+            if (entry == entries.end() || !entry->second.armed || entry->second.data != pollData[i]) {
+                continue;
+            }
+            if (!entry->second.persistent) {
+                entry->second.armed = false;
+            }
+            ready[reported++] = pollData[i];
+        }
+        return reported;
+#endif
+    }
+
+    Private Void DrainWake() {
+        char buffer[64];
+        while (read(wakeFds[0], buffer, sizeof(buffer)) > 0) {
+        }
+    }
+};
+
+#endif // EVENTPOLLER_H
+#endif // ARDUINO
@@ -0,0 +1,222 @@
+#ifndef HTTPCOMPRESSION_H
+#define HTTPCOMPRESSION_H
+
+#include <StandardDefines.h>
+#include <string_view>
+#include "Deflate.h"
+#include "HttpMessage.h"
+
+// Smallest body compressed per response; below it the framing and CPU time outweigh the bytes saved
+#ifndef HTTPSERVER_COMPRESSION_MIN_BYTES
+    #define HTTPSERVER_COMPRESSION_MIN_BYTES 256
+#endif
+
+/**
+ * Response compression for ThreadedHttpServer and SelectHttpServer,
+ * negotiated per request from Accept-Encoding by q-value (gzip on a tie).
+ *
+ * Bodies of at least the threshold are compressed with the connection's
+ * DeflateEncoder and sent compressed only if that made them smaller. Bodies
+ * registered with AddConstant() are compressed once, up front, and served
+ * from the cache at any size, so a constant body costs a lookup instead of
+ * a compression per request.
+ *
+ * Apply() only reads, so one instance can serve every worker; register the
+ * constants before the server starts.
+ *
+ *     HttpCompression compression;
+ *     compression.AddConstant(kSettingsPage);
+ *     server.SetCompression(&compression);
+ */
+class HttpCompression {
+    // Per-connection state Apply() works in; buffers are kept between responses
+    Public struct Buffers {
+        DeflateEncoder encoder;
+        StdString output;
+    };
+
+    Private struct Constant {
+        StdString body;
+        // Empty when that coding does not make the body smaller
+        StdString gzip;
+        StdString deflate;
+    };
+
+    Private Size minimumBytes;
+    Private StdVector<Constant> constants;
+
+    Public explicit HttpCompression(Size minimumBodyBytes = HTTPSERVER_COMPRESSION_MIN_BYTES)
+        : minimumBytes(minimumBodyBytes) {}
+
+    /**
+     * @brief Precompress a body that handlers send unchanged
+     * A body that compression does not make smaller is still recorded and
+     * then always sent as is.
+     */
+    Public Void AddConstant(std::string_view body) {
+        DeflateEncoder encoder;
+        Constant constant;
+        constant.body.assign(body.data(), body.size());
+        encoder.Gzip(body, constant.gzip);
+        encoder.Zlib(body, constant.deflate);
+        if (constant.gzip.size() >= body.size()) {
+            constant.gzip.clear();
+        }
+        if (constant.deflate.size() >= body.size()) {
+            constant.deflate.clear();
+        }
+        constant.gzip.shrink_to_fit();
+        constant.deflate.shrink_to_fit();
+        constants.push_back(std::move(constant));
+    }
+
+    Public Size GetConstantCount() const {
+        return constants.size();
+    }
+
+    Public Bool HasConstant(const StdString& body) const {
+        return FindConstant(body) != nullptr;
+    }
+
+    Public Size GetMinimumBytes() const {
+        return minimumBytes;
+    }
+
+    /**
+     * @brief Encode response.body as the request's Accept-Encoding allows
+     * Responses a handler already encoded are left alone.
+     * @param buffers The connection's; the body is swapped with buffers.output
+     */
+    Public Void Apply(const HttpServerRequest& request, HttpServerResponse& response, Buffers& buffers) const {
+        if (response.contentCoding != HttpContentCoding::Identity) {
+            return;
+        }
+        const Constant* constant = FindConstant(response.body);
+        if (constant != nullptr ? constant->gzip.empty() && constant->deflate.empty()
+                                : response.body.size() < minimumBytes) {
+            return;
+        }
+        response.varyAcceptEncoding = true;
+        HttpContentCoding coding = Negotiate(request.Header("accept-encoding"));
+        if (coding == HttpContentCoding::Identity) {
+            return;
+        }
+
+        if (constant != nullptr) {
+            const StdString& encoded = coding == HttpContentCoding::Gzip ? constant->gzip : constant->deflate;
+            if (!encoded.empty()) {
+                response.body.assign(encoded);
+                response.contentCoding = coding;
+            }
+            return;
+        }
+        buffers.output.clear();
+        if (coding == HttpContentCoding::Gzip) {
+            buffers.encoder.Gzip(response.body, buffers.output);
+        } else {
+            buffers.encoder.Zlib(response.body, buffers.output);
+        }
+        if (buffers.output.size() < response.body.size()) {
+            response.body.swap(buffers.output);
+            response.contentCoding = coding;
+        }
+    }
+
+    /**
+     * @brief Coding to send for an Accept-Encoding value, e.g. "gzip, deflate;q=0.5, br"
+     * The coding with the highest q-value wins, gzip on a tie; q=0 refuses
+     * a coding and "*" stands for every coding not listed.
+     * @param acceptEncoding nullptr when the request has no Accept-Encoding
+     */
+    Public Static HttpContentCoding Negotiate(const std::string_view* acceptEncoding) {
+        if (acceptEncoding == nullptr) {
+            return HttpContentCoding::Identity;
+        }
+        // q-values in thousandths, -1 when not listed
+        Int gzip = -1;
+        Int deflate = -1;
+        Int any = -1;
+        std::string_view rest = *acceptEncoding;
+        while (!rest.empty()) {
+            Size comma = rest.find(',');
+            std::string_view item = rest.substr(0, comma);
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+            Size semicolon = item.find(';');
+            std::string_view name = Trim(item.substr(0, semicolon));
+            Int quality = semicolon != std::string_view::npos ? Quality(item.substr(semicolon + 1)) : 1000;
+            if (HttpServerRequest::HeaderNameEquals(name, "gzip") || HttpServerRequest::HeaderNameEquals(name, "x-gzip")) {
+                gzip = quality;
+            } else if (HttpServerRequest::HeaderNameEquals(name, "deflate")) {
+                deflate = quality;
+            } else if (name == "*") {
+                any = quality;
+            }
+        }
+        if (gzip < 0) {
+            gzip = any;
+        }
+        if (deflate < 0) {
+            deflate = any;
+        }
+        if (gzip > 0 && gzip >= deflate) {
+            return HttpContentCoding::Gzip;
+        }
+        if (deflate > 0) {
+            return HttpContentCoding::Deflate;
+        }
+        return HttpContentCoding::Identity;
+    }
+
+    // Constants are few, so a scan that compares sizes first is enough
+    Private const Constant* FindConstant(const StdString& body) const {
+        for (const Constant& constant : constants) {
+            if (constant.body.size() == body.size() && constant.body == body) {
+                return &constant;
+            }
+        }
+        return nullptr;
+    }
+
+    // q-value in thousandths from parameters such as " q=0.5"; 1000 when there is none or it does not parse
+    Private Static Int Quality(std::string_view parameters) {
+        while (!parameters.empty()) {
+            Size semicolon = parameters.find(';');
+            std::string_view parameter = Trim(parameters.substr(0, semicolon));
+            parameters = semicolon == std::string_view::npos ? std::string_view() : parameters.substr(semicolon + 1);
+            if (parameter.size() < 3 || (parameter[0] | 0x20) != 'q' || parameter[1] != '=') {
+                continue;
+            }
+            // "0", "0.xyz", "1" or "1.000"
+            std::string_view value = parameter.substr(2);
+            if (value[0] != '0' && value[0] != '1') {
+                return 1000;
+            }
+            Int quality = (value[0] - '0') * 1000;
+            if (value.size() > 1 && value[1] != '.') {
+                return 1000;
+            }
+            Int scale = 100;
+            for (Size i = 2; i < value.size() && i < 5; i++) {
+                if (value[i] < '0' || value[i] > '9') {
+                    return 1000;
+                }
+                quality += (value[i] - '0') * scale;
+                scale /= 10;
+            }
+            return quality > 1000 ? 1000 : quality;
+        }
+        return 1000;
+    }
+
+    Private Static std::string_view Trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+};
+
+#endif // HTTPCOMPRESSION_H
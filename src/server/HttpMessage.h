@@ -0,0 +1,330 @@
+#ifndef HTTPMESSAGE_H
+#define HTTPMESSAGE_H
+
+#include <StandardDefines.h>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "../serializer/NumberFormat.h"
+
+// Largest request line plus headers accepted; bigger requests get 431
+#ifndef HTTPSERVER_MAX_HEADER_BYTES
+    #define HTTPSERVER_MAX_HEADER_BYTES 8192
+#endif
+
+// Largest Content-Length accepted; bigger bodies get 413
+#ifndef HTTPSERVER_MAX_BODY_BYTES
+    #define HTTPSERVER_MAX_BODY_BYTES 65536
+#endif
+
+/**
+ * One parsed request. Every field is a view into the buffer the request was
+ * parsed from (the connection's RequestArena), valid until the handler
+ * returns; copy what has to outlive it. The object is reused for the
+ * connection's next request, so the header list keeps its capacity.
+ */
+struct HttpServerRequest {
+    std::string_view method;
+    // Path and query as sent, e.g. "/switch/3/on?source=app"
+    std::string_view target;
+    // Names as sent; Header() ignores their case
+    StdVector<std::pair<std::string_view, std::string_view>> headers;
+    std::string_view body;
+    // HTTP/1.1 unless "Connection: close"; HTTP/1.0 only with "Connection: keep-alive"
+    Bool keepAlive = true;
+
+    // Path without the query string
+    std::string_view Path() const {
+        Size query = target.find('?');
+        return query == std::string_view::npos ? target : target.substr(0, query);
+    }
+
+    /**
+     * @param name Lower-case header name
+     * @return The header's value, or nullptr when absent
+     */
+    const std::string_view* Header(std::string_view name) const {
+        for (const auto& header : headers) {
+            if (HeaderNameEquals(header.first, name)) {
+                return &header.second;
+            }
+        }
+        return nullptr;
+    }
+
+    // name as sent against a lower-case name
+    Static Bool HeaderNameEquals(std::string_view name, std::string_view lowerCase) {
+        if (name.size() != lowerCase.size()) {
+            return false;
+        }
+        for (Size i = 0; i < name.size(); i++) {
+            char c = name[i];
+            if ((c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c) != lowerCase[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Content-Encoding of a response body; see HttpCompression
+enum class HttpContentCoding {
+    Identity,
+    Gzip,
+    // zlib format, as the "deflate" coding is defined
+    Deflate
+};
+
+/**
+ * One response. contentType must outlive the response, which string
+ * literals do; the servers reuse the object per connection, so a handler
+ * that appends to body writes into a buffer that keeps its capacity.
+ */
+struct HttpServerResponse {
+    Int status = 200;
+    std::string_view contentType = "application/json";
+    StdString body;
+    // How body is encoded; handlers leave it Identity and HttpCompression sets it
+    HttpContentCoding contentCoding = HttpContentCoding::Identity;
+    // Whether the body depends on Accept-Encoding, for caches between server and client
+    Bool varyAcceptEncoding = false;
+
+    // Back to a 200 with an empty body, keeping the body's buffer
+    Void Reset() {
+        status = 200;
+        contentType = "application/json";
+        body.clear();
+        contentCoding = HttpContentCoding::Identity;
+        varyAcceptEncoding = false;
+    }
+};
+
+// Called once per request; ThreadedHttpServer may call it from several workers at once
+typedef std::function<HttpServerResponse(const HttpServerRequest&)> HttpRequestHandler;
+
+// Same, filling the connection's reused response (body starts empty) instead of returning one
+typedef std::function<Void(const HttpServerRequest&, HttpServerResponse&)> HttpResponseHandler;
+
+enum class HttpParseStatus {
+    Complete,
+    // The buffer ends before the request does; read more and parse again
+    Incomplete,
+    // Not HTTP/1.x, a feature this server does not speak (chunked bodies), or conflicting Content-Lengths
+    Malformed,
+    HeadersTooLarge,
+    BodyTooLarge
+};
+
+/**
+ * Parses HTTP/1.x requests from a connection's receive buffer into views of
+ * that buffer; nothing is copied or allocated once the request's header list
+ * has grown to size. Stateless: an Incomplete request is parsed again from the
+ * start once more bytes arrive, which for requests of a few hundred bytes is
+ * cheaper than keeping state.
+ */
+class HttpRequestParser {
+    /**
+     * @brief Parse the request at the start of [data, data + size)
+     * @param out Views into data; they stay valid while data does
+     * @param consumed Bytes the request occupies when Complete
+     */
+    Public Static HttpParseStatus Parse(const char* data, Size size, HttpServerRequest& out, Size& consumed) {
+        std::string_view buffer(data, size);
+        Size headerEnd = buffer.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos) {
+            return size > HTTPSERVER_MAX_HEADER_BYTES ? HttpParseStatus::HeadersTooLarge : HttpParseStatus::Incomplete;
+        }
+        if (headerEnd > HTTPSERVER_MAX_HEADER_BYTES) {
+            return HttpParseStatus::HeadersTooLarge;
+        }
+
+        std::string_view head = buffer.substr(0, headerEnd);
+        Size lineEnd = head.find("\r\n");
+        std::string_view requestLine = head.substr(0, lineEnd);
+        if (!ParseRequestLine(requestLine, out)) {
+            return HttpParseStatus::Malformed;
+        }
+
+        out.headers.clear();
+        Size contentLength = 0;
+        Bool lengthSeen = false;
+        Bool http10 = requestLine.substr(requestLine.size() - 3) == "1.0";
+        out.keepAlive = !http10;
+        while (lineEnd != std::string_view::npos) {
+            Size start = lineEnd + 2;
+            lineEnd = head.find("\r\n", start);
+            std::string_view line = head.substr(start, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - start);
+            Size colon = line.find(':');
+            if (colon == std::string_view::npos || colon == 0) {
+                return HttpParseStatus::Malformed;
+            }
+            std::string_view name = line.substr(0, colon);
+            std::string_view value = Trim(line.substr(colon + 1));
+            if (HttpServerRequest::HeaderNameEquals(name, "content-length")) {
+                uint64_t length = 0;
+                if (value.empty() ||
+                    NumberFormat::ParseUInt(value.data(), value.data() + value.size(), length) != value.size()) {
+                    return HttpParseStatus::Malformed;
+                }
+                // Two lengths that disagree leave the body's end ambiguous (request smuggling)
+                if (lengthSeen && length != contentLength) {
+                    return HttpParseStatus::Malformed;
+                }
+                if (length > HTTPSERVER_MAX_BODY_BYTES) {
+                    return HttpParseStatus::BodyTooLarge;
+                }
+                contentLength = static_cast<Size>(length);
+                lengthSeen = true;
+            } else if (HttpServerRequest::HeaderNameEquals(name, "transfer-encoding")) {
+                return HttpParseStatus::Malformed;
+            } else if (HttpServerRequest::HeaderNameEquals(name, "connection")) {
+                if (ContainsToken(value, "close")) {
+                    out.keepAlive = false;
+                } else if (ContainsToken(value, "keep-alive")) {
+                    out.keepAlive = true;
+                }
+            }
+            out.headers.emplace_back(name, value);
+        }
+
+        Size bodyStart = headerEnd + 4;
+        if (size - bodyStart < contentLength) {
+            return HttpParseStatus::Incomplete;
+        }
+        out.body = std::string_view(data + bodyStart, contentLength);
+        consumed = bodyStart + contentLength;
+        return HttpParseStatus::Complete;
+    }
+
+    // "PUT /switch/3/on HTTP/1.1"
+    Private Static Bool ParseRequestLine(std::string_view line, HttpServerRequest& out) {
+        Size firstSpace = line.find(' ');
+        if (firstSpace == std::string_view::npos || firstSpace == 0) {
+            return false;
+        }
+        Size secondSpace = line.find(' ', firstSpace + 1);
+        if (secondSpace == std::string_view::npos || secondSpace == firstSpace + 1) {
+            return false;
+        }
+        if (line.substr(secondSpace + 1).compare(0, 7, "HTTP/1.") != 0) {
+            return false;
+        }
+        out.method = line.substr(0, firstSpace);
+        out.target = line.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+        return true;
+    }
+
+    // Case-insensitive search for a token in a header value such as "Keep-Alive, Upgrade"
+    Private Static Bool ContainsToken(std::string_view value, std::string_view token) {
+        for (Size i = 0; i + token.size() <= value.size(); i++) {
+            Size j = 0;
+            while (j < token.size() && (value[i + j] | 0x20) == token[j]) {
+                j++;
+            }
+            if (j == token.size()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Private Static std::string_view Trim(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+};
+
+inline const char* HttpReasonPhrase(Int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 203: return "Non-Authoritative Information";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+    }
+    return status < 400 ? "OK" : "Error";
+}
+
+/**
+ * @brief Content-Encoding and Vary header lines of a response, CRLF included
+ * @return Empty for an identity body that does not vary
+ */
+inline std::string_view HttpContentCodingHeaders(const HttpServerResponse& response) {
+    switch (response.contentCoding) {
+        case HttpContentCoding::Gzip:
+            return "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n";
+        case HttpContentCoding::Deflate:
+            return "Content-Encoding: deflate\r\nVary: Accept-Encoding\r\n";
+        case HttpContentCoding::Identity:
+            break;
+    }
+    return response.varyAcceptEncoding ? "Vary: Accept-Encoding\r\n" : "";
+}
+
+/**
+ * @brief Append the status line, headers and body of a response, ready to send
+ * Pipelined responses are appended one after another to the same buffer.
+ * @param keepAlive false to announce that the connection closes after this response
+ */
+inline Void AppendHttpResponse(const HttpServerResponse& response, Bool keepAlive, StdString& out) {
+    out.reserve(out.size() + 128 + response.contentType.size() + response.body.size());
+    out += "HTTP/1.1 ";
+    NumberFormat::AppendInt(response.status, out);
+    out += ' ';
+    out += HttpReasonPhrase(response.status);
+    out += "\r\nContent-Type: ";
+    out += response.contentType;
+    out += "\r\n";
+    out += HttpContentCodingHeaders(response);
+    out += "Content-Length: ";
+    NumberFormat::AppendUInt(response.body.size(), out);
+    out += keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    out += response.body;
+}
+
+inline StdString FormatHttpResponse(const HttpServerResponse& response, Bool keepAlive) {
+    StdString out;
+    AppendHttpResponse(response, keepAlive, out);
+    return out;
+}
+
+/**
+ * @brief Response for a request the parser rejected
+ */
+inline HttpServerResponse HttpParseErrorResponse(HttpParseStatus status) {
+    HttpServerResponse response;
+    switch (status) {
+        case HttpParseStatus::HeadersTooLarge:
+            response.status = 431;
+            break;
+        case HttpParseStatus::BodyTooLarge:
+            response.status = 413;
+            break;
+        default:
+            response.status = 400;
+            break;
+    }
+    response.body = "{\"error\":\"";
+    response.body += HttpReasonPhrase(response.status);
+    response.body += "\"}";
+    return response;
+}
+
+#endif // HTTPMESSAGE_H
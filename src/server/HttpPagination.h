@@ -0,0 +1,227 @@
+#ifndef HTTPPAGINATION_H
+#define HTTPPAGINATION_H
+
+#include <StandardDefines.h>
+#include <SerializationUtility.h>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include "../serializer/NumberFormat.h"
+#include "../storage/EntityPage.h"
+#include "HttpMessage.h"
+
+// Page size when a request gives none
+#ifndef HTTPSERVER_DEFAULT_PAGE_SIZE
+    #define HTTPSERVER_DEFAULT_PAGE_SIZE 20
+#endif
+
+// Largest page size a request may ask for
+#ifndef HTTPSERVER_MAX_PAGE_SIZE
+    #ifdef ARDUINO
+        #define HTTPSERVER_MAX_PAGE_SIZE 50
+    #else
+        #define HTTPSERVER_MAX_PAGE_SIZE 1000
+    #endif
+#endif
+
+// Bytes JsonArrayStream collects before handing them on
+#ifndef HTTPSERVER_STREAM_CHUNK_BYTES
+    #ifdef ARDUINO
+        #define HTTPSERVER_STREAM_CHUNK_BYTES 1024
+    #else
+        #define HTTPSERVER_STREAM_CHUNK_BYTES 16384
+    #endif
+#endif
+
+/**
+ * Paging parameters of a request, e.g. "/orders?page=2&size=50&sort=customerId,desc",
+ * for EntityRepository::FindAll(page, size, sortBy, ascending).
+ *
+ * Missing or malformed values keep their defaults, and size is capped at
+ * HTTPSERVER_MAX_PAGE_SIZE so no request can ask for the whole table at once.
+ */
+struct PageRequest {
+    // Zero-based
+    Size page = 0;
+    Size size = HTTPSERVER_DEFAULT_PAGE_SIZE;
+    // Member to sort by; empty for the repository's order
+    StdString sort;
+    Bool ascending = true;
+
+    // From a request target (path and query) or a bare query string
+    Static PageRequest FromTarget(std::string_view target) {
+        PageRequest request;
+        Size query = target.find('?');
+        std::string_view rest = query == std::string_view::npos ? std::string_view() : target.substr(query + 1);
+        while (!rest.empty()) {
+            Size end = rest.find('&');
+            std::string_view parameter = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+            Size equals = parameter.find('=');
+            if (equals == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = parameter.substr(0, equals);
+            std::string_view value = parameter.substr(equals + 1);
+            uint64_t number = 0;
+            if (name == "page" && ParseNumber(value, number)) {
+                request.page = static_cast<Size>(number);
+            } else if (name == "size" && ParseNumber(value, number) && number > 0) {
+                request.size = static_cast<Size>(std::min<uint64_t>(number, HTTPSERVER_MAX_PAGE_SIZE));
+            } else if (name == "sort") {
+                // "member" or "member,asc" / "member,desc"
+                Size comma = value.find(',');
+                request.sort.assign(value.data(), std::min(comma, value.size()));
+                std::string_view direction = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+                request.ascending = direction != "desc" && direction != "DESC";
+            }
+        }
+        return request;
+    }
+
+    Private Static Bool ParseNumber(std::string_view text, uint64_t& value) {
+        return !text.empty() && NumberFormat::ParseUInt(text.data(), text.data() + text.size(), value) == text.size();
+    }
+};
+
+/**
+ * Writes a JSON array to a sink in chunks of about chunkBytes, one element
+ * at a time, so an array of any length costs one element and one chunk of
+ * memory. The chunks are consecutive pieces of the array text; a sink
+ * sends each as it comes, e.g. with the ESP32 WebServer's sendContent()
+ * after a response of unknown length, or as an HTTP chunk (AppendHttpChunk).
+ *
+ *     JsonArrayStream stream([&](std::string_view chunk) { server.sendContent(chunk.data(), chunk.size()); });
+ *     OrderEntityRepository::Cursor cursor = orders.OpenCursor();
+ *     stream.AddAll(cursor);
+ *     stream.Finish();
+ */
+class JsonArrayStream {
+    Public typedef std::function<Void(std::string_view)> Sink;
+
+    Private Sink sink;
+    Private Size chunkBytes;
+    Private StdString buffer;
+    Private Size count = 0;
+    Private Bool finished = false;
+
+    Public explicit JsonArrayStream(Sink output, Size chunk = HTTPSERVER_STREAM_CHUNK_BYTES)
+        : sink(std::move(output)), chunkBytes(chunk) {
+        buffer.reserve(chunkBytes);
+        buffer += '[';
+    }
+
+    // Serializes element with SerializationUtility
+    Public template<typename T>
+    Void Add(const T& element) {
+        AddJson(nayan::serializer::SerializationUtility::Serialize(element));
+    }
+
+    // An element already in JSON
+    Public Void AddJson(std::string_view json) {
+        if (count++ > 0) {
+            buffer += ',';
+        }
+        buffer += json;
+        if (buffer.size() >= chunkBytes) {
+            Flush();
+        }
+    }
+
+    /**
+     * @brief Add every element a cursor returns, e.g. EntityRepository::OpenCursor()
+     * @return Elements added
+     */
+    Public template<typename Cursor>
+    Size AddAll(Cursor& cursor) {
+        Size added = 0;
+        for (auto element = cursor.Next(); element.has_value(); element = cursor.Next()) {
+            Add(element.value());
+            added++;
+        }
+        return added;
+    }
+
+    // Close the array and hand on what is left; later calls do nothing
+    Public Void Finish() {
+        if (finished) {
+            return;
+        }
+        finished = true;
+        buffer += ']';
+        Flush();
+    }
+
+    Public Size GetCount() const {
+        return count;
+    }
+
+    Private Void Flush() {
+        if (!buffer.empty()) {
+            sink(buffer);
+            buffer.clear();
+        }
+    }
+};
+
+/**
+ * @brief Append a page as {"content":[...],"page":0,"size":20,"totalElements":57,"totalPages":3}
+ */
+template<typename T>
+Void AppendPageJson(const EntityPage<T>& page, StdString& out) {
+    out += "{\"content\":[";
+    for (Size i = 0; i < page.content.size(); i++) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += nayan::serializer::SerializationUtility::Serialize(page.content[i]);
+    }
+    out += "],\"page\":";
+    NumberFormat::AppendUInt(page.page, out);
+    out += ",\"size\":";
+    NumberFormat::AppendUInt(page.size, out);
+    out += ",\"totalElements\":";
+    NumberFormat::AppendUInt(page.totalElements, out);
+    out += ",\"totalPages\":";
+    NumberFormat::AppendUInt(page.TotalPages(), out);
+    out += '}';
+}
+
+/**
+ * @brief Append the status line and headers of a response whose body follows in HTTP chunks
+ * Each chunk is then framed with AppendHttpChunk() and the body ended with kHttpLastChunk.
+ */
+inline Void AppendHttpChunkedHead(Int status, std::string_view contentType, Bool keepAlive, StdString& out) {
+    out += "HTTP/1.1 ";
+    NumberFormat::AppendInt(status, out);
+    out += ' ';
+    out += HttpReasonPhrase(status);
+    out += "\r\nContent-Type: ";
+    out += contentType;
+    out += keepAlive ? "\r\nTransfer-Encoding: chunked\r\nConnection: keep-alive\r\n\r\n"
+                     : "\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n\r\n";
+}
+
+// Append data as one HTTP chunk; empty data is skipped, as an empty chunk would end the body
+inline Void AppendHttpChunk(std::string_view data, StdString& out) {
+    if (data.empty()) {
+        return;
+    }
+    static const char kHexDigits[] = "0123456789abcdef";
+    char digits[2 * sizeof(Size)];
+    Size length = 0;
+    for (Size size = data.size(); size > 0; size >>= 4) {
+        digits[length++] = kHexDigits[size & 0xF];
+    }
+    while (length > 0) {
+        out += digits[--length];
+    }
+    out += "\r\n";
+    out += data;
+    out += "\r\n";
+}
+
+// Ends a chunked body
+inline constexpr std::string_view kHttpLastChunk = "0\r\n\r\n";
+
+#endif // HTTPPAGINATION_H
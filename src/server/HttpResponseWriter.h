@@ -0,0 +1,295 @@
+#ifndef HTTPRESPONSEWRITER_H
+#define HTTPRESPONSEWRITER_H
+
+#include <StandardDefines.h>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include "HttpMessage.h"
+
+#ifdef ARDUINO
+    // lwip_writev hands all vectors to one netconn write: one tcp_write chain
+    #include <lwip/sockets.h>
+#else
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+#endif
+
+// Vectors passed to one writev; each response takes up to eight
+#ifndef HTTPSERVER_WRITE_VECTORS
+    #ifdef ARDUINO
+        #define HTTPSERVER_WRITE_VECTORS 16
+    #else
+        #define HTTPSERVER_WRITE_VECTORS 64
+    #endif
+#endif
+
+/**
+ * @brief Status line as a constant, e.g. "HTTP/1.1 404 Not Found\r\n"
+ * @return Empty for statuses without one; the writer formats those
+ */
+inline std::string_view HttpStatusLine(Int status) {
+    switch (status) {
+        case 200: return "HTTP/1.1 200 OK\r\n";
+        case 201: return "HTTP/1.1 201 Created\r\n";
+        case 202: return "HTTP/1.1 202 Accepted\r\n";
+        case 203: return "HTTP/1.1 203 Non-Authoritative Information\r\n";
+        case 204: return "HTTP/1.1 204 No Content\r\n";
+        case 400: return "HTTP/1.1 400 Bad Request\r\n";
+        case 401: return "HTTP/1.1 401 Unauthorized\r\n";
+        case 403: return "HTTP/1.1 403 Forbidden\r\n";
+        case 404: return "HTTP/1.1 404 Not Found\r\n";
+        case 405: return "HTTP/1.1 405 Method Not Allowed\r\n";
+        case 409: return "HTTP/1.1 409 Conflict\r\n";
+        case 413: return "HTTP/1.1 413 Payload Too Large\r\n";
+        case 431: return "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+        case 500: return "HTTP/1.1 500 Internal Server Error\r\n";
+        case 501: return "HTTP/1.1 501 Not Implemented\r\n";
+        case 503: return "HTTP/1.1 503 Service Unavailable\r\n";
+    }
+    return std::string_view();
+}
+
+/**
+ * Per-connection response queue that sends with scatter-gather I/O.
+ *
+ * A handler fills the response returned by Next() in place; the slots are
+ * reused, so their body buffers keep their capacity. Status lines and
+ * headers are constants referenced by the vectors, and only the
+ * Content-Length digits are formatted. Write() sends every queued response,
+ * pipelined ones included, in one writev (on the ESP32, lwIP turns that into
+ * one tcp_write chain), producing the same bytes as AppendHttpResponse().
+ *
+ * GetSyscallCount() and GetBytesCopied() count the writes issued and the
+ * bytes formatted into the writer's own buffers, for benchmarks.
+ */
+class HttpResponseWriter {
+    Private struct Slot {
+        HttpServerResponse response;
+        Bool keepAlive = true;
+        // Status line when there is no constant one, followed by the Content-Length digits
+        char scratch[96];
+        Size statusLength = 0;
+        Size digitsLength = 0;
+    };
+
+    Private StdVector<Slot> slots;
+    Private Size used = 0;
+    Private StdVector<iovec> vectors;
+    // First vector not completely written
+    Private Size written = 0;
+    Private Size pendingBytes = 0;
+    Private Size syscalls = 0;
+    Private Size bytesCopied = 0;
+
+    /**
+     * @brief The next response to fill: 200, application/json, empty body
+     * Only call while nothing is being written (Empty()), or between Commit()s.
+     */
+    Public HttpServerResponse& Next() {
+        if (used == slots.size()) {
+            slots.emplace_back();
+        }
+        HttpServerResponse& response = slots[used].response;
+        response.Reset();
+        return response;
+    }
+
+    /**
+     * @brief Queue the response returned by Next()
+     * @param keepAlive false to announce that the connection closes after it
+     */
+    Public Void Commit(Bool keepAlive) {
+        Slot& slot = slots[used++];
+        slot.keepAlive = keepAlive;
+        slot.statusLength = 0;
+        if (HttpStatusLine(slot.response.status).empty()) {
+            slot.statusLength = FormatStatusLine(slot.response.status, slot.scratch);
+        }
+        slot.digitsLength = FormatDigits(slot.response.body.size(), slot.scratch + slot.statusLength);
+        bytesCopied += slot.statusLength + slot.digitsLength;
+        pendingBytes += slot.statusLength + slot.digitsLength + slot.response.body.size() + 96;
+    }
+
+    // Queue a response built elsewhere; its body is moved in, not copied
+    Public Void Add(HttpServerResponse&& response, Bool keepAlive) {
+        HttpServerResponse& slot = Next();
+        slot.status = response.status;
+        slot.contentType = response.contentType;
+        slot.contentCoding = response.contentCoding;
+        slot.varyAcceptEncoding = response.varyAcceptEncoding;
+        slot.body.swap(response.body);
+        Commit(keepAlive);
+    }
+
+    Public Bool Empty() const {
+        return used == 0;
+    }
+
+    // Roughly the bytes queued, for deciding when to flush pipelined responses
+    Public Size PendingBytes() const {
+        return pendingBytes;
+    }
+
+    Public Size GetSyscallCount() const {
+        return syscalls;
+    }
+
+    Public Size GetBytesCopied() const {
+        return bytesCopied;
+    }
+
+    /**
+     * @brief Send as much as the socket takes without waiting
+     * @return false when the socket failed; the queue is dropped then
+     */
+    Public Bool Write(Int fd) {
+        if (used == 0) {
+            return true;
+        }
+        if (vectors.empty()) {
+            BuildVectors();
+        }
+        while (written < vectors.size()) {
+            Size count = vectors.size() - written;
+            count = count < HTTPSERVER_WRITE_VECTORS ? count : HTTPSERVER_WRITE_VECTORS;
+            syscalls++;
+            ssize_t sent = WriteVectors(fd, &vectors[written], count);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;
+            }
+            if (sent <= 0) {
+                Clear();
+                return false;
+            }
+            Advance(static_cast<Size>(sent));
+        }
+        Clear();
+        return true;
+    }
+
+#ifndef ARDUINO
+    /**
+     * @brief Send everything queued, waiting up to timeoutMs for a slow client
+     * @return false when the socket failed or the client stopped reading
+     */
+    Public Bool Flush(Int fd, Int timeoutMs) {
+        while (!Empty()) {
+            if (!Write(fd)) {
+                return false;
+            }
+            pollfd writable{fd, POLLOUT, 0};
+            if (!Empty() && poll(&writable, 1, timeoutMs) <= 0) {
+                Clear();
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+    // Drop what is queued, e.g. when the connection closes
+    Public Void Clear() {
+        used = 0;
+        vectors.clear();
+        written = 0;
+        pendingBytes = 0;
+    }
+
+    Private Void BuildVectors() {
+        for (Size i = 0; i < used; i++) {
+            Slot& slot = slots[i];
+            std::string_view status = HttpStatusLine(slot.response.status);
+            if (slot.statusLength > 0) {
+                status = std::string_view(slot.scratch, slot.statusLength);
+            }
+            Push(status);
+            std::string_view coding = HttpContentCodingHeaders(slot.response);
+            if (slot.response.contentType == "application/json" && coding.empty()) {
+                Push("Content-Type: application/json\r\nContent-Length: ");
+            } else {
+                if (slot.response.contentType == "application/json") {
+                    Push("Content-Type: application/json\r\n");
+                } else {
+                    Push("Content-Type: ");
+                    Push(slot.response.contentType);
+                    Push("\r\n");
+                }
+                Push(coding);
+                Push("Content-Length: ");
+            }
+            Push(std::string_view(slot.scratch + slot.statusLength, slot.digitsLength));
+            Push(slot.keepAlive ? std::string_view("\r\nConnection: keep-alive\r\n\r\n")
+                                : std::string_view("\r\nConnection: close\r\n\r\n"));
+            Push(slot.response.body);
+        }
+    }
+
+    Private Void Push(std::string_view bytes) {
+        if (!bytes.empty()) {
+            iovec vector;
+            vector.iov_base = const_cast<char*>(bytes.data());
+            vector.iov_len = bytes.size();
+            vectors.push_back(vector);
+        }
+    }
+
+    // Skip what a partial write sent
+    Private Void Advance(Size sent) {
+        while (sent > 0 && written < vectors.size()) {
+            iovec& vector = vectors[written];
+            if (sent < vector.iov_len) {
+                vector.iov_base = static_cast<char*>(vector.iov_base) + sent;
+                vector.iov_len -= sent;
+                return;
+            }
+            sent -= vector.iov_len;
+            written++;
+        }
+    }
+
+    Private Static ssize_t WriteVectors(Int fd, iovec* first, Size count) {
+#if defined(MSG_NOSIGNAL) && !defined(ARDUINO)
+        msghdr message{};
+        message.msg_iov = first;
+        message.msg_iovlen = count;
+        return sendmsg(fd, &message, MSG_NOSIGNAL);
+#else
+        return writev(fd, first, static_cast<int>(count));
+#endif
+    }
+
+    // "HTTP/1.1 299 OK\r\n" for a status without a constant line
+    Private Static Size FormatStatusLine(Int status, char* out) {
+        std::memcpy(out, "HTTP/1.1 ", 9);
+        Size length = 9;
+        length += FormatDigits(static_cast<Size>(status > 0 ? status : 0), out + length);
+        out[length++] = ' ';
+        const char* reason = HttpReasonPhrase(status);
+        while (*reason != '\0' && length < 60) {
+            out[length++] = *reason++;
+        }
+        out[length++] = '\r';
+        out[length++] = '\n';
+        return length;
+    }
+
+    Private Static Size FormatDigits(Size value, char* out) {
+        char reversed[20];
+        Size count = 0;
+        do {
+            reversed[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        for (Size i = 0; i < count; i++) {
+            out[i] = reversed[count - 1 - i];
+        }
+        return count;
+    }
+};
+
+#endif // HTTPRESPONSEWRITER_H
@@ -0,0 +1,101 @@
+#ifndef REQUESTARENA_H
+#define REQUESTARENA_H
+
+#include <StandardDefines.h>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+// First block of a connection's arena; it doubles while a request needs more
+#ifndef HTTPSERVER_ARENA_INITIAL_BYTES
+    #ifdef ARDUINO
+        #define HTTPSERVER_ARENA_INITIAL_BYTES 1024
+    #else
+        #define HTTPSERVER_ARENA_INITIAL_BYTES 4096
+    #endif
+#endif
+
+/**
+ * Per-connection bump arena for the raw request bytes.
+ *
+ * The socket is read straight into the free tail (Reserve / Commit) and the
+ * parser hands out string views into [begin, end), so method, path, headers
+ * and body are never copied. Consume() bumps begin past each answered
+ * request. Reset() runs once the responses are written: it moves the bytes
+ * of a partly received request to the front and invalidates every view.
+ *
+ * The block is kept across requests, so once it has grown to the connection's
+ * largest request no further allocation happens.
+ */
+class RequestArena {
+    Private std::unique_ptr<char[]> block;
+    Private Size capacity = 0;
+    Private Size begin = 0;
+    Private Size end = 0;
+
+    /**
+     * @brief Free space of at least minimum bytes after the received data
+     * Growing moves the data, so call this only while no views are held.
+     * @return Where the next bytes go; Commit() how many were written
+     */
+    Public char* Reserve(Size minimum) {
+        if (capacity - end < minimum) {
+            Size grown = capacity == 0 ? HTTPSERVER_ARENA_INITIAL_BYTES : capacity * 2;
+            while (grown - (end - begin) < minimum) {
+                grown *= 2;
+            }
+            std::unique_ptr<char[]> larger(new char[grown]);
+            if (end > begin) {
+                std::memcpy(larger.get(), block.get() + begin, end - begin);
+            }
+            block = std::move(larger);
+            capacity = grown;
+            end -= begin;
+            begin = 0;
+        }
+        return block.get() + end;
+    }
+
+    Public Void Commit(Size written) {
+        end += written;
+    }
+
+    // Received bytes not yet consumed; the next request starts at data()
+    Public std::string_view Pending() const {
+        return std::string_view(block.get() + begin, end - begin);
+    }
+
+    Public Void Consume(Size count) {
+        begin += count;
+    }
+
+    // Free space left before Reserve() has to grow the block
+    Public Size Available() const {
+        return capacity - end;
+    }
+
+    Public Size Capacity() const {
+        return capacity;
+    }
+
+    // Drop everything received, e.g. when the connection closes
+    Public Void Clear() {
+        begin = end = 0;
+    }
+
+    /**
+     * @brief Drop the consumed requests, keeping the block
+     * Every view handed out since the last Reset() is invalid afterwards.
+     */
+    Public Void Reset() {
+        if (begin == end) {
+            begin = end = 0;
+            return;
+        }
+        std::memmove(block.get(), block.get() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+};
+
+#endif // REQUESTARENA_H
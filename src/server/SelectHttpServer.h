@@ -0,0 +1,299 @@
+#ifndef SELECTHTTPSERVER_H
+#define SELECTHTTPSERVER_H
+
+#include <StandardDefines.h>
+#include <cerrno>
+#include "HttpCompression.h"
+#include "HttpMessage.h"
+#include "HttpResponseWriter.h"
+#include "RequestArena.h"
+
+#ifdef ARDUINO
+    #include <lwip/sockets.h>
+#else
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/select.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+// Connections served at once. lwIP's socket pool (CONFIG_LWIP_MAX_SOCKETS)
+// defaults to 10 and the listener and the framework's server need some.
+#ifndef HTTPSERVER_SELECT_MAX_CONNECTIONS
+    #ifdef ARDUINO
+        #define HTTPSERVER_SELECT_MAX_CONNECTIONS 6
+    #else
+        #define HTTPSERVER_SELECT_MAX_CONNECTIONS 64
+    #endif
+#endif
+
+/**
+ * Single-threaded HTTP/1.1 server on select(), for the ESP32's lwIP stack
+ * (and any BSD socket API). Connections are kept alive and pipelined
+ * requests answered in order, like ThreadedHttpServer, but handlers run on
+ * the caller's thread from Poll(), so it fits into the Arduino loop():
+ *
+ *     SelectHttpServer server(handler);
+ *     server.Start(8080);            // in setup(), once WiFi is up
+ *     server.Poll(0);                // in loop()
+ *
+ * A connection with unsent output is not read from until the output is
+ * gone, so a slow client cannot make its responses pile up in RAM. Requests
+ * are parsed in place in the connection's RequestArena and responses filled
+ * in place in its HttpResponseWriter, whose buffers are kept between
+ * requests, so serving does not fragment the heap. Each batch of responses
+ * goes out in one writev, which lwIP sends as one tcp_write chain.
+ * SetCompression() gzips large bodies before they go out, which over WiFi
+ * takes less time than sending them as they are.
+ */
+class SelectHttpServer {
+    Private struct Connection {
+        Int fd = -1;
+        RequestArena input;
+        HttpServerRequest request;
+        HttpResponseWriter output;
+        Bool closeAfterOutput = false;
+    };
+
+    Private HttpResponseHandler handler;
+    Private const HttpCompression* compression = nullptr;
+    // Handlers run one at a time, so all connections share one encoder
+    Private HttpCompression::Buffers compressionBuffers;
+    Private Int listenFd = -1;
+    Private uint16_t boundPort = 0;
+    Private Connection connections[HTTPSERVER_SELECT_MAX_CONNECTIONS];
+
+    Public explicit SelectHttpServer(HttpResponseHandler responseHandler) : handler(std::move(responseHandler)) {}
+
+    Public explicit SelectHttpServer(HttpRequestHandler requestHandler)
+        : handler([requestHandler](const HttpServerRequest& request, HttpServerResponse& response) {
+              response = requestHandler(request);
+          }) {}
+
+    SelectHttpServer(const SelectHttpServer&) = delete;
+    SelectHttpServer& operator=(const SelectHttpServer&) = delete;
+
+    Public ~SelectHttpServer() {
+        Stop();
+    }
+
+    /**
+     * @param port 0 picks a free port; see GetPort()
+     * @return false when the socket cannot be bound
+     */
+    Public Bool Start(uint16_t port, const char* address = "0.0.0.0") {
+        if (listenFd >= 0) {
+            return false;
+        }
+        sockaddr_in bindAddress{};
+        bindAddress.sin_family = AF_INET;
+        bindAddress.sin_port = htons(port);
+        if (inet_pton(AF_INET, address, &bindAddress.sin_addr) != 1) {
+            return false;
+        }
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&bindAddress), sizeof(bindAddress)) != 0 ||
+            listen(listenFd, HTTPSERVER_SELECT_MAX_CONNECTIONS) != 0 || !SetNonBlocking(listenFd)) {
+            close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+        sockaddr_in actual{};
+        socklen_t length = sizeof(actual);
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&actual), &length);
+        boundPort = ntohs(actual.sin_port);
+        return true;
+    }
+
+    Public Void Stop() {
+        for (Connection& connection : connections) {
+            Close(connection);
+        }
+        if (listenFd >= 0) {
+            close(listenFd);
+            listenFd = -1;
+        }
+    }
+
+    /**
+     * @brief Compress responses the way compression decides; nullptr turns it off
+     * compression must outlive the server.
+     */
+    Public Void SetCompression(const HttpCompression* responseCompression) {
+        compression = responseCompression;
+    }
+
+    Public uint16_t GetPort() const {
+        return boundPort;
+    }
+
+    Public Size GetConnectionCount() const {
+        Size count = 0;
+        for (const Connection& connection : connections) {
+            count += connection.fd >= 0 ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Accept, read, answer and write whatever is ready
+     * @param timeoutMs Longest wait for activity; 0 returns at once
+     * @return Number of requests answered
+     */
+    Public Size Poll(Int timeoutMs) {
+        if (listenFd < 0) {
+            return 0;
+        }
+        fd_set readable;
+        fd_set writable;
+        FD_ZERO(&readable);
+        FD_ZERO(&writable);
+        Int highest = listenFd;
+        Bool slotFree = false;
+        for (const Connection& connection : connections) {
+            if (connection.fd < 0) {
+                slotFree = true;
+                continue;
+            }
+            if (!connection.output.Empty()) {
+                FD_SET(connection.fd, &writable);
+            } else {
+                FD_SET(connection.fd, &readable);
+            }
+            highest = connection.fd > highest ? connection.fd : highest;
+        }
+        // Without a free slot new clients wait in the listen backlog
+        if (slotFree) {
+            FD_SET(listenFd, &readable);
+        }
+
+        timeval timeout{};
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        if (select(highest + 1, &readable, &writable, nullptr, &timeout) <= 0) {
+            return 0;
+        }
+
+        Size answered = 0;
+        for (Connection& connection : connections) {
+            if (connection.fd < 0) {
+                continue;
+            }
+            if (FD_ISSET(connection.fd, &writable)) {
+                Flush(connection);
+            } else if (FD_ISSET(connection.fd, &readable)) {
+                answered += Serve(connection);
+            }
+        }
+        if (slotFree && FD_ISSET(listenFd, &readable)) {
+            Accept();
+        }
+        return answered;
+    }
+
+    Private Void Accept() {
+        for (Connection& connection : connections) {
+            if (connection.fd >= 0) {
+                continue;
+            }
+            Int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            if (!SetNonBlocking(fd)) {
+                close(fd);
+                continue;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            connection.fd = fd;
+        }
+    }
+
+    // Read what arrived and answer every complete request in it
+    Private Size Serve(Connection& connection) {
+        const Size limit = HTTPSERVER_MAX_HEADER_BYTES + HTTPSERVER_MAX_BODY_BYTES + 4;
+        Bool peerOpen = true;
+        while (connection.input.Pending().size() < limit) {
+            char* tail = connection.input.Reserve(connection.input.Available() > 0 ? connection.input.Available() : 512);
+            ssize_t received = recv(connection.fd, tail, connection.input.Available(), 0);
+            if (received > 0) {
+                connection.input.Commit(static_cast<Size>(received));
+                continue;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            peerOpen = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+
+        Size answered = 0;
+        HttpServerRequest& request = connection.request;
+        while (!connection.closeAfterOutput && !connection.input.Pending().empty()) {
+            std::string_view pending = connection.input.Pending();
+            Size consumed = 0;
+            HttpParseStatus status = HttpRequestParser::Parse(pending.data(), pending.size(), request, consumed);
+            if (status == HttpParseStatus::Incomplete) {
+                break;
+            }
+            if (status != HttpParseStatus::Complete) {
+                connection.output.Add(HttpParseErrorResponse(status), false);
+                connection.closeAfterOutput = true;
+                break;
+            }
+            connection.input.Consume(consumed);
+            connection.closeAfterOutput = !request.keepAlive;
+            HttpServerResponse& response = connection.output.Next();
+            handler(request, response);
+            if (compression != nullptr) {
+                compression->Apply(request, response, compressionBuffers);
+            }
+            connection.output.Commit(request.keepAlive);
+            answered++;
+        }
+        // The responses are built, so no view into the arena is left
+        connection.input.Reset();
+        if (!peerOpen) {
+            connection.closeAfterOutput = true;
+        }
+        Flush(connection);
+        return answered;
+    }
+
+    // Send as much output as the socket takes; the rest goes out on a later Poll()
+    Private Void Flush(Connection& connection) {
+        if (!connection.output.Write(connection.fd)) {
+            Close(connection);
+            return;
+        }
+        if (connection.output.Empty() && connection.closeAfterOutput) {
+            Close(connection);
+        }
+    }
+
+    Private Static Void Close(Connection& connection) {
+        if (connection.fd >= 0) {
+            close(connection.fd);
+        }
+        connection.fd = -1;
+        connection.input.Clear();
+        connection.output.Clear();
+        connection.closeAfterOutput = false;
+    }
+
+    Private Static Bool SetNonBlocking(Int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+};
+
+#endif // SELECTHTTPSERVER_H
@@ -0,0 +1,345 @@
+#ifndef ARDUINO
+#ifndef THREADEDHTTPSERVER_H
+#define THREADEDHTTPSERVER_H
+
+#include <StandardDefines.h>
+#include <IThreadPool.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include "EventPoller.h"
+#include "HttpCompression.h"
+#include "HttpMessage.h"
+#include "HttpResponseWriter.h"
+#include "RequestArena.h"
+
+// Time a worker waits for a slow client to take the response
+#ifndef HTTPSERVER_SEND_TIMEOUT_MS
+    #define HTTPSERVER_SEND_TIMEOUT_MS 5000
+#endif
+
+// Open connections beyond this are closed as soon as they are accepted
+#ifndef HTTPSERVER_MAX_CONNECTIONS
+    #define HTTPSERVER_MAX_CONNECTIONS 10000
+#endif
+
+// Pipelined responses are sent once this much output has built up
+#ifndef HTTPSERVER_OUTPUT_FLUSH_BYTES
+    #define HTTPSERVER_OUTPUT_FLUSH_BYTES 65536
+#endif
+
+/**
+ * Desktop HTTP/1.1 server that runs handlers on a ThreadPool.
+ *
+ * One poller thread accepts connections and waits on all of them with
+ * EventPoller (epoll on Linux). When a connection becomes readable it is
+ * handed to a worker, which reads what arrived, answers every complete
+ * request in the buffer in order (pipelining), sends the responses and
+ * re-arms the connection. Idle keep-alive connections cost a buffer and an
+ * epoll entry, not a thread, so thousands of them can stay open.
+ *
+ * Requests are read into the connection's RequestArena and handed to the
+ * handler as views of it. Responses are filled in place in the connection's
+ * HttpResponseWriter and sent with one writev, so a connection in steady
+ * state serves requests without heap allocations of its own. With
+ * SetCompression(), bodies are gzipped per connection on the worker.
+ *
+ *     ThreadedHttpServer server(handler, 4);
+ *     server.Start(8080);
+ */
+class ThreadedHttpServer {
+    Private struct Connection {
+        Int fd;
+        // Received bytes not yet answered
+        RequestArena input;
+        HttpServerRequest request;
+        HttpResponseWriter output;
+        HttpCompression::Buffers compression;
+
+        explicit Connection(Int socket) : fd(socket) {}
+    };
+
+    Private HttpResponseHandler handler;
+    Private const HttpCompression* compression = nullptr;
+    Private ThreadPool workers;
+    Private EventPoller poller;
+    Private Int listenFd = -1;
+    Private std::thread pollThread;
+    Private std::atomic<Bool> running{false};
+    Private uint16_t boundPort = 0;
+    Private std::mutex connectionsMutex;
+    Private std::unordered_map<Int, std::unique_ptr<Connection>> connections;
+
+    Public ThreadedHttpServer(HttpResponseHandler responseHandler, Size workerCount)
+        : handler(std::move(responseHandler)), workers(workerCount > 0 ? workerCount : 1) {}
+
+    Public ThreadedHttpServer(HttpRequestHandler requestHandler, Size workerCount)
+        : ThreadedHttpServer(
+              [requestHandler](const HttpServerRequest& request, HttpServerResponse& response) {
+                  response = requestHandler(request);
+              },
+              workerCount) {}
+
+    ThreadedHttpServer(const ThreadedHttpServer&) = delete;
+    ThreadedHttpServer& operator=(const ThreadedHttpServer&) = delete;
+
+    Public ~ThreadedHttpServer() {
+        Stop();
+    }
+
+    /**
+     * @brief Bind, listen and start the poller thread
+     * @param port 0 picks a free port; see GetPort()
+     * @param address IPv4 address to bind, e.g. "127.0.0.1"
+     * @return false when the socket cannot be bound or the server already runs
+     */
+    Public Bool Start(uint16_t port, const char* address = "0.0.0.0") {
+        if (running.load()) {
+            return false;
+        }
+        sockaddr_in bindAddress{};
+        bindAddress.sin_family = AF_INET;
+        bindAddress.sin_port = htons(port);
+        if (inet_pton(AF_INET, address, &bindAddress.sin_addr) != 1) {
+            return false;
+        }
+
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&bindAddress), sizeof(bindAddress)) != 0 ||
+            listen(listenFd, SOMAXCONN) != 0 || !SetNonBlocking(listenFd) ||
+            !poller.Open() || !poller.Watch(listenFd, this)) {
+            CloseListener();
+            return false;
+        }
+
+        sockaddr_in actual{};
+        socklen_t length = sizeof(actual);
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&actual), &length);
+        boundPort = ntohs(actual.sin_port);
+
+        running.store(true);
+        pollThread = std::thread([this]() { PollLoop(); });
+        return true;
+    }
+
+    /**
+     * @brief Compress responses the way compression decides; nullptr turns it off
+     * Call before Start(); compression must outlive the server.
+     */
+    Public Void SetCompression(const HttpCompression* responseCompression) {
+        compression = responseCompression;
+    }
+
+    Public uint16_t GetPort() const {
+        return boundPort;
+    }
+
+    Public Size GetWorkerCount() const {
+        return workers.GetPoolSize();
+    }
+
+    Public Bool IsRunning() const {
+        return running.load();
+    }
+
+    Public Size GetConnectionCount() {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        return connections.size();
+    }
+
+    /**
+     * @brief Stop accepting, let workers finish the requests they hold and
+     * close every connection
+     * Waits for the workers however long their handlers take: a worker still
+     * serving a connection must not see it freed. Each send gives up after
+     * HTTPSERVER_SEND_TIMEOUT_MS, so slow clients cannot hold Stop() forever.
+     */
+    Public Void Stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        poller.Wake();
+        if (pollThread.joinable()) {
+            pollThread.join();
+        }
+        // 0: no timeout
+        workers.WaitForCompletion(0);
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            for (auto& entry : connections) {
+                close(entry.first);
+            }
+            connections.clear();
+        }
+        CloseListener();
+    }
+
+    Private Void PollLoop() {
+        void* ready[64];
+        while (running.load()) {
+            Int count = poller.Wait(ready, 64, -1);
+            for (Int i = 0; i < count && running.load(); i++) {
+                if (ready[i] == this) {
+                    AcceptAll();
+                    continue;
+                }
+                Connection* connection = static_cast<Connection*>(ready[i]);
+                if (!workers.Submit([this, connection]() { Serve(*connection); })) {
+                    CloseConnection(*connection);
+                }
+            }
+        }
+    }
+
+    Private Void AcceptAll() {
+        while (true) {
+            Int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            if (!SetNonBlocking(fd)) {
+                close(fd);
+                continue;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            if (connections.size() >= HTTPSERVER_MAX_CONNECTIONS) {
+                close(fd);
+                continue;
+            }
+            std::unique_ptr<Connection> connection(new Connection(fd));
+            Connection* armed = connection.get();
+            connections[fd] = std::move(connection);
+            if (!poller.Arm(fd, armed, false)) {
+                connections.erase(fd);
+                close(fd);
+            }
+        }
+    }
+
+    /**
+     * @brief Runs on a worker: read, answer complete requests, re-arm or close
+     * The poller reports a connection once per Arm(), so only this worker
+     * touches it until it is re-armed.
+     */
+    Private Void Serve(Connection& connection) {
+        Bool peerOpen = ReadAvailable(connection);
+        Bool keepAlive = true;
+        HttpServerRequest& request = connection.request;
+        while (keepAlive && !connection.input.Pending().empty()) {
+            std::string_view pending = connection.input.Pending();
+            Size consumed = 0;
+            HttpParseStatus status = HttpRequestParser::Parse(pending.data(), pending.size(), request, consumed);
+            if (status == HttpParseStatus::Incomplete) {
+                break;
+            }
+            if (status != HttpParseStatus::Complete) {
+                connection.output.Add(HttpParseErrorResponse(status), false);
+                keepAlive = false;
+                break;
+            }
+            connection.input.Consume(consumed);
+            keepAlive = request.keepAlive;
+            HttpServerResponse& response = connection.output.Next();
+            Handle(request, response);
+            if (compression != nullptr) {
+                compression->Apply(request, response, connection.compression);
+            }
+            connection.output.Commit(keepAlive);
+            if (connection.output.PendingBytes() >= HTTPSERVER_OUTPUT_FLUSH_BYTES &&
+                !connection.output.Flush(connection.fd, HTTPSERVER_SEND_TIMEOUT_MS)) {
+                keepAlive = false;
+            }
+        }
+        if (!connection.output.Flush(connection.fd, HTTPSERVER_SEND_TIMEOUT_MS) || !keepAlive || !peerOpen || !running.load()) {
+            CloseConnection(connection);
+            return;
+        }
+        // Responses are out, so no view into the arena is left
+        connection.input.Reset();
+        if (!poller.Arm(connection.fd, &connection, true)) {
+            CloseConnection(connection);
+        }
+    }
+
+    // A throwing handler must not take its worker thread down with it
+    Private Void Handle(const HttpServerRequest& request, HttpServerResponse& response) {
+        try {
+            handler(request, response);
+        } catch (...) {
+            response.Reset();
+            response.status = 500;
+            response.body = "{\"error\":\"Internal Server Error\"}";
+        }
+    }
+
+    /**
+     * @brief Receive straight into the arena, up to one largest request at a time
+     * What does not fit stays in the socket, which the poller reports again.
+     * @return false once the peer has closed its side or the socket failed
+     */
+    Private Static Bool ReadAvailable(Connection& connection) {
+        const Size limit = HTTPSERVER_MAX_HEADER_BYTES + HTTPSERVER_MAX_BODY_BYTES + 4;
+        while (connection.input.Pending().size() < limit) {
+            Size room = connection.input.Available() > 0 ? connection.input.Available() : 1024;
+            char* tail = connection.input.Reserve(room);
+            room = connection.input.Available();
+            ssize_t received = recv(connection.fd, tail, room, 0);
+            if (received > 0) {
+                connection.input.Commit(static_cast<Size>(received));
+                if (static_cast<Size>(received) < room) {
+                    return true;
+                }
+                continue;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+        return true;
+    }
+
+    Private Void CloseConnection(Connection& connection) {
+        Int fd = connection.fd;
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        poller.Forget(fd);
+        close(fd);
+        connections.erase(fd);
+    }
+
+    Private Static Bool SetNonBlocking(Int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    Private Void CloseListener() {
+        if (listenFd >= 0) {
+            close(listenFd);
+            listenFd = -1;
+        }
+        poller.Close();
+    }
+};
+
+#endif // THREADEDHTTPSERVER_H
+#endif // ARDUINO
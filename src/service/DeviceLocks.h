@@ -0,0 +1,40 @@
+#ifndef DEVICELOCKS_H
+#define DEVICELOCKS_H
+
+#include <StandardDefines.h>
+#include <mutex>
+
+// Must be a power of two; ids that share a stripe also share a lock
+#ifndef DEVICELOCKS_STRIPES
+    #define DEVICELOCKS_STRIPES 16
+#endif
+
+/**
+ * Striped per-device locks, so commands for different switches run in
+ * parallel while two commands for the same switch are serialized.
+ * A fixed array rather than a map: nothing is allocated or resized while
+ * requests are being served.
+ */
+class DeviceLockTable {
+    static_assert((DEVICELOCKS_STRIPES & (DEVICELOCKS_STRIPES - 1)) == 0, "DEVICELOCKS_STRIPES must be a power of two");
+
+    Private std::mutex stripes[DEVICELOCKS_STRIPES];
+
+    Public DeviceLockTable() = default;
+
+    DeviceLockTable(const DeviceLockTable&) = delete;
+    DeviceLockTable& operator=(const DeviceLockTable&) = delete;
+
+    /**
+     * @brief Lock the stripe owning a device id until the returned lock goes out of scope
+     */
+    Public std::unique_lock<std::mutex> Lock(Int id) {
+        return std::unique_lock<std::mutex>(stripes[StripeOf(id)]);
+    }
+
+    Public Static Size StripeOf(Int id) {
+        return static_cast<Size>(static_cast<unsigned>(id)) & (DEVICELOCKS_STRIPES - 1);
+    }
+};
+
+#endif // DEVICELOCKS_H
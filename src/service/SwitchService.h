@@ -3,6 +3,7 @@
 
 #include <StandardDefines.h>
 #include "ISwitchService.h"
+#include "DeviceLocks.h"
 #include "../IDeviceCollection.h"
 #include "../ISwitchDevice.h"
 #include "../controller/SwitchResponseDto.h"
@@ -13,6 +14,9 @@ class SwitchService : public ISwitchService {
     /* @Autowired */
     Private IDeviceCollectionPtr deviceCollection;
 
+    // Requests may arrive on several worker threads; each device is changed under its own lock
+    Private DeviceLockTable deviceLocks;
+
     Public SwitchService() = default;
 
     Public Virtual ~SwitchService() = default;
@@ -22,6 +26,7 @@ class SwitchService : public ISwitchService {
         if (device == nullptr) {
             return optional<SwitchResponseDto>();
         }
+        std::unique_lock<std::mutex> lock = deviceLocks.Lock(id);
         device->TurnOn();
         return optional<SwitchResponseDto>(device->GetSwitchDetails());
     }
@@ -31,6 +36,7 @@ class SwitchService : public ISwitchService {
         if (device == nullptr) {
             return optional<SwitchResponseDto>();
         }
+        std::unique_lock<std::mutex> lock = deviceLocks.Lock(id);
         device->TurnOff();
         return optional<SwitchResponseDto>(device->GetSwitchDetails());
     }
@@ -40,6 +46,7 @@ class SwitchService : public ISwitchService {
         if (device == nullptr) {
             return optional<SwitchResponseDto>();
         }
+        std::unique_lock<std::mutex> lock = deviceLocks.Lock(id);
         device->Toggle();
         return optional<SwitchResponseDto>(device->GetSwitchDetails());
     }
@@ -49,6 +56,7 @@ class SwitchService : public ISwitchService {
         if (device == nullptr) {
             return optional<SwitchResponseDto>();
         }
+        std::unique_lock<std::mutex> lock = deviceLocks.Lock(id);
         return optional<SwitchResponseDto>(device->GetSwitchDetails());
     }
 
@@ -57,6 +65,7 @@ class SwitchService : public ISwitchService {
         for (Int i = 1; i <= 3; i++) {
             ISwitchDevicePtr device = deviceCollection->GetSwitchDeviceById(i);
             if (device != nullptr) {
+                std::unique_lock<std::mutex> lock = deviceLocks.Lock(i);
                 result.push_back(device->GetSwitchDetails());
             }
         }
@@ -67,6 +76,7 @@ class SwitchService : public ISwitchService {
         for (Int i = 1; i <= 4; i++) {
             ISwitchDevicePtr device = deviceCollection->GetSwitchDeviceById(i);
             if (device != nullptr) {
+                std::unique_lock<std::mutex> lock = deviceLocks.Lock(i);
                 device->Refresh();
             }
         }
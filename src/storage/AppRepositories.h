@@ -0,0 +1,77 @@
+#ifndef APPREPOSITORIES_H
+#define APPREPOSITORIES_H
+
+#if __has_include(<GeneratedEntityRepositories.h>)
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+#include <GeneratedEntityRepositories.h>
+#include "HashedFileManager.h"
+#ifndef ARDUINO
+    #include "DirectoryFileManager.h"
+#endif
+
+#define APPREPOSITORIES_AVAILABLE 1
+
+/**
+ * The repositories the app itself reads and writes, built from the
+ * generated *EntityRepository classes so that their @Cache and @Storage
+ * annotations take effect, instead of the framework's CpaRepositoryImpl.
+ *
+ * Records go through Files(): on the desktop a DirectoryFileManager over
+ * DirectoryFileManager::ConfiguredRoot(), on the ESP32 the framework's
+ * IFileManager. Each repository is created on first use; before that, the
+ * files the framework wrote for its entity under hashed names are moved to
+ * the names EntityFileStore reads, so saved state survives the switch.
+ *
+ *     SwitchRepositoryPtr switches = AppRepositories::Switches();
+ */
+class AppRepositories {
+    Public Static IFileManagerPtr Files() {
+#ifdef ARDUINO
+        static IFileManagerPtr files = Implementation<IFileManager>::type::GetInstance();
+#else
+        static IFileManagerPtr files = std::make_shared<DirectoryFileManager>(DirectoryFileManager::ConfiguredRoot());
+#endif
+        return files;
+    }
+
+    // @Cache("pinned"): a handful of switches, read on every request
+    Public Static SwitchRepositoryPtr Switches() {
+        static SwitchRepositoryPtr switches = Open<SwitchEntityRepository>("Switch");
+        return switches;
+    }
+
+    Public Static UserRepositoryPtr Users() {
+        static UserRepositoryPtr users = Open<UserEntityRepository>("User");
+        return users;
+    }
+
+    Private template<typename Repository>
+    Static std::shared_ptr<Repository> Open(CStdString& entityName) {
+        IFileManagerPtr files = Files();
+        MoveLegacyFiles(*files, entityName);
+        return std::make_shared<Repository>(files);
+    }
+
+    /**
+     * @brief Move an entity's files from HashedFileManager::LegacyFileName() names to their own
+     * Records first and the id list last, so a move cut short is finished by the next call.
+     */
+    Public Static Void MoveLegacyFiles(IFileManager& files, CStdString& entityName) {
+        StdVector<StdString> names = HashedFileManager::LegacyEntityFiles(files, entityName);
+        for (Size i = names.size(); i-- > 0;) {
+            StdString legacyFile = HashedFileManager::LegacyFileName(names[i]);
+            StdString contents = files.Read(legacyFile);
+            if (!contents.empty() && files.Create(names[i], contents)) {
+                files.Delete(legacyFile);
+            }
+        }
+    }
+};
+
+#else
+    #define APPREPOSITORIES_AVAILABLE 0
+#endif
+
+#endif // APPREPOSITORIES_H
@@ -0,0 +1,478 @@
+#ifndef DIRECTORYFILEMANAGER_H
+#define DIRECTORYFILEMANAGER_H
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "IFileSyncer.h"
+#include "RecordView.h"
+
+// Mappings a DirectoryFileManager with mapped reads keeps open for files read again
+#ifndef DIRECTORYFILEMANAGER_MAPPED_FILES
+#define DIRECTORYFILEMANAGER_MAPPED_FILES 1024
+#endif
+
+// Environment variable that overrides the storage root, see ConfiguredRoot()
+#ifndef DIRECTORYFILEMANAGER_ROOT_VARIABLE
+#define DIRECTORYFILEMANAGER_ROOT_VARIABLE "DB_ROOT"
+#endif
+
+// Storage root when the variable is not set, relative to the working directory
+#ifndef DIRECTORYFILEMANAGER_DEFAULT_ROOT
+#define DIRECTORYFILEMANAGER_DEFAULT_ROOT "./db"
+#endif
+
+DefineStandardPointers(DirectoryFileManager)
+
+/**
+ * IFileManager over one directory of the desktop filesystem, each file
+ * named as given under root.
+ *
+ * The framework's desktop file manager writes to a fixed directory; this
+ * one takes the directory from its caller, so tests and benchmarks can
+ * keep their files apart, and ConfiguredRoot() reads it from the
+ * environment. Plain POSIX calls, one open/read or open/write per
+ * operation, no fsync: a crash can lose recent writes, as with the
+ * framework's, unless Sync() flushed them. Sync() fsyncs each file written
+ * since the last one, and each directory a file was created in or removed
+ * from.
+ *
+ * With shardBuckets, files are spread over that many subdirectories named
+ * by a hash of the file name, e.g. "<root>/a7/Product_id_42" for 256, so
+ * no directory grows past a few hundred entries with 100k files. The hash
+ * is FNV-1a, the same on every platform and run; a directory written with
+ * one layout must be read with the same one.
+ *
+ * List() scans the directory once and then keeps the names up to date
+ * with this manager's own writes, so later listings and Exists() cost no
+ * system call; files added or removed by anything else are not seen.
+ *
+ * With mapReads, View() maps a file instead of reading it, so a record is
+ * parsed straight from the page cache without a copy, and keeps the mappings
+ * of the last mappedFiles files viewed, so a file viewed again costs no
+ * system call at all. A write through this manager drops the file's mapping,
+ * under the lock View() takes, so no later view maps the old file. Files
+ * changed by anything else are not noticed while they stay mapped. Read()
+ * reads either way.
+ *
+ * Create and Update write a temporary file next to the file and rename it
+ * into place, so a reader sees the old contents or the new ones, never part
+ * of a write, and a view still held keeps the old file instead of faulting.
+ * Temporary files are named ".~<name>.<n>" and never listed.
+ *
+ * Mapping a small file once costs more than reading it (mmap, a page fault
+ * and munmap against one read), so mapReads pays off for files viewed again
+ * while their mapping is kept, or for large ones; see storage_bench's FindAll.
+ */
+class DirectoryFileManager : public IFileManager, public IFileViewReader, public IFileSyncer {
+    Public struct Options {
+        // View() maps files; otherwise it reads them like Read()
+        Bool mapReads = false;
+        // Mappings kept for files viewed again; 0 unmaps each once its view is gone
+        Size mappedFiles = DIRECTORYFILEMANAGER_MAPPED_FILES;
+        // Subdirectories files are spread over, at most 4096; 0 keeps every file in root
+        Size shardBuckets = 0;
+    };
+
+    Public struct Stats {
+        Size mappings = 0;
+        Size mappingHits = 0;
+        // Mappings open now, held by the manager or by views
+        Size openMappings = 0;
+        // Directory scans for List(); one unless nothing has been listed yet
+        Size listScans = 0;
+        // Files and directories fsynced by Sync()
+        Size syncs = 0;
+    };
+
+    // One mapped file, unmapped when the last view of it is gone
+    Private class Mapping {
+        Private void* address;
+        Private Size length;
+
+        Public Mapping(void* start, Size bytes) : address(start), length(bytes) {}
+
+        Public ~Mapping() {
+            ::munmap(address, length);
+        }
+
+        Public std::string_view Data() const {
+            return std::string_view(static_cast<const char*>(address), length);
+        }
+    };
+
+    Private struct MappedFile {
+        StdString filename;
+        std::shared_ptr<const Mapping> mapping;
+    };
+
+    Private StdString root;
+    Private Options options;
+    Private std::mutex mutex;
+    // Most recently viewed first
+    Private std::list<MappedFile> mapped;
+    Private StdUnorderedMap<StdString, std::list<MappedFile>::iterator> mappedByName;
+    Private Stats stats;
+    // Names of every file once List() has scanned them
+    Private StdUnorderedSet<StdString> listing;
+    Private Bool listed = false;
+    // Written, and directories with files created or removed, since the last Sync()
+    Private StdUnorderedSet<StdString> unsynced;
+    Private StdUnorderedSet<StdString> unsyncedDirectories;
+    Private std::shared_ptr<std::atomic<Size>> openMappings = std::make_shared<std::atomic<Size>>(0);
+    // Numbers temporary files, so concurrent writes of one file do not share one
+    Private std::atomic<uint64_t> temporaryFiles{0};
+
+    /**
+     * @param rootDirectory Created if missing; its parent must exist
+     */
+    Public explicit DirectoryFileManager(CStdString& rootDirectory) : DirectoryFileManager(rootDirectory, Options()) {}
+
+    Public DirectoryFileManager(CStdString& rootDirectory, const Options& managerOptions)
+        : root(rootDirectory), options(managerOptions) {
+        options.shardBuckets = std::min<Size>(options.shardBuckets, 4096);
+        ::mkdir(root.c_str(), 0755);
+    }
+
+    // DIRECTORYFILEMANAGER_ROOT_VARIABLE from the environment, or DIRECTORYFILEMANAGER_DEFAULT_ROOT
+    Public Static StdString ConfiguredRoot() {
+        const char* configured = std::getenv(DIRECTORYFILEMANAGER_ROOT_VARIABLE);
+        return configured != nullptr && configured[0] != '\0' ? StdString(configured) : StdString(DIRECTORYFILEMANAGER_DEFAULT_ROOT);
+    }
+
+    Public Bool Create(CStdString& filename, CStdString& contents) override {
+        return WriteFile(filename, contents, O_TRUNC);
+    }
+
+    // Empty when the file does not exist
+    Public StdString Read(CStdString& filename) override {
+        StdString contents;
+        Int fd = ::open(PathOf(filename).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return contents;
+        }
+        struct stat status;
+        if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+            contents.resize(static_cast<Size>(status.st_size));
+            Size done = 0;
+            while (done < contents.size()) {
+                ssize_t count = ::read(fd, &contents[done], contents.size() - done);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    break;
+                }
+                done += static_cast<Size>(count);
+            }
+            contents.resize(done);
+        }
+        ::close(fd);
+        return contents;
+    }
+
+    Public Bool Update(CStdString& filename, CStdString& contents) override {
+        return WriteFile(filename, contents, O_TRUNC);
+    }
+
+    Public Bool Delete(CStdString& filename) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        Bool deleted = ::unlink(PathOf(filename).c_str()) == 0;
+        DropMapping(filename);
+        if (listed) {
+            listing.erase(filename);
+        }
+        unsynced.erase(filename);
+        unsyncedDirectories.insert(DirectoryOf(filename));
+        return deleted;
+    }
+
+    // Files and directories that fail to sync are retried by the next call
+    Public Bool Sync() override {
+        StdUnorderedSet<StdString> files;
+        StdUnorderedSet<StdString> directories;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            files.swap(unsynced);
+            directories.swap(unsyncedDirectories);
+        }
+        StdVector<StdString> failed;
+        StdVector<StdString> failedDirectories;
+        for (CStdString& filename : files) {
+            if (!SyncPath(PathOf(filename))) {
+                failed.push_back(filename);
+            }
+        }
+        for (CStdString& directory : directories) {
+            if (!SyncPath(directory)) {
+                failedDirectories.push_back(directory);
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.syncs += files.size() + directories.size();
+        unsynced.insert(failed.begin(), failed.end());
+        unsyncedDirectories.insert(failedDirectories.begin(), failedDirectories.end());
+        return failed.empty() && failedDirectories.empty();
+    }
+
+    Public Bool Append(CStdString& filename, CStdString& contents) override {
+        return WriteFile(filename, contents, O_APPEND);
+    }
+
+    // Mapped with mapReads, otherwise read; empty when the file does not exist
+    Public RecordView View(CStdString& filename) override {
+        if (!options.mapReads) {
+            return RecordView(Read(filename));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = mappedByName.find(filename);
+        if (it != mappedByName.end()) {
+            stats.mappingHits++;
+            mapped.splice(mapped.begin(), mapped, it->second);
+            const std::shared_ptr<const Mapping>& mapping = it->second->mapping;
+            return RecordView(mapping, mapping->Data());
+        }
+        std::shared_ptr<const Mapping> mapping = Map(filename);
+        if (mapping == nullptr) {
+            return RecordView();
+        }
+        if (options.mappedFiles > 0) {
+            mapped.push_front(MappedFile{filename, mapping});
+            mappedByName.emplace(filename, mapped.begin());
+            while (mapped.size() > options.mappedFiles) {
+                mappedByName.erase(mapped.back().filename);
+                mapped.pop_back();
+            }
+        }
+        return RecordView(mapping, mapping->Data());
+    }
+
+    // Every file name, in no particular order; scanned on the first call only
+    Public StdVector<StdString> List() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Scan();
+        return StdVector<StdString>(listing.begin(), listing.end());
+    }
+
+    // From the listing once List() has been called, otherwise with one stat
+    Public Bool Exists(CStdString& filename) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (listed) {
+                return listing.count(filename) > 0;
+            }
+        }
+        struct stat status;
+        return ::stat(PathOf(filename).c_str(), &status) == 0;
+    }
+
+    Public const Options& GetOptions() const {
+        return options;
+    }
+
+    Public Stats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats current = stats;
+        current.openMappings = openMappings->load();
+        return current;
+    }
+
+    Public CStdString& GetRoot() const {
+        return root;
+    }
+
+    Public StdString PathOf(CStdString& filename) const {
+        if (options.shardBuckets == 0) {
+            return root + "/" + filename;
+        }
+        return ShardDirectory(ShardOf(filename)) + "/" + filename;
+    }
+
+    Public StdString DirectoryOf(CStdString& filename) const {
+        return options.shardBuckets == 0 ? root : ShardDirectory(ShardOf(filename));
+    }
+
+    // FNV-1a of the name, modulo shardBuckets
+    Public Size ShardOf(CStdString& filename) const {
+        uint32_t hash = 2166136261u;
+        for (char c : filename) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+        return options.shardBuckets == 0 ? 0 : hash % options.shardBuckets;
+    }
+
+    // Appends in place; otherwise writes a temporary file and renames it over the file
+    Private Bool WriteFile(CStdString& filename, CStdString& contents, Int mode) {
+        StdString path = PathOf(filename);
+        if (mode == O_APPEND) {
+            // With mapReads, held across the write so View() cannot map the file before the old mapping is dropped
+            std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+            if (options.mapReads) {
+                lock.lock();
+            }
+            Bool written = WriteTo(path, filename, contents, O_APPEND);
+            if (!lock.owns_lock()) {
+                lock.lock();
+            }
+            Written(filename);
+            return written;
+        }
+        StdString temporary = DirectoryOf(filename) + "/.~" + filename + "." + std::to_string(temporaryFiles++);
+        if (!WriteTo(temporary, filename, contents, O_TRUNC | O_EXCL)) {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (::rename(temporary.c_str(), path.c_str()) != 0) {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        Written(filename);
+        return true;
+    }
+
+    Private Bool WriteTo(CStdString& path, CStdString& filename, CStdString& contents, Int mode) {
+        Int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | mode, 0644);
+        if (fd < 0 && errno == ENOENT && options.shardBuckets > 0) {
+            // The shard's first file
+            ::mkdir(ShardDirectory(ShardOf(filename)).c_str(), 0755);
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | mode, 0644);
+        }
+        if (fd < 0) {
+            return false;
+        }
+        Size done = 0;
+        while (done < contents.size()) {
+            ssize_t count = ::write(fd, contents.data() + done, contents.size() - done);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            done += static_cast<Size>(count);
+        }
+        return ::close(fd) == 0 && done == contents.size();
+    }
+
+    // After a write: the old mapping goes, the listing and Sync() learn of the file; the lock must be held
+    Private Void Written(CStdString& filename) {
+        DropMapping(filename);
+        if (listed) {
+            listing.insert(filename);
+        }
+        unsynced.insert(filename);
+        unsyncedDirectories.insert(DirectoryOf(filename));
+    }
+
+    // A file removed since it was written has nothing left to sync
+    Private Static Bool SyncPath(CStdString& path) {
+        Int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errno == ENOENT;
+        }
+        Bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+
+    // Null when the file does not exist or is empty, which cannot be mapped
+    Private std::shared_ptr<const Mapping> Map(CStdString& filename) {
+        Int fd = ::open(PathOf(filename).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat status;
+        void* address = MAP_FAILED;
+        Size length = 0;
+        if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+            length = static_cast<Size>(status.st_size);
+            address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        // The mapping outlives the descriptor
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            return nullptr;
+        }
+        stats.mappings++;
+        (*openMappings)++;
+        // Counted down as the last view goes, which may be after the lock is released
+        std::shared_ptr<std::atomic<Size>> counter = openMappings;
+        return std::shared_ptr<const Mapping>(new Mapping(address, length), [counter](const Mapping* mapping) {
+            delete mapping;
+            (*counter)--;
+        });
+    }
+
+    // Two hex digits for 256 buckets, three for up to 4096
+    Private StdString ShardDirectory(Size shard) const {
+        static const char kHexDigits[] = "0123456789abcdef";
+        StdString directory = root + "/";
+        for (Size shift = options.shardBuckets > 256 ? 8 : options.shardBuckets > 16 ? 4 : 0;; shift -= 4) {
+            directory += kHexDigits[(shard >> shift) & 0xF];
+            if (shift == 0) {
+                break;
+            }
+        }
+        return directory;
+    }
+
+    // Reads the names into listing unless already done; the lock must be held
+    Private Void Scan() {
+        if (listed) {
+            return;
+        }
+        listed = true;
+        stats.listScans++;
+        if (options.shardBuckets == 0) {
+            ScanDirectory(root);
+            return;
+        }
+        for (Size shard = 0; shard < options.shardBuckets; shard++) {
+            ScanDirectory(ShardDirectory(shard));
+        }
+    }
+
+    Private Void ScanDirectory(CStdString& directory) {
+        DIR* handle = ::opendir(directory.c_str());
+        if (handle == nullptr) {
+            return;
+        }
+        for (struct dirent* entry = ::readdir(handle); entry != nullptr; entry = ::readdir(handle)) {
+            // Shard directories, "." and ".." are not files, nor are temporary files
+            if (entry->d_type == DT_DIR || (entry->d_name[0] == '.' && entry->d_name[1] == '~')) {
+                continue;
+            }
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat status;
+                if (::stat((directory + "/" + entry->d_name).c_str(), &status) != 0 || S_ISDIR(status.st_mode)) {
+                    continue;
+                }
+            }
+            listing.emplace(entry->d_name);
+        }
+        ::closedir(handle);
+    }
+
+    // The lock must be held
+    Private Void DropMapping(CStdString& filename) {
+        auto it = mappedByName.find(filename);
+        if (it != mappedByName.end()) {
+            mapped.erase(it->second);
+            mappedByName.erase(it);
+        }
+    }
+};
+
+#endif // DIRECTORYFILEMANAGER_H
@@ -0,0 +1,210 @@
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include <StandardDefines.h>
+#include <list>
+
+// Entities an LRU cache holds unless configured otherwise
+#ifndef ENTITYCACHE_DEFAULT_ENTRIES
+#ifdef ARDUINO
+#define ENTITYCACHE_DEFAULT_ENTRIES 16
+#else
+#define ENTITYCACHE_DEFAULT_ENTRIES 1024
+#endif
+#endif
+
+// Record bytes a size-bounded cache holds unless configured otherwise
+#ifndef ENTITYCACHE_DEFAULT_BYTES
+#ifdef ARDUINO
+#define ENTITYCACHE_DEFAULT_BYTES 4096
+#else
+#define ENTITYCACHE_DEFAULT_BYTES 1048576
+#endif
+#endif
+
+/**
+ * How an EntityCache bounds itself. A @Repository picks one with
+ * @Cache("lru"), @Cache("size") or @Cache("pinned"), optionally followed by
+ * the bound, e.g. @Cache("lru", 64); without the annotation there is no cache.
+ */
+struct EntityCacheOptions {
+    enum class Mode {
+        // Every read goes to the store
+        Off,
+        // At most maxEntries entities, least recently used evicted first
+        Lru,
+        // At most maxBytes of serialized records, least recently used evicted first
+        SizeBounded,
+        // Every entity read or written stays; for tables of a few entities
+        Pinned
+    };
+
+    Mode mode = Mode::Off;
+    Size maxEntries = ENTITYCACHE_DEFAULT_ENTRIES;
+    Size maxBytes = ENTITYCACHE_DEFAULT_BYTES;
+
+    Static EntityCacheOptions Off() {
+        return EntityCacheOptions();
+    }
+
+    Static EntityCacheOptions Lru(Size entries = ENTITYCACHE_DEFAULT_ENTRIES) {
+        EntityCacheOptions options;
+        options.mode = Mode::Lru;
+        options.maxEntries = entries;
+        return options;
+    }
+
+    Static EntityCacheOptions SizeBounded(Size bytes = ENTITYCACHE_DEFAULT_BYTES) {
+        EntityCacheOptions options;
+        options.mode = Mode::SizeBounded;
+        options.maxBytes = bytes;
+        return options;
+    }
+
+    Static EntityCacheOptions Pinned() {
+        EntityCacheOptions options;
+        options.mode = Mode::Pinned;
+        return options;
+    }
+};
+
+/**
+ * Deserialized entities by key, in front of an EntityRepository's store.
+ *
+ * Entries are kept in recency order; Find() moves a hit to the front and
+ * Put() evicts from the back until the bounds hold again. Entries are sized
+ * by their serialized record, the closest measure of what they hold that
+ * does not depend on T. Not synchronized: the repository's mutex covers it.
+ */
+template<typename T>
+class EntityCache {
+    Public struct Counters {
+        Size hits = 0;
+        Size misses = 0;
+        Size evictions = 0;
+    };
+
+    Private struct Entry {
+        StdString key;
+        T entity;
+        Size bytes;
+    };
+
+    Private EntityCacheOptions options;
+    Private std::list<Entry> entries;
+    Private StdUnorderedMap<StdString, typename std::list<Entry>::iterator> byKey;
+    Private Size bytes = 0;
+    Private Counters counters;
+
+    Public EntityCache() = default;
+
+    Public explicit EntityCache(const EntityCacheOptions& cacheOptions) : options(cacheOptions) {}
+
+    // Changing the options empties the cache; counters are kept
+    Public Void Configure(const EntityCacheOptions& cacheOptions) {
+        options = cacheOptions;
+        Clear();
+    }
+
+    Public const EntityCacheOptions& GetOptions() const {
+        return options;
+    }
+
+    Public Bool IsEnabled() const {
+        return options.mode != EntityCacheOptions::Mode::Off;
+    }
+
+    /**
+     * @brief The cached entity for key, counted as a hit or a miss
+     * @return nullptr on a miss; valid until the next Put, Erase or Clear
+     */
+    Public const T* Find(CStdString& key) {
+        if (!IsEnabled()) {
+            return nullptr;
+        }
+        auto it = byKey.find(key);
+        if (it == byKey.end()) {
+            counters.misses++;
+            return nullptr;
+        }
+        counters.hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->entity;
+    }
+
+    /**
+     * @brief Cache entity under key, replacing what was there
+     * @param recordBytes Size of its serialized record
+     */
+    Public Void Put(CStdString& key, const T& entity, Size recordBytes) {
+        if (!IsEnabled()) {
+            return;
+        }
+        auto it = byKey.find(key);
+        if (it != byKey.end()) {
+            bytes -= it->second->bytes;
+            it->second->entity = entity;
+            it->second->bytes = recordBytes;
+            entries.splice(entries.begin(), entries, it->second);
+        } else {
+            entries.push_front(Entry{key, entity, recordBytes});
+            byKey.emplace(key, entries.begin());
+        }
+        bytes += recordBytes;
+        Evict();
+    }
+
+    Public Void Erase(CStdString& key) {
+        auto it = byKey.find(key);
+        if (it == byKey.end()) {
+            return;
+        }
+        bytes -= it->second->bytes;
+        entries.erase(it->second);
+        byKey.erase(it);
+    }
+
+    Public Void Clear() {
+        entries.clear();
+        byKey.clear();
+        bytes = 0;
+    }
+
+    Public Size GetEntryCount() const {
+        return entries.size();
+    }
+
+    Public Size GetBytes() const {
+        return bytes;
+    }
+
+    Public const Counters& GetCounters() const {
+        return counters;
+    }
+
+    Public Void ResetCounters() {
+        counters = Counters();
+    }
+
+    Private Void Evict() {
+        while (!entries.empty() && OverBound()) {
+            bytes -= entries.back().bytes;
+            byKey.erase(entries.back().key);
+            entries.pop_back();
+            counters.evictions++;
+        }
+    }
+
+    Private Bool OverBound() const {
+        switch (options.mode) {
+            case EntityCacheOptions::Mode::Lru:
+                return entries.size() > options.maxEntries;
+            case EntityCacheOptions::Mode::SizeBounded:
+                return bytes > options.maxBytes;
+            default:
+                return false;
+        }
+    }
+};
+
+#endif // ENTITYCACHE_H
@@ -0,0 +1,188 @@
+#ifndef ENTITYFILESTORE_H
+#define ENTITYFILESTORE_H
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+#include <algorithm>
+#include <string_view>
+#include "IEntityStore.h"
+#include "IFileSyncer.h"
+#include "RecordView.h"
+
+/**
+ * File-per-entity record store over an IFileManager, in the framework's
+ * layout: each record in "<Entity>_id_<key>" and the keys, one per line,
+ * in "<Entity>_IDs".
+ *
+ * The key list is read once and then kept in memory, so Contains() and the
+ * key order for FindAll() cost no I/O. A new key is appended to the list; only
+ * a removal rewrites it. WriteAll() appends every new key of the batch at
+ * once and RemoveAll() rewrites the list once, however many keys they touch.
+ *
+ * When the file manager is also an IFileViewReader, e.g. a DirectoryFileManager
+ * with mapped reads, ReadView() returns records in place rather than copied.
+ *
+ * IFileManager cannot flush a file to storage, so Sync() goes through the
+ * file manager's IFileSyncer, e.g. a DirectoryFileManager's. Over any other
+ * file manager the store cannot sync and EntityRepository::AttachJournal()
+ * refuses it: a journal could never drop the records written through it.
+ */
+DefineStandardPointers(EntityFileStore)
+class EntityFileStore : public IEntityStore {
+    Private IFileManagerPtr files;
+    Private IFileViewReader* views = nullptr;
+    Private IFileSyncer* syncer = nullptr;
+    Private StdString prefix;
+    Private StdString listFile;
+    Private StdVector<StdString> keys;
+    Private StdUnorderedSet<StdString> keySet;
+    Private Bool loaded = false;
+
+    Public EntityFileStore(IFileManagerPtr fileManager, CStdString& entityName)
+        : files(fileManager), prefix(entityName + "_id_"), listFile(entityName + "_IDs") {
+#ifndef ARDUINO
+        // Only desktop file managers map or sync files
+        views = dynamic_cast<IFileViewReader*>(files.get());
+        syncer = dynamic_cast<IFileSyncer*>(files.get());
+#endif
+    }
+
+    Public Bool Write(CStdString& key, CStdString& record) override {
+        Load();
+        if (keySet.count(key) > 0) {
+            return files->Update(FileOf(key), record);
+        }
+        if (!files->Create(FileOf(key), record)) {
+            return false;
+        }
+        keys.push_back(key);
+        keySet.insert(key);
+        return files->Append(listFile, key + "\n");
+    }
+
+    Public StdString Read(CStdString& key) override {
+        Load();
+        if (keySet.count(key) == 0) {
+            return StdString();
+        }
+        return files->Read(FileOf(key));
+    }
+
+    Public RecordView ReadView(CStdString& key) override {
+        Load();
+        if (keySet.count(key) == 0) {
+            return RecordView();
+        }
+        return views != nullptr ? views->View(FileOf(key)) : RecordView(files->Read(FileOf(key)));
+    }
+
+    Public Bool Remove(CStdString& key) override {
+        Load();
+        if (keySet.erase(key) == 0) {
+            return false;
+        }
+        for (auto it = keys.begin(); it != keys.end(); ++it) {
+            if (*it == key) {
+                keys.erase(it);
+                break;
+            }
+        }
+        files->Delete(FileOf(key));
+        StdString list;
+        for (CStdString& remaining : keys) {
+            list += remaining;
+            list += '\n';
+        }
+        return files->Update(listFile, list);
+    }
+
+    // Records first, then the new keys in one append, so a crash leaves no key without its record
+    Public Bool WriteAll(const StdVector<std::pair<StdString, StdString>>& records) override {
+        Load();
+        Bool written = true;
+        StdString added;
+        for (const auto& record : records) {
+            if (keySet.count(record.first) > 0) {
+                written = files->Update(FileOf(record.first), record.second) && written;
+                continue;
+            }
+            if (!files->Create(FileOf(record.first), record.second)) {
+                written = false;
+                continue;
+            }
+            keys.push_back(record.first);
+            keySet.insert(record.first);
+            added += record.first;
+            added += '\n';
+        }
+        if (!added.empty()) {
+            written = files->Append(listFile, added) && written;
+        }
+        return written;
+    }
+
+    Public Size RemoveAll(const StdVector<StdString>& removing) override {
+        Load();
+        StdUnorderedSet<StdString> removed;
+        for (CStdString& key : removing) {
+            if (keySet.erase(key) > 0) {
+                removed.insert(key);
+                files->Delete(FileOf(key));
+            }
+        }
+        if (removed.empty()) {
+            return 0;
+        }
+        keys.erase(std::remove_if(keys.begin(), keys.end(), [&](CStdString& key) {
+            return removed.count(key) > 0;
+        }), keys.end());
+        StdString list;
+        for (CStdString& remaining : keys) {
+            list += remaining;
+            list += '\n';
+        }
+        files->Update(listFile, list);
+        return removed.size();
+    }
+
+    Public Bool Contains(CStdString& key) override {
+        Load();
+        return keySet.count(key) > 0;
+    }
+
+    Public Bool Sync() override {
+        return syncer != nullptr && syncer->Sync();
+    }
+
+    Public Bool CanSync() const override {
+        return syncer != nullptr;
+    }
+
+    Public const StdVector<StdString>& Keys() override {
+        Load();
+        return keys;
+    }
+
+    Public StdString FileOf(CStdString& key) const {
+        return prefix + key;
+    }
+
+    Private Void Load() {
+        if (loaded) {
+            return;
+        }
+        loaded = true;
+        StdString list = files->Read(listFile);
+        std::string_view rest = list;
+        while (!rest.empty()) {
+            Size end = rest.find('\n');
+            std::string_view line = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+            if (!line.empty() && keySet.emplace(line.data(), line.size()).second) {
+                keys.emplace_back(line.data(), line.size());
+            }
+        }
+    }
+};
+
+#endif // ENTITYFILESTORE_H
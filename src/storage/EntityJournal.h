@@ -0,0 +1,552 @@
+#ifndef ENTITYJOURNAL_H
+#define ENTITYJOURNAL_H
+
+#include <StandardDefines.h>
+#include <cerrno>
+#include <condition_variable>
+#include <algorithm>
+#include <deque>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../server/Deflate.h"
+
+// Journal size past which it is emptied once every transaction in it is applied and synced
+#ifndef ENTITYJOURNAL_CHECKPOINT_BYTES
+#ifdef ARDUINO
+#define ENTITYJOURNAL_CHECKPOINT_BYTES 16384
+#else
+#define ENTITYJOURNAL_CHECKPOINT_BYTES 4194304
+#endif
+#endif
+
+class EntityJournal;
+
+/**
+ * Writes to one or more repositories that take effect together or not at
+ * all, from EntityJournal::Begin(). EntityRepository::Save(entity,
+ * transaction) and DeleteById(id, transaction) stage a change here; nothing
+ * is written or visible until Commit(). Rollback(), or letting the
+ * transaction go out of scope uncommitted, discards the staged changes.
+ */
+class EntityTransaction {
+    friend class EntityJournal;
+
+    Private struct Operation {
+        StdString store;
+        StdString key;
+        // Null for a removal
+        std::unique_ptr<StdString> record;
+        // Applies the change to the live repository after the journal holds it
+        std::function<Void()> apply;
+    };
+
+    Private EntityJournal* journal;
+    Private StdVector<Operation> operations;
+    Private Bool open = true;
+
+    Public explicit EntityTransaction(EntityJournal* owner) : journal(owner) {}
+
+    Public EntityTransaction(EntityTransaction&& other) noexcept
+        : journal(other.journal), operations(std::move(other.operations)), open(other.open) {
+        other.open = false;
+    }
+
+    EntityTransaction(const EntityTransaction&) = delete;
+    EntityTransaction& operator=(const EntityTransaction&) = delete;
+
+    Public ~EntityTransaction() {
+        Rollback();
+    }
+
+    /**
+     * @brief Stage a change; the repositories call this
+     * @param record Serialized entity, or nullptr to remove key
+     * @param apply Makes the change in the live repository once committed
+     */
+    Public Void Stage(CStdString& store, CStdString& key, const StdString* record, std::function<Void()> apply) {
+        if (!open) {
+            return;
+        }
+        Operation operation;
+        operation.store = store;
+        operation.key = key;
+        if (record != nullptr) {
+            operation.record.reset(new StdString(*record));
+        }
+        operation.apply = std::move(apply);
+        operations.push_back(std::move(operation));
+    }
+
+    /**
+     * @brief Journal the staged changes durably, then apply them
+     * @return False when the journal could not be written; nothing was applied then
+     * @throws What applying a change throws; the journal then fails every later commit
+     */
+    Public Bool Commit();
+
+    Public Void Rollback();
+
+    Public Bool IsOpen() const {
+        return open;
+    }
+
+    Public Size GetOperationCount() const {
+        return operations.size();
+    }
+};
+
+/**
+ * Write-ahead journal shared by the repositories that take part in
+ * EntityTransactions, so changes to several entities, of one repository or
+ * of several, survive a crash all together or not at all.
+ *
+ * Commit() appends one record holding every change of the transaction,
+ *
+ *     u32 crc | u32 length | u32 operations | per operation:
+ *         u32 store length | u32 key length | u32 value length | store | key | value
+ *
+ * little-endian, the CRC-32 covering everything after it and the top bit of
+ * a key length marking a removal; fsyncs it; and only then applies the
+ * changes to the repositories, in journal order. Transactions committing at
+ * the same time share one write and one fsync (group commit): the first to
+ * find the journal idle writes every record queued so far, the others wait
+ * for it. With groupCommit off each record gets a write and an fsync of its
+ * own, one after the other.
+ *
+ * At startup, after every repository is attached, Replay() applies each
+ * whole record again (rewriting a record is harmless when it was already
+ * applied) and cuts the journal at the first record a crash left short.
+ * Once the journal outgrows checkpointBytes and every transaction in it is
+ * applied, the attached stores are synced and the journal emptied, unless
+ * the replay found changes for a store no repository was attached for:
+ * those are kept, and the journal with them, until a start that attaches
+ * it. Only stores that can sync are attached, EntityFileStore only over a
+ * file manager with an IFileSyncer; a Sync() that still fails keeps the
+ * journal whole, and the next checkpoint waits until the journal doubles.
+ *
+ * Transactions are atomic and durable, not isolated: a reader may see the
+ * first repository's change of a transaction before the second's while it
+ * is being applied, and two transactions touching the same entity apply in
+ * commit order, the later one winning.
+ *
+ *     EntityJournalPtr journal = std::make_shared<EntityJournal>("/littlefs/entities.journal");
+ *     switches.AttachJournal(journal);
+ *     orders.AttachJournal(journal);
+ *     journal->Replay();
+ *
+ *     EntityTransaction transaction = journal->Begin();
+ *     switches.Save(device, transaction);
+ *     orders.Save(order, transaction);
+ *     transaction.Commit();
+ */
+DefineStandardPointers(EntityJournal)
+class EntityJournal {
+    friend class EntityTransaction;
+
+    Public struct Options {
+        // fsync each journal write; off, a power loss can drop the latest commits, never part of one
+        Bool syncOnCommit = true;
+        // Transactions committing together share a write and an fsync
+        Bool groupCommit = true;
+        Size checkpointBytes = ENTITYJOURNAL_CHECKPOINT_BYTES;
+    };
+
+    Public struct Stats {
+        Size commits = 0;
+        Size rollbacks = 0;
+        // Journal writes; with group commit, fewer than commits when they overlapped
+        Size writes = 0;
+        Size syncs = 0;
+        Size checkpoints = 0;
+        Size replayedTransactions = 0;
+        // Replayed changes for stores no repository was attached for; the journal is kept for them
+        Size droppedOperations = 0;
+        // Bytes cut from the end of the journal on replay, after a crash
+        Size recoveredBytes = 0;
+    };
+
+    // Re-applies one journaled change: the record, or nullptr for a removal
+    Public typedef std::function<Void(CStdString& key, const StdString* record)> Replayer;
+
+    Private struct Participant {
+        Replayer replay;
+        std::function<Bool()> sync;
+    };
+
+    Private Static constexpr uint32_t kTombstone = 0x80000000u;
+
+    Private StdString path;
+    Private Options options;
+    Private Int fd = -1;
+    Private std::mutex mutex;
+    Private std::condition_variable written;
+    Private StdUnorderedMap<StdString, Participant> participants;
+    Private Bool replayed = false;
+    // Replay found changes for a store not attached; they stay journaled until a start that attaches it
+    Private Bool keepsDropped = false;
+    Private uint64_t fileBytes = 0;
+    // Journal size of the next checkpoint attempt
+    Private uint64_t checkpointAt = 0;
+    // Records waiting for a write, the last queued, the last written (or failed), the last written successfully
+    Private std::deque<StdString> pending;
+    Private uint64_t queued = 0;
+    Private uint64_t flushed = 0;
+    Private uint64_t durable = 0;
+    Private Bool flushing = false;
+    Private Bool failed = false;
+    Private Stats stats;
+    // Transactions are applied in journal order; applied is the last one done
+    Private std::mutex applyMutex;
+    Private std::condition_variable appliedChanged;
+    Private uint64_t applied = 0;
+
+    /**
+     * @param journalPath The journal, created if missing
+     */
+    Public explicit EntityJournal(CStdString& journalPath) : EntityJournal(journalPath, Options()) {}
+
+    Public EntityJournal(CStdString& journalPath, const Options& journalOptions) : path(journalPath), options(journalOptions) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        struct stat status;
+        if (fd >= 0 && ::fstat(fd, &status) == 0) {
+            fileBytes = static_cast<uint64_t>(status.st_size);
+        }
+    }
+
+    Public ~EntityJournal() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    EntityJournal(const EntityJournal&) = delete;
+    EntityJournal& operator=(const EntityJournal&) = delete;
+
+    /**
+     * @brief Take part in transactions and replay as store; EntityRepository::AttachJournal() calls this
+     * @param sync Makes the store's writes durable before a checkpoint drops them from the journal
+     */
+    Public Void Attach(CStdString& store, Replayer replay, std::function<Bool()> sync) {
+        std::lock_guard<std::mutex> lock(mutex);
+        participants[store] = Participant{std::move(replay), std::move(sync)};
+    }
+
+    Public Void Detach(CStdString& store) {
+        std::lock_guard<std::mutex> lock(mutex);
+        participants.erase(store);
+    }
+
+    /**
+     * @brief Apply the journal's whole records to the attached stores, once per journal
+     * Runs on the first Begin() if not called before; attach every repository first.
+     * @return Transactions replayed
+     */
+    Public Size Replay() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (replayed) {
+            return 0;
+        }
+        replayed = true;
+        if (fd < 0) {
+            return 0;
+        }
+        StdString contents(static_cast<Size>(fileBytes), '\0');
+        Size length = Read(fd, &contents[0], contents.size());
+        contents.resize(length);
+        Size offset = 0;
+        Size transactions = 0;
+        Size dropped = 0;
+        while (offset + 8 <= contents.size()) {
+            uint32_t recordLength = LoadLittleEndian(contents.data() + offset + 4);
+            if (recordLength > contents.size() - offset - 8) {
+                break;
+            }
+            std::string_view record(contents.data() + offset + 4, 4 + recordLength);
+            if (DeflateEncoder::Crc32(record) != LoadLittleEndian(contents.data() + offset) ||
+                !ReplayRecord(record.substr(4), dropped)) {
+                break;
+            }
+            offset += 8 + recordLength;
+            transactions++;
+        }
+        if (offset < fileBytes) {
+            stats.recoveredBytes = static_cast<Size>(fileBytes - offset);
+        }
+        stats.replayedTransactions = transactions;
+        stats.droppedOperations = dropped;
+        keepsDropped = dropped > 0;
+        fileBytes = offset;
+        // Every change is in the stores now, unless it was for a store missing here
+        if (dropped == 0 && SyncParticipants()) {
+            fileBytes = 0;
+            stats.checkpoints += transactions > 0 ? 1 : 0;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(fileBytes)) == 0) {
+            ::fsync(fd);
+        }
+        return transactions;
+    }
+
+    Public EntityTransaction Begin() {
+        Replay();
+        return EntityTransaction(this);
+    }
+
+    Public Stats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    Public const Options& GetOptions() const {
+        return options;
+    }
+
+    Public CStdString& GetPath() const {
+        return path;
+    }
+
+    Private Bool Commit(EntityTransaction& transaction) {
+        StdString record = Encode(transaction);
+        uint64_t sequence = 0;
+        Bool ok = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pending.push_back(std::move(record));
+            sequence = ++queued;
+            while (flushed < sequence) {
+                if (flushing) {
+                    written.wait(lock);
+                    continue;
+                }
+                Flush(lock);
+            }
+            ok = sequence <= durable;
+            stats.commits += ok ? 1 : 0;
+        }
+
+        // In journal order, so the repositories end up as a replay would leave them
+        {
+            std::unique_lock<std::mutex> lock(applyMutex);
+            appliedChanged.wait(lock, [&]() { return applied == sequence - 1; });
+        }
+        if (ok) {
+            try {
+                for (EntityTransaction::Operation& operation : transaction.operations) {
+                    operation.apply();
+                }
+            } catch (...) {
+                // The repositories now lack changes the journal holds; refuse commits until a restart replays them
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    failed = true;
+                }
+                MarkApplied(sequence);
+                throw;
+            }
+        }
+        MarkApplied(sequence);
+        Checkpoint();
+        return ok;
+    }
+
+    // Lets the transaction after sequence apply
+    Private Void MarkApplied(uint64_t sequence) {
+        {
+            std::lock_guard<std::mutex> lock(applyMutex);
+            applied = sequence;
+        }
+        appliedChanged.notify_all();
+    }
+
+    // Writes queued records, all of them with group commit, else the oldest; called holding mutex, which it releases meanwhile
+    Private Void Flush(std::unique_lock<std::mutex>& lock) {
+        flushing = true;
+        StdString bytes;
+        uint64_t last = flushed;
+        if (options.groupCommit) {
+            for (CStdString& record : pending) {
+                bytes += record;
+            }
+            last += pending.size();
+            pending.clear();
+        } else {
+            bytes = std::move(pending.front());
+            pending.pop_front();
+            last++;
+        }
+        uint64_t offset = fileBytes;
+        Bool ok = !failed && fd >= 0;
+        lock.unlock();
+        ok = ok && WriteAt(fd, offset, bytes.data(), bytes.size()) && (!options.syncOnCommit || ::fsync(fd) == 0);
+        lock.lock();
+        stats.writes++;
+        stats.syncs += options.syncOnCommit ? 1 : 0;
+        if (ok) {
+            fileBytes += bytes.size();
+            durable = last;
+        } else {
+            // What follows a record that may be torn would be lost on replay; fail every later commit
+            failed = true;
+        }
+        flushed = last;
+        flushing = false;
+        written.notify_all();
+    }
+
+    // Empties the journal once it is large and every transaction in it is applied and synced
+    Private Void Checkpoint() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fileBytes < std::max<uint64_t>(options.checkpointBytes, checkpointAt) || flushing || !pending.empty() || failed ||
+            keepsDropped) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> applying(applyMutex);
+            if (applied != queued) {
+                return;
+            }
+        }
+        if (!SyncParticipants() || ::ftruncate(fd, 0) != 0) {
+            // A store that could not sync still needs its records; avoid syncing on every commit meanwhile
+            checkpointAt = fileBytes * 2;
+            return;
+        }
+        ::fsync(fd);
+        fileBytes = 0;
+        checkpointAt = 0;
+        stats.checkpoints++;
+    }
+
+    Private Bool SyncParticipants() {
+        Bool synced = true;
+        for (auto& participant : participants) {
+            synced = participant.second.sync() && synced;
+        }
+        return synced;
+    }
+
+    // One record's changes, to the attached stores; false when the record does not parse
+    Private Bool ReplayRecord(std::string_view payload, Size& dropped) {
+        if (payload.size() < 4) {
+            return false;
+        }
+        uint32_t count = LoadLittleEndian(payload.data());
+        Size offset = 4;
+        StdString record;
+        for (uint32_t i = 0; i < count; i++) {
+            if (payload.size() - offset < 12) {
+                return false;
+            }
+            uint32_t storeLength = LoadLittleEndian(payload.data() + offset);
+            uint32_t keyField = LoadLittleEndian(payload.data() + offset + 4);
+            uint32_t valueLength = LoadLittleEndian(payload.data() + offset + 8);
+            uint32_t keyLength = keyField & ~kTombstone;
+            offset += 12;
+            if (payload.size() - offset < static_cast<uint64_t>(storeLength) + keyLength + valueLength) {
+                return false;
+            }
+            StdString store(payload.data() + offset, storeLength);
+            StdString key(payload.data() + offset + storeLength, keyLength);
+            record.assign(payload.data() + offset + storeLength + keyLength, valueLength);
+            offset += storeLength + keyLength + valueLength;
+            auto participant = participants.find(store);
+            if (participant == participants.end()) {
+                dropped++;
+                continue;
+            }
+            participant->second.replay(key, (keyField & kTombstone) != 0 ? nullptr : &record);
+        }
+        return offset == payload.size();
+    }
+
+    Private Static StdString Encode(const EntityTransaction& transaction) {
+        StdString bytes(8, '\0');
+        StoreLittleEndian(static_cast<uint32_t>(transaction.operations.size()), bytes);
+        for (const EntityTransaction::Operation& operation : transaction.operations) {
+            StoreLittleEndian(static_cast<uint32_t>(operation.store.size()), bytes);
+            StoreLittleEndian(static_cast<uint32_t>(operation.key.size()) | (operation.record == nullptr ? kTombstone : 0), bytes);
+            StoreLittleEndian(operation.record == nullptr ? 0 : static_cast<uint32_t>(operation.record->size()), bytes);
+            bytes += operation.store;
+            bytes += operation.key;
+            if (operation.record != nullptr) {
+                bytes += *operation.record;
+            }
+        }
+        uint32_t length = static_cast<uint32_t>(bytes.size() - 8);
+        for (Int i = 0; i < 4; i++) {
+            bytes[4 + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+        }
+        uint32_t crc = DeflateEncoder::Crc32(std::string_view(bytes).substr(4));
+        for (Int i = 0; i < 4; i++) {
+            bytes[i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+        }
+        return bytes;
+    }
+
+    Private Static Size Read(Int file, char* out, Size length) {
+        Size done = 0;
+        while (done < length) {
+            ssize_t count = ::pread(file, out + done, length - done, static_cast<off_t>(done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            done += static_cast<Size>(count);
+        }
+        return done;
+    }
+
+    Private Static Bool WriteAt(Int file, uint64_t offset, const char* data, Size length) {
+        Size done = 0;
+        while (done < length) {
+            ssize_t count = ::pwrite(file, data + done, length - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            done += static_cast<Size>(count);
+        }
+        return true;
+    }
+
+    Private Static uint32_t LoadLittleEndian(const char* bytes) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes);
+        return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+    }
+
+    Private Static Void StoreLittleEndian(uint32_t value, StdString& out) {
+        for (Int i = 0; i < 4; i++) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+};
+
+inline Bool EntityTransaction::Commit() {
+    if (!open) {
+        return false;
+    }
+    open = false;
+    Bool committed = operations.empty() || journal->Commit(*this);
+    operations.clear();
+    return committed;
+}
+
+inline Void EntityTransaction::Rollback() {
+    if (!open) {
+        return;
+    }
+    open = false;
+    operations.clear();
+    std::lock_guard<std::mutex> lock(journal->mutex);
+    journal->stats.rollbacks++;
+}
+
+#endif // ENTITYJOURNAL_H
@@ -0,0 +1,572 @@
+#ifndef ENTITYLOGSTORE_H
+#define ENTITYLOGSTORE_H
+
+#include <StandardDefines.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <mutex>
+#include <string_view>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include "../server/Deflate.h"
+#include "IEntityStore.h"
+
+// Directory of the logs of @Storage("log") repositories, unless given to the constructor
+#ifndef ENTITYLOGSTORE_DIRECTORY
+#ifdef ARDUINO
+#define ENTITYLOGSTORE_DIRECTORY "/littlefs"
+#else
+#define ENTITYLOGSTORE_DIRECTORY "."
+#endif
+#endif
+
+// Bytes of superseded records a log may hold before it is compacted
+#ifndef ENTITYLOGSTORE_COMPACT_MIN_BYTES
+#ifdef ARDUINO
+#define ENTITYLOGSTORE_COMPACT_MIN_BYTES 16384
+#else
+#define ENTITYLOGSTORE_COMPACT_MIN_BYTES 1048576
+#endif
+#endif
+
+/**
+ * Record store keeping every record of an entity type in one append-only
+ * log, with an in-memory index from key to the offset of its latest record.
+ *
+ * Each record is
+ *
+ *     u32 crc | u32 key length | u32 value length | key | value
+ *
+ * little-endian, the CRC-32 covering everything after it. A removal appends
+ * a tombstone: the key with the top bit of its length set and no value. A
+ * Write costs one pwrite and a Read one pread, however many records there
+ * are; WriteAll() and RemoveAll() one pwrite per batch; Keys() and Contains()
+ * cost none.
+ *
+ * Opening the log replays it to rebuild the index. Replay stops at the
+ * first record that is short or fails its CRC, as the record a crash cut
+ * off would, and the log is truncated there, so later writes follow the
+ * last whole record. Only the records after that point are lost.
+ *
+ * Superseded records and tombstones are dropped by compaction once they
+ * outweigh the live records and exceed compactMinBytes. Compaction copies
+ * the live records to "<log>.compact" without holding the store, then,
+ * holding it, copies whatever was appended meanwhile, syncs, and renames the
+ * copy over the log. By default it runs on a thread of its own, so the
+ * write that crosses the threshold does not wait for it.
+ *
+ * On the ESP32 the directory must be on a mounted filesystem (LittleFS,
+ * SPIFFS, an SD card); the default partition table has none.
+ */
+DefineStandardPointers(EntityLogStore)
+class EntityLogStore : public IEntityStore {
+    Public struct Options {
+        // fsync after each record; otherwise a crash can lose the latest records, never earlier ones
+        Bool syncEachWrite = false;
+        // Compact on a thread of its own rather than in the write that triggered it
+        Bool backgroundCompaction = true;
+        Size compactMinBytes = ENTITYLOGSTORE_COMPACT_MIN_BYTES;
+    };
+
+    Public struct Stats {
+        Size records = 0;
+        Size liveBytes = 0;
+        Size fileBytes = 0;
+        Size compactions = 0;
+        // Bytes cut from the end of the log on open, after a crash
+        Size recoveredBytes = 0;
+    };
+
+    Private Static constexpr Size kHeaderBytes = 12;
+    Private Static constexpr uint32_t kTombstone = 0x80000000u;
+    Private Static constexpr Size kBlockBytes = 65536;
+
+    // Where a key's latest record is in the log
+    Private struct Entry {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    Private StdString path;
+    Private Options options;
+    Private std::mutex mutex;
+    Private Int fd = -1;
+    Private uint64_t fileBytes = 0;
+    Private uint64_t liveBytes = 0;
+    Private StdUnorderedMap<StdString, Entry> entries;
+    Private StdVector<StdString> keys;
+    Private Stats stats;
+
+    // One compaction at a time; compacting is set from a trigger until its compaction finishes
+    Private std::mutex compactionMutex;
+    Private std::atomic<Bool> compacting{false};
+    Private std::mutex compactorMutex;
+    Private std::thread compactor;
+
+    /**
+     * @param logPath The log, created if missing
+     */
+    Public explicit EntityLogStore(CStdString& logPath) : EntityLogStore(logPath, Options()) {}
+
+    Public EntityLogStore(CStdString& logPath, const Options& storeOptions) : path(logPath), options(storeOptions) {
+        Open();
+    }
+
+    Public ~EntityLogStore() override {
+        WaitForCompaction();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    EntityLogStore(const EntityLogStore&) = delete;
+    EntityLogStore& operator=(const EntityLogStore&) = delete;
+
+    Public Bool Write(CStdString& key, CStdString& record) override {
+        return Append({{&key, &record}}) == 1;
+    }
+
+    Public Bool Sync() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return fd >= 0 && ::fsync(fd) == 0;
+    }
+
+    Public Bool CanSync() const override {
+        return true;
+    }
+
+    Public StdString Read(CStdString& key) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return StdString();
+        }
+        StdString record;
+        record.resize(it->second.length);
+        if (!ReadAt(fd, it->second.offset, &record[0], record.size())) {
+            return StdString();
+        }
+        uint32_t valueLength = 0;
+        if (!Check(record, nullptr, &valueLength)) {
+            return StdString();
+        }
+        record.erase(0, record.size() - valueLength);
+        return record;
+    }
+
+    Public Bool Remove(CStdString& key) override {
+        return Append({{&key, nullptr}}) == 1;
+    }
+
+    // One write, and one fsync with syncEachWrite, for the whole batch
+    Public Bool WriteAll(const StdVector<std::pair<StdString, StdString>>& records) override {
+        StdVector<std::pair<const StdString*, const StdString*>> batch;
+        batch.reserve(records.size());
+        for (const auto& record : records) {
+            batch.emplace_back(&record.first, &record.second);
+        }
+        return Append(batch) == records.size();
+    }
+
+    Public Size RemoveAll(const StdVector<StdString>& keys) override {
+        StdVector<std::pair<const StdString*, const StdString*>> batch;
+        batch.reserve(keys.size());
+        for (CStdString& key : keys) {
+            batch.emplace_back(&key, nullptr);
+        }
+        return Append(batch);
+    }
+
+    Public Bool Contains(CStdString& key) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.count(key) > 0;
+    }
+
+    Public const StdVector<StdString>& Keys() override {
+        return keys;
+    }
+
+    Public Stats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats current = stats;
+        current.records = entries.size();
+        current.liveBytes = static_cast<Size>(liveBytes);
+        current.fileBytes = static_cast<Size>(fileBytes);
+        return current;
+    }
+
+    Public CStdString& GetPath() const {
+        return path;
+    }
+
+    // Wait for a background compaction to finish
+    Public Void WaitForCompaction() {
+        std::lock_guard<std::mutex> lock(compactorMutex);
+        if (compactor.joinable()) {
+            compactor.join();
+        }
+    }
+
+    /**
+     * @brief Rewrite the log with only its live records
+     * @return False when the copy could not be written; the log is left as it was
+     */
+    Public Bool Compact() {
+        std::lock_guard<std::mutex> compaction(compactionMutex);
+        return CompactLog();
+    }
+
+    /**
+     * @brief Append records in one write, a tombstone where the record is nullptr
+     * Tombstones for keys without a record are left out.
+     * @return Records and tombstones appended; 0 when the write failed
+     */
+    Private Size Append(const StdVector<std::pair<const StdString*, const StdString*>>& batch) {
+        Size appended = 0;
+        Bool compactNow = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fd < 0) {
+                return 0;
+            }
+            StdString bytes;
+            StdVector<std::pair<Size, uint32_t>> encoded;
+            // Whether each key has a record once the batch before it is applied
+            StdUnorderedMap<StdString, Bool> present;
+            for (const auto& change : batch) {
+                CStdString& key = *change.first;
+                if (key.empty() || key.size() >= kTombstone) {
+                    encoded.emplace_back(0, 0);
+                    continue;
+                }
+                auto known = present.find(key);
+                Bool exists = known != present.end() ? known->second : entries.count(key) > 0;
+                if (change.second == nullptr && !exists) {
+                    encoded.emplace_back(0, 0);
+                    continue;
+                }
+                present[key] = change.second != nullptr;
+                Size before = bytes.size();
+                Encode(key, change.second, bytes);
+                encoded.emplace_back(before, static_cast<uint32_t>(bytes.size() - before));
+            }
+            if (bytes.empty()) {
+                return 0;
+            }
+            if (!WriteAt(fd, fileBytes, bytes.data(), bytes.size())) {
+                // Whatever reached the file is overwritten by the next write
+                return 0;
+            }
+            if (options.syncEachWrite) {
+                ::fsync(fd);
+            }
+            for (Size i = 0; i < batch.size(); i++) {
+                if (encoded[i].second > 0) {
+                    Apply(entries, *batch[i].first, batch[i].second == nullptr, fileBytes + encoded[i].first, encoded[i].second, true);
+                    appended++;
+                }
+            }
+            fileBytes += bytes.size();
+            compactNow = ShouldCompact();
+        }
+        if (compactNow && options.backgroundCompaction) {
+            // The previous compaction has finished, it cleared compacting
+            std::lock_guard<std::mutex> lock(compactorMutex);
+            if (compactor.joinable()) {
+                compactor.join();
+            }
+            compactor = std::thread([this]() { RunCompaction(); });
+        } else if (compactNow) {
+            RunCompaction();
+        }
+        return appended;
+    }
+
+    Private Void RunCompaction() {
+        std::lock_guard<std::mutex> compaction(compactionMutex);
+        CompactLog();
+        compacting = false;
+    }
+
+    // Called holding mutex; claims the compaction when it is due
+    Private Bool ShouldCompact() {
+        uint64_t garbage = fileBytes - liveBytes;
+        if (garbage < options.compactMinBytes || garbage < liveBytes) {
+            return false;
+        }
+        Bool idle = false;
+        return compacting.compare_exchange_strong(idle, true);
+    }
+
+    Private Void Open() {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return;
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            fd = -1;
+            return;
+        }
+        uint64_t size = static_cast<uint64_t>(status.st_size);
+        fileBytes = Replay(fd, 0, size, [this](CStdString& key, Bool tombstone, uint64_t offset, uint32_t length) {
+            Apply(entries, key, tombstone, offset, length, true);
+        });
+        if (fileBytes < size) {
+            stats.recoveredBytes = static_cast<Size>(size - fileBytes);
+            if (::ftruncate(fd, static_cast<off_t>(fileBytes)) == 0) {
+                ::fsync(fd);
+            }
+        }
+    }
+
+    /**
+     * @brief Point index at a record; live counts are kept when tracked
+     * @param tracked True for the store's own index, which keys and liveBytes follow
+     */
+    Private Void Apply(StdUnorderedMap<StdString, Entry>& index, CStdString& key, Bool tombstone,
+                       uint64_t offset, uint32_t length, Bool tracked) {
+        auto it = index.find(key);
+        if (it != index.end() && tracked) {
+            liveBytes -= it->second.length;
+        }
+        if (tombstone) {
+            if (it == index.end()) {
+                return;
+            }
+            index.erase(it);
+            if (tracked) {
+                keys.erase(std::find(keys.begin(), keys.end(), key));
+            }
+            return;
+        }
+        if (it == index.end()) {
+            index.emplace(key, Entry{offset, length});
+            if (tracked) {
+                keys.push_back(key);
+            }
+        } else {
+            it->second = Entry{offset, length};
+        }
+        if (tracked) {
+            liveBytes += length;
+        }
+    }
+
+    /**
+     * @brief Read the records in [from, to) of file in order
+     * @param visit Called with key, tombstone, offset and length of each whole, valid record
+     * @return Offset just past the last valid record
+     */
+    Private template<typename Visitor>
+    Static uint64_t Replay(Int file, uint64_t from, uint64_t to, Visitor visit) {
+        StdString block;
+        uint64_t blockStart = from;
+        uint64_t offset = from;
+        StdString key;
+        while (offset + kHeaderBytes <= to) {
+            // Keep the record in block, reading the next stretch of the file when it runs past
+            if (!Buffer(file, block, blockStart, offset, kHeaderBytes, to)) {
+                break;
+            }
+            const char* header = block.data() + (offset - blockStart);
+            uint32_t keyLength = LoadLittleEndian(header + 4);
+            uint32_t valueLength = LoadLittleEndian(header + 8);
+            Bool tombstone = (keyLength & kTombstone) != 0;
+            keyLength &= ~kTombstone;
+            uint64_t length = kHeaderBytes + uint64_t(keyLength) + valueLength;
+            if (keyLength == 0 || (tombstone && valueLength != 0) || offset + length > to ||
+                !Buffer(file, block, blockStart, offset, static_cast<Size>(length), to)) {
+                break;
+            }
+            std::string_view bytes(block.data() + (offset - blockStart), static_cast<Size>(length));
+            if (!Check(bytes, nullptr, nullptr)) {
+                break;
+            }
+            key.assign(bytes.data() + kHeaderBytes, keyLength);
+            visit(key, tombstone, offset, static_cast<uint32_t>(length));
+            offset += length;
+        }
+        return offset;
+    }
+
+    // Make block hold [offset, offset + length), reading from the file as needed
+    Private Static Bool Buffer(Int file, StdString& block, uint64_t& blockStart, uint64_t offset, Size length, uint64_t end) {
+        if (offset >= blockStart && offset + length <= blockStart + block.size()) {
+            return true;
+        }
+        Size size = static_cast<Size>(std::min<uint64_t>(std::max(length, kBlockBytes), end - offset));
+        block.resize(size);
+        blockStart = offset;
+        return size >= length && ReadAt(file, offset, &block[0], size);
+    }
+
+    /**
+     * @brief Verify a whole record's CRC and lengths
+     * @param keyLength, valueLength Set from the header unless nullptr
+     */
+    Private Static Bool Check(std::string_view record, uint32_t* keyLength, uint32_t* valueLength) {
+        if (record.size() < kHeaderBytes) {
+            return false;
+        }
+        uint32_t keyBytes = LoadLittleEndian(record.data() + 4) & ~kTombstone;
+        uint32_t valueBytes = LoadLittleEndian(record.data() + 8);
+        if (kHeaderBytes + uint64_t(keyBytes) + valueBytes != record.size() ||
+            DeflateEncoder::Crc32(record.substr(4)) != LoadLittleEndian(record.data())) {
+            return false;
+        }
+        if (keyLength != nullptr) {
+            *keyLength = keyBytes;
+        }
+        if (valueLength != nullptr) {
+            *valueLength = valueBytes;
+        }
+        return true;
+    }
+
+    // Append the record for key, or its tombstone when record is nullptr, to bytes
+    Private Static Void Encode(CStdString& key, CStdString* record, StdString& bytes) {
+        Size start = bytes.size();
+        bytes.append(4, '\0');
+        uint32_t keyLength = static_cast<uint32_t>(key.size());
+        StoreLittleEndian(record == nullptr ? keyLength | kTombstone : keyLength, bytes);
+        StoreLittleEndian(record == nullptr ? 0 : static_cast<uint32_t>(record->size()), bytes);
+        bytes += key;
+        if (record != nullptr) {
+            bytes += *record;
+        }
+        uint32_t crc = DeflateEncoder::Crc32(std::string_view(bytes).substr(start + 4));
+        for (Int i = 0; i < 4; i++) {
+            bytes[start + i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+        }
+    }
+
+    Private Bool CompactLog() {
+        // Phase 1: copy the live records as of now, the store left free for readers and writers
+        StdVector<std::pair<StdString, Entry>> live;
+        uint64_t snapshotEnd;
+        Int source;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fd < 0) {
+                return false;
+            }
+            live.assign(entries.begin(), entries.end());
+            snapshotEnd = fileBytes;
+            source = fd;
+        }
+        // In log order, so the copy reads the old log front to back
+        std::sort(live.begin(), live.end(), [](const std::pair<StdString, Entry>& a, const std::pair<StdString, Entry>& b) {
+            return a.second.offset < b.second.offset;
+        });
+        StdString copyPath = path + ".compact";
+        Int copy = ::open(copyPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (copy < 0) {
+            return false;
+        }
+        StdUnorderedMap<StdString, Entry> copied;
+        copied.reserve(live.size());
+        uint64_t copyBytes = 0;
+        StdString pending;
+        StdString record;
+        Bool ok = true;
+        for (const auto& entry : live) {
+            record.resize(entry.second.length);
+            if (!ReadAt(source, entry.second.offset, &record[0], record.size())) {
+                ok = false;
+                break;
+            }
+            copied.emplace(entry.first, Entry{copyBytes + pending.size(), entry.second.length});
+            pending += record;
+            if (pending.size() >= kBlockBytes) {
+                ok = WriteAt(copy, copyBytes, pending.data(), pending.size());
+                copyBytes += pending.size();
+                pending.clear();
+                if (!ok) {
+                    break;
+                }
+            }
+        }
+        if (ok && !pending.empty()) {
+            ok = WriteAt(copy, copyBytes, pending.data(), pending.size());
+            copyBytes += pending.size();
+        }
+
+        // Phase 2: holding the store, bring the copy up to date and swap it in
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok && fileBytes > snapshotEnd) {
+            StdString tail(static_cast<Size>(fileBytes - snapshotEnd), '\0');
+            ok = ReadAt(fd, snapshotEnd, &tail[0], tail.size()) && WriteAt(copy, copyBytes, tail.data(), tail.size());
+            if (ok) {
+                uint64_t shift = copyBytes;
+                Replay(fd, snapshotEnd, fileBytes, [&](CStdString& key, Bool tombstone, uint64_t offset, uint32_t length) {
+                    Apply(copied, key, tombstone, offset - snapshotEnd + shift, length, false);
+                });
+                copyBytes += tail.size();
+            }
+        }
+        if (!ok || ::fsync(copy) != 0 || std::rename(copyPath.c_str(), path.c_str()) != 0) {
+            ::close(copy);
+            ::unlink(copyPath.c_str());
+            return false;
+        }
+        ::close(fd);
+        fd = copy;
+        fileBytes = copyBytes;
+        entries.swap(copied);
+        liveBytes = 0;
+        for (const auto& entry : entries) {
+            liveBytes += entry.second.length;
+        }
+        stats.compactions++;
+        return true;
+    }
+
+    Private Static Bool ReadAt(Int file, uint64_t offset, char* out, Size length) {
+        Size done = 0;
+        while (done < length) {
+            ssize_t count = ::pread(file, out + done, length - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            done += static_cast<Size>(count);
+        }
+        return true;
+    }
+
+    Private Static Bool WriteAt(Int file, uint64_t offset, const char* data, Size length) {
+        Size done = 0;
+        while (done < length) {
+            ssize_t count = ::pwrite(file, data + done, length - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            done += static_cast<Size>(count);
+        }
+        return true;
+    }
+
+    Private Static uint32_t LoadLittleEndian(const char* bytes) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes);
+        return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+    }
+
+    Private Static Void StoreLittleEndian(uint32_t value, StdString& out) {
+        for (Int i = 0; i < 4; i++) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+};
+
+#endif // ENTITYLOGSTORE_H
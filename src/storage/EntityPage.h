@@ -0,0 +1,27 @@
+#ifndef ENTITYPAGE_H
+#define ENTITYPAGE_H
+
+#include <StandardDefines.h>
+
+/**
+ * One page of a repository's entities, as EntityRepository::FindAll(page,
+ * size) returns it: page is zero-based, and totalElements counts every
+ * entity in the repository, not just this page.
+ */
+template<typename T>
+struct EntityPage {
+    StdVector<T> content;
+    Size page = 0;
+    Size size = 0;
+    Size totalElements = 0;
+
+    Size TotalPages() const {
+        return size == 0 ? 0 : (totalElements + size - 1) / size;
+    }
+
+    Bool HasNext() const {
+        return size > 0 && page + 1 < TotalPages();
+    }
+};
+
+#endif // ENTITYPAGE_H
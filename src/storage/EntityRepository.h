@@ -0,0 +1,631 @@
+#ifndef ENTITYREPOSITORY_H
+#define ENTITYREPOSITORY_H
+
+#include <StandardDefines.h>
+#include <CpaRepository.h>
+#include <IFileManager.h>
+#include <SerializationUtility.h>
+#include <algorithm>
+#include <mutex>
+#include "../serializer/StreamingDeserializer.h"
+#include "EntityCache.h"
+#include "EntityJournal.h"
+#include "EntityPage.h"
+#include "EntityTable.h"
+#include "IEntityStore.h"
+#include "SecondaryIndex.h"
+
+/**
+ * CpaRepository over an IFileManager with secondary indexes for derived
+ * queries.
+ *
+ * Records go to an IEntityStore: one file per entity through EntityFileStore,
+ * or one append-only log per entity type through EntityLogStore. Every
+ * member annotated @Indexed in the entity gets a SecondaryIndex in
+ * "<Entity>_idx_<member>", updated on Save/Update/DeleteById, so a
+ * FindBy<Member> query reads and deserializes only the records holding the
+ * value instead of every record. Each record read through an index is
+ * checked against the value again, so an index entry a crash left behind
+ * between the two writes cannot return a wrong entity. An index file that is
+ * missing, e.g. for a member newly annotated, is rebuilt from the records on
+ * first use.
+ *
+ * An EntityCache configured with ConfigureCache(), or by a @Cache annotation
+ * on the interface, keeps deserialized entities: reads go through it and
+ * writes update it, so FindById for an entity just saved or read costs
+ * neither I/O nor parsing. ExistsById is answered from the store's in-memory
+ * key set, cached or not.
+ *
+ * scripts/generate_entity_repositories.py derives a concrete class from each
+ * @Repository interface, implementing its FindBy methods with
+ * FindByIndex() where the member is indexed and FindWhere() otherwise:
+ *
+ *     ProductEntityRepositoryPtr products = std::make_shared<ProductEntityRepository>(fileManager);
+ *     StdVector<Product> electronics = products->FindByCategory("Electronics");
+ *
+ * FindAll() reads every entity into one vector. For more than a few dozen
+ * on the ESP32, FindAll(page, size) reads one page, optionally sorted by an
+ * @Indexed member, and OpenCursor() or ForEach() deserialize one entity at a
+ * time.
+ *
+ * AttachJournal() lets Save(entity, transaction) and DeleteById(id,
+ * transaction) join an EntityTransaction, so changes to several entities,
+ * here and in other repositories sharing the journal, land together or not
+ * at all. The repository must outlive the transactions it joins. Once a
+ * journal is attached, Save(), DeleteById() and the batch calls go through it
+ * too, each as a transaction of its own, so a replay never re-applies an old
+ * transaction over a later write. The store must be able to sync, see
+ * IEntityStore::CanSync().
+ *
+ * Calls are serialized with a mutex, so one instance can serve every worker.
+ */
+template<typename T, typename ID, typename Interface = CpaRepository<T, ID>>
+class EntityRepository : public Interface {
+    typedef EntityTable<T> Table;
+    static_assert(Table::available, "EntityRepository needs a generated EntityTable; is the class annotated @Entity?");
+
+    Private std::mutex mutex;
+    Private IEntityStorePtr store;
+    Private EntityCache<T> cache;
+    Private StdVector<SecondaryIndex> indexes;
+    Private Bool opened = false;
+    Private EntityJournalPtr journal;
+
+    /**
+     * @param fileManager Holds the index files
+     * @param recordStore Holds the records
+     */
+    Public EntityRepository(IFileManagerPtr fileManager, IEntityStorePtr recordStore)
+        : store(recordStore) {
+        for (Size i = 0; i < Table::indexCount; i++) {
+            indexes.emplace_back(fileManager, StdString(Table::name) + "_idx_" + Table::indexes[i].name);
+        }
+    }
+
+    Public ~EntityRepository() {
+        if (journal) {
+            journal->Detach(Table::name);
+        }
+    }
+
+    // An entity without an id is returned unsaved
+    Public T Save(T& entity) override {
+        if (journal) {
+            EntityTransaction transaction = journal->Begin();
+            Save(entity, transaction);
+            transaction.Commit();
+            return entity;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        const optional<ID>& id = Table::Id(entity);
+        if (!id.has_value()) {
+            return entity;
+        }
+        Open();
+        Put(EntityKey::Of(id.value()), entity, nayan::serializer::SerializationUtility::Serialize(entity));
+        return entity;
+    }
+
+    Public optional<T> FindById(ID id) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Load(EntityKey::Of(id));
+    }
+
+    Public StdVector<T> FindAll() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        StdVector<T> entities;
+        for (CStdString& key : store->Keys()) {
+            optional<T> entity = Load(key);
+            if (entity.has_value()) {
+                entities.push_back(std::move(entity.value()));
+            }
+        }
+        return entities;
+    }
+
+    Public T Update(T& entity) override {
+        return Save(entity);
+    }
+
+    Public Void DeleteById(ID id) override {
+        if (journal) {
+            EntityTransaction transaction = journal->Begin();
+            DeleteById(id, transaction);
+            transaction.Commit();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Drop(EntityKey::Of(id));
+    }
+
+    Public Void Delete(T& entity) override {
+        const optional<ID>& id = Table::Id(entity);
+        if (id.has_value()) {
+            DeleteById(id.value());
+        }
+    }
+
+    Public Bool ExistsById(ID id) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return store->Contains(EntityKey::Of(id));
+    }
+
+    /**
+     * @brief Save every entity with one store write and one append per index
+     * The store's WriteAll() writes the records, then the id list once,
+     * rather than once per entity. Entities without an id are returned unsaved.
+     * With a journal attached the batch is one transaction.
+     */
+    Public StdVector<T> SaveAll(StdVector<T>& entities) {
+        if (journal) {
+            EntityTransaction transaction = journal->Begin();
+            for (T& entity : entities) {
+                Save(entity, transaction);
+            }
+            transaction.Commit();
+            return entities;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Open();
+        StdVector<std::pair<StdString, StdString>> records;
+        records.reserve(entities.size());
+        DeferIndexes();
+        for (const T& entity : entities) {
+            const optional<ID>& id = Table::Id(entity);
+            if (!id.has_value()) {
+                continue;
+            }
+            StdString key = EntityKey::Of(id.value());
+            IndexEntity(key, &entity);
+            records.emplace_back(key, nayan::serializer::SerializationUtility::Serialize(entity));
+        }
+        FlushIndexes();
+        Bool written = store->WriteAll(records);
+        Size next = 0;
+        for (const T& entity : entities) {
+            if (Table::Id(entity).has_value()) {
+                const auto& record = records[next++];
+                if (written) {
+                    cache.Put(record.first, entity, record.second.size());
+                } else {
+                    cache.Erase(record.first);
+                }
+            }
+        }
+        return entities;
+    }
+
+    /**
+     * @brief One page of entities, in the order they were first saved
+     * @param page Zero-based
+     */
+    Public EntityPage<T> FindAll(Size page, Size size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const StdVector<StdString>& keys = store->Keys();
+        EntityPage<T> result = EmptyPage(page, size, keys.size());
+        if (size == 0 || page >= result.TotalPages()) {
+            return result;
+        }
+        Size end = std::min(keys.size(), (page + 1) * size);
+        for (Size i = page * size; i < end; i++) {
+            optional<T> entity = Load(keys[i]);
+            if (entity.has_value()) {
+                result.content.push_back(std::move(entity.value()));
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief One page of entities sorted by an @Indexed member, through its index
+     * Entities with the same value keep the order they were indexed in;
+     * entities without a value come last either way. A member that is not
+     * indexed leaves the order they were first saved in.
+     */
+    Public EntityPage<T> FindAll(Size page, Size size, CStdString& sortBy, Bool ascending = true) {
+        Size index = IndexOf(sortBy);
+        if (index == indexes.size()) {
+            return FindAll(page, size);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Open();
+        const StdVector<StdString>& keys = store->Keys();
+        EntityPage<T> result = EmptyPage(page, size, keys.size());
+        if (size == 0 || page >= result.TotalPages()) {
+            return result;
+        }
+        // Keys of the page, in sorted order; skip counts down the entries before it
+        StdVector<StdString> pageKeys;
+        Size skip = page * size;
+        auto take = [&](CStdString& key) {
+            if (skip > 0) {
+                skip--;
+                return true;
+            }
+            pageKeys.push_back(key);
+            return pageKeys.size() < size;
+        };
+        SecondaryIndex& sorted = indexes[index];
+        const StdVector<const StdString*>& values = sorted.SortedValues(Table::indexes[index].numeric);
+        Bool more = true;
+        for (Size i = 0; more && i < values.size(); i++) {
+            const StdString* value = values[ascending ? i : values.size() - 1 - i];
+            const StdVector<StdString>* holders = sorted.Find(*value);
+            // Past the whole bucket without visiting its keys
+            if (skip >= holders->size()) {
+                skip -= holders->size();
+                continue;
+            }
+            for (Size j = 0; more && j < holders->size(); j++) {
+                more = take((*holders)[j]);
+            }
+        }
+        for (Size i = 0; more && i < keys.size(); i++) {
+            if (!sorted.Contains(keys[i])) {
+                more = take(keys[i]);
+            }
+        }
+        for (CStdString& key : pageKeys) {
+            optional<T> entity = Load(key);
+            if (entity.has_value()) {
+                result.content.push_back(std::move(entity.value()));
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Reads a repository's entities one at a time, in the order they were
+     * first saved. Each Next() takes the repository's lock for one read, so
+     * other calls may run between them; an entity removed meanwhile may shift
+     * the position by one.
+     */
+    Public class Cursor {
+        Private EntityRepository* repository;
+        Private Size position = 0;
+
+        Public explicit Cursor(EntityRepository* owner) : repository(owner) {}
+
+        // The next entity, or an empty optional after the last
+        Public optional<T> Next() {
+            return repository->LoadAt(position);
+        }
+    };
+
+    Public Cursor OpenCursor() {
+        return Cursor(this);
+    }
+
+    /**
+     * @brief Call fn with each entity, one deserialized at a time
+     * fn runs without the repository's lock held, so it may use the repository.
+     * @return Entities visited
+     */
+    Public template<typename Fn>
+    Size ForEach(Fn fn) {
+        Cursor cursor = OpenCursor();
+        Size visited = 0;
+        for (optional<T> entity = cursor.Next(); entity.has_value(); entity = cursor.Next()) {
+            fn(entity.value());
+            visited++;
+        }
+        return visited;
+    }
+
+    // The entities found, in the order of ids; missing ids are skipped
+    Public StdVector<T> FindAllById(const StdVector<ID>& ids) {
+        std::lock_guard<std::mutex> lock(mutex);
+        StdVector<T> entities;
+        entities.reserve(ids.size());
+        for (const ID& id : ids) {
+            optional<T> entity = Load(EntityKey::Of(id));
+            if (entity.has_value()) {
+                entities.push_back(std::move(entity.value()));
+            }
+        }
+        return entities;
+    }
+
+    // One store removal for every id, e.g. one rewrite of the id list
+    Public Void DeleteAllById(const StdVector<ID>& ids) {
+        if (journal) {
+            EntityTransaction transaction = journal->Begin();
+            for (const ID& id : ids) {
+                DeleteById(id, transaction);
+            }
+            transaction.Commit();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Open();
+        StdVector<StdString> keys;
+        keys.reserve(ids.size());
+        DeferIndexes();
+        for (const ID& id : ids) {
+            StdString key = EntityKey::Of(id);
+            if (store->Contains(key)) {
+                IndexEntity(key, nullptr);
+                cache.Erase(key);
+                keys.push_back(std::move(key));
+            }
+        }
+        FlushIndexes();
+        store->RemoveAll(keys);
+    }
+
+    /**
+     * @brief Take part in the journal's transactions and replay
+     * Attach every repository before the journal's Replay() or first Begin(),
+     * and before the repository is used.
+     * @return False, attaching nothing, when the store cannot sync: a
+     * checkpoint could never drop its records, so the journal would only grow
+     */
+    Public Bool AttachJournal(EntityJournalPtr entityJournal) {
+        if (entityJournal && !store->CanSync()) {
+            return false;
+        }
+        // Not holding the mutex: replay takes the journal's lock, then ours
+        if (journal) {
+            journal->Detach(Table::name);
+        }
+        journal = entityJournal;
+        if (!journal) {
+            return true;
+        }
+        IEntityStorePtr records = store;
+        journal->Attach(Table::name, [this](CStdString& key, const StdString* record) {
+            std::lock_guard<std::mutex> lock(mutex);
+            Open();
+            if (record == nullptr) {
+                Drop(key);
+                return;
+            }
+            T entity = StreamingDeserializer::Deserialize<T>(std::string_view(*record));
+            Put(key, entity, *record);
+        }, [records]() {
+            return records->Sync();
+        });
+        return true;
+    }
+
+    /**
+     * @brief Save entity when transaction commits
+     * Nothing is written or visible before. An entity without an id is not staged.
+     */
+    Public Void Save(T& entity, EntityTransaction& transaction) {
+        const optional<ID>& id = Table::Id(entity);
+        if (!id.has_value()) {
+            return;
+        }
+        StdString key = EntityKey::Of(id.value());
+        StdString record = nayan::serializer::SerializationUtility::Serialize(entity);
+        transaction.Stage(Table::name, key, &record, [this, key, saved = entity, record]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            Open();
+            Put(key, saved, record);
+        });
+    }
+
+    // Delete the entity when transaction commits
+    Public Void DeleteById(ID id, EntityTransaction& transaction) {
+        StdString key = EntityKey::Of(id);
+        transaction.Stage(Table::name, key, nullptr, [this, key]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            Drop(key);
+        });
+    }
+
+    // Empties the cache; see EntityCacheOptions
+    Public Void ConfigureCache(const EntityCacheOptions& options) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.Configure(options);
+    }
+
+    Public EntityCacheOptions GetCacheOptions() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.GetOptions();
+    }
+
+    Public typename EntityCache<T>::Counters GetCacheCounters() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.GetCounters();
+    }
+
+    Public Void ResetCacheCounters() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cache.ResetCounters();
+    }
+
+    /**
+     * @brief Entities whose indexed member equals value, read through the index
+     * @param index Position of the member in EntityTable<T>::indexes
+     * @param limit Most entities returned
+     */
+    Protected template<typename V>
+    StdVector<T> FindByIndex(Size index, const V& value, Size limit = static_cast<Size>(-1)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Open();
+        StdVector<T> entities;
+        StdString wanted = EntityKey::Of(value);
+        const StdVector<StdString>* keys = indexes[index].Find(wanted);
+        if (keys == nullptr) {
+            return entities;
+        }
+        StdString current;
+        for (CStdString& key : *keys) {
+            optional<T> entity = Load(key);
+            current.clear();
+            if (entity.has_value() && Table::indexes[index].key(entity.value(), current) && current == wanted) {
+                entities.push_back(std::move(entity.value()));
+                if (entities.size() >= limit) {
+                    break;
+                }
+            }
+        }
+        return entities;
+    }
+
+    Protected template<typename V>
+    optional<T> FindFirstByIndex(Size index, const V& value) {
+        StdVector<T> entities = FindByIndex(index, value, 1);
+        if (entities.empty()) {
+            return optional<T>();
+        }
+        return std::move(entities.front());
+    }
+
+    /**
+     * @brief Entities matching predicate, found by reading every record
+     * Derived queries on members that are not indexed use this.
+     */
+    Protected template<typename Predicate>
+    StdVector<T> FindWhere(Predicate predicate, Size limit = static_cast<Size>(-1)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        StdVector<T> entities;
+        for (CStdString& key : store->Keys()) {
+            optional<T> entity = Load(key);
+            if (entity.has_value() && predicate(entity.value())) {
+                entities.push_back(std::move(entity.value()));
+                if (entities.size() >= limit) {
+                    break;
+                }
+            }
+        }
+        return entities;
+    }
+
+    Protected template<typename Predicate>
+    optional<T> FindFirstWhere(Predicate predicate) {
+        StdVector<T> entities = FindWhere(predicate, 1);
+        if (entities.empty()) {
+            return optional<T>();
+        }
+        return std::move(entities.front());
+    }
+
+    // Load the index files, rebuilding any that are missing from the records
+    Private Void Open() {
+        if (opened) {
+            return;
+        }
+        opened = true;
+        StdVector<Size> missing;
+        for (Size i = 0; i < indexes.size(); i++) {
+            if (!indexes[i].Load()) {
+                missing.push_back(i);
+            }
+        }
+        if (missing.empty()) {
+            return;
+        }
+        StdVector<StdVector<std::pair<StdString, StdString>>> entries(indexes.size());
+        StdString value;
+        for (CStdString& key : store->Keys()) {
+            optional<T> entity = Load(key);
+            if (!entity.has_value()) {
+                continue;
+            }
+            for (Size i : missing) {
+                value.clear();
+                if (Table::indexes[i].key(entity.value(), value)) {
+                    entries[i].emplace_back(key, value);
+                }
+            }
+        }
+        for (Size i : missing) {
+            indexes[i].Rebuild(entries[i]);
+        }
+    }
+
+    // Position of the @Indexed member in EntityTable<T>::indexes; indexes.size() when not indexed
+    Private Size IndexOf(CStdString& member) const {
+        for (Size i = 0; i < indexes.size(); i++) {
+            if (member == Table::indexes[i].name) {
+                return i;
+            }
+        }
+        return indexes.size();
+    }
+
+    Private Static EntityPage<T> EmptyPage(Size page, Size size, Size totalElements) {
+        EntityPage<T> result;
+        result.page = page;
+        result.size = size;
+        result.totalElements = totalElements;
+        return result;
+    }
+
+    // The first entity from position on, position moved past it
+    Private optional<T> LoadAt(Size& position) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const StdVector<StdString>& keys = store->Keys();
+        while (position < keys.size()) {
+            optional<T> entity = Load(keys[position++]);
+            if (entity.has_value()) {
+                return entity;
+            }
+        }
+        return optional<T>();
+    }
+
+    Private Void DeferIndexes() {
+        for (SecondaryIndex& index : indexes) {
+            index.Defer();
+        }
+    }
+
+    Private Void FlushIndexes() {
+        for (SecondaryIndex& index : indexes) {
+            index.Flush();
+        }
+    }
+
+    // Index, write and cache one record; called holding the mutex, after Open()
+    Private Void Put(CStdString& key, const T& entity, CStdString& record) {
+        IndexEntity(key, &entity);
+        if (store->Write(key, record)) {
+            cache.Put(key, entity, record.size());
+        } else {
+            cache.Erase(key);
+        }
+    }
+
+    // Called holding the mutex
+    Private Void Drop(CStdString& key) {
+        if (!store->Contains(key)) {
+            return;
+        }
+        Open();
+        IndexEntity(key, nullptr);
+        cache.Erase(key);
+        store->Remove(key);
+    }
+
+    // Point every index at the entity's values; nullptr drops key from all of them
+    Private Void IndexEntity(CStdString& key, const T* entity) {
+        StdString value;
+        for (Size i = 0; i < indexes.size(); i++) {
+            value.clear();
+            Bool indexed = entity != nullptr && Table::indexes[i].key(*entity, value);
+            indexes[i].Set(key, indexed ? &value : nullptr);
+        }
+    }
+
+    Private optional<T> Load(CStdString& key) {
+        const T* cached = cache.Find(key);
+        if (cached != nullptr) {
+            return *cached;
+        }
+        // Parsed where the store holds it: a mapped file, or the string read
+        RecordView record = store->ReadView(key);
+        std::string_view bytes = record.Data();
+        if (bytes.empty()) {
+            return optional<T>();
+        }
+        T entity = StreamingDeserializer::Deserialize<T>(bytes);
+        cache.Put(key, entity, bytes.size());
+        return entity;
+    }
+};
+
+#endif // ENTITYREPOSITORY_H
@@ -0,0 +1,144 @@
+#ifndef ENTITYTABLE_H
+#define ENTITYTABLE_H
+
+#include <StandardDefines.h>
+#include <string_view>
+#include <type_traits>
+#include "../serializer/NumberFormat.h"
+
+/**
+ * Compile-time metadata for @Entity classes, used by EntityRepository.
+ *
+ * scripts/generate_entity_repositories.py emits one EntityTable
+ * specialization per entity: its name (the prefix of its files), the
+ * @Id member and the members annotated @Indexed, each with a function that
+ * renders the member's value as index key text.
+ *
+ *     template<>
+ *     struct EntityTable<Product> {
+ *         Static constexpr Bool available = true;
+ *         Static constexpr const char* name = "Product";
+ *         Static const optional<int>& Id(const Product& entity) { return entity.id; }
+ *         Static constexpr Size indexCount = 1;
+ *         Static constexpr EntityIndexField<Product> indexes[] = {
+ *             {"category", &EntityFieldKey<Product, optional<StdString>, &Product::category>::Key,
+ *              EntityFieldKey<Product, optional<StdString>, &Product::category>::numeric},
+ *         };
+ *     };
+ */
+
+/**
+ * Text form of ids and indexed values: strings as they are, numbers in
+ * NumberFormat's locale-independent decimal, enums as their underlying value.
+ */
+class EntityKey {
+    Public Static Void Append(const StdString& value, StdString& out) {
+        out += value;
+    }
+
+    Public Static Void Append(const char* value, StdString& out) {
+        out += value;
+    }
+
+    Public Static Void Append(Bool value, StdString& out) {
+        out += value ? "true" : "false";
+    }
+
+    Public Static Void Append(double value, StdString& out) {
+        NumberFormat::AppendDouble(value, out);
+    }
+
+    Public template<typename T>
+    Static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type Append(T value, StdString& out) {
+        NumberFormat::AppendInt(value, out);
+    }
+
+    Public template<typename T>
+    Static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value && !std::is_same<T, bool>::value>::type
+    Append(T value, StdString& out) {
+        NumberFormat::AppendUInt(value, out);
+    }
+
+    Public template<typename T>
+    Static typename std::enable_if<std::is_enum<T>::value>::type Append(T value, StdString& out) {
+        Append(static_cast<typename std::underlying_type<T>::type>(value), out);
+    }
+
+    Public template<typename T>
+    Static StdString Of(const T& value) {
+        StdString out;
+        Append(value, out);
+        return out;
+    }
+
+    /**
+     * @brief Parse an id back from its text form, e.g. a line of the id list
+     * @return False when the text is not a whole value of type T
+     */
+    Public Static Bool Parse(std::string_view text, StdString& out) {
+        out.assign(text.data(), text.size());
+        return true;
+    }
+
+    Public template<typename T>
+    Static typename std::enable_if<std::is_integral<T>::value, Bool>::type Parse(std::string_view text, T& out) {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        if (std::is_signed<T>::value) {
+            int64_t value = 0;
+            if (text.empty() || NumberFormat::ParseInt(first, last, value) != text.size()) {
+                return false;
+            }
+            out = static_cast<T>(value);
+        } else {
+            uint64_t value = 0;
+            if (text.empty() || NumberFormat::ParseUInt(first, last, value) != text.size()) {
+                return false;
+            }
+            out = static_cast<T>(value);
+        }
+        return true;
+    }
+};
+
+/**
+ * One @Indexed member of an entity T
+ */
+template<typename T>
+struct EntityIndexField {
+    typedef Bool (*KeyFn)(const T&, StdString&);
+
+    // Member name; also names the index file
+    const char* name;
+
+    // Appends the member's key text; false when the member is empty, which is not indexed
+    KeyFn key;
+
+    // Whether key texts sort as numbers rather than as text ("false" < "true" sorts either way)
+    Bool numeric;
+};
+
+// Reads one optional member of T as index key text; the generated tables point at these
+template<typename T, typename M, M T::*Member>
+struct EntityFieldKey {
+    typedef typename M::value_type Value;
+    Static constexpr Bool numeric = (std::is_arithmetic<Value>::value && !std::is_same<Value, bool>::value) ||
+                                    std::is_enum<Value>::value;
+
+    Static Bool Key(const T& entity, StdString& out) {
+        const M& value = entity.*Member;
+        if (!value.has_value()) {
+            return false;
+        }
+        EntityKey::Append(value.value(), out);
+        return true;
+    }
+};
+
+// No table for T: it is not an @Entity, or the generated header is not on the include path
+template<typename T>
+struct EntityTable {
+    Static constexpr Bool available = false;
+};
+
+#endif // ENTITYTABLE_H
@@ -0,0 +1,124 @@
+#ifndef ESPNVSPARTITION_H
+#define ESPNVSPARTITION_H
+
+#ifdef ARDUINO
+
+#include <StandardDefines.h>
+#include <mutex>
+#include <nvs.h>
+#include <nvs_flash.h>
+#include "INvsPartition.h"
+
+// Label of the partition in partitions.csv
+#ifndef ESPNVSPARTITION_LABEL
+#define ESPNVSPARTITION_LABEL "nvs"
+#endif
+
+DefineStandardPointers(EspNvsPartition)
+
+/**
+ * INvsPartition over ESP-IDF's nvs_* API, the flash Preferences writes to,
+ * with one handle per namespace kept open.
+ *
+ * Entry counts come from nvs_get_stats(). ESP-IDF does not report erased
+ * entries or page erases, so those stay zero; bytesProgrammed estimates the
+ * entries each blob takes, without garbage collection, which NvsSimulator
+ * counts on the desktop.
+ */
+class EspNvsPartition : public INvsPartition {
+    Private StdString label;
+    Private std::mutex mutex;
+    Private StdMap<StdString, nvs_handle_t> handles;
+    Private Bool ready = false;
+    Private Size bytesProgrammed = 0;
+    Private Size bytesRequested = 0;
+
+    Public explicit EspNvsPartition(CStdString& partitionLabel = ESPNVSPARTITION_LABEL) : label(partitionLabel) {
+        esp_err_t result = nvs_flash_init_partition(label.c_str());
+        if (result == ESP_ERR_NVS_NO_FREE_PAGES || result == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+            // As Preferences does: a partition written by another NVS version is erased
+            nvs_flash_erase_partition(label.c_str());
+            result = nvs_flash_init_partition(label.c_str());
+        }
+        ready = result == ESP_OK;
+    }
+
+    Public ~EspNvsPartition() override {
+        for (auto& handle : handles) {
+            nvs_close(handle.second);
+        }
+    }
+
+    EspNvsPartition(const EspNvsPartition&) = delete;
+    EspNvsPartition& operator=(const EspNvsPartition&) = delete;
+
+    Public Bool SetBlob(CStdString& space, CStdString& key, CStdString& value) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        nvs_handle_t handle;
+        if (!Open(space, handle) || key.size() > kMaxKeyLength ||
+            nvs_set_blob(handle, key.c_str(), value.data(), value.size()) != ESP_OK) {
+            return false;
+        }
+        // A data chunk's header, its data and the index entry
+        bytesProgrammed += (2 + (value.size() + 31) / 32) * 32;
+        bytesRequested += value.size();
+        return true;
+    }
+
+    Public Bool GetBlob(CStdString& space, CStdString& key, StdString& value) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        nvs_handle_t handle;
+        size_t length = 0;
+        if (!Open(space, handle) || nvs_get_blob(handle, key.c_str(), nullptr, &length) != ESP_OK) {
+            return false;
+        }
+        value.resize(length);
+        return length == 0 || nvs_get_blob(handle, key.c_str(), &value[0], &length) == ESP_OK;
+    }
+
+    Public Bool EraseKey(CStdString& space, CStdString& key) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        nvs_handle_t handle;
+        return Open(space, handle) && nvs_erase_key(handle, key.c_str()) == ESP_OK;
+    }
+
+    Public Bool Commit(CStdString& space) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        nvs_handle_t handle;
+        return Open(space, handle) && nvs_commit(handle) == ESP_OK;
+    }
+
+    Public Stats GetStats() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats stats;
+        nvs_stats_t nvs;
+        if (ready && nvs_get_stats(label.c_str(), &nvs) == ESP_OK) {
+            stats.totalEntries = nvs.total_entries;
+            stats.usedEntries = nvs.used_entries;
+            stats.freeEntries = nvs.free_entries;
+            stats.availableEntries = nvs.free_entries > 126 ? nvs.free_entries - 126 : 0;
+        }
+        stats.bytesProgrammed = bytesProgrammed;
+        stats.bytesRequested = bytesRequested;
+        return stats;
+    }
+
+    // The namespace's handle, opened on first use; called holding the mutex
+    Private Bool Open(CStdString& space, nvs_handle_t& handle) {
+        auto it = handles.find(space);
+        if (it != handles.end()) {
+            handle = it->second;
+            return true;
+        }
+        if (!ready || space.size() > kMaxKeyLength ||
+            nvs_open_from_partition(label.c_str(), space.c_str(), NVS_READWRITE, &handle) != ESP_OK) {
+            return false;
+        }
+        handles[space] = handle;
+        return true;
+    }
+};
+
+#endif // ARDUINO
+
+#endif // ESPNVSPARTITION_H
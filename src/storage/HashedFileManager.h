@@ -0,0 +1,460 @@
+#ifndef HASHEDFILEMANAGER_H
+#define HASHEDFILEMANAGER_H
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include "../serializer/NumberFormat.h"
+#include "StableHash.h"
+
+// Files of the key directory in the wrapped file manager, with ".0" and ".1" appended
+#ifndef HASHEDFILEMANAGER_DIRECTORY_FILE
+#define HASHEDFILEMANAGER_DIRECTORY_FILE "_key_directory"
+#endif
+
+DefineStandardPointers(HashedFileManager)
+
+/**
+ * IFileManager that stores each file under a fixed-length name derived from
+ * a 64-bit StableHash of the name it is given, e.g. "Product_id_42" as
+ * "3b0c5a1f9e24d870", in another file manager.
+ *
+ * The framework names entity files by std::hash truncated to 32 bits:
+ * past some 10k files two names are likely to share a file, and the later
+ * write silently replaces the other entity; the value also differs between
+ * standard libraries. Here every name is recorded in a key directory with
+ * the file it owns, so a name whose hash is already taken gets the lowest
+ * free "~1", "~2"... suffix instead of another name's file, and reading a
+ * name that was never stored reads nothing, whatever its hash. Deleting a
+ * name frees its file for the next name with that hash.
+ *
+ * The directory is a log, one line per change, appended before the file
+ * itself is written:
+ *
+ *     #keys 1 7 2                          format, generation, names in the snapshot
+ *     +3b0c5a1f9e24d870\tProduct_id_42      snapshot, then changes: name stored in file
+ *     +9d41e0c27b5a3f16\tProduct_id_43
+ *     -Product_id_42                       name deleted
+ *
+ * Once more lines were appended than the last snapshot held, like
+ * SecondaryIndex, a new snapshot of the next generation is written to the
+ * other of the two directory files, and later changes go there. A snapshot
+ * a crash cut short has fewer lines than its header says and is ignored on
+ * load in favour of the older, whole one; a change line cut short is
+ * ignored too. The directory is read once, on the first call; memory is one
+ * entry of hash and suffix per name, and a count per hash. Names may not
+ * contain tabs or newlines.
+ *
+ * MigrateLegacy() moves the files of a store written by the framework's
+ * naming into this one.
+ */
+class HashedFileManager : public IFileManager {
+    Public typedef std::function<uint64_t(std::string_view)> HashFn;
+
+    Public struct Stats {
+        Size names = 0;
+        // Names stored under a suffix because their hash was taken
+        Size collisions = 0;
+        Size directoryRewrites = 0;
+    };
+
+    Public struct MigrationResult {
+        Size migrated = 0;
+        // Names without a legacy file
+        Size missing = 0;
+        // Names sharing a legacy file with another, left where they were
+        Size collided = 0;
+    };
+
+    Private Static constexpr Size kCompactSlack = 32;
+
+    // The file a name is stored in: its hash, plus a suffix when the hash was taken
+    Private struct Slot {
+        uint64_t hash;
+        uint32_t suffix;
+    };
+
+    Private IFileManagerPtr files;
+    Private HashFn hashFn;
+    Private std::mutex mutex;
+    Private StdUnorderedMap<StdString, Slot> slotByName;
+    // Names stored per hash; more than one only after a collision
+    Private StdUnorderedMap<uint64_t, uint32_t> namesByHash;
+    Private Bool loaded = false;
+    // Directory file changes are appended to, 0 or 1, and its generation
+    Private Int current = 0;
+    Private uint64_t generation = 0;
+    Private Size appendedLines = 0;
+    Private Size compactedEntries = 0;
+    // The current file is missing or ends in a cut-short line, so the next change writes a snapshot
+    Private Bool tornTail = false;
+    Private Bool deferring = false;
+    Private StdString pending;
+    Private Stats stats;
+
+    /**
+     * @param fileManager Holds the files and the key directory
+     * @param hash Hash of a name; StableHash::Of unless given, e.g. to force collisions in tests
+     */
+    Public explicit HashedFileManager(IFileManagerPtr fileManager, HashFn hash = HashFn())
+        : files(fileManager), hashFn(hash ? std::move(hash) : HashFn([](std::string_view name) {
+              return StableHash::Of(name);
+          })) {}
+
+    Public Bool Create(CStdString& filename, CStdString& contents) override {
+        StdString file;
+        return Assign(filename, file) && files->Create(file, contents);
+    }
+
+    // Empty when no file was stored under the name
+    Public StdString Read(CStdString& filename) override {
+        StdString file;
+        return Find(filename, file) ? files->Read(file) : StdString();
+    }
+
+    Public Bool Update(CStdString& filename, CStdString& contents) override {
+        StdString file;
+        return Assign(filename, file) && files->Update(file, contents);
+    }
+
+    Public Bool Append(CStdString& filename, CStdString& contents) override {
+        StdString file;
+        return Assign(filename, file) && files->Append(file, contents);
+    }
+
+    Public Bool Delete(CStdString& filename) override {
+        StdString file;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Load();
+            auto it = slotByName.find(filename);
+            if (it == slotByName.end()) {
+                return false;
+            }
+            file = FileOf(it->second);
+            Release(it);
+            Log("-" + filename + "\n");
+        }
+        return files->Delete(file);
+    }
+
+    /**
+     * @brief The file a name is stored in
+     * @return False when no file was stored under the name
+     */
+    Public Bool Find(CStdString& filename, StdString& file) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        auto it = slotByName.find(filename);
+        if (it == slotByName.end()) {
+            return false;
+        }
+        file = FileOf(it->second);
+        return true;
+    }
+
+    Public Bool Exists(CStdString& filename) {
+        StdString file;
+        return Find(filename, file);
+    }
+
+    Public Stats GetStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        Stats current = stats;
+        current.names = slotByName.size();
+        return current;
+    }
+
+    /**
+     * @brief The name the framework stores a file under: std::hash truncated to 32 bits, in decimal
+     * As CpaRepositoryImpl::GenerateHash; only valid with the standard library that wrote the store.
+     */
+    Public Static StdString LegacyFileName(CStdString& filename) {
+        return std::to_string(static_cast<uint32_t>(std::hash<StdString>()(filename)));
+    }
+
+    /**
+     * @brief The names of an entity's files in a legacy store: its id list and one per id
+     */
+    Public Static StdVector<StdString> LegacyEntityFiles(IFileManager& legacy, CStdString& entityName) {
+        StdVector<StdString> names;
+        StdString listFile = entityName + "_IDs";
+        StdString list = legacy.Read(LegacyFileName(listFile));
+        if (list.empty()) {
+            return names;
+        }
+        names.push_back(listFile);
+        std::string_view rest(list);
+        while (!rest.empty()) {
+            Size end = rest.find('\n');
+            std::string_view line = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+            if (!line.empty()) {
+                names.push_back(entityName + "_id_" + StdString(line));
+            }
+        }
+        return names;
+    }
+
+    /**
+     * @brief Move files stored under LegacyFileName() into this manager, in one pass
+     * Each file is copied, the key directory written once for all of them,
+     * and only then are the legacy files deleted, so a crash at any point
+     * leaves every file readable from one store or the other and the
+     * migration can simply be run again. Names that share a legacy file lost
+     * data before the migration; they are not copied and their file is kept.
+     */
+    Public MigrationResult MigrateLegacy(IFileManager& legacy, const StdVector<StdString>& names) {
+        MigrationResult result;
+        StdUnorderedMap<StdString, Size> namesByFile;
+        for (CStdString& name : names) {
+            namesByFile[LegacyFileName(name)]++;
+        }
+        StdVector<StdString> migrated;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Load();
+            deferring = true;
+        }
+        for (CStdString& name : names) {
+            StdString legacyFile = LegacyFileName(name);
+            if (namesByFile[legacyFile] > 1) {
+                result.collided++;
+                continue;
+            }
+            StdString contents = legacy.Read(legacyFile);
+            if (contents.empty()) {
+                result.missing++;
+                continue;
+            }
+            if (Create(name, contents)) {
+                migrated.push_back(std::move(legacyFile));
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            deferring = false;
+            Flush();
+        }
+        for (CStdString& legacyFile : migrated) {
+            legacy.Delete(legacyFile);
+        }
+        result.migrated = migrated.size();
+        return result;
+    }
+
+    // The file for a name, taking a free one and recording it when the name is new
+    Private Bool Assign(CStdString& filename, StdString& file) {
+        if (filename.find_first_of("\t\n") != StdString::npos) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        auto it = slotByName.find(filename);
+        if (it != slotByName.end()) {
+            file = FileOf(it->second);
+            return true;
+        }
+        Slot slot{hashFn(filename), 0};
+        if (namesByHash.count(slot.hash) > 0) {
+            // A collision, rare enough to look for the lowest free suffix among every name
+            StdSet<uint32_t> taken;
+            for (const auto& entry : slotByName) {
+                if (entry.second.hash == slot.hash) {
+                    taken.insert(entry.second.suffix);
+                }
+            }
+            while (taken.count(slot.suffix) > 0) {
+                slot.suffix++;
+            }
+        }
+        Take(slotByName.emplace(filename, slot).first);
+        file = FileOf(slot);
+        Log("+" + file + "\t" + filename + "\n");
+        return true;
+    }
+
+    // Counts a name just added to slotByName; the lock must be held
+    Private Void Take(StdUnorderedMap<StdString, Slot>::iterator it) {
+        namesByHash[it->second.hash]++;
+        stats.collisions += it->second.suffix > 0 ? 1 : 0;
+    }
+
+    // Removes a name from slotByName, freeing its file; the lock must be held
+    Private Void Release(StdUnorderedMap<StdString, Slot>::iterator it) {
+        auto count = namesByHash.find(it->second.hash);
+        if (count != namesByHash.end() && --count->second == 0) {
+            namesByHash.erase(count);
+        }
+        stats.collisions -= it->second.suffix > 0 ? 1 : 0;
+        slotByName.erase(it);
+    }
+
+    Private Static StdString FileOf(const Slot& slot) {
+        StdString file = StableHash::Hex(slot.hash);
+        if (slot.suffix > 0) {
+            file += '~';
+            NumberFormat::AppendUInt(slot.suffix, file);
+        }
+        return file;
+    }
+
+    // Parses "3b0c5a1f9e24d870" or "3b0c5a1f9e24d870~2"
+    Private Static Bool ParseFile(std::string_view file, Slot& slot) {
+        if (file.size() < 16) {
+            return false;
+        }
+        slot.hash = 0;
+        for (Size i = 0; i < 16; i++) {
+            char c = file[i];
+            Int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            slot.hash = (slot.hash << 4) | static_cast<uint64_t>(digit);
+        }
+        slot.suffix = 0;
+        if (file.size() == 16) {
+            return true;
+        }
+        uint64_t suffix = 0;
+        if (file[16] != '~' || NumberFormat::ParseUInt(file.data() + 17, file.data() + file.size(), suffix) != file.size() - 17) {
+            return false;
+        }
+        slot.suffix = static_cast<uint32_t>(suffix);
+        return true;
+    }
+
+    // Reads the key directory on first use: the newer directory file whose snapshot is whole; the lock must be held
+    Private Void Load() {
+        if (loaded) {
+            return;
+        }
+        loaded = true;
+        StdString contents[2];
+        uint64_t generations[2] = {0, 0};
+        uint64_t snapshots[2] = {0, 0};
+        Bool whole[2] = {false, false};
+        for (Int i = 0; i < 2; i++) {
+            contents[i] = files->Read(DirectoryFile(i));
+            whole[i] = ParseHeader(contents[i], generations[i], snapshots[i]);
+        }
+        if (!whole[0] && !whole[1]) {
+            // Nothing stored yet, or nothing readable; the first change writes a snapshot
+            tornTail = true;
+            return;
+        }
+        current = whole[1] && (!whole[0] || generations[1] > generations[0]) ? 1 : 0;
+        generation = generations[current];
+        CStdString& chosen = contents[current];
+        tornTail = chosen.back() != '\n';
+        std::string_view rest(chosen);
+        Size end = rest.find('\n');
+        rest.remove_prefix(end + 1);
+        // Only the changes after the snapshot count towards the next rewrite, as they do after Rewrite()
+        uint64_t snapshotLines = snapshots[current];
+        while ((end = rest.find('\n')) != std::string_view::npos) {
+            std::string_view line = rest.substr(0, end);
+            rest.remove_prefix(end + 1);
+            if (snapshotLines > 0) {
+                snapshotLines--;
+            } else {
+                appendedLines++;
+            }
+            if (line.size() < 2) {
+                continue;
+            }
+            if (line[0] == '-') {
+                auto it = slotByName.find(StdString(line.substr(1)));
+                if (it != slotByName.end()) {
+                    Release(it);
+                }
+                continue;
+            }
+            Size tab = line.find('\t');
+            Slot slot;
+            if (line[0] != '+' || tab == std::string_view::npos || !ParseFile(line.substr(1, tab - 1), slot)) {
+                continue;
+            }
+            auto inserted = slotByName.emplace(StdString(line.substr(tab + 1)), slot);
+            if (inserted.second) {
+                Take(inserted.first);
+            }
+        }
+        compactedEntries = static_cast<Size>(snapshots[current]);
+    }
+
+    // A directory file whose header is "#keys 1 <generation> <names>" and whose snapshot lines all end
+    Private Static Bool ParseHeader(CStdString& contents, uint64_t& fileGeneration, uint64_t& names) {
+        Size end = contents.find('\n');
+        if (contents.compare(0, 8, "#keys 1 ") != 0 || end == StdString::npos) {
+            return false;
+        }
+        const char* p = contents.data() + 8;
+        const char* last = contents.data() + end;
+        Size digits = NumberFormat::ParseUInt(p, last, fileGeneration);
+        if (digits == 0 || p[digits] != ' ' || NumberFormat::ParseUInt(p + digits + 1, last, names) != static_cast<Size>(last - p) - digits - 1) {
+            return false;
+        }
+        return static_cast<uint64_t>(std::count(contents.begin() + static_cast<std::ptrdiff_t>(end) + 1, contents.end(), '\n')) >= names;
+    }
+
+    Private Static StdString DirectoryFile(Int index) {
+        return StdString(HASHEDFILEMANAGER_DIRECTORY_FILE) + (index == 0 ? ".0" : ".1");
+    }
+
+    // Appends a change, or rewrites the directory when due; the lock must be held
+    Private Void Log(CStdString& line) {
+        pending += line;
+        appendedLines++;
+        if (!deferring) {
+            Flush();
+        }
+    }
+
+    Private Void Flush() {
+        if (pending.empty()) {
+            return;
+        }
+        if (tornTail || appendedLines > compactedEntries + kCompactSlack) {
+            Rewrite();
+        } else {
+            files->Append(DirectoryFile(current), pending);
+        }
+        pending.clear();
+    }
+
+    // A snapshot of the next generation into the other directory file; the current one stays whole until it is
+    Private Void Rewrite() {
+        StdString contents = "#keys 1 ";
+        contents.reserve(32 + slotByName.size() * 40);
+        NumberFormat::AppendUInt(generation + 1, contents);
+        contents += ' ';
+        NumberFormat::AppendUInt(slotByName.size(), contents);
+        contents += '\n';
+        for (const auto& entry : slotByName) {
+            contents += '+';
+            contents += FileOf(entry.second);
+            contents += '\t';
+            contents += entry.first;
+            contents += '\n';
+        }
+        if (!files->Update(DirectoryFile(1 - current), contents)) {
+            // Keep appending to the current one; the next change tries again
+            files->Append(DirectoryFile(current), pending);
+            return;
+        }
+        current = 1 - current;
+        generation++;
+        compactedEntries = slotByName.size();
+        appendedLines = 0;
+        tornTail = false;
+        stats.directoryRewrites++;
+    }
+};
+
+#endif // HASHEDFILEMANAGER_H
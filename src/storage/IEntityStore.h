@@ -0,0 +1,92 @@
+#ifndef IENTITYSTORE_H
+#define IENTITYSTORE_H
+
+#include <StandardDefines.h>
+#include "RecordView.h"
+
+/**
+ * Record storage behind EntityRepository: serialized entities by key, the
+ * key being the text form of the entity's id.
+ *
+ * EntityFileStore keeps one file per record through an IFileManager;
+ * EntityLogStore appends every record to one log per entity type. A
+ * @Repository picks its backend with a @Storage annotation.
+ */
+DefineStandardPointers(IEntityStore)
+class IEntityStore {
+    Public Virtual ~IEntityStore() = default;
+
+    /**
+     * @brief Write a record, creating it or replacing the previous one
+     */
+    Public Virtual Bool Write(CStdString& key, CStdString& record) = 0;
+
+    /**
+     * @brief Read a record
+     * @return Empty when there is no record for key
+     */
+    Public Virtual StdString Read(CStdString& key) = 0;
+
+    /**
+     * @brief Read a record for parsing in place, mapped where the store can
+     * @return Empty when there is no record for key
+     */
+    Public Virtual RecordView ReadView(CStdString& key) {
+        return RecordView(Read(key));
+    }
+
+    /**
+     * @brief Remove a record
+     * @return False when there was none
+     */
+    Public Virtual Bool Remove(CStdString& key) = 0;
+
+    Public Virtual Bool Contains(CStdString& key) = 0;
+
+    /**
+     * @brief Make every write so far durable, e.g. before a journal drops them
+     * @return False when they could not be, and always for stores that cannot
+     * sync, so an EntityJournal keeps the records that may not be on disk yet
+     */
+    Public Virtual Bool Sync() {
+        return false;
+    }
+
+    // Whether Sync() can succeed at all; EntityRepository::AttachJournal() refuses stores that cannot
+    Public Virtual Bool CanSync() const {
+        return false;
+    }
+
+    /**
+     * @brief Write several records, as one write where the store can
+     * @param records (key, record) pairs; a key written twice keeps its last record
+     * @return False when any write failed
+     */
+    Public Virtual Bool WriteAll(const StdVector<std::pair<StdString, StdString>>& records) {
+        Bool written = true;
+        for (const auto& record : records) {
+            written = Write(record.first, record.second) && written;
+        }
+        return written;
+    }
+
+    /**
+     * @brief Remove several records, as one write where the store can
+     * @return Records removed
+     */
+    Public Virtual Size RemoveAll(const StdVector<StdString>& keys) {
+        Size removed = 0;
+        for (CStdString& key : keys) {
+            removed += Remove(key) ? 1 : 0;
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Keys of every record, in the order they were first written
+     * Valid until the next Write or Remove.
+     */
+    Public Virtual const StdVector<StdString>& Keys() = 0;
+};
+
+#endif // IENTITYSTORE_H
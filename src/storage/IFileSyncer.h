@@ -0,0 +1,22 @@
+#ifndef IFILESYNCER_H
+#define IFILESYNCER_H
+
+#include <StandardDefines.h>
+
+/**
+ * An IFileManager that can also flush what it wrote to storage. EntityFileStore
+ * syncs through it when its file manager is one, which lets an EntityJournal
+ * drop records written through the store.
+ */
+DefineStandardPointers(IFileSyncer)
+class IFileSyncer {
+    Public Virtual ~IFileSyncer() = default;
+
+    /**
+     * @brief Make every write, creation and removal so far durable
+     * @return False when any of them could not be
+     */
+    Public Virtual Bool Sync() = 0;
+};
+
+#endif // IFILESYNCER_H
@@ -0,0 +1,71 @@
+#ifndef INVSPARTITION_H
+#define INVSPARTITION_H
+
+#include <StandardDefines.h>
+
+/**
+ * Blob API of the ESP32's NVS (non-volatile storage) partition: values by
+ * namespace and key, both at most 15 characters.
+ *
+ * NVS stores values in 4 KB flash pages of 126 entries of 32 bytes. A blob
+ * takes one entry for its header and one per 32 bytes of data, plus an index
+ * entry; rewriting a key programs all of them again and marks the old ones
+ * erased. A page is erased only when garbage collection moves its live
+ * entries out, so the erase count, and so flash wear, follows the entries
+ * written, not the bytes changed.
+ *
+ * EspNvsPartition is the device's partition; NvsSimulator models the page
+ * format on the desktop.
+ */
+DefineStandardPointers(INvsPartition)
+class INvsPartition {
+    Public struct Stats {
+        Size totalEntries = 0;
+        // Entries holding live values
+        Size usedEntries = 0;
+        // Entries a new value can take, erased ones included: total minus used
+        Size freeEntries = 0;
+        // Free entries outside the page NVS keeps for garbage collection
+        Size availableEntries = 0;
+        // Entries holding superseded or removed values, reclaimed by garbage collection
+        Size erasedEntries = 0;
+        // Flash page erases, and the most any one page had; zero where the partition cannot tell
+        Size pageErases = 0;
+        Size maxPageErases = 0;
+        // Bytes of entries written to flash, garbage collection included
+        Size bytesProgrammed = 0;
+        // Bytes of values the caller wrote
+        Size bytesRequested = 0;
+    };
+
+    Public Static constexpr Size kMaxKeyLength = 15;
+
+    Public Virtual ~INvsPartition() = default;
+
+    /**
+     * @brief Create or replace a blob
+     * @return False when the partition is full or a name is too long
+     */
+    Public Virtual Bool SetBlob(CStdString& space, CStdString& key, CStdString& value) = 0;
+
+    /**
+     * @brief Read a blob
+     * @return False when there is none
+     */
+    Public Virtual Bool GetBlob(CStdString& space, CStdString& key, StdString& value) = 0;
+
+    /**
+     * @brief Remove a blob
+     * @return False when there was none
+     */
+    Public Virtual Bool EraseKey(CStdString& space, CStdString& key) = 0;
+
+    /**
+     * @brief Make the namespace's writes durable
+     */
+    Public Virtual Bool Commit(CStdString& space) = 0;
+
+    Public Virtual Stats GetStats() = 0;
+};
+
+#endif // INVSPARTITION_H
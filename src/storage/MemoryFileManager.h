@@ -0,0 +1,102 @@
+#ifndef MEMORYFILEMANAGER_H
+#define MEMORYFILEMANAGER_H
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+
+DefineStandardPointers(MemoryFileManager)
+
+/**
+ * IFileManager over a map in memory, counting every call and byte written.
+ *
+ * Lets EntityRepository be tested and benchmarked without a disk or the
+ * ESP32's Preferences, and the counters show what a change costs in I/O:
+ * a store that reads fewer files or writes fewer bytes does so here too.
+ * Not thread-safe.
+ */
+class MemoryFileManager : public IFileManager {
+    Public struct Counters {
+        Size reads = 0;
+        Size creates = 0;
+        Size updates = 0;
+        Size appends = 0;
+        Size deletes = 0;
+        Size bytesRead = 0;
+        Size bytesWritten = 0;
+
+        Size Writes() const {
+            return creates + updates + appends + deletes;
+        }
+    };
+
+    Private StdMap<StdString, StdString> files;
+    Private Counters counters;
+
+    Public MemoryFileManager() = default;
+
+    Public Bool Create(CStdString& filename, CStdString& contents) override {
+        files[filename] = contents;
+        counters.creates++;
+        counters.bytesWritten += contents.size();
+        return true;
+    }
+
+    // Empty when the file does not exist, as with the framework's file managers
+    Public StdString Read(CStdString& filename) override {
+        counters.reads++;
+        auto it = files.find(filename);
+        if (it == files.end()) {
+            return StdString();
+        }
+        counters.bytesRead += it->second.size();
+        return it->second;
+    }
+
+    Public Bool Update(CStdString& filename, CStdString& contents) override {
+        files[filename] = contents;
+        counters.updates++;
+        counters.bytesWritten += contents.size();
+        return true;
+    }
+
+    Public Bool Delete(CStdString& filename) override {
+        counters.deletes++;
+        return files.erase(filename) > 0;
+    }
+
+    Public Bool Append(CStdString& filename, CStdString& contents) override {
+        files[filename] += contents;
+        counters.appends++;
+        counters.bytesWritten += contents.size();
+        return true;
+    }
+
+    Public Bool Exists(CStdString& filename) const {
+        return files.find(filename) != files.end();
+    }
+
+    // Contents without counting a read
+    Public StdString Peek(CStdString& filename) const {
+        auto it = files.find(filename);
+        return it == files.end() ? StdString() : it->second;
+    }
+
+    Public Size GetFileCount() const {
+        return files.size();
+    }
+
+    Public const Counters& GetCounters() const {
+        return counters;
+    }
+
+    Public Void ResetCounters() {
+        counters = Counters();
+    }
+
+    Public Void Clear() {
+        files.clear();
+        counters = Counters();
+    }
+};
+
+#endif // MEMORYFILEMANAGER_H
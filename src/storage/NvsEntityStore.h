@@ -0,0 +1,453 @@
+#ifndef NVSENTITYSTORE_H
+#define NVSENTITYSTORE_H
+
+#include <StandardDefines.h>
+#include <algorithm>
+#include <string_view>
+#include "IEntityStore.h"
+#include "INvsPartition.h"
+#include "NvsSimulator.h"
+#ifdef ARDUINO
+#include "EspNvsPartition.h"
+#endif
+
+// Bytes of records packed into one NVS blob; 0 gives every record a blob of its own
+#ifndef NVSENTITYSTORE_PACK_BYTES
+#define NVSENTITYSTORE_PACK_BYTES 0
+#endif
+
+/**
+ * Record store in NVS, for the small, often rewritten entities that fit the
+ * ESP32's nvs partition, e.g. Switch.
+ *
+ * Records are kept in blobs ("packs") in the entity's namespace, "p0",
+ * "p1" and so on, each record as
+ *
+ *     u8 key length | u16 record length, little-endian | key | record
+ *
+ * By default every record has a pack of its own. With packBytes set, records
+ * share packs of up to that many bytes, so forty switches take a dozen blobs
+ * rather than forty, each with its own header and index entries. The blob
+ * "keys" is the key directory,
+ * one "<pack> <key>" line per record in the order they were first written:
+ * NVS cannot list a namespace through Preferences, so the directory is how
+ * Keys() enumerates the records and how a record is found without reading
+ * every pack.
+ *
+ * Rewriting a record rewrites its pack, so the pack size trades space for
+ * wear: every rewrite programs the whole pack to flash, and pages are
+ * erased in proportion. nvs_bench prints the flash bytes and page erases
+ * per toggle of a switch for several sizes; packing only pays for records
+ * that are rarely rewritten and many. A record that outgrows its pack
+ * moves to one with room. The directory is rewritten only when a record is
+ * added, moved or removed.
+ *
+ * The directory names a record only while its pack holds it: a new record's
+ * pack is written before the directory, a removal updates the directory
+ * first. Loading drops directory lines whose pack lacks the record. Every
+ * change is committed to the partition before the call returns. A write
+ * the partition cannot take returns false and reloads the directory.
+ *
+ * Not thread-safe; EntityRepository serializes its calls.
+ */
+DefineStandardPointers(NvsEntityStore)
+class NvsEntityStore : public IEntityStore {
+    Public struct Options {
+        Size packBytes = NVSENTITYSTORE_PACK_BYTES;
+    };
+
+    Public struct Stats {
+        Size records = 0;
+        Size packs = 0;
+        Size packWrites = 0;
+        Size directoryWrites = 0;
+        // Blob bytes written, packs and directory
+        Size bytesWritten = 0;
+        Size commits = 0;
+    };
+
+    Private typedef StdVector<std::pair<StdString, StdString>> Pack;
+
+    // Packs a batch of changes touches, written once each when it is done
+    Private struct Batch {
+        StdMap<Size, Pack> packs;
+        // Written before the directory
+        StdSet<Size> grown;
+        // Written after it
+        StdSet<Size> shrunk;
+        Bool directory = false;
+    };
+
+    Private Static constexpr const char* kDirectoryKey = "keys";
+
+    Private INvsPartitionPtr nvs;
+    Private StdString space;
+    Private Options options;
+    Private StdVector<StdString> keys;
+    Private StdUnorderedMap<StdString, Size> packOf;
+    // Encoded bytes of each pack
+    Private StdMap<Size, Size> packSizes;
+    Private Stats stats;
+    Private Bool loaded = false;
+
+    /**
+     * @param partition The NVS partition, e.g. DefaultPartition()
+     * @param entityName Namespace of the records, cut to 15 characters
+     */
+    Public NvsEntityStore(INvsPartitionPtr partition, CStdString& entityName)
+        : NvsEntityStore(partition, entityName, Options()) {}
+
+    Public NvsEntityStore(INvsPartitionPtr partition, CStdString& entityName, const Options& storeOptions)
+        : nvs(partition), space(entityName.substr(0, INvsPartition::kMaxKeyLength)), options(storeOptions) {}
+
+    /**
+     * @brief The partition @Storage("nvs") repositories share
+     * The nvs partition on the ESP32; an NvsSimulator, gone on exit, on the desktop.
+     */
+    Public Static INvsPartitionPtr DefaultPartition() {
+#ifdef ARDUINO
+        static INvsPartitionPtr partition = std::make_shared<EspNvsPartition>();
+#else
+        static INvsPartitionPtr partition = std::make_shared<NvsSimulator>();
+#endif
+        return partition;
+    }
+
+    // False for a key over 255 bytes or holding a newline, or a record over 65535 bytes
+    Public Bool Write(CStdString& key, CStdString& record) override {
+        Load();
+        Batch batch;
+        return Put(batch, key, record) && Flush(batch);
+    }
+
+    Public StdString Read(CStdString& key) override {
+        Load();
+        auto it = packOf.find(key);
+        StdString blob;
+        if (it == packOf.end() || !nvs->GetBlob(space, PackKey(it->second), blob)) {
+            return StdString();
+        }
+        std::string_view record;
+        return Find(blob, key, record) ? StdString(record) : StdString();
+    }
+
+    Public Bool Remove(CStdString& key) override {
+        Load();
+        if (packOf.count(key) == 0) {
+            return false;
+        }
+        Batch batch;
+        Drop(batch, key);
+        Flush(batch);
+        return true;
+    }
+
+    // Each touched pack and the directory written once
+    Public Bool WriteAll(const StdVector<std::pair<StdString, StdString>>& records) override {
+        Load();
+        Batch batch;
+        Bool placed = true;
+        for (const auto& record : records) {
+            placed = Put(batch, record.first, record.second) && placed;
+        }
+        return Flush(batch) && placed;
+    }
+
+    Public Size RemoveAll(const StdVector<StdString>& removing) override {
+        Load();
+        Batch batch;
+        Size removed = 0;
+        for (CStdString& key : removing) {
+            if (packOf.count(key) > 0) {
+                Drop(batch, key);
+                removed++;
+            }
+        }
+        if (removed > 0) {
+            Flush(batch);
+        }
+        return removed;
+    }
+
+    Public Bool Contains(CStdString& key) override {
+        Load();
+        return packOf.count(key) > 0;
+    }
+
+    Public Bool Sync() override {
+        return nvs->Commit(space);
+    }
+
+    Public Bool CanSync() const override {
+        return true;
+    }
+
+    Public const StdVector<StdString>& Keys() override {
+        Load();
+        return keys;
+    }
+
+    Public Stats GetStats() {
+        Load();
+        Stats current = stats;
+        current.records = keys.size();
+        current.packs = packSizes.size();
+        return current;
+    }
+
+    Public Void ResetStats() {
+        stats = Stats();
+    }
+
+    Public INvsPartition::Stats GetPartitionStats() {
+        return nvs->GetStats();
+    }
+
+    Public CStdString& GetNamespace() const {
+        return space;
+    }
+
+    Public Static StdString PackKey(Size pack) {
+        return "p" + std::to_string(pack);
+    }
+
+    // Places the record: in its pack while it fits, else the first pack with room
+    Private Bool Put(Batch& batch, CStdString& key, CStdString& record) {
+        if (key.empty() || key.size() > 0xFF || record.size() > 0xFFFF || key.find('\n') != StdString::npos) {
+            return false;
+        }
+        Size need = EntrySize(key, record.size());
+        auto it = packOf.find(key);
+        Size from = static_cast<Size>(-1);
+        if (it == packOf.end()) {
+            keys.push_back(key);
+        } else {
+            from = it->second;
+            Pack& pack = Touch(batch, from);
+            auto entry = Entry(pack, key);
+            // Missing only when the pack could not be read; the record is placed anew
+            if (entry != pack.end()) {
+                Size size = packSizes[from] - EntrySize(key, entry->second.size()) + need;
+                if (size <= options.packBytes || pack.size() == 1) {
+                    entry->second = record;
+                    packSizes[from] = size;
+                    batch.grown.insert(from);
+                    return true;
+                }
+                packSizes[from] -= EntrySize(key, entry->second.size());
+                pack.erase(entry);
+                batch.shrunk.insert(from);
+            }
+        }
+        Size to = Room(need, from);
+        Touch(batch, to).emplace_back(key, record);
+        packSizes[to] += need;
+        packOf[key] = to;
+        batch.grown.insert(to);
+        batch.directory = true;
+        return true;
+    }
+
+    Private Void Drop(Batch& batch, CStdString& key) {
+        Size from = packOf[key];
+        Pack& pack = Touch(batch, from);
+        auto entry = Entry(pack, key);
+        if (entry != pack.end()) {
+            packSizes[from] -= EntrySize(key, entry->second.size());
+            pack.erase(entry);
+        }
+        packOf.erase(key);
+        keys.erase(std::find(keys.begin(), keys.end(), key));
+        batch.shrunk.insert(from);
+        batch.directory = true;
+    }
+
+    // Packs with new records, then the directory, then packs that only lost records, then a commit
+    Private Bool Flush(Batch& batch) {
+        Bool ok = true;
+        for (Size pack : batch.grown) {
+            ok = WritePack(pack, batch.packs[pack]) && ok;
+        }
+        if (ok && batch.directory) {
+            StdString directory;
+            for (CStdString& key : keys) {
+                directory += std::to_string(packOf[key]);
+                directory += ' ';
+                directory += key;
+                directory += '\n';
+            }
+            ok = nvs->SetBlob(space, kDirectoryKey, directory);
+            stats.directoryWrites++;
+            stats.bytesWritten += directory.size();
+        }
+        for (Size pack : batch.shrunk) {
+            if (!ok || batch.grown.count(pack) > 0) {
+                continue;
+            }
+            if (batch.packs[pack].empty()) {
+                nvs->EraseKey(space, PackKey(pack));
+                packSizes.erase(pack);
+            } else {
+                ok = WritePack(pack, batch.packs[pack]) && ok;
+            }
+        }
+        ok = nvs->Commit(space) && ok;
+        stats.commits++;
+        if (!ok) {
+            // Flash holds part of the batch at most; start over from what it holds
+            Unload();
+        }
+        return ok;
+    }
+
+    Private Bool WritePack(Size pack, const Pack& records) {
+        StdString blob;
+        for (const auto& record : records) {
+            blob += static_cast<char>(record.first.size());
+            blob += static_cast<char>(record.second.size() & 0xFF);
+            blob += static_cast<char>((record.second.size() >> 8) & 0xFF);
+            blob += record.first;
+            blob += record.second;
+        }
+        stats.packWrites++;
+        stats.bytesWritten += blob.size();
+        return nvs->SetBlob(space, PackKey(pack), blob);
+    }
+
+    // The pack's records, read into the batch the first time it touches the pack
+    Private Pack& Touch(Batch& batch, Size pack) {
+        auto it = batch.packs.find(pack);
+        if (it != batch.packs.end()) {
+            return it->second;
+        }
+        Pack& records = batch.packs[pack];
+        StdString blob;
+        if (packSizes.count(pack) == 0 || !nvs->GetBlob(space, PackKey(pack), blob)) {
+            return records;
+        }
+        Decode(blob, [&](std::string_view key, std::string_view record) {
+            // Records the directory places elsewhere are leftovers of an interrupted move
+            auto owner = packOf.find(StdString(key));
+            if (owner != packOf.end() && owner->second == pack) {
+                records.emplace_back(StdString(key), StdString(record));
+            }
+        });
+        Size size = 0;
+        for (const auto& record : records) {
+            size += EntrySize(record.first, record.second.size());
+        }
+        packSizes[pack] = size;
+        return records;
+    }
+
+    // First pack other than except with need bytes to spare, else the lowest unused number
+    Private Size Room(Size need, Size except) const {
+        for (const auto& pack : packSizes) {
+            if (pack.first != except && pack.second > 0 && pack.second + need <= options.packBytes) {
+                return pack.first;
+            }
+        }
+        Size pack = 0;
+        while (packSizes.count(pack) > 0 && (packSizes.at(pack) > 0 || pack == except)) {
+            pack++;
+        }
+        return pack;
+    }
+
+    // Reads the directory and sizes the packs, dropping lines whose pack lacks the record
+    Private Void Load() {
+        if (loaded) {
+            return;
+        }
+        loaded = true;
+        StdString directory;
+        if (!nvs->GetBlob(space, kDirectoryKey, directory)) {
+            return;
+        }
+        StdVector<std::pair<StdString, Size>> lines;
+        std::string_view rest = directory;
+        while (!rest.empty()) {
+            Size end = rest.find('\n');
+            std::string_view line = rest.substr(0, end);
+            rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+            Size separator = line.find(' ');
+            if (separator == std::string_view::npos || separator == 0) {
+                continue;
+            }
+            Size pack = 0;
+            for (char digit : line.substr(0, separator)) {
+                pack = pack * 10 + static_cast<Size>(digit - '0');
+            }
+            lines.emplace_back(StdString(line.substr(separator + 1)), pack);
+        }
+        StdMap<Size, StdUnorderedMap<StdString, Size>> packs;
+        for (const auto& line : lines) {
+            packs[line.second];
+        }
+        for (auto& pack : packs) {
+            StdString blob;
+            if (!nvs->GetBlob(space, PackKey(pack.first), blob)) {
+                continue;
+            }
+            Decode(blob, [&](std::string_view key, std::string_view record) {
+                pack.second[StdString(key)] = EntrySize(StdString(key), record.size());
+            });
+        }
+        for (const auto& line : lines) {
+            auto& records = packs[line.second];
+            auto record = records.find(line.first);
+            if (record == records.end() || packOf.count(line.first) > 0) {
+                continue;
+            }
+            keys.push_back(line.first);
+            packOf[line.first] = line.second;
+            packSizes[line.second] += record->second;
+        }
+    }
+
+    Private Void Unload() {
+        keys.clear();
+        packOf.clear();
+        packSizes.clear();
+        loaded = false;
+    }
+
+    Private Static Size EntrySize(CStdString& key, Size recordLength) {
+        return 3 + key.size() + recordLength;
+    }
+
+    Private Static Pack::iterator Entry(Pack& pack, CStdString& key) {
+        return std::find_if(pack.begin(), pack.end(), [&](const std::pair<StdString, StdString>& record) {
+            return record.first == key;
+        });
+    }
+
+    // Calls visit(key, record) for each whole record in blob
+    Private template<typename Visit>
+    Static Void Decode(std::string_view blob, Visit visit) {
+        Size offset = 0;
+        while (blob.size() - offset >= 3) {
+            const uint8_t* header = reinterpret_cast<const uint8_t*>(blob.data() + offset);
+            Size keyLength = header[0];
+            Size recordLength = Size(header[1]) | (Size(header[2]) << 8);
+            if (blob.size() - offset - 3 < keyLength + recordLength) {
+                return;
+            }
+            visit(blob.substr(offset + 3, keyLength), blob.substr(offset + 3 + keyLength, recordLength));
+            offset += 3 + keyLength + recordLength;
+        }
+    }
+
+    Private Static Bool Find(std::string_view blob, CStdString& key, std::string_view& found) {
+        Bool present = false;
+        Decode(blob, [&](std::string_view candidate, std::string_view record) {
+            if (!present && candidate == key) {
+                found = record;
+                present = true;
+            }
+        });
+        return present;
+    }
+};
+
+#endif // NVSENTITYSTORE_H
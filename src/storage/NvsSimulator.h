@@ -0,0 +1,309 @@
+#ifndef NVSSIMULATOR_H
+#define NVSSIMULATOR_H
+
+#include <StandardDefines.h>
+#include <algorithm>
+#include <mutex>
+#include "INvsPartition.h"
+
+// Size of the simulated partition; the nvs partition in partitions.csv
+#ifndef NVSSIMULATOR_PARTITION_BYTES
+#define NVSSIMULATOR_PARTITION_BYTES 0x6000
+#endif
+
+DefineStandardPointers(NvsSimulator)
+
+/**
+ * INvsPartition in memory, laid out as ESP-IDF's NVS lays out flash, so the
+ * entries, garbage collection and page erases a store causes on the device
+ * can be counted on the desktop.
+ *
+ * The partition is a row of 4096-byte pages of 126 32-byte entries, written
+ * front to back, one page active at a time. A namespace takes one entry the
+ * first time it is used. A blob is written as ESP-IDF's version 2 format
+ * writes it: data chunks of one header entry plus one entry per 32 bytes,
+ * each within a page, then an index entry. Replacing a blob writes the new
+ * chunks and index before erasing the old ones, so a rewrite needs room for
+ * both. When the active page is full and only the page NVS keeps free for
+ * garbage collection remains, the full page with the most erased entries
+ * has its live entries copied there and is erased; if no page has any,
+ * the write fails as ESP_ERR_NVS_NOT_ENOUGH_SPACE.
+ *
+ * CRCs, entry states and power loss are not modelled. Calls are serialized
+ * with a mutex, as repositories share the partition.
+ */
+class NvsSimulator : public INvsPartition {
+    Public Static constexpr Size kPageBytes = 4096;
+    Public Static constexpr Size kEntryBytes = 32;
+    Public Static constexpr Size kEntriesPerPage = 126;
+
+    Private Static constexpr uint8_t kNamespaceItem = 0xFE;
+    Private Static constexpr uint8_t kIndexItem = 0xFF;
+
+    Private struct Item {
+        StdString space;
+        StdString key;
+        // Chunk number, or kIndexItem / kNamespaceItem
+        uint8_t chunk = 0;
+        StdString data;
+        Size span = 1;
+        Bool erased = false;
+    };
+
+    Private struct Page {
+        StdVector<Item> items;
+        Size nextEntry = 0;
+        Size usedEntries = 0;
+        Size erasedEntries = 0;
+        Size eraseCount = 0;
+
+        Size FreeEntries() const {
+            return kEntriesPerPage - nextEntry;
+        }
+    };
+
+    // Where an item is: page, then position in Page::items
+    Private typedef std::pair<Size, Size> Location;
+
+    Private std::mutex mutex;
+    Private StdVector<Page> pages;
+    // Pages with nothing written, the one kept for garbage collection among them
+    Private StdVector<Size> freePages;
+    Private Size active = 0;
+    Private Bool started = false;
+    // Live items of each blob, "<space>/<key>": chunks in order, then the index
+    Private StdMap<StdString, StdVector<Location>> blobs;
+    Private StdMap<StdString, Bool> spaces;
+    Private Size pageErases = 0;
+    Private Size bytesProgrammed = 0;
+    Private Size bytesRequested = 0;
+
+    Public explicit NvsSimulator(Size partitionBytes = NVSSIMULATOR_PARTITION_BYTES)
+        : pages(std::max<Size>(partitionBytes / kPageBytes, 2)) {
+        for (Size i = 0; i < pages.size(); i++) {
+            freePages.push_back(i);
+        }
+    }
+
+    Public Bool SetBlob(CStdString& space, CStdString& key, CStdString& value) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (space.empty() || key.empty() || space.size() > kMaxKeyLength || key.size() > kMaxKeyLength) {
+            return false;
+        }
+        if (spaces.find(space) == spaces.end()) {
+            Location location;
+            if (!Place(Item{StdString(), space, kNamespaceItem, StdString(), 1, false}, location)) {
+                return false;
+            }
+            spaces[space] = true;
+        }
+        StdVector<Location> written;
+        Size offset = 0;
+        uint8_t chunk = 0;
+        Bool ok = true;
+        while (ok && (offset < value.size() || written.empty())) {
+            // A chunk stays within one page: all the active page holds, less its header
+            ok = Ensure(2);
+            if (!ok) {
+                break;
+            }
+            Size room = (pages[active].FreeEntries() - 1) * kEntryBytes;
+            Size length = std::min(room, value.size() - offset);
+            Item item{space, key, chunk++, value.substr(offset, length), 1 + (length + kEntryBytes - 1) / kEntryBytes, false};
+            Location location;
+            ok = Place(std::move(item), location);
+            if (ok) {
+                written.push_back(location);
+                offset += length;
+            }
+        }
+        Location index;
+        ok = ok && Place(Item{space, key, kIndexItem, StdString(), 1, false}, index);
+        if (!ok) {
+            // As NVS does, drop the chunks of a blob that did not fit
+            for (const Location& location : written) {
+                Erase(location);
+            }
+            return false;
+        }
+        written.push_back(index);
+        StdString name = space + "/" + key;
+        auto previous = blobs.find(name);
+        if (previous != blobs.end()) {
+            for (const Location& location : previous->second) {
+                Erase(location);
+            }
+        }
+        blobs[name] = written;
+        bytesRequested += value.size();
+        return true;
+    }
+
+    Public Bool GetBlob(CStdString& space, CStdString& key, StdString& value) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto blob = blobs.find(space + "/" + key);
+        if (blob == blobs.end()) {
+            return false;
+        }
+        value.clear();
+        for (const Location& location : blob->second) {
+            value += pages[location.first].items[location.second].data;
+        }
+        return true;
+    }
+
+    Public Bool EraseKey(CStdString& space, CStdString& key) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto blob = blobs.find(space + "/" + key);
+        if (blob == blobs.end()) {
+            return false;
+        }
+        for (const Location& location : blob->second) {
+            Erase(location);
+        }
+        blobs.erase(blob);
+        return true;
+    }
+
+    // Writes reach the simulated flash at once
+    Public Bool Commit(CStdString&) override {
+        return true;
+    }
+
+    Public Stats GetStats() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats stats;
+        stats.totalEntries = pages.size() * kEntriesPerPage;
+        for (const Page& page : pages) {
+            stats.usedEntries += page.usedEntries;
+            stats.erasedEntries += page.erasedEntries;
+            stats.maxPageErases = std::max(stats.maxPageErases, page.eraseCount);
+        }
+        stats.freeEntries = stats.totalEntries - stats.usedEntries;
+        stats.availableEntries = stats.freeEntries > kEntriesPerPage ? stats.freeEntries - kEntriesPerPage : 0;
+        stats.pageErases = pageErases;
+        stats.bytesProgrammed = bytesProgrammed;
+        stats.bytesRequested = bytesRequested;
+        return stats;
+    }
+
+    Public StdVector<Size> GetPageEraseCounts() {
+        std::lock_guard<std::mutex> lock(mutex);
+        StdVector<Size> counts;
+        for (const Page& page : pages) {
+            counts.push_back(page.eraseCount);
+        }
+        return counts;
+    }
+
+    Public Size GetPageCount() const {
+        return pages.size();
+    }
+
+    // An erased partition, the erase counts kept
+    Public Void EraseAll() {
+        std::lock_guard<std::mutex> lock(mutex);
+        freePages.clear();
+        for (Size i = 0; i < pages.size(); i++) {
+            if (!pages[i].items.empty()) {
+                pages[i].eraseCount++;
+                pageErases++;
+            }
+            pages[i] = Page{StdVector<Item>(), 0, 0, 0, pages[i].eraseCount};
+            freePages.push_back(i);
+        }
+        blobs.clear();
+        spaces.clear();
+        started = false;
+    }
+
+    // Writes item to the active page, which Ensure() made room on
+    Private Bool Place(Item item, Location& location) {
+        if (!Ensure(item.span)) {
+            return false;
+        }
+        Page& page = pages[active];
+        page.nextEntry += item.span;
+        page.usedEntries += item.span;
+        bytesProgrammed += item.span * kEntryBytes;
+        page.items.push_back(std::move(item));
+        location = Location(active, page.items.size() - 1);
+        return true;
+    }
+
+    Private Void Erase(const Location& location) {
+        Page& page = pages[location.first];
+        Item& item = page.items[location.second];
+        if (item.erased) {
+            return;
+        }
+        item.erased = true;
+        item.data.clear();
+        page.usedEntries -= item.span;
+        page.erasedEntries += item.span;
+    }
+
+    // Makes the active page hold span more entries, moving to a new page and collecting garbage as needed
+    Private Bool Ensure(Size span) {
+        if (started && pages[active].FreeEntries() >= span) {
+            return true;
+        }
+        if (span > kEntriesPerPage) {
+            return false;
+        }
+        // The last free page is only for garbage collection
+        while (freePages.size() <= 1) {
+            if (!Collect()) {
+                return false;
+            }
+            if (pages[active].FreeEntries() >= span) {
+                return true;
+            }
+        }
+        active = freePages.front();
+        freePages.erase(freePages.begin());
+        started = true;
+        return true;
+    }
+
+    // Moves the live entries of the full page with the most erased ones to the free page, then erases it
+    Private Bool Collect() {
+        Size victim = pages.size();
+        for (Size i = 0; i < pages.size(); i++) {
+            Bool full = (!started || i != active) && std::find(freePages.begin(), freePages.end(), i) == freePages.end();
+            if (full && pages[i].erasedEntries > 0 && (victim == pages.size() || pages[i].erasedEntries > pages[victim].erasedEntries)) {
+                victim = i;
+            }
+        }
+        if (victim == pages.size() || freePages.empty()) {
+            return false;
+        }
+        active = freePages.front();
+        freePages.erase(freePages.begin());
+        started = true;
+        Page& target = pages[active];
+        StdVector<Item>& items = pages[victim].items;
+        for (Size i = 0; i < items.size(); i++) {
+            if (items[i].erased) {
+                continue;
+            }
+            if (items[i].chunk != kNamespaceItem) {
+                for (Location& location : blobs[items[i].space + "/" + items[i].key]) {
+                    if (location == Location(victim, i)) {
+                        location = Location(active, target.items.size());
+                    }
+                }
+            }
+            target.nextEntry += items[i].span;
+            target.usedEntries += items[i].span;
+            bytesProgrammed += items[i].span * kEntryBytes;
+            target.items.push_back(std::move(items[i]));
+        }
+        pages[victim] = Page{StdVector<Item>(), 0, 0, 0, pages[victim].eraseCount + 1};
+        pageErases++;
+        freePages.push_back(victim);
+        return true;
+    }
+};
+
+#endif // NVSSIMULATOR_H
@@ -0,0 +1,60 @@
+#ifndef RECORDVIEW_H
+#define RECORDVIEW_H
+
+#include <StandardDefines.h>
+#include <memory>
+#include <string_view>
+
+/**
+ * The bytes of one record or file, as IEntityStore::ReadView() and
+ * IFileViewReader::View() return them: either a string the view owns, or a
+ * range of a mapping it keeps alive, so a reader can parse the bytes in place
+ * whichever it is. Data() is valid while the view is.
+ */
+class RecordView {
+    Private StdString contents;
+    Private std::shared_ptr<const void> owner;
+    Private std::string_view mapped;
+
+    Public RecordView() = default;
+
+    Public explicit RecordView(StdString record) : contents(std::move(record)) {}
+
+    /**
+     * @param mapping Kept alive as long as the view
+     * @param bytes Inside mapping
+     */
+    Public RecordView(std::shared_ptr<const void> mapping, std::string_view bytes)
+        : owner(std::move(mapping)), mapped(bytes) {}
+
+    Public std::string_view Data() const {
+        return owner != nullptr ? mapped : std::string_view(contents);
+    }
+
+    Public Bool Empty() const {
+        return Data().empty();
+    }
+
+    // Whether the bytes are in a mapping rather than a string of the view's own
+    Public Bool IsMapped() const {
+        return owner != nullptr;
+    }
+};
+
+/**
+ * An IFileManager that can also hand out a file's contents in place,
+ * without copying them into a string. EntityFileStore reads records through
+ * it when its file manager is one.
+ */
+DefineStandardPointers(IFileViewReader)
+class IFileViewReader {
+    Public Virtual ~IFileViewReader() = default;
+
+    /**
+     * @brief The contents of a file
+     * @return Empty when the file does not exist or is empty
+     */
+    Public Virtual RecordView View(CStdString& filename) = 0;
+};
+
+#endif // RECORDVIEW_H
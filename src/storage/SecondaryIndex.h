@@ -0,0 +1,329 @@
+#ifndef SECONDARYINDEX_H
+#define SECONDARYINDEX_H
+
+#include <StandardDefines.h>
+#include <IFileManager.h>
+#include <algorithm>
+#include <string_view>
+#include "../serializer/NumberFormat.h"
+
+/**
+ * Persisted secondary index from a member's value to the keys of the
+ * entities holding it, e.g. category -> product ids.
+ *
+ * The index lives in memory as value -> keys plus key -> value, so a change
+ * knows which entry to drop without reading the old record. The file is a
+ * log of changes, one line each, appended as they happen:
+ *
+ *     #index 1
+ *     +Electronics\t1\t2\t3        keys now holding a value
+ *     -2                           key no longer indexed
+ *
+ * and rewritten with one "+" line per value once more lines were appended
+ * than the last rewrite held entries. Rewrites then cost O(1) per change
+ * amortized, and the file stays within about twice the size of the ids it
+ * lists. Tabs,
+ * newlines and backslashes in values and keys are escaped. A line cut short
+ * by a crash has no newline and is ignored on load; the next change then
+ * rewrites the file rather than appending to the fragment.
+ *
+ * Between Defer() and Flush() changes are collected and then appended in
+ * one write, for batches of saves.
+ */
+class SecondaryIndex {
+    // Lines appended beyond the entries of the last rewrite before the next one
+    Private Static constexpr Size kCompactSlack = 32;
+
+    Private IFileManagerPtr files;
+    Private StdString path;
+    Private StdUnorderedMap<StdString, StdVector<StdString>> keysByValue;
+    Private StdUnorderedMap<StdString, StdString> valueByKey;
+    // Lines appended since the file was last rewritten, entries it was rewritten with
+    Private Size appendedLines = 0;
+    Private Size compactedEntries = 0;
+    Private Bool tornTail = false;
+    // Lines held back between Defer() and Flush()
+    Private Bool deferring = false;
+    Private StdString pending;
+    // Values in order for SortedValues(), rebuilt after a value is added or dropped
+    Private StdVector<const StdString*> sorted;
+    Private Bool sortedNumeric = false;
+    Private Bool sortedValid = false;
+
+    Public SecondaryIndex(IFileManagerPtr fileManager, CStdString& indexFile)
+        : files(fileManager), path(indexFile) {}
+
+    /**
+     * @brief Read the index file
+     * @return False when there is no index file yet; the caller rebuilds it
+     */
+    Public Bool Load() {
+        sortedValid = false;
+        keysByValue.clear();
+        valueByKey.clear();
+        appendedLines = 0;
+        StdString contents = files->Read(path);
+        tornTail = !contents.empty() && contents.back() != '\n';
+        if (contents.compare(0, 8, "#index 1") != 0) {
+            return false;
+        }
+        std::string_view rest(contents);
+        Size end = rest.find('\n');
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+        StdString value;
+        StdString key;
+        while ((end = rest.find('\n')) != std::string_view::npos) {
+            std::string_view line = rest.substr(0, end);
+            rest.remove_prefix(end + 1);
+            appendedLines++;
+            if (line.empty()) {
+                continue;
+            }
+            char change = line[0];
+            line.remove_prefix(1);
+            Size tab = line.find('\t');
+            if (change == '-') {
+                Unescape(line, key);
+                Remove(key);
+            } else if (change == '+' && tab != std::string_view::npos) {
+                Unescape(line.substr(0, tab), value);
+                line.remove_prefix(tab + 1);
+                while (true) {
+                    tab = line.find('\t');
+                    Unescape(line.substr(0, tab), key);
+                    Insert(key, value);
+                    if (tab == std::string_view::npos) {
+                        break;
+                    }
+                    line.remove_prefix(tab + 1);
+                }
+            }
+        }
+        compactedEntries = valueByKey.size();
+        return true;
+    }
+
+    /**
+     * @brief Replace the index with entries, e.g. from a scan of every record
+     * @param entries (key, value) pairs
+     */
+    Public Void Rebuild(const StdVector<std::pair<StdString, StdString>>& entries) {
+        sortedValid = false;
+        keysByValue.clear();
+        valueByKey.clear();
+        for (const auto& entry : entries) {
+            Insert(entry.first, entry.second);
+        }
+        Compact();
+    }
+
+    /**
+     * @brief Record the value key now holds
+     * @param value nullptr when key is deleted or its member is empty
+     */
+    Public Void Set(CStdString& key, const StdString* value) {
+        auto current = valueByKey.find(key);
+        if (value == nullptr) {
+            if (current == valueByKey.end()) {
+                return;
+            }
+            Remove(key);
+            Log("-" + Escape(key) + "\n");
+            return;
+        }
+        if (current != valueByKey.end() && current->second == *value) {
+            return;
+        }
+        Remove(key);
+        Insert(key, *value);
+        Log("+" + Escape(*value) + "\t" + Escape(key) + "\n");
+    }
+
+    // Hold the lines of the following changes until Flush()
+    Public Void Defer() {
+        deferring = true;
+    }
+
+    // Write the changes since Defer() in one append, or one rewrite when due
+    Public Void Flush() {
+        deferring = false;
+        if (pending.empty()) {
+            return;
+        }
+        if (tornTail || appendedLines > compactedEntries + kCompactSlack) {
+            Compact();
+            return;
+        }
+        files->Append(path, pending);
+        pending.clear();
+    }
+
+    /**
+     * @brief Keys holding value, in the order they were indexed
+     * @return nullptr when no entity holds value
+     */
+    Public const StdVector<StdString>* Find(CStdString& value) const {
+        auto it = keysByValue.find(value);
+        return it == keysByValue.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Every value in ascending order, for reading entities sorted by the member
+     * @param numeric Compare as numbers rather than as text
+     * @return Valid until the index next changes
+     */
+    Public const StdVector<const StdString*>& SortedValues(Bool numeric) {
+        if (sortedValid && sortedNumeric == numeric) {
+            return sorted;
+        }
+        sorted.clear();
+        sorted.reserve(keysByValue.size());
+        for (const auto& bucket : keysByValue) {
+            sorted.push_back(&bucket.first);
+        }
+        if (numeric) {
+            StdVector<std::pair<double, const StdString*>> numbers;
+            numbers.reserve(sorted.size());
+            for (const StdString* value : sorted) {
+                double number = 0;
+                NumberFormat::ParseDouble(*value, number);
+                numbers.emplace_back(number, value);
+            }
+            std::sort(numbers.begin(), numbers.end(), [](const std::pair<double, const StdString*>& a,
+                                                          const std::pair<double, const StdString*>& b) {
+                return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+            });
+            for (Size i = 0; i < numbers.size(); i++) {
+                sorted[i] = numbers[i].second;
+            }
+        } else {
+            std::sort(sorted.begin(), sorted.end(), [](const StdString* a, const StdString* b) {
+                return *a < *b;
+            });
+        }
+        sortedNumeric = numeric;
+        sortedValid = true;
+        return sorted;
+    }
+
+    Public Bool Contains(CStdString& key) const {
+        return valueByKey.count(key) > 0;
+    }
+
+    // Distinct values, then indexed keys
+    Public Size GetValueCount() const {
+        return keysByValue.size();
+    }
+
+    Public Size GetEntryCount() const {
+        return valueByKey.size();
+    }
+
+    Public CStdString& GetPath() const {
+        return path;
+    }
+
+    Private Void Insert(CStdString& key, CStdString& value) {
+        auto result = valueByKey.emplace(key, value);
+        if (!result.second) {
+            if (result.first->second == value) {
+                return;
+            }
+            Remove(key);
+            valueByKey.emplace(key, value);
+        }
+        auto bucket = keysByValue.find(value);
+        if (bucket == keysByValue.end()) {
+            bucket = keysByValue.emplace(value, StdVector<StdString>()).first;
+            sortedValid = false;
+        }
+        bucket->second.push_back(key);
+    }
+
+    Private Void Remove(CStdString& key) {
+        auto current = valueByKey.find(key);
+        if (current == valueByKey.end()) {
+            return;
+        }
+        auto bucket = keysByValue.find(current->second);
+        if (bucket != keysByValue.end()) {
+            StdVector<StdString>& keys = bucket->second;
+            for (auto it = keys.begin(); it != keys.end(); ++it) {
+                if (*it == key) {
+                    keys.erase(it);
+                    break;
+                }
+            }
+            if (keys.empty()) {
+                keysByValue.erase(bucket);
+                sortedValid = false;
+            }
+        }
+        valueByKey.erase(current);
+    }
+
+    Private Void Log(CStdString& line) {
+        appendedLines++;
+        if (deferring) {
+            pending += line;
+            return;
+        }
+        // After a torn line the change would be appended to it, so rewrite instead
+        if (tornTail || appendedLines > compactedEntries + kCompactSlack) {
+            Compact();
+            return;
+        }
+        files->Append(path, line);
+    }
+
+    Private Void Compact() {
+        StdString contents = "#index 1\n";
+        for (const auto& bucket : keysByValue) {
+            contents += '+';
+            contents += Escape(bucket.first);
+            for (CStdString& key : bucket.second) {
+                contents += '\t';
+                contents += Escape(key);
+            }
+            contents += '\n';
+        }
+        files->Update(path, contents);
+        pending.clear();
+        appendedLines = 0;
+        compactedEntries = valueByKey.size();
+        tornTail = false;
+    }
+
+    Private Static StdString Escape(CStdString& text) {
+        if (text.find_first_of("\t\n\\") == StdString::npos) {
+            return text;
+        }
+        StdString out;
+        for (char c : text) {
+            if (c == '\t') {
+                out += "\\t";
+            } else if (c == '\n') {
+                out += "\\n";
+            } else if (c == '\\') {
+                out += "\\\\";
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    Private Static Void Unescape(std::string_view text, StdString& out) {
+        out.clear();
+        for (Size i = 0; i < text.size(); i++) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                char next = text[++i];
+                out += next == 't' ? '\t' : next == 'n' ? '\n' : next;
+            } else {
+                out += text[i];
+            }
+        }
+    }
+};
+
+#endif // SECONDARYINDEX_H
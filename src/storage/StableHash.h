@@ -0,0 +1,123 @@
+#ifndef STABLEHASH_H
+#define STABLEHASH_H
+
+#include <StandardDefines.h>
+#include <cstring>
+#include <string_view>
+
+/**
+ * XXH64: a 64-bit hash whose value is fixed by its specification, so a name
+ * hashes the same on the ESP32 and the desktop, with any standard library
+ * and in every run, unlike std::hash. Only 64-bit multiplies and rotates,
+ * no 128-bit arithmetic, so it is as fast on the ESP32's 32-bit core as its
+ * compiler's 64-bit multiply allows.
+ *
+ *     uint64_t hash = StableHash::Of("Product_id_42");   // same value everywhere
+ *     StdString file = StableHash::Hex(hash);            // 16 lowercase hex digits
+ */
+class StableHash {
+    Private Static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    Private Static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    Private Static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+    Private Static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+    Private Static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+    Public Static uint64_t Of(std::string_view data, uint64_t seed = 0) {
+        const char* p = data.data();
+        const char* end = p + data.size();
+        uint64_t hash;
+        if (data.size() >= 32) {
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            for (; p + 32 <= end; p += 32) {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+            }
+            hash = Rotate(v1, 1) + Rotate(v2, 7) + Rotate(v3, 12) + Rotate(v4, 18);
+            hash = Merge(hash, v1);
+            hash = Merge(hash, v2);
+            hash = Merge(hash, v3);
+            hash = Merge(hash, v4);
+        } else {
+            hash = seed + kPrime5;
+        }
+        hash += static_cast<uint64_t>(data.size());
+        for (; p + 8 <= end; p += 8) {
+            hash ^= Round(0, Read64(p));
+            hash = Rotate(hash, 27) * kPrime1 + kPrime4;
+        }
+        if (p + 4 <= end) {
+            hash ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+            hash = Rotate(hash, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; p++) {
+            hash ^= static_cast<uint64_t>(static_cast<uint8_t>(*p)) * kPrime5;
+            hash = Rotate(hash, 11) * kPrime1;
+        }
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // 16 lowercase hex digits, most significant first
+    Public Static StdString Hex(uint64_t hash) {
+        static const char kHexDigits[] = "0123456789abcdef";
+        StdString out(16, '0');
+        for (Size i = 16; i-- > 0; hash >>= 4) {
+            out[i] = kHexDigits[hash & 0xF];
+        }
+        return out;
+    }
+
+    Private Static uint64_t Rotate(uint64_t value, Int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    Private Static uint64_t Round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * kPrime2;
+        return Rotate(accumulator, 31) * kPrime1;
+    }
+
+    Private Static uint64_t Merge(uint64_t hash, uint64_t value) {
+        hash ^= Round(0, value);
+        return hash * kPrime1 + kPrime4;
+    }
+
+    // Little-endian whatever the host, so the hash is too; one load on little-endian hosts, the ESP32 included
+    Private Static uint64_t Read64(const char* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+#else
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(p);
+        uint64_t value = 0;
+        for (Int i = 7; i >= 0; i--) {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+#endif
+    }
+
+    Private Static uint32_t Read32(const char* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+#else
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(p);
+        return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+               static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+#endif
+    }
+};
+
+#endif // STABLEHASH_H
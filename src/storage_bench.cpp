@@ -0,0 +1,189 @@
+#ifndef ARDUINO
+#include <StandardDefines.h>
+#include <GeneratedEntityRepositories.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include "bench/AllocationTracking.h"
+#include "bench/BenchUtils.h"
+#include "storage/DirectoryFileManager.h"
+
+// Storage benchmark: ProductRepository Save and FindById with N products
+// stored (default 1000, 10000 and 100000), for each record store:
+//
+//   file store   one file per record plus the id list, through a
+//                DirectoryFileManager, as the framework lays them out
+//   log store    every record in one append-only log (@Storage("log"))
+//
+// Save updates a stored product and FindById reads one, cycling through the
+// ids, so both run against a store of N. The category index goes through a
+// DirectoryFileManager for both. Files are on disk under --dir (default: the
+// system temp directory) and removed afterwards; the first load of each
+// store is timed once and printed below the table.
+//
+// FindAll then reads --findall products (default 50000) from the file store,
+// through a DirectoryFileManager that reads each file into a string, one that
+// maps each file and unmaps it once parsed, and one that keeps every mapping,
+// as a repository read repeatedly would. The files are in the page cache for
+// all three, so the difference is the copy and the system calls.
+
+namespace {
+
+Product BenchProduct(Int id, Int round) {
+    Product product;
+    product.id = id;
+    product.name = "Product " + std::to_string(id);
+    product.price = 0.25 * id + round;
+    product.category = "Category " + std::to_string((id + round) % 20);
+    return product;
+}
+
+StdVector<Int> ParseSizes(CStdString& list) {
+    StdVector<Int> sizes;
+    Size start = 0;
+    while (start <= list.size()) {
+        Size end = list.find(',', start);
+        Int size = std::atoi(list.substr(start, end - start).c_str());
+        if (size > 0) {
+            sizes.push_back(size);
+        }
+        if (end == StdString::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return sizes;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    StdVector<Int> sizes = {1000, 10000, 100000};
+    StdString baseDirectory = std::filesystem::temp_directory_path().string();
+    Int findAllCount = 50000;
+
+    BenchCommandLine commandLine;
+    commandLine.Flag("--sizes", "N,M,...", "Products stored, comma-separated (default 1000,10000,100000)", [&sizes](const char* value) {
+        sizes = ParseSizes(value);
+    });
+    commandLine.Flag("--findall", "Products FindAll reads, 0 to skip (default 50000)", findAllCount, 0);
+    commandLine.Flag("--dir", "Directory for the store files (default: system temp directory)", baseDirectory);
+    if (!commandLine.Parse(argc, argv)) {
+        return 0;
+    }
+
+    Bool verbose = commandLine.Verbose();
+    BenchReport report("storage_bench", commandLine.options);
+    if (verbose) {
+        report.PrintTableHeader();
+    }
+
+    const StdString root = baseDirectory + "/storage_bench_" + std::to_string(::getpid());
+    std::filesystem::create_directories(root);
+    const Size recordBytes = nayan::serializer::SerializationUtility::Serialize(BenchProduct(1, 0)).size();
+
+    StdVector<BenchResult> results;
+    StdString loads;
+    Size failures = 0;
+    for (Int count : sizes) {
+        for (Int backend = 0; backend < 3; backend++) {
+            const Bool log = backend > 0;
+            const Bool sync = backend == 2;
+            const StdString name = StdString(!log ? "file store" : sync ? "log store, fsync each write" : "log store") +
+                                   ", " + std::to_string(count);
+            const StdString directory = root + "/" + std::to_string(count) + "_" + std::to_string(backend);
+            DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory);
+            auto openStore = [&](Bool syncEachWrite) {
+                EntityLogStore::Options logOptions;
+                logOptions.syncEachWrite = syncEachWrite;
+                return log ? IEntityStorePtr(std::make_shared<EntityLogStore>(directory + "/Product.log", logOptions))
+                           : IEntityStorePtr(std::make_shared<EntityFileStore>(files, "Product"));
+            };
+
+            // Loaded unsynced in every case; fsync on each write would make 100k products take minutes
+            std::unique_ptr<ProductEntityRepository> products(new ProductEntityRepository(files, openStore(false)));
+            auto start = std::chrono::steady_clock::now();
+            for (Int id = 1; id <= count; id++) {
+                Product product = BenchProduct(id, 0);
+                products->Save(product);
+            }
+            double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (sync) {
+                products.reset();
+                products.reset(new ProductEntityRepository(files, openStore(true)));
+            } else {
+                char line[160];
+                std::snprintf(line, sizeof(line), "  %-24s load %9.1f ms  (%6.2f us per Save)\n",
+                              name.c_str(), millis, 1000.0 * millis / count);
+                loads += line;
+            }
+
+            results.push_back(report.Measure("Save", name, 1, recordBytes, [&, step = Size(0)]() mutable {
+                Product product = BenchProduct(static_cast<Int>(1 + (step * 7919) % count), static_cast<Int>(1 + step / count));
+                step++;
+                products->Save(product);
+            }));
+            if (sync) {
+                // Reads do not depend on fsync
+                products.reset();
+                std::filesystem::remove_all(directory);
+                continue;
+            }
+            results.push_back(report.Measure("FindById", name, 1, recordBytes, [&, step = Size(0)]() mutable {
+                failures += products->FindById(static_cast<Int>(1 + (step++ * 7919) % count)).has_value() ? 0 : 1;
+            }));
+            products.reset();
+            std::filesystem::remove_all(directory);
+        }
+    }
+
+    if (findAllCount > 0) {
+        const StdString directory = root + "/findall";
+        {
+            ProductEntityRepository products(std::make_shared<DirectoryFileManager>(directory));
+            StdVector<Product> batch;
+            batch.reserve(findAllCount);
+            for (Int id = 1; id <= findAllCount; id++) {
+                batch.push_back(BenchProduct(id, 0));
+            }
+            products.SaveAll(batch);
+        }
+        for (Int mode = 0; mode < 3; mode++) {
+            DirectoryFileManager::Options fileOptions;
+            fileOptions.mapReads = mode > 0;
+            fileOptions.mappedFiles = mode == 2 ? static_cast<Size>(findAllCount) : 0;
+            const StdString name = StdString(mode == 0 ? "read" : mode == 1 ? "mmap" : "mmap, mappings kept") +
+                                   ", " + std::to_string(findAllCount);
+            ProductEntityRepository products(std::make_shared<DirectoryFileManager>(directory, fileOptions));
+            results.push_back(report.Measure("FindAll", name, findAllCount, findAllCount * recordBytes, [&]() {
+                failures += products.FindAll().size() == static_cast<Size>(findAllCount) ? 0 : 1;
+            }));
+        }
+    }
+    std::filesystem::remove_all(root);
+
+    if (verbose) {
+        for (const BenchResult& result : results) {
+            report.PrintTableRow(result);
+        }
+        std::printf("\nFirst load of each store (%zu-byte records):\n%s", recordBytes, loads.c_str());
+    }
+
+    if (!commandLine.WriteJson(report)) {
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " lookups found no product" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif // ARDUINO
@@ -5,8 +5,18 @@
 #include "../controller/UserRepositoryTests.h"
 #include "../repository_tests/RepositoryTests.h"
 #include "../serialization_tests/SerializationUtilityTests.h"
+#include "../serialization_tests/StreamingDeserializerTests.h"
+#include "../serialization_tests/MessagePackCodecTests.h"
+#include "../serialization_tests/NumberFormatTests.h"
 //#include "../controller_tests/WifiCredentialsControllerTests.h"
 #include "EndpointTrieTests.h"
+#include "RadixRouterTests.h"
+#include "StaticRouteTableTests.h"
+#include "PathVariableTests.h"
+#include "RouteMetricsTests.h"
+#include "ErrorResponseTests.h"
+#include "HttpServerTests.h"
+#include "EntityRepositoryTests.h"
 #include "../thread_tests/ThreadPoolTests.h"
 #include "../thread_tests/ThreadPoolMathExampleTests.h"
 
@@ -17,8 +27,18 @@
  * - UserRepositoryTests
  * - RepositoryTests
  * - SerializationUtilityTests
+ * - StreamingDeserializerTests
+ * - MessagePackCodecTests
+ * - NumberFormatTests
  * - WifiCredentialsControllerTests
  * - EndpointTrieTests
+ * - RadixRouterTests
+ * - StaticRouteTableTests
+ * - PathVariableTests
+ * - RouteMetricsTests
+ * - ErrorResponseTests
+ * - HttpServerTests
+ * - EntityRepositoryTests
  * 
  * @param argc Command-line argument count (for UserRepositoryTests)
  * @param argv Command-line arguments (for UserRepositoryTests)
@@ -62,6 +82,26 @@ int RunAllTestSuites(int argc, char* argv[]) {
     }
     std_println("");
 
+    // Run StreamingDeserializerTests
+    std_println("----------------------------------------");
+    std_println("  StreamingDeserializerTests");
+    std_println("----------------------------------------");
+    int streamingResult = RunAllStreamingDeserializerTests();
+    if (streamingResult != 0) {
+        totalFailed += streamingResult;
+    }
+    std_println("");
+
+    // Run MessagePackCodecTests
+    std_println("----------------------------------------");
+    std_println("  MessagePackCodecTests");
+    std_println("----------------------------------------");
+    int messagePackResult = RunAllMessagePackCodecTests();
+    if (messagePackResult != 0) {
+        totalFailed += messagePackResult;
+    }
+    std_println("");
+
     // Run EndpointTrieTests
     std_println("----------------------------------------");
     std_println("  EndpointTrieTests");
@@ -73,6 +113,86 @@ int RunAllTestSuites(int argc, char* argv[]) {
     std_println("");
 #endif // ARDUINO
 
+    // NumberFormatTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  NumberFormatTests");
+    std_println("----------------------------------------");
+    int numberFormatResult = RunAllNumberFormatTests();
+    if (numberFormatResult != 0) {
+        totalFailed += numberFormatResult;
+    }
+    std_println("");
+
+    // RadixRouterTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  RadixRouterTests");
+    std_println("----------------------------------------");
+    int radixRouterResult = RunAllRadixRouterTests();
+    if (radixRouterResult != 0) {
+        totalFailed += radixRouterResult;
+    }
+    std_println("");
+
+    // StaticRouteTableTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  StaticRouteTableTests");
+    std_println("----------------------------------------");
+    int staticRouteTableResult = RunAllStaticRouteTableTests();
+    if (staticRouteTableResult != 0) {
+        totalFailed += staticRouteTableResult;
+    }
+    std_println("");
+
+    // PathVariableTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  PathVariableTests");
+    std_println("----------------------------------------");
+    int pathVariableResult = RunAllPathVariableTests();
+    if (pathVariableResult != 0) {
+        totalFailed += pathVariableResult;
+    }
+    std_println("");
+
+    // RouteMetricsTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  RouteMetricsTests");
+    std_println("----------------------------------------");
+    int routeMetricsResult = RunAllRouteMetricsTests();
+    if (routeMetricsResult != 0) {
+        totalFailed += routeMetricsResult;
+    }
+    std_println("");
+
+    // ErrorResponseTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  ErrorResponseTests");
+    std_println("----------------------------------------");
+    int errorResponseResult = RunAllErrorResponseTests();
+    if (errorResponseResult != 0) {
+        totalFailed += errorResponseResult;
+    }
+    std_println("");
+
+    // HttpServerTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  HttpServerTests");
+    std_println("----------------------------------------");
+    int httpServerResult = RunAllHttpServerTests();
+    if (httpServerResult != 0) {
+        totalFailed += httpServerResult;
+    }
+    std_println("");
+
+    // EntityRepositoryTests (desktop and Arduino)
+    std_println("----------------------------------------");
+    std_println("  EntityRepositoryTests");
+    std_println("----------------------------------------");
+    int entityRepositoryResult = RunAllEntityRepositoryTests();
+    if (entityRepositoryResult != 0) {
+        totalFailed += entityRepositoryResult;
+    }
+    std_println("");
+
     // ThreadPoolTests (desktop and Arduino)
     std_println("----------------------------------------");
     std_println("  ThreadPoolTests");
@@ -0,0 +1,1296 @@
+#ifndef ENTITY_REPOSITORY_TESTS_H
+#define ENTITY_REPOSITORY_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+    #include <filesystem>
+    #include <unistd.h>
+#endif
+
+#include <StandardDefines.h>
+#include <GeneratedEntityRepositories.h>
+#include <chrono>
+#include "../server/HttpPagination.h"
+#include "../storage/AppRepositories.h"
+#include "../storage/HashedFileManager.h"
+#include "../storage/MemoryFileManager.h"
+#include "../storage/NvsEntityStore.h"
+#include "../storage/NvsSimulator.h"
+#include "TestUtils.h"
+#ifndef ARDUINO
+    #include <atomic>
+    #include <stdexcept>
+    #include <thread>
+    #include "../storage/DirectoryFileManager.h"
+    #include "../storage/EntityJournal.h"
+#endif
+
+// Test counters
+static int testsPassed_entity_repository = 0;
+static int testsFailed_entity_repository = 0;
+
+inline Product EntityTestProduct(Int id, CStdString& name, CStdString& category) {
+    Product product;
+    product.id = id;
+    product.name = name;
+    product.price = 10.0 * id;
+    product.category = category;
+    return product;
+}
+
+// ========== CRUD ==========
+
+bool TestEntityRepositoryCrud() {
+    TEST_START("Test Entity Repository CRUD");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    ProductEntityRepository products(files);
+    Product laptop = EntityTestProduct(1, "Laptop", "Electronics");
+    Product saved = products.Save(laptop);
+    ASSERT(saved.id.has_value() && saved.id.value() == 1, "Save should return the entity");
+    ASSERT(files->Exists("Product_id_1") && files->Peek("Product_IDs") == "1\n",
+           "Save should write Product_id_1 and list it in Product_IDs");
+
+    optional<Product> found = products.FindById(1);
+    ASSERT(found.has_value() && found.value().name == StdString("Laptop") && found.value().price == 10.0,
+           "FindById should read the saved entity back");
+    ASSERT(products.ExistsById(1) && !products.ExistsById(2), "ExistsById should know saved ids only");
+    ASSERT(!products.FindById(2).has_value(), "FindById should be empty for an unknown id");
+
+    laptop.name = StdString("Gaming Laptop");
+    products.Update(laptop);
+    ASSERT(products.FindById(1).value().name == StdString("Gaming Laptop"), "Update should replace the record");
+    ASSERT(files->Peek("Product_IDs") == "1\n", "Update should not list the id again");
+
+    Product phone = EntityTestProduct(2, "Phone", "Electronics");
+    products.Save(phone);
+    ASSERT(products.FindAll().size() == 2, "FindAll should return both entities");
+
+    products.DeleteById(1);
+    ASSERT(!products.ExistsById(1) && !files->Exists("Product_id_1"), "DeleteById should remove the record");
+    ASSERT(files->Peek("Product_IDs") == "2\n", "DeleteById should rewrite the id list");
+    products.Delete(phone);
+    ASSERT(products.FindAll().empty(), "Delete should remove the entity");
+
+    Product anonymous;
+    anonymous.name = StdString("No id");
+    products.Save(anonymous);
+    ASSERT(files->Peek("Product_IDs").empty(), "An entity without an id should not be saved");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== DERIVED QUERIES ==========
+
+bool TestEntityRepositoryIndexedQueries() {
+    TEST_START("Test Entity Repository Indexed Queries");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    ProductEntityRepository products(files);
+    const char* categories[] = {"Electronics", "Books", "Garden", "Toys"};
+    for (Int id = 1; id <= 40; id++) {
+        Product product = EntityTestProduct(id, "Product " + std::to_string(id), categories[id % 4]);
+        products.Save(product);
+    }
+
+    files->ResetCounters();
+    StdVector<Product> books = products.FindByCategory("Books");
+    ASSERT(books.size() == 10, "FindByCategory should find every product in the category");
+    Bool allBooks = true;
+    for (const Product& product : books) {
+        allBooks = allBooks && product.category == StdString("Books") && product.id.value() % 4 == 1;
+    }
+    ASSERT(allBooks, "FindByCategory should return only that category");
+    ASSERT(files->GetCounters().reads == 10, "FindByCategory should read only the matching records");
+    ASSERT(products.FindByCategory("Music").empty(), "An unknown category should find nothing");
+
+    Product moved = products.FindById(5).value();
+    moved.category = StdString("Garden");
+    products.Update(moved);
+    ASSERT(products.FindByCategory("Books").size() == 9 && products.FindByCategory("Garden").size() == 11,
+           "Update should move the entity to its new category");
+    products.DeleteById(9);
+    ASSERT(products.FindByCategory("Books").size() == 8, "DeleteById should drop the entity from the index");
+
+    optional<Product> byName = products.FindByName("Product 12");
+    ASSERT(byName.has_value() && byName.value().id.value() == 12, "FindByName should scan the records");
+
+    OrderEntityRepository orders(files, std::make_shared<EntityFileStore>(files, "Order"));
+    for (Int id = 1; id <= 6; id++) {
+        Order order;
+        order.id = id;
+        order.orderNumber = "ORD-" + std::to_string(id);
+        order.customerId = id % 2 == 0 ? 7 : 8;
+        orders.Save(order);
+    }
+    ASSERT(orders.FindByCustomerId(7).size() == 3 && orders.FindByCustomerId(9).empty(),
+           "FindByCustomerId should go through the integer index");
+
+    CustomerEntityRepository customers(files);
+    Customer customer;
+    customer.id = 1;
+    customer.email = StdString("tab\tand\\slash@example.com");
+    customer.lastName = StdString("Doe");
+    customers.Save(customer);
+    Customer unindexed;
+    unindexed.id = 2;
+    unindexed.lastName = StdString("Doe");
+    customers.Save(unindexed);
+    ASSERT(customers.FindByEmail("tab\tand\\slash@example.com").has_value(), "Escaped values should be found");
+    ASSERT(customers.FindByLastName("Doe").size() == 2, "FindByLastName should find both customers");
+    ASSERT(!customers.FindByPhone("555").has_value(), "Empty members should not be indexed");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== INDEX FILES ==========
+
+bool TestEntityRepositoryIndexFiles() {
+    TEST_START("Test Entity Repository Index Files");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    {
+        ProductEntityRepository products(files);
+        for (Int id = 1; id <= 100; id++) {
+            Product product = EntityTestProduct(id, "Product", id % 2 == 0 ? "Even" : "Odd");
+            products.Save(product);
+        }
+        // Flip every category back and forth so the change log outgrows the entries
+        for (Int round = 0; round < 2; round++) {
+            for (Int id = 1; id <= 100; id++) {
+                Product product = EntityTestProduct(id, "Product", (id + round) % 2 == 0 ? "Odd" : "Even");
+                products.Update(product);
+            }
+        }
+    }
+    StdString index = files->Peek("Product_idx_category");
+    ASSERT(index.compare(0, 9, "#index 1\n") == 0, "The index file should start with its header");
+    Size lines = 0;
+    for (char c : index) {
+        lines += c == '\n' ? 1 : 0;
+    }
+    ASSERT(lines <= 2 * 100 + 32 + 1, "The index file should be compacted as changes accumulate");
+
+    // A new instance loads the index instead of reading the records
+    ProductEntityRepository reopened(files);
+    files->ResetCounters();
+    StdVector<Product> odd = reopened.FindByCategory("Odd");
+    ASSERT(odd.size() == 50 && odd.front().id.value() % 2 == 1, "The reopened index should hold the last categories");
+    ASSERT(files->GetCounters().reads == 2 + 50, "Reopening should read the id list, the index and the matches");
+
+    // A torn last line is ignored, a missing index is rebuilt from the records
+    files->Append("Product_idx_category", "+Even\t4");
+    ProductEntityRepository torn(files);
+    ASSERT(torn.FindByCategory("Odd").size() == 50, "A line without a newline should be ignored");
+    Product moved = EntityTestProduct(3, "Product", "Even");
+    torn.Update(moved);
+    ASSERT(ProductEntityRepository(files).FindByCategory("Even").size() == 51, "Changes after a torn line should load");
+    moved.category = StdString("Odd");
+    torn.Update(moved);
+    files->Delete("Product_idx_category");
+    ProductEntityRepository rebuilt(files);
+    ASSERT(rebuilt.FindByCategory("Even").size() == 50, "A missing index should be rebuilt");
+    ASSERT(files->Exists("Product_idx_category"), "The rebuilt index should be written");
+
+    // An index entry whose record changed behind it is not returned
+    files->Update("Product_id_1", nayan::serializer::SerializationUtility::Serialize(EntityTestProduct(1, "Product", "Moved")));
+    ProductEntityRepository stale(files);
+    ASSERT(stale.FindByCategory("Odd").size() == 49, "Records are checked against the value they were found by");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== CACHE ==========
+
+bool TestEntityRepositoryCache() {
+    TEST_START("Test Entity Repository Cache");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    ProductEntityRepository products(files);
+    ASSERT(products.GetCacheOptions().mode == EntityCacheOptions::Mode::Off, "Repositories without @Cache should not cache");
+    products.ConfigureCache(EntityCacheOptions::Lru(4));
+    for (Int id = 1; id <= 6; id++) {
+        Product product = EntityTestProduct(id, "Product " + std::to_string(id), "Books");
+        products.Save(product);
+    }
+
+    // Saves write through: the last four are cached, the first two evicted
+    files->ResetCounters();
+    ASSERT(products.FindById(6).has_value() && products.FindById(3).has_value(), "Cached entities should be found");
+    ASSERT(files->GetCounters().reads == 0, "Hits should not read the store");
+    ASSERT(products.FindById(1).value().name.value() == "Product 1" && files->GetCounters().reads == 1,
+           "A miss should read through");
+    EntityCache<Product>::Counters counters = products.GetCacheCounters();
+    ASSERT(counters.hits == 2 && counters.misses == 1 && counters.evictions == 3,
+           "Counters should record hits, misses and evictions");
+    ASSERT(products.ExistsById(2) && !products.ExistsById(7) && files->GetCounters().reads == 1,
+           "ExistsById should be answered from the id set");
+
+    Product changed = EntityTestProduct(6, "Renamed", "Garden");
+    products.Update(changed);
+    ASSERT(products.FindById(6).value().name.value() == "Renamed", "Updates should replace the cached entity");
+    products.DeleteById(6);
+    ASSERT(!products.FindById(6).has_value(), "Deletes should drop the cached entity");
+
+    // Size-bounded, with room for three and a half records
+    Size record = nayan::serializer::SerializationUtility::Serialize(EntityTestProduct(1, "Product 1", "Books")).size();
+    products.ConfigureCache(EntityCacheOptions::SizeBounded(3 * record + record / 2));
+    for (Int id = 1; id <= 5; id++) {
+        products.FindById(id);
+    }
+    products.ResetCacheCounters();
+    files->ResetCounters();
+    products.FindById(5);
+    products.FindById(3);
+    products.FindById(1);
+    ASSERT(products.GetCacheCounters().hits == 2 && files->GetCounters().reads == 1,
+           "A size-bounded cache should keep what fits, most recent first");
+
+    // The generated Switch repository is @Cache("pinned"): nothing is evicted
+    SwitchEntityRepository switches(files);
+    ASSERT(switches.GetCacheOptions().mode == EntityCacheOptions::Mode::Pinned, "@Cache should configure the cache");
+    for (Int id = 0; id < 200; id++) {
+        Switch device(id, SwitchState::On);
+        switches.Save(device);
+    }
+    files->ResetCounters();
+    for (Int id = 0; id < 200; id++) {
+        switches.FindById(id);
+    }
+    ASSERT(files->GetCounters().reads == 0 && switches.GetCacheCounters().evictions == 0,
+           "A pinned cache should keep every entity");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== PAGING ==========
+
+// Ids of the entities of a page, e.g. "3,6,9"
+template<typename T>
+StdString EntityTestIds(const StdVector<T>& entities) {
+    StdString ids;
+    for (const T& entity : entities) {
+        ids += ids.empty() ? "" : ",";
+        ids += std::to_string(entity.id.value());
+    }
+    return ids;
+}
+
+bool TestEntityRepositoryPaging() {
+    TEST_START("Test Entity Repository Paging");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    ProductEntityRepository products(files);
+    // Categories C0, C1, C2 for ids 1 to 22; 23 to 25 have none
+    for (Int id = 1; id <= 25; id++) {
+        Product product = EntityTestProduct(id, "Product " + std::to_string(id), "C" + std::to_string(id % 3));
+        if (id > 22) {
+            product.category.reset();
+        }
+        products.Save(product);
+    }
+
+    EntityPage<Product> first = products.FindAll(0, 10);
+    EntityPage<Product> last = products.FindAll(2, 10);
+    ASSERT(EntityTestIds(first.content) == "1,2,3,4,5,6,7,8,9,10" && first.HasNext(), "The first page should hold the first ids");
+    ASSERT(EntityTestIds(last.content) == "21,22,23,24,25" && !last.HasNext() && last.TotalPages() == 3 &&
+           last.totalElements == 25, "The last page should hold the rest");
+    ASSERT(products.FindAll(3, 10).content.empty() && products.FindAll(0, 0).content.empty(), "Pages past the end should be empty");
+
+    // Sorted through the category index, entities without one last
+    files->ResetCounters();
+    EntityPage<Product> sorted = products.FindAll(0, 10, "category");
+    ASSERT(EntityTestIds(sorted.content) == "3,6,9,12,15,18,21,1,4,7", "Ascending should start with C0 in save order");
+    ASSERT(files->GetCounters().reads == 10, "A sorted page should read only its own records");
+    ASSERT(EntityTestIds(products.FindAll(2, 10, "category").content) == "17,20,23,24,25",
+           "Entities without a value should come last");
+    ASSERT(EntityTestIds(products.FindAll(0, 9, "category", false).content) == "2,5,8,11,14,17,20,1,4",
+           "Descending should start with C2");
+    ASSERT(EntityTestIds(products.FindAll(0, 3, "name").content) == "1,2,3", "Members without an index should keep save order");
+
+    // Numeric members sort as numbers
+    OrderEntityRepository orders(files, std::make_shared<EntityFileStore>(files, "Order"));
+    const Int customers[] = {10, 2, 9};
+    for (Int id = 1; id <= 3; id++) {
+        Order order;
+        order.id = id;
+        order.customerId = customers[id - 1];
+        orders.Save(order);
+    }
+    ASSERT(EntityTestIds(orders.FindAll(0, 3, "customerId").content) == "2,3,1", "2 < 9 < 10, not \"10\" < \"2\"");
+
+    // A cursor reads one record per entity
+    files->ResetCounters();
+    ProductEntityRepository::Cursor cursor = products.OpenCursor();
+    optional<Product> firstProduct = cursor.Next();
+    ASSERT(firstProduct.has_value() && firstProduct.value().id.value() == 1 && files->GetCounters().reads == 1,
+           "Next should deserialize one entity");
+    Int idSum = 0;
+    Size visited = products.ForEach([&](const Product& product) {
+        idSum += product.id.value();
+    });
+    ASSERT(visited == 25 && idSum == 25 * 26 / 2, "ForEach should visit every entity once");
+
+    // Streamed as a JSON array in chunks
+    StdVector<StdString> chunks;
+    JsonArrayStream stream([&](std::string_view chunk) {
+        chunks.emplace_back(chunk);
+    }, 256);
+    ProductEntityRepository::Cursor streaming = products.OpenCursor();
+    ASSERT(stream.AddAll(streaming) == 25, "AddAll should add every entity");
+    stream.Finish();
+    StdString joined;
+    StdString expected = "[";
+    Size largest = 0;
+    for (CStdString& chunk : chunks) {
+        joined += chunk;
+        largest = std::max(largest, chunk.size());
+    }
+    for (const Product& product : products.FindAll()) {
+        expected += expected.size() > 1 ? "," : "";
+        expected += nayan::serializer::SerializationUtility::Serialize(product);
+    }
+    expected += "]";
+    ASSERT(joined == expected, "The chunks should join into the whole array");
+    ASSERT(chunks.size() > 5 && largest < 256 + 100, "Chunks should stay near the chunk size");
+
+    StdString json;
+    AppendPageJson(products.FindAll(1, 2), json);
+    ASSERT(json.compare(0, 12, "{\"content\":[") == 0 &&
+           json.find(",\"page\":1,\"size\":2,\"totalElements\":25,\"totalPages\":13}") != StdString::npos,
+           "Pages should serialize with their totals");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== HASHED FILE NAMES ==========
+
+// Keys the scale test stores through a HashedFileManager in the suite; hashed_scale_tests stores a million
+#ifndef HASHED_SCALE_TEST_KEYS
+#define HASHED_SCALE_TEST_KEYS 2000
+#endif
+
+bool TestHashedFileManager() {
+    TEST_START("Test Hashed File Manager");
+
+    ASSERT(StableHash::Hex(StableHash::Of("")) == "ef46db3751d8e999" && StableHash::Hex(StableHash::Of("abc")) == "44bc2cf5ad770999" &&
+           StableHash::Hex(StableHash::Of(StdString(100, 'a'))) == "375041e8b1decfb3", "StableHash should be XXH64");
+
+    // Every name of the same length collides
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    HashedFileManager::HashFn byLength = [](std::string_view name) {
+        return static_cast<uint64_t>(name.size());
+    };
+    {
+        HashedFileManager hashed(files, byLength);
+        hashed.Create("a1", "first");
+        hashed.Create("a2", "second");
+        hashed.Create("a3", "third");
+        hashed.Update("a1", "first, updated");
+        ASSERT(hashed.Read("a1") == "first, updated" && hashed.Read("a2") == "second" && hashed.Read("a3") == "third",
+               "Colliding names should keep files of their own");
+        ASSERT(hashed.GetStats().collisions == 2 && files->GetFileCount() == 4, "Two names should have taken a suffix");
+        ASSERT(hashed.Read("a4").empty() && !hashed.Exists("a4"), "A name never stored should read nothing, whatever its hash");
+        hashed.Delete("a2");
+    }
+    HashedFileManager reopened(files, byLength);
+    ASSERT(reopened.Read("a1") == "first, updated" && reopened.Read("a2").empty() && reopened.Read("a3") == "third",
+           "The key directory should survive a restart");
+    reopened.Create("a4", "fourth");
+    ASSERT(reopened.Read("a3") == "third" && reopened.Read("a4") == "fourth", "A new name should not take a file in use");
+
+    // Deleting and saving a name again takes the freed file, not a new suffix
+    reopened.Delete("a1");
+    reopened.Create("a1", "first, again");
+    StdString file;
+    ASSERT(reopened.Find("a1", file) && file == StableHash::Hex(2) && reopened.Read("a1") == "first, again",
+           "A recreated name should take the lowest free file");
+    ASSERT(reopened.GetStats().collisions == 2 && reopened.Read("a3") == "third" && reopened.Read("a4") == "fourth",
+           "Freed files should not count as collisions");
+    HashedFileManager plain(std::make_shared<MemoryFileManager>());
+    for (Int round = 0; round < 3; round++) {
+        plain.Create("Product_id_1", std::to_string(round));
+        plain.Delete("Product_id_1");
+    }
+    plain.Create("Product_id_1", "last");
+    ASSERT(plain.Find("Product_id_1", file) && file == StableHash::Hex(StableHash::Of("Product_id_1")) &&
+           plain.GetStats().collisions == 0, "Delete then recreate should not collide with itself");
+
+    // A snapshot cut short falls back to the previous one
+    MemoryFileManagerPtr snapshotFiles = std::make_shared<MemoryFileManager>();
+    HashedFileManager writer(snapshotFiles);
+    Size rewrites = writer.GetStats().directoryRewrites;
+    Int count = 0;
+    while (writer.GetStats().directoryRewrites < rewrites + 2) {
+        count++;
+        writer.Create("File_" + std::to_string(count), std::to_string(count));
+    }
+    StdString snapshot = snapshotFiles->Peek("_key_directory.0");
+    snapshotFiles->Update("_key_directory.0", snapshot.substr(0, snapshot.size() / 2));
+    HashedFileManager recovered(snapshotFiles);
+    Bool whole = true;
+    for (Int i = 1; i < count; i++) {
+        whole = whole && recovered.Read("File_" + std::to_string(i)) == std::to_string(i);
+    }
+    ASSERT(whole && recovered.GetStats().names == static_cast<Size>(count - 1),
+           "Every name before the torn snapshot should be found in the older one");
+
+    // A reopened directory rewrites after as many changes as one kept open
+    MemoryFileManagerPtr churnFiles = std::make_shared<MemoryFileManager>();
+    HashedFileManager kept(churnFiles);
+    for (Int i = 0; i < 100; i++) {
+        kept.Create("Churn_" + std::to_string(i), "x");
+    }
+    for (Int i = 0; i < 50; i++) {
+        kept.Delete("Churn_" + std::to_string(i));
+    }
+    HashedFileManager restarted(std::make_shared<MemoryFileManager>(*churnFiles));
+    Size keptRewrites = kept.GetStats().directoryRewrites;
+    for (Int i = 0; i < 20; i++) {
+        kept.Create("Extra", "x");
+        kept.Delete("Extra");
+        restarted.Create("Extra", "x");
+        restarted.Delete("Extra");
+    }
+    ASSERT(restarted.GetStats().directoryRewrites == kept.GetStats().directoryRewrites - keptRewrites,
+           "Snapshot lines read at startup should not count as changes since the snapshot");
+
+    // A store named the framework's way moves over in one pass
+    MemoryFileManagerPtr legacy = std::make_shared<MemoryFileManager>();
+    legacy->Create(HashedFileManager::LegacyFileName("User_IDs"), "1\n2\n3\n");
+    legacy->Create(HashedFileManager::LegacyFileName("User_id_1"), "{\"id\":1}");
+    legacy->Create(HashedFileManager::LegacyFileName("User_id_3"), "{\"id\":3}");
+    StdVector<StdString> names = HashedFileManager::LegacyEntityFiles(*legacy, "User");
+    ASSERT(names.size() == 4 && names[1] == "User_id_1", "The id list should name every file");
+    MemoryFileManagerPtr target = std::make_shared<MemoryFileManager>();
+    HashedFileManager migrated(target);
+    HashedFileManager::MigrationResult result = migrated.MigrateLegacy(*legacy, names);
+    ASSERT(result.migrated == 3 && result.missing == 1 && result.collided == 0, "Every legacy file should be migrated");
+    ASSERT(migrated.Read("User_IDs") == "1\n2\n3\n" && migrated.Read("User_id_3") == "{\"id\":3}" && legacy->GetFileCount() == 0,
+           "Migrated files should read back and leave the legacy store");
+    ASSERT(target->GetCounters().appends + target->GetCounters().updates == 1, "The key directory should be written once");
+
+    // The app's repositories take the framework's files over under their own names
+    MemoryFileManagerPtr appFiles = std::make_shared<MemoryFileManager>();
+    Switch saved(2, SwitchState::On);
+    appFiles->Create(HashedFileManager::LegacyFileName("Switch_IDs"), "2\n");
+    appFiles->Create(HashedFileManager::LegacyFileName("Switch_id_2"), nayan::serializer::SerializationUtility::Serialize(saved));
+    AppRepositories::MoveLegacyFiles(*appFiles, "Switch");
+    SwitchEntityRepository switches(appFiles);
+    optional<Switch> moved = switches.FindById(2);
+    ASSERT(moved.has_value() && moved.value().GetVirtualState() == optional<SwitchState>(SwitchState::On) &&
+           appFiles->GetFileCount() == 2, "Legacy switch files should move to the names EntityFileStore reads");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+bool TestHashedFileManagerScale(Size keys = HASHED_SCALE_TEST_KEYS) {
+    TEST_START("Test Hashed File Manager Scale");
+
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    StdUnorderedSet<uint32_t> legacyFiles;
+    {
+        HashedFileManager hashed(files);
+        for (Size i = 0; i < keys; i++) {
+            StdString name = "Product_id_" + std::to_string(i);
+            hashed.Create(name, std::to_string(i));
+            legacyFiles.insert(static_cast<uint32_t>(std::hash<StdString>()(name)));
+        }
+        ASSERT(hashed.GetStats().names == keys, "Every key should be in the directory");
+    }
+
+    HashedFileManager reopened(files);
+    Size lost = 0;
+    for (Size i = 0; i < keys; i++) {
+        lost += reopened.Read("Product_id_" + std::to_string(i)) == std::to_string(i) ? 0 : 1;
+    }
+    ASSERT(lost == 0, "No key should be lost or read another's file");
+    ASSERT(files->GetFileCount() == keys + 2, "One file per key plus the two directory files");
+    std_print("  ");
+    std_print(keys);
+    std_print(" keys: 32-bit std::hash names would have lost ");
+    std_print(keys - legacyFiles.size());
+    std_print(", 64-bit hash collisions ");
+    std_println(reopened.GetStats().collisions);
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== BATCHES ==========
+
+// Milliseconds fn takes
+template<typename Fn>
+double EntityTestMillis(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool TestEntityRepositoryBatches() {
+    TEST_START("Test Entity Repository Batches");
+
+#ifdef ARDUINO
+    const Int count = 200;
+#else
+    const Int count = 5000;
+#endif
+    StdVector<UserAccount> accounts;
+    StdVector<StdString> removing;
+    for (Int i = 0; i < count; i++) {
+        UserAccount account;
+        account.username = "user" + std::to_string(i);
+        account.password = StdString("secret");
+        account.name = "User " + std::to_string(i);
+        accounts.push_back(account);
+        if (i % 10 == 0) {
+            removing.push_back(account.username.value());
+        }
+    }
+
+    MemoryFileManagerPtr singleFiles = std::make_shared<MemoryFileManager>();
+    MemoryFileManagerPtr batchFiles = std::make_shared<MemoryFileManager>();
+    UserAccountEntityRepository single(singleFiles);
+    UserAccountEntityRepository batch(batchFiles);
+    double singleSave = EntityTestMillis([&]() {
+        for (UserAccount& account : accounts) {
+            single.Save(account);
+        }
+    });
+    double batchSave = EntityTestMillis([&]() {
+        batch.SaveAll(accounts);
+    });
+    MemoryFileManager::Counters singleSaved = singleFiles->GetCounters();
+    MemoryFileManager::Counters batchSaved = batchFiles->GetCounters();
+    ASSERT(batch.FindAll().size() == static_cast<Size>(count), "SaveAll should save every entity");
+    ASSERT(batchSaved.creates == static_cast<Size>(count) && batchSaved.appends == 1 && singleSaved.appends == static_cast<Size>(count),
+           "SaveAll should write the id list once");
+    ASSERT(batchSaved.bytesWritten == singleSaved.bytesWritten, "SaveAll should write the same bytes as single saves");
+    ASSERT(batchFiles->Peek("UserAccount_IDs") == singleFiles->Peek("UserAccount_IDs"), "Both should list the ids in order");
+
+    StdVector<UserAccount> found = batch.FindAllById({"user3", "missing", "user1"});
+    ASSERT(found.size() == 2 && found[0].username.value() == "user3" && found[1].username.value() == "user1",
+           "FindAllById should return the entities found, in the order asked");
+
+    // Each DeleteById rewrites the id list; DeleteAllById rewrites it once
+    singleFiles->ResetCounters();
+    batchFiles->ResetCounters();
+    double singleDelete = EntityTestMillis([&]() {
+        for (CStdString& username : removing) {
+            single.DeleteById(username);
+        }
+    });
+    double batchDelete = EntityTestMillis([&]() {
+        batch.DeleteAllById(removing);
+    });
+    Size singleBytes = singleFiles->GetCounters().bytesWritten;
+    Size batchBytes = batchFiles->GetCounters().bytesWritten;
+    ASSERT(batchFiles->GetCounters().updates == 1 && batchFiles->GetCounters().deletes == removing.size(),
+           "DeleteAllById should delete the records and rewrite the id list once");
+    ASSERT(batchBytes * 10 < singleBytes, "DeleteAllById should write a fraction of the bytes of single deletes");
+    ASSERT(!batch.ExistsById("user10") && batch.ExistsById("user11") && batch.FindAll().size() == count - removing.size(),
+           "DeleteAllById should remove exactly the ids given");
+    ASSERT(batchFiles->Peek("UserAccount_IDs") == singleFiles->Peek("UserAccount_IDs"), "Both should keep the same ids");
+
+    std_print("  Save, ");
+    std_print(count);
+    std_print(" entities: single ");
+    std_print(singleSave);
+    std_print(" ms, SaveAll ");
+    std_print(batchSave);
+    std_print(" ms, ");
+    std_print(batchSaved.bytesWritten);
+    std_println(" bytes written by each");
+    std_print("  Delete, ");
+    std_print(removing.size());
+    std_print(" entities: single ");
+    std_print(singleDelete);
+    std_print(" ms and ");
+    std_print(singleBytes);
+    std_print(" bytes, DeleteAllById ");
+    std_print(batchDelete);
+    std_print(" ms and ");
+    std_print(batchBytes);
+    std_println(" bytes");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== NVS ==========
+
+bool TestNvsSimulator() {
+    TEST_START("Test NVS Simulator");
+
+    NvsSimulator nvs;
+    ASSERT(nvs.GetPageCount() == 6 && nvs.GetStats().totalEntries == 6 * 126, "The nvs partition should hold six pages");
+    StdString value(60, 'v');
+    ASSERT(nvs.SetBlob("Switch", "p0", value), "A blob should be written");
+    INvsPartition::Stats stats = nvs.GetStats();
+    // Namespace entry, then a chunk header, two data entries and the index
+    ASSERT(stats.usedEntries == 5 && stats.bytesProgrammed == 5 * 32 && stats.bytesRequested == 60,
+           "A blob should take a header, an entry per 32 bytes and an index");
+    ASSERT(nvs.SetBlob("Switch", "a_key_of_15_chr", value) && !nvs.SetBlob("Switch", "a_key_of_16_chrs", value),
+           "Keys should be at most 15 characters");
+
+    // Rewrites fill the pages with erased entries until garbage collection erases one
+    StdString read;
+    for (Int i = 0; i < 400; i++) {
+        ASSERT(nvs.SetBlob("Switch", "p0", value + std::to_string(i)), "Rewrites should reclaim erased entries");
+    }
+    stats = nvs.GetStats();
+    ASSERT(stats.pageErases > 0 && stats.usedEntries == 5 + 4 && stats.freeEntries == stats.totalEntries - 9,
+           "Garbage collection should erase pages and keep only live entries");
+    ASSERT(nvs.GetBlob("Switch", "p0", read) && read == value + "399" && nvs.GetBlob("Switch", "a_key_of_15_chr", read),
+           "Live values should survive garbage collection");
+
+    // A blob larger than a page is written in chunks
+    StdString large(5000, 'x');
+    for (Size i = 0; i < large.size(); i++) {
+        large[i] = static_cast<char>('a' + i % 26);
+    }
+    ASSERT(nvs.SetBlob("Other", "large", large) && nvs.GetBlob("Other", "large", read) && read == large,
+           "A blob should span pages");
+    ASSERT(nvs.EraseKey("Other", "large") && !nvs.GetBlob("Other", "large", read) && !nvs.EraseKey("Other", "large"),
+           "An erased blob should be gone");
+
+    // Values that cannot be reclaimed fill the partition
+    Size written = 0;
+    while (nvs.SetBlob("Fill", "k" + std::to_string(written), StdString(200, 'f'))) {
+        written++;
+    }
+    stats = nvs.GetStats();
+    ASSERT(written > 50 && stats.availableEntries < 9, "A full partition should refuse writes");
+    ASSERT(nvs.GetBlob("Switch", "p0", read) && read == value + "399", "A refused write should lose nothing");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+bool TestNvsEntityStore() {
+    TEST_START("Test NVS Entity Store");
+
+    NvsSimulatorPtr nvs = std::make_shared<NvsSimulator>();
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    NvsEntityStorePtr store = std::make_shared<NvsEntityStore>(nvs, "Switch", NvsEntityStore::Options{256});
+    {
+        SwitchEntityRepository switches(files, store);
+        for (Int id = 1; id <= 40; id++) {
+            Switch device(id, SwitchState::Off);
+            switches.Save(device);
+        }
+        NvsEntityStore::Stats stats = store->GetStats();
+        ASSERT(stats.records == 40 && stats.packs < 40 && stats.packs >= 40 * 30 / 256,
+               "Records should be packed into blobs");
+
+        store->ResetStats();
+        Switch toggled(7, SwitchState::On);
+        switches.Save(toggled);
+        stats = store->GetStats();
+        ASSERT(stats.packWrites == 1 && stats.directoryWrites == 0, "A toggle should rewrite one pack only");
+        ASSERT(stats.commits == 1, "A toggle should be committed");
+        switches.DeleteById(8);
+        ASSERT(store->GetStats().directoryWrites == 1 && !store->Contains("8"), "A removal should update the directory");
+    }
+
+    // Another store over the partition, as after a restart
+    NvsEntityStorePtr reopened = std::make_shared<NvsEntityStore>(nvs, "Switch");
+    SwitchEntityRepository switches(files, reopened);
+    StdVector<Switch> all = switches.FindAll();
+    ASSERT(all.size() == 39 && all.front().id.value() == 1 && all.back().id.value() == 40,
+           "The directory should list every record in write order");
+    ASSERT(switches.FindById(7).value().virtualState.value() == SwitchState::On, "Records should read back");
+
+    // A directory line whose pack lost the record, as an interrupted move leaves it
+    StdString directory;
+    nvs->GetBlob("Switch", "keys", directory);
+    nvs->SetBlob("Switch", "keys", directory + "0 999\n");
+    NvsEntityStore checked(nvs, "Switch");
+    ASSERT(checked.Keys().size() == 39 && !checked.Contains("999"), "Lines without a record should be dropped");
+
+    // A record that outgrows its pack moves
+    NvsEntityStore small(nvs, "Small", NvsEntityStore::Options{64});
+    for (Int id = 1; id <= 4; id++) {
+        small.Write(std::to_string(id), StdString(20, 'a'));
+    }
+    ASSERT(small.GetStats().packs == 2, "Records should fill packs up to packBytes");
+    ASSERT(small.Write("1", StdString(40, 'b')) && small.Read("1") == StdString(40, 'b') && small.Read("2") == StdString(20, 'a'),
+           "A grown record should move to a pack with room");
+    ASSERT(small.GetStats().packs == 3 && small.Keys().front() == "1", "A move should keep the key order");
+    ASSERT(small.RemoveAll({"1", "2", "3", "4"}) == 4 && small.GetStats().packs == 0 && small.Keys().empty(),
+           "Removing every record should erase the packs");
+
+    // One blob per record, the default
+    NvsEntityStore unpacked(nvs, "Unpacked");
+    unpacked.WriteAll({{"1", "one"}, {"2", "two"}, {"3", "three"}});
+    ASSERT(unpacked.GetStats().packs == 3 && unpacked.GetStats().directoryWrites == 1 && unpacked.Read("3") == "three",
+           "packBytes 0 should give each record its own blob, the directory written once per batch");
+
+    // The partition full, a write fails without losing what was stored
+    NvsEntityStore bulk(nvs, "Bulk");
+    Bool full = false;
+    for (Int id = 0; id < 1000 && !full; id++) {
+        full = !bulk.Write(std::to_string(id), StdString(200, 'x'));
+    }
+    ASSERT(full && bulk.GetPartitionStats().availableEntries < 20, "Writes should fail once the partition is full");
+    ASSERT(bulk.Read("0") == StdString(200, 'x') && bulk.Keys().size() > 10 && switches.FindAll().size() == 39,
+           "A failed write should keep the records stored before");
+
+    testsPassed_entity_repository++;
+    return true;
+}
+
+#ifndef ARDUINO
+// ========== LOG STORE ==========
+
+// A fresh directory under the system temp directory
+inline StdString EntityTestDirectory(CStdString& name) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      (name + "_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory.string();
+}
+
+bool TestEntityLogStoreRepository() {
+    TEST_START("Test Entity Log Store Repository");
+
+    StdString directory = EntityTestDirectory("entity_log_repository");
+    MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+    {
+        // OrderRepository is @Storage("log")
+        OrderEntityRepository orders(files, directory);
+        for (Int id = 1; id <= 6; id++) {
+            Order order;
+            order.id = id;
+            order.orderNumber = "ORD-" + std::to_string(id);
+            order.customerId = id % 2 == 0 ? 7 : 8;
+            orders.Save(order);
+        }
+        orders.DeleteById(2);
+        ASSERT(orders.FindByCustomerId(7).size() == 2, "Indexed queries should read records from the log");
+        StdVector<Order> batch(3);
+        for (Int i = 0; i < 3; i++) {
+            batch[i].id = 7 + i;
+            batch[i].customerId = 9;
+        }
+        orders.SaveAll(batch);
+        orders.DeleteAllById({7, 8, 9, 100});
+        ASSERT(orders.FindByCustomerId(9).empty() && orders.FindAll().size() == 5, "Batches should go through the log");
+        ASSERT(!files->Exists("Order_id_1") && !files->Exists("Order_IDs"), "Records should not go to the file manager");
+    }
+    OrderEntityRepository reopened(files, directory);
+    StdVector<Order> all = reopened.FindAll();
+    ASSERT(all.size() == 5 && all.front().id.value() == 1 && all.back().id.value() == 6,
+           "A reopened log should hold every record in write order");
+    ASSERT(!reopened.ExistsById(2), "A removed record should stay removed");
+    optional<Order> order = reopened.FindByOrderNumber("ORD-5");
+    ASSERT(order.has_value() && order.value().customerId.value() == 8, "Records should read back whole");
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+bool TestEntityLogStoreCrashRecovery() {
+    TEST_START("Test Entity Log Store Crash Recovery");
+
+    StdString directory = EntityTestDirectory("entity_log_recovery");
+    StdString path = directory + "/Product.log";
+    Size intact = 0;
+    {
+        EntityLogStore store(path);
+        for (Int id = 1; id <= 20; id++) {
+            store.Write(std::to_string(id), "record " + std::to_string(id));
+        }
+        store.Remove("5");
+        intact = store.GetStats().fileBytes;
+        store.Write("21", StdString(200, 'x'));
+    }
+    // Cut the last record in half, as a crash during its write would
+    ASSERT(::truncate(path.c_str(), static_cast<off_t>(intact + 100)) == 0, "The log should be truncated");
+    {
+        EntityLogStore store(path);
+        EntityLogStore::Stats stats = store.GetStats();
+        ASSERT(stats.records == 19 && stats.recoveredBytes == 100, "Replay should stop at the torn record");
+        ASSERT(std::filesystem::file_size(path) == intact, "The torn record should be cut from the log");
+        ASSERT(store.Read("20") == "record 20" && store.Read("21").empty() && !store.Contains("5"),
+               "Records before the torn one should survive");
+        store.Write("22", "after recovery");
+    }
+    {
+        EntityLogStore store(path);
+        ASSERT(store.Read("22") == "after recovery" && store.Keys().size() == 20,
+               "Records written after recovery should follow the last whole record");
+    }
+
+    // A flipped byte fails the record's CRC; replay stops there too
+    {
+        FILE* file = std::fopen(path.c_str(), "r+b");
+        std::fseek(file, static_cast<long>(intact) - 3, SEEK_SET);
+        std::fputc('?', file);
+        std::fclose(file);
+    }
+    EntityLogStore damaged(path);
+    ASSERT(damaged.Read("20") == "record 20" && !damaged.Contains("22") && damaged.GetStats().recoveredBytes > 0,
+           "A record failing its CRC should end the replay");
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+bool TestEntityLogStoreCompaction() {
+    TEST_START("Test Entity Log Store Compaction");
+
+    StdString directory = EntityTestDirectory("entity_log_compaction");
+    for (Bool background : {false, true}) {
+        StdString path = directory + (background ? "/background.log" : "/foreground.log");
+        EntityLogStore::Options options;
+        options.backgroundCompaction = background;
+        options.compactMinBytes = 4096;
+        {
+            EntityLogStore store(path, options);
+            for (Int round = 0; round < 40; round++) {
+                for (Int id = 1; id <= 50; id++) {
+                    store.Write(std::to_string(id), "value " + std::to_string(id) + " round " + std::to_string(round));
+                }
+                store.Remove(std::to_string(50 - round % 2));
+            }
+            store.WaitForCompaction();
+            EntityLogStore::Stats stats = store.GetStats();
+            ASSERT(stats.compactions > 0, "Superseded records should trigger compaction");
+            ASSERT(stats.fileBytes < 2 * stats.liveBytes + options.compactMinBytes + 100,
+                   "Compaction should keep the log near its live records");
+            ASSERT(store.Read("7") == "value 7 round 39" && !store.Contains("49") && store.Contains("50"),
+                   "Compaction should keep the latest records");
+            ASSERT(!std::filesystem::exists(path + ".compact"), "The copy should replace the log");
+        }
+        EntityLogStore reopened(path, options);
+        ASSERT(reopened.GetStats().records == 49 && reopened.Read("1") == "value 1 round 39" &&
+               reopened.GetStats().recoveredBytes == 0,
+               "The compacted log should replay cleanly");
+        ASSERT(reopened.Compact() && reopened.GetStats().fileBytes == reopened.GetStats().liveBytes,
+               "An explicit compaction should leave only live records");
+    }
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== MAPPED READS ==========
+
+bool TestEntityRepositoryMappedReads() {
+    TEST_START("Test Entity Repository Mapped Reads");
+
+    StdString directory = EntityTestDirectory("entity_mapped_reads");
+    DirectoryFileManager::Options mapOptions;
+    mapOptions.mapReads = true;
+    mapOptions.mappedFiles = 4;
+    DirectoryFileManagerPtr mappedFiles = std::make_shared<DirectoryFileManager>(directory, mapOptions);
+    DirectoryFileManagerPtr plainFiles = std::make_shared<DirectoryFileManager>(directory);
+    ProductEntityRepository mapped(mappedFiles);
+    for (Int id = 1; id <= 10; id++) {
+        Product product = EntityTestProduct(id, "Product " + std::to_string(id), "C" + std::to_string(id % 2));
+        mapped.Save(product);
+    }
+
+    ProductEntityRepository plain(plainFiles);
+    StdVector<Product> read = plain.FindAll();
+    StdVector<Product> viewed = mapped.FindAll();
+    ASSERT(viewed.size() == 10 && read.size() == 10, "Both should find every product");
+    Bool same = true;
+    for (Size i = 0; i < read.size(); i++) {
+        same = same && nayan::serializer::SerializationUtility::Serialize(read[i]) ==
+                       nayan::serializer::SerializationUtility::Serialize(viewed[i]);
+    }
+    ASSERT(same, "Mapped records should deserialize as read ones do");
+    DirectoryFileManager::Stats stats = mappedFiles->GetStats();
+    ASSERT(stats.mappings == 10 && stats.openMappings == 4, "Only the last mappedFiles mappings should stay open");
+
+    mapped.FindById(10);
+    ASSERT(mappedFiles->GetStats().mappingHits == 1, "A file viewed again should reuse its mapping");
+
+    // A view outlives a rewrite of its file
+    RecordView before = mappedFiles->View("Product_id_10");
+    ASSERT(before.IsMapped(), "View should map the file");
+    Product renamed = EntityTestProduct(10, "Renamed", "C0");
+    mapped.Save(renamed);
+    ASSERT(before.Data().find("\"Product 10\"") != std::string_view::npos, "A held view should keep the old contents");
+    optional<Product> found = mapped.FindById(10);
+    ASSERT(found.has_value() && found.value().name.value() == "Renamed", "A write should drop the file's mapping");
+
+    mapped.DeleteById(9);
+    ASSERT(!mapped.FindById(9).has_value() && mappedFiles->View("Product_id_9").Empty(),
+           "A deleted file should no longer be viewed");
+    ASSERT(!plainFiles->View("Product_id_1").IsMapped(), "Without mapReads View should read");
+
+    // Views taken while the file is rewritten see one whole version or the other
+    StdString first(8192, 'a');
+    StdString second(8192, 'b');
+    mappedFiles->Create("Contended", first);
+    std::atomic<Bool> writing(true);
+    std::atomic<Int> torn(0);
+    StdVector<std::thread> readers;
+    for (Int t = 0; t < 4; t++) {
+        readers.emplace_back([&]() {
+            while (writing.load()) {
+                RecordView view = mappedFiles->View("Contended");
+                std::string_view data = view.Data();
+                if (data != first && data != second) {
+                    torn++;
+                }
+            }
+        });
+    }
+    for (Int i = 0; i < 2000; i++) {
+        mappedFiles->Update("Contended", i % 2 == 0 ? second : first);
+    }
+    writing.store(false);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT(torn == 0, "A view should never see part of a write");
+    Size leftover = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        leftover += entry.path().filename().string().compare(0, 2, ".~") == 0 ? 1 : 0;
+    }
+    ASSERT(leftover == 0 && mappedFiles->List().size() == 12, "Rewrites should leave no temporary files behind");
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== SHARDED DIRECTORIES ==========
+
+bool TestDirectoryFileManagerSharding() {
+    TEST_START("Test Directory File Manager Sharding");
+
+    StdString directory = EntityTestDirectory("entity_sharded_files");
+    DirectoryFileManager::Options shardOptions;
+    shardOptions.shardBuckets = 256;
+    DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory, shardOptions);
+    {
+        ProductEntityRepository products(files);
+        for (Int id = 1; id <= 300; id++) {
+            Product product = EntityTestProduct(id, "Product " + std::to_string(id), "C" + std::to_string(id % 4));
+            products.Save(product);
+        }
+    }
+    StdString path = files->PathOf("Product_id_42");
+    ASSERT(path.size() == directory.size() + 4 + 13 && path.compare(0, directory.size() + 1, directory + "/") == 0 &&
+           path[directory.size() + 3] == '/' && std::filesystem::exists(path), "Files should be in a two-digit shard directory");
+    Size shards = 0;
+    Size rootFiles = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        (entry.is_directory() ? shards : rootFiles)++;
+    }
+    ASSERT(shards > 100 && shards <= 256 && rootFiles == 0, "Files should spread over the shards, none in root");
+
+    // Reopened with the same layout
+    ProductEntityRepository reopened(std::make_shared<DirectoryFileManager>(directory, shardOptions));
+    ASSERT(reopened.FindAll().size() == 300 && reopened.FindByCategory("C1").size() == 75, "A sharded store should read back whole");
+
+    StdVector<StdString> listed = files->List();
+    ASSERT(listed.size() == 302, "List should find every record, the id list and the index");
+    files->Create("Extra", "x");
+    files->Delete("Product_id_1");
+    ASSERT(files->Exists("Extra") && !files->Exists("Product_id_1") && files->List().size() == 302,
+           "The listing should follow the manager's writes");
+    ASSERT(files->GetStats().listScans == 1, "The directories should be scanned once");
+
+    ::setenv(DIRECTORYFILEMANAGER_ROOT_VARIABLE, directory.c_str(), 1);
+    ASSERT(DirectoryFileManager::ConfiguredRoot() == directory, "The environment should set the root");
+    ::unsetenv(DIRECTORYFILEMANAGER_ROOT_VARIABLE);
+    ASSERT(DirectoryFileManager::ConfiguredRoot() == DIRECTORYFILEMANAGER_DEFAULT_ROOT, "The default root should apply otherwise");
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+// ========== TRANSACTIONS ==========
+
+inline Order EntityTestOrder(Int id, Int customerId) {
+    Order order;
+    order.id = id;
+    order.orderNumber = "ORD-" + std::to_string(id);
+    order.customerId = customerId;
+    return order;
+}
+
+bool TestEntityJournalTransactions() {
+    TEST_START("Test Entity Journal Transactions");
+
+    StdString directory = EntityTestDirectory("entity_journal");
+    StdString path = directory + "/entities.journal";
+    {
+        DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory + "/files");
+        ProductEntityRepository products(files);
+        OrderEntityRepository orders(files, directory);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        ProductEntityRepository unsyncable(std::make_shared<MemoryFileManager>());
+        ASSERT(!unsyncable.AttachJournal(journal), "A store that cannot sync should be refused");
+        ASSERT(products.AttachJournal(journal) && orders.AttachJournal(journal), "Stores that sync should attach");
+        ASSERT(journal->Replay() == 0, "A new journal should have nothing to replay");
+
+        EntityTransaction transaction = journal->Begin();
+        Product laptop = EntityTestProduct(1, "Laptop", "Electronics");
+        Order order = EntityTestOrder(1, 7);
+        products.Save(laptop, transaction);
+        orders.Save(order, transaction);
+        ASSERT(!products.ExistsById(1) && !orders.ExistsById(1), "Staged changes should not be visible before commit");
+        ASSERT(transaction.Commit() && !transaction.IsOpen(), "The transaction should commit");
+        ASSERT(products.FindByCategory("Electronics").size() == 1 && orders.FindByCustomerId(7).size() == 1,
+               "A commit should write and index both repositories");
+
+        {
+            EntityTransaction abandoned = journal->Begin();
+            Product phone = EntityTestProduct(2, "Phone", "Electronics");
+            products.Save(phone, abandoned);
+            orders.DeleteById(1, abandoned);
+        }
+        EntityTransaction rolledBack = journal->Begin();
+        Order other = EntityTestOrder(2, 7);
+        orders.Save(other, rolledBack);
+        rolledBack.Rollback();
+        ASSERT(!rolledBack.Commit(), "A rolled back transaction should not commit");
+        ASSERT(!products.ExistsById(2) && orders.ExistsById(1) && !orders.ExistsById(2),
+               "Rolled back changes should never apply");
+
+        EntityTransaction replace = journal->Begin();
+        Product tablet = EntityTestProduct(3, "Tablet", "Electronics");
+        products.DeleteById(1, replace);
+        products.Save(tablet, replace);
+        ASSERT(replace.Commit() && !products.ExistsById(1) && products.FindByCategory("Electronics").size() == 1,
+               "Deletes should commit with saves");
+
+        EntityJournal::Stats stats = journal->GetStats();
+        ASSERT(stats.commits == 2 && stats.rollbacks == 2 && stats.syncs == 2, "Each commit should be journaled once");
+    }
+
+    // A crash after the journal write but before the stores: replay into empty ones
+    {
+        std::filesystem::copy_file(path, path + ".copy");
+        std::filesystem::remove_all(directory + "/Order.log");
+        DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory + "/replayed");
+        ProductEntityRepository products(files);
+        OrderEntityRepository orders(files, directory);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        products.AttachJournal(journal);
+        orders.AttachJournal(journal);
+        ASSERT(journal->Replay() == 2, "Every commit should replay");
+        ASSERT(products.FindByCategory("Electronics").size() == 1 && products.ExistsById(3) && !products.ExistsById(1) &&
+               orders.FindByCustomerId(7).size() == 1, "Replay should rebuild records and indexes");
+        // The products' EntityFileStore syncs through the DirectoryFileManager
+        ASSERT(std::filesystem::file_size(path) == 0 && journal->GetStats().checkpoints == 1 && files->GetStats().syncs > 0,
+               "A replay should sync the stores and empty the journal");
+    }
+
+    // A record cut short, as a crash during the write would leave it
+    std::filesystem::rename(path + ".copy", path);
+    Size full = static_cast<Size>(std::filesystem::file_size(path));
+    ASSERT(::truncate(path.c_str(), static_cast<off_t>(full - 5)) == 0, "The journal should be truncated");
+    {
+        DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory + "/torn");
+        ProductEntityRepository products(files);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        products.AttachJournal(journal);
+        ASSERT(journal->Replay() == 1, "Replay should stop at the torn record");
+        EntityJournal::Stats stats = journal->GetStats();
+        ASSERT(products.ExistsById(1) && !products.ExistsById(3) && stats.recoveredBytes > 0,
+               "Only the whole transaction should apply");
+        ASSERT(stats.droppedOperations == 1 && std::filesystem::file_size(path) > 0,
+               "Changes for a missing repository should keep the journal");
+    }
+    // Nor may a checkpoint drop them later, however large the journal grows
+    {
+        DirectoryFileManagerPtr files = std::make_shared<DirectoryFileManager>(directory + "/torn");
+        ProductEntityRepository products(files);
+        EntityJournal::Options options;
+        options.checkpointBytes = 1;
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path, options);
+        products.AttachJournal(journal);
+        journal->Replay();
+        Size before = static_cast<Size>(std::filesystem::file_size(path));
+        Product phone = EntityTestProduct(2, "Phone", "Electronics");
+        products.Save(phone);
+        ASSERT(journal->GetStats().checkpoints == 0 && std::filesystem::file_size(path) > before,
+               "A checkpoint should not drop changes kept for a missing repository");
+    }
+
+    // Writes outside a transaction after a commit must survive the next replay
+    std::filesystem::remove(path);
+    DirectoryFileManagerPtr kept = std::make_shared<DirectoryFileManager>(directory + "/kept");
+    {
+        ProductEntityRepository products(kept);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        products.AttachJournal(journal);
+        EntityTransaction transaction = journal->Begin();
+        Product laptop = EntityTestProduct(1, "Laptop", "Electronics");
+        Product phone = EntityTestProduct(2, "Phone", "Electronics");
+        products.Save(laptop, transaction);
+        products.Save(phone, transaction);
+        ASSERT(transaction.Commit(), "The transaction should commit");
+        Product renamed = EntityTestProduct(1, "Direct", "Garden");
+        products.Save(renamed);
+        products.DeleteById(2);
+    }
+    {
+        ProductEntityRepository products(kept);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        products.AttachJournal(journal);
+        journal->Replay();
+        optional<Product> laptop = products.FindById(1);
+        ASSERT(laptop.has_value() && laptop.value().name.value() == "Direct" && products.FindByCategory("Electronics").empty(),
+               "A replay should not revert a later direct save");
+        ASSERT(!products.ExistsById(2), "A replay should not bring back a later direct delete");
+    }
+
+    // An apply that throws must not leave later commits waiting for it
+    std::filesystem::remove(path);
+    {
+        ProductEntityRepository products(kept);
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(path);
+        products.AttachJournal(journal);
+        EntityTransaction failing = journal->Begin();
+        StdString record = "{}";
+        failing.Stage("Product", "9", &record, []() { throw std::runtime_error("apply failed"); });
+        Bool threw = false;
+        try {
+            failing.Commit();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ASSERT(threw, "Commit should pass on what an apply throws");
+        EntityTransaction next = journal->Begin();
+        Product tablet = EntityTestProduct(3, "Tablet", "Electronics");
+        products.Save(tablet, next);
+        ASSERT(!next.Commit() && !products.ExistsById(3), "Commits after a failed apply should fail, not hang");
+    }
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+
+bool TestEntityJournalGroupCommit() {
+    TEST_START("Test Entity Journal Group Commit");
+
+    StdString directory = EntityTestDirectory("entity_journal_group");
+    const Int threads = 8;
+    const Int perThread = 25;
+    for (Bool group : {true, false}) {
+        StdString logs = directory + (group ? "/group" : "/single");
+        std::filesystem::create_directories(logs);
+        MemoryFileManagerPtr files = std::make_shared<MemoryFileManager>();
+        // Both over logs, which sync, so checkpoints can empty the journal
+        ProductEntityRepository products(files, std::make_shared<EntityLogStore>(logs + "/Product.log"));
+        OrderEntityRepository orders(files, logs);
+        EntityJournal::Options options;
+        options.groupCommit = group;
+        options.checkpointBytes = 4096;
+        EntityJournalPtr journal = std::make_shared<EntityJournal>(directory + (group ? "/group.journal" : "/single.journal"), options);
+        products.AttachJournal(journal);
+        orders.AttachJournal(journal);
+
+        std::atomic<Int> failures(0);
+        StdVector<std::thread> workers;
+        for (Int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                for (Int i = 0; i < perThread; i++) {
+                    Int id = t * perThread + i + 1;
+                    EntityTransaction transaction = journal->Begin();
+                    Product product = EntityTestProduct(id, "Product", "C" + std::to_string(t));
+                    Order order = EntityTestOrder(id, t);
+                    products.Save(product, transaction);
+                    orders.Save(order, transaction);
+                    if (!transaction.Commit()) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        EntityJournal::Stats stats = journal->GetStats();
+        ASSERT(failures == 0 && stats.commits == threads * perThread, "Every transaction should commit");
+        ASSERT(products.FindAll().size() == threads * perThread && orders.FindByCustomerId(3).size() == perThread &&
+               products.FindByCategory("C5").size() == perThread, "Every committed change should apply");
+        ASSERT(stats.syncs == stats.writes && stats.writes <= stats.commits, "Each journal write should be synced once");
+        ASSERT(group || stats.writes == stats.commits, "Without group commit each commit should write alone");
+        ASSERT(stats.checkpoints > 0 && std::filesystem::file_size(journal->GetPath()) < options.checkpointBytes + 4096,
+               "Checkpoints should keep the journal small");
+    }
+
+    std::filesystem::remove_all(directory);
+    testsPassed_entity_repository++;
+    return true;
+}
+#endif
+
+// ========== RUN ALL TESTS ==========
+
+int RunAllEntityRepositoryTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  EntityRepository Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_entity_repository = 0;
+    testsFailed_entity_repository = 0;
+
+    if (!TestEntityRepositoryCrud()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryIndexedQueries()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryIndexFiles()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryCache()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryBatches()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryPaging()) testsFailed_entity_repository++;
+    if (!TestHashedFileManager()) testsFailed_entity_repository++;
+    if (!TestHashedFileManagerScale()) testsFailed_entity_repository++;
+    if (!TestNvsSimulator()) testsFailed_entity_repository++;
+    if (!TestNvsEntityStore()) testsFailed_entity_repository++;
+#ifndef ARDUINO
+    if (!TestEntityLogStoreRepository()) testsFailed_entity_repository++;
+    if (!TestEntityLogStoreCrashRecovery()) testsFailed_entity_repository++;
+    if (!TestEntityLogStoreCompaction()) testsFailed_entity_repository++;
+    if (!TestEntityRepositoryMappedReads()) testsFailed_entity_repository++;
+    if (!TestDirectoryFileManagerSharding()) testsFailed_entity_repository++;
+    if (!TestEntityJournalTransactions()) testsFailed_entity_repository++;
+    if (!TestEntityJournalGroupCommit()) testsFailed_entity_repository++;
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_entity_repository);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_entity_repository);
+    std_print("Total Tests: ");
+    std_println(testsPassed_entity_repository + testsFailed_entity_repository);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_entity_repository;
+}
+
+#endif // ENTITY_REPOSITORY_TESTS_H
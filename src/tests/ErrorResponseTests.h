@@ -0,0 +1,210 @@
+#ifndef ERROR_RESPONSE_TESTS_H
+#define ERROR_RESPONSE_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+#endif
+
+#include <stdexcept>
+#include <StandardDefines.h>
+#include "../errors/ErrorResponse.h"
+#include "../errors/Expected.h"
+#include "../controller/CustomException.h"
+#include "../server/AppRequestHandler.h"
+#include "TestUtils.h"
+
+// Test counters
+static int testsPassed_error_response = 0;
+static int testsFailed_error_response = 0;
+
+// ========== BODY TEMPLATES ==========
+
+bool TestErrorBodyTemplate() {
+    TEST_START("Test Error Body Template");
+
+    ErrorBodyTemplate withMessage("{\"error\":\"Bad Request\",\"message\":\"{message}\"}");
+    ASSERT(withMessage.HasMessage(), "Placeholder should be found");
+    ASSERT(withMessage.Render("id \"x\" is\nbad") == "{\"error\":\"Bad Request\",\"message\":\"id \\\"x\\\" is\\u000abad\"}",
+           "Message should be JSON-escaped into the placeholder");
+
+    ErrorBodyTemplate fixed("{\"error\":\"Not Found\"}");
+    ASSERT(!fixed.HasMessage() && fixed.Render("ignored") == "{\"error\":\"Not Found\"}", "Fixed bodies ignore the message");
+
+    testsPassed_error_response++;
+    return true;
+}
+
+// ========== NO-THROW PATH ==========
+
+bool TestErrorRegistryRespond() {
+    TEST_START("Test Error Registry Respond");
+
+    ExceptionResponseRegistry registry = ExceptionResponseRegistry::Default();
+    registry.Register<CustomException>(HttpStatus::BAD_REQUEST, "{\"error\":\"Custom\",\"message\":\"{message}\"}");
+
+    ErrorResponse runtime = registry.Respond(std::runtime_error("disk full"));
+    ASSERT(runtime.status == HttpStatus::INTERNAL_SERVER_ERROR, "runtime_error should map to 500");
+    ASSERT(runtime.body == "{\"error\":\"Internal Server Error\",\"message\":\"disk full\"}", "Body should carry what()");
+
+    ASSERT(registry.Respond(std::invalid_argument("id")).status == HttpStatus::BAD_REQUEST, "invalid_argument should map to 400");
+    ASSERT(registry.Respond(CustomException("boom")).body == "{\"error\":\"Custom\",\"message\":\"boom\"}",
+           "CustomException should use its message member");
+
+    ErrorResponse unknown = registry.Respond(42);
+    ASSERT(unknown.status == HttpStatus::INTERNAL_SERVER_ERROR && unknown.body.find("Unknown exception occurred") != StdString::npos,
+           "Unregistered types should use the fallback");
+
+    Expected<Int> failed = Unexpected(std::out_of_range("page 9"), registry);
+    Expected<Int> succeeded = 7;
+    ASSERT(!failed.HasValue() && failed.Error().status == HttpStatus::BAD_REQUEST, "Expected should hold the error");
+    ASSERT(succeeded && succeeded.Value() == 7, "Expected should hold the value");
+
+    testsPassed_error_response++;
+    return true;
+}
+
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+// ========== THROW PATH ==========
+
+template<typename E>
+ErrorResponse TranslateThrown(const ExceptionResponseRegistry& registry, const E& error) {
+    ErrorResponse response;
+    optional<Int> result = registry.Invoke([&]() -> Int { throw error; }, response);
+    return result.has_value() ? ErrorResponse() : response;
+}
+
+// Throwing an error and returning it through Expected must give the same response
+bool TestErrorRegistryTranslateMatchesRespond() {
+    TEST_START("Test Error Registry Translate Matches Respond");
+
+    ExceptionResponseRegistry registry = ExceptionResponseRegistry::Default();
+    registry.Register<CustomException>(HttpStatus::BAD_REQUEST, "{\"error\":\"Custom\",\"message\":\"{message}\"}");
+
+    Bool same = true;
+    ErrorResponse thrown = TranslateThrown(registry, std::runtime_error("a"));
+    ErrorResponse returned = registry.Respond(std::runtime_error("a"));
+    same = same && thrown.status == returned.status && thrown.body == returned.body;
+    thrown = TranslateThrown(registry, std::invalid_argument("b"));
+    returned = registry.Respond(std::invalid_argument("b"));
+    same = same && thrown.status == returned.status && thrown.body == returned.body;
+    thrown = TranslateThrown(registry, CustomException("c"));
+    returned = registry.Respond(CustomException("c"));
+    same = same && thrown.status == returned.status && thrown.body == returned.body;
+    thrown = TranslateThrown(registry, 42);
+    returned = registry.Respond(42);
+    same = same && thrown.status == returned.status && thrown.body == returned.body;
+    ASSERT(same, "Both paths should produce the same status and body");
+
+    try {
+        throw std::invalid_argument("d");
+    } catch (...) {
+        ASSERT(registry.TranslateCurrentException().status == HttpStatus::BAD_REQUEST,
+               "TranslateCurrentException should map like Invoke");
+    }
+    ErrorResponse untouched;
+    ASSERT(registry.Invoke([]() { return 5; }, untouched) == optional<Int>(5), "Invoke should pass results through");
+
+    const char* text = "plain text";
+    ASSERT(TranslateThrown(registry, text).body.find("Unknown exception occurred") != StdString::npos,
+           "const char* should use the fallback until registered");
+    registry.Register<const char*>(HttpStatus::BAD_REQUEST, "{\"error\":\"Bad Request\",\"message\":\"{message}\"}");
+    ASSERT(TranslateThrown(registry, text).body == "{\"error\":\"Bad Request\",\"message\":\"plain text\"}",
+           "Registered const char* should carry its text");
+
+    testsPassed_error_response++;
+    return true;
+}
+
+#if APPREQUESTHANDLER_AVAILABLE
+// What the servers send for an /exception-test route
+HttpServerResponse ErrorResponseTestRequest(const AppRequestHandler& handler, const char* path) {
+    HttpServerRequest request;
+    request.method = "GET";
+    request.target = path;
+    return handler.Handle(request);
+}
+
+// The servers' handler must map what the controller throws through its registry
+bool TestAppRequestHandlerMapsThrownErrors() {
+    TEST_START("Test App Request Handler Maps Thrown Errors");
+
+    ExceptionResponseRegistry registry = ExceptionResponseRegistry::Default();
+    registry.Register<CustomException>(HttpStatus::BAD_REQUEST, "{\"error\":\"Custom\",\"message\":\"{message}\"}");
+    AppRequestHandler handler(nullptr, registry);
+
+    HttpServerResponse runtime = ErrorResponseTestRequest(handler, "/exception-test/runtime-error");
+    ErrorResponse expected = registry.Respond(std::runtime_error("This is a runtime error with a detailed message"));
+    ASSERT(runtime.status == static_cast<Int>(expected.status) && runtime.body == expected.body,
+           "A thrown runtime_error should get the registry's response");
+    HttpServerResponse custom = ErrorResponseTestRequest(handler, "/exception-test/custom-exception");
+    ASSERT(custom.status == 400 && custom.body == "{\"error\":\"Custom\",\"message\":\"This is a custom exception type\"}",
+           "A registered custom exception should get its own mapping");
+    HttpServerResponse integer = ErrorResponseTestRequest(handler, "/exception-test/int-exception");
+    ASSERT(integer.status == 500 && integer.body.find("Unknown exception occurred") != StdString::npos,
+           "An unregistered type should get the fallback");
+    HttpServerResponse returned = ErrorResponseTestRequest(handler, "/exception-test/expected-error");
+    ASSERT(returned.status == runtime.status && returned.body == runtime.body,
+           "An Expected failure should answer like the thrown one");
+    ASSERT(ErrorResponseTestRequest(handler, "/response-entity/int").status == 202,
+           "ResponseEntity routes should keep their status");
+    HttpServerResponse none = ErrorResponseTestRequest(handler, "/response-entity/void");
+    ASSERT(none.status == 404 && none.body.empty(), "A ResponseEntity<Void> should have no body");
+
+    // The fixed answers are the bodies registered for compression up front
+    HttpCompression compression;
+    handler.AddConstantBodies(compression);
+    ASSERT(compression.HasConstant(runtime.body) && compression.HasConstant(custom.body) &&
+           compression.HasConstant(returned.body), "Exception-test bodies should be registered");
+    ASSERT(compression.HasConstant(ErrorResponseTestRequest(handler, "/response-entity/order").body) &&
+           compression.HasConstant(ErrorResponseTestRequest(handler, "/no-such-route").body),
+           "ResponseEntity and 404 bodies should be registered");
+
+    testsPassed_error_response++;
+    return true;
+}
+#endif
+#endif
+
+// Main test runner function
+int RunAllErrorResponseTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  ErrorResponse Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_error_response = 0;
+    testsFailed_error_response = 0;
+
+    if (!TestErrorBodyTemplate()) testsFailed_error_response++;
+    if (!TestErrorRegistryRespond()) testsFailed_error_response++;
+#if ERRORRESPONSE_HAS_EXCEPTIONS
+    if (!TestErrorRegistryTranslateMatchesRespond()) testsFailed_error_response++;
+#if APPREQUESTHANDLER_AVAILABLE
+    if (!TestAppRequestHandlerMapsThrownErrors()) testsFailed_error_response++;
+#endif
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_error_response);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_error_response);
+    std_print("Total Tests: ");
+    std_println(testsPassed_error_response + testsFailed_error_response);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_error_response;
+}
+
+#endif // ERROR_RESPONSE_TESTS_H
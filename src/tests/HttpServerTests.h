@@ -0,0 +1,627 @@
+#ifndef HTTP_SERVER_TESTS_H
+#define HTTP_SERVER_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+    #include <chrono>
+    #include <thread>
+#endif
+
+#include <cstring>
+#include <StandardDefines.h>
+#include "../server/Deflate.h"
+#include "../server/HttpCompression.h"
+#include "../server/HttpMessage.h"
+#include "../server/HttpPagination.h"
+#include "../server/HttpResponseWriter.h"
+#include "../server/RequestArena.h"
+#ifndef ARDUINO
+    #include <atomic>
+    #include "../server/SelectHttpServer.h"
+    #include "../server/ThreadedHttpServer.h"
+#endif
+#include "TestUtils.h"
+
+// Test counters
+static int testsPassed_http_server = 0;
+static int testsFailed_http_server = 0;
+
+// ========== PARSER ==========
+
+bool TestHttpRequestParserComplete() {
+    TEST_START("Test Http Request Parser Complete");
+
+    const char raw[] =
+        "PUT /switch/3/on?source=app HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Type: application/json\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n"
+        "{}"
+        "GET /switch HTTP/1.1\r\n\r\n";
+    HttpServerRequest request;
+    Size consumed = 0;
+    ASSERT(HttpRequestParser::Parse(raw, std::strlen(raw), request, consumed) == HttpParseStatus::Complete,
+           "Request should parse");
+    ASSERT(request.method == "PUT" && request.target == "/switch/3/on?source=app", "Request line should be split");
+    ASSERT(request.Path() == "/switch/3/on", "Path should drop the query");
+    ASSERT(request.Header("content-type") != nullptr && *request.Header("content-type") == "application/json",
+           "Header names should match in any case and values be trimmed");
+    ASSERT(request.body == "{}", "Body should be Content-Length bytes");
+    ASSERT(request.body.data() == std::strstr(raw, "{}") && request.method.data() == raw,
+           "Fields should be views of the buffer, not copies");
+    ASSERT(request.keepAlive, "HTTP/1.1 should keep the connection open by default");
+
+    // A second request in the same buffer starts where the first ended
+    const char* next = raw + consumed;
+    ASSERT(HttpRequestParser::Parse(next, std::strlen(next), request, consumed) == HttpParseStatus::Complete &&
+           request.method == "GET" && request.body.empty(), "Following request should parse on its own");
+
+    StdString closing = "GET / HTTP/1.1\r\nConnection: Close\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(closing.data(), closing.size(), request, consumed) == HttpParseStatus::Complete &&
+           !request.keepAlive, "Connection: close should end keep-alive");
+    StdString http10 = "GET / HTTP/1.0\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(http10.data(), http10.size(), request, consumed) == HttpParseStatus::Complete &&
+           !request.keepAlive, "HTTP/1.0 should close unless asked to keep alive");
+    http10 = "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(http10.data(), http10.size(), request, consumed) == HttpParseStatus::Complete &&
+           request.keepAlive, "HTTP/1.0 keep-alive should be honoured");
+
+    ASSERT(HttpRequestParser::Parse(raw, 20, request, consumed) == HttpParseStatus::Incomplete,
+           "Truncated headers should need more data");
+    Size withoutBody = std::strstr(raw, "{}") - raw + 1;
+    ASSERT(HttpRequestParser::Parse(raw, withoutBody, request, consumed) == HttpParseStatus::Incomplete,
+           "Truncated body should need more data");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestHttpRequestParserRejects() {
+    TEST_START("Test Http Request Parser Rejects");
+
+    HttpServerRequest request;
+    Size consumed = 0;
+    StdString garbage = "hello\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(garbage.data(), garbage.size(), request, consumed) == HttpParseStatus::Malformed,
+           "A line that is not a request line should be rejected");
+
+    StdString chunked = "POST /x HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(chunked.data(), chunked.size(), request, consumed) == HttpParseStatus::Malformed,
+           "Chunked bodies are not supported");
+
+    StdString badLength = "POST /x HTTP/1.1\r\nContent-Length: 1x\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(badLength.data(), badLength.size(), request, consumed) == HttpParseStatus::Malformed,
+           "Content-Length must be a number");
+
+    StdString conflicting = "POST /x HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\nab";
+    ASSERT(HttpRequestParser::Parse(conflicting.data(), conflicting.size(), request, consumed) == HttpParseStatus::Malformed,
+           "Content-Lengths that disagree should be rejected");
+    ASSERT(HttpParseErrorResponse(HttpParseStatus::Malformed).status == 400, "Malformed requests should map to 400");
+
+    StdString lengthAndChunked = "POST /x HTTP/1.1\r\nContent-Length: 2\r\nTransfer-Encoding: chunked\r\n\r\nab";
+    ASSERT(HttpRequestParser::Parse(lengthAndChunked.data(), lengthAndChunked.size(), request, consumed) == HttpParseStatus::Malformed,
+           "Content-Length with Transfer-Encoding should be rejected");
+
+    StdString repeated = "POST /x HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nab";
+    ASSERT(HttpRequestParser::Parse(repeated.data(), repeated.size(), request, consumed) == HttpParseStatus::Complete &&
+           request.body == "ab", "A repeated Content-Length with the same value is accepted");
+
+    StdString huge = "POST /x HTTP/1.1\r\nContent-Length: 99999999\r\n\r\n";
+    ASSERT(HttpRequestParser::Parse(huge.data(), huge.size(), request, consumed) == HttpParseStatus::BodyTooLarge,
+           "Oversized bodies should be refused before they arrive");
+
+    StdString endless = "GET /" + StdString(HTTPSERVER_MAX_HEADER_BYTES, 'a');
+    ASSERT(HttpRequestParser::Parse(endless.data(), endless.size(), request, consumed) == HttpParseStatus::HeadersTooLarge,
+           "Headers past the limit should be refused");
+
+    ASSERT(HttpParseErrorResponse(HttpParseStatus::BodyTooLarge).status == 413, "Too large body should map to 413");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestRequestArena() {
+    TEST_START("Test Request Arena");
+
+    RequestArena arena;
+    const StdString request = "PUT /switch/1/on HTTP/1.1\r\nHost: device\r\n\r\n";
+    HttpServerRequest parsed;
+    Size capacity = 0;
+    for (Int round = 0; round < 50; round++) {
+        // One and a half requests arrive; the half waits for the next round
+        StdString received = round == 0 ? request + request.substr(0, 10) : request.substr(10) + request.substr(0, 10);
+        char* tail = arena.Reserve(received.size());
+        std::memcpy(tail, received.data(), received.size());
+        arena.Commit(received.size());
+
+        Size consumed = 0;
+        std::string_view pending = arena.Pending();
+        ASSERT(HttpRequestParser::Parse(pending.data(), pending.size(), parsed, consumed) == HttpParseStatus::Complete &&
+               parsed.Path() == "/switch/1/on", "Request should parse from the arena");
+        arena.Consume(consumed);
+        ASSERT(HttpRequestParser::Parse(arena.Pending().data(), arena.Pending().size(), parsed, consumed) ==
+               HttpParseStatus::Incomplete, "The partial request should wait");
+        arena.Reset();
+        ASSERT(arena.Pending() == request.substr(0, 10), "Reset should keep the partial request");
+        if (round == 1) {
+            capacity = arena.Capacity();
+        }
+    }
+    ASSERT(capacity == HTTPSERVER_ARENA_INITIAL_BYTES && arena.Capacity() == capacity,
+           "The block should be reused, not reallocated");
+
+    // Growing keeps the unconsumed bytes
+    arena.Reserve(HTTPSERVER_ARENA_INITIAL_BYTES * 3);
+    ASSERT(arena.Capacity() >= HTTPSERVER_ARENA_INITIAL_BYTES * 3 && arena.Pending() == request.substr(0, 10),
+           "Growing should move the pending bytes");
+    arena.Clear();
+    ASSERT(arena.Pending().empty(), "Clear should drop everything");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestFormatHttpResponse() {
+    TEST_START("Test Format Http Response");
+
+    HttpServerResponse response;
+    response.status = 404;
+    response.body = "{}";
+    ASSERT(FormatHttpResponse(response, false) ==
+           "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\nContent-Length: 2\r\nConnection: close\r\n\r\n{}",
+           "Response should have status line, headers and body");
+    ASSERT(FormatHttpResponse(response, true).find("Connection: keep-alive\r\n") != StdString::npos,
+           "Kept-alive responses should say so");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+// A switch list as GET /switch returns it, count entries long
+StdString HttpServerTestSwitchList(Int count) {
+    StdString body = "[";
+    for (Int i = 1; i <= count; i++) {
+        body += i > 1 ? "," : "";
+        body += "{\"id\":" + std::to_string(i) + ",\"virtualState\":\"Off\",\"physicalSwitchState\":\"Off\",\"relayState\":\"Off\"}";
+    }
+    return body + "]";
+}
+
+bool TestPageRequest() {
+    TEST_START("Test Page Request");
+
+    PageRequest defaults = PageRequest::FromTarget("/orders");
+    ASSERT(defaults.page == 0 && defaults.size == HTTPSERVER_DEFAULT_PAGE_SIZE && defaults.sort.empty() && defaults.ascending,
+           "A target without a query should use the defaults");
+    PageRequest request = PageRequest::FromTarget("/orders?source=app&page=2&size=5&sort=customerId,desc");
+    ASSERT(request.page == 2 && request.size == 5 && request.sort == "customerId" && !request.ascending,
+           "Page, size and sort should be read");
+    PageRequest capped = PageRequest::FromTarget("/orders?size=100000&page=x&sort=name");
+    ASSERT(capped.size == HTTPSERVER_MAX_PAGE_SIZE && capped.page == 0 && capped.sort == "name" && capped.ascending,
+           "Size should be capped and malformed values ignored");
+    ASSERT(PageRequest::FromTarget("/orders?size=0").size == HTTPSERVER_DEFAULT_PAGE_SIZE, "A zero size should be ignored");
+
+    StdString chunked;
+    AppendHttpChunkedHead(200, "application/json", true, chunked);
+    AppendHttpChunk(StdString(26, 'a'), chunked);
+    AppendHttpChunk("", chunked);
+    chunked += kHttpLastChunk;
+    ASSERT(chunked == "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n"
+                      "Connection: keep-alive\r\n\r\n1a\r\n" + StdString(26, 'a') + "\r\n0\r\n\r\n",
+           "Chunks should be framed with their hex length");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestDeflateEncoder() {
+    TEST_START("Test Deflate Encoder");
+
+    ASSERT(DeflateEncoder::Crc32("123456789") == 0xCBF43926u, "CRC-32 should match the check value");
+    ASSERT(DeflateEncoder::Adler32("Wikipedia") == 0x11E60398u, "Adler-32 should match the known value");
+
+    DeflateEncoder encoder;
+    StdString raw;
+    encoder.Raw("a", raw);
+    ASSERT(raw == StdString("\x4b\x04\x00", 3), "A literal should use the fixed code");
+    raw.clear();
+    encoder.Raw("abcabcabcabc", raw);
+    ASSERT(raw == StdString("\x4b\x4c\x4a\x86\x23\x00", 6), "Repeats should become one match");
+
+    StdString body = HttpServerTestSwitchList(100);
+    StdString gzip;
+    encoder.Gzip(body, gzip);
+    ASSERT(gzip.compare(0, 3, "\x1f\x8b\x08") == 0, "gzip member should start with its magic and method");
+    uint32_t size = 0;
+    uint32_t crc = 0;
+    for (Int i = 3; i >= 0; i--) {
+        crc = (crc << 8) | static_cast<uint8_t>(gzip[gzip.size() - 8 + i]);
+        size = (size << 8) | static_cast<uint8_t>(gzip[gzip.size() - 4 + i]);
+    }
+    ASSERT(crc == DeflateEncoder::Crc32(body) && size == body.size(), "gzip trailer should hold CRC and size");
+    ASSERT(gzip.size() * 8 < body.size(), "A switch list should shrink more than eightfold");
+
+    StdString zlib;
+    encoder.Zlib(body, zlib);
+    ASSERT(zlib.compare(0, 2, "\x78\x01") == 0 && zlib.size() == gzip.size() - 18 + 6,
+           "zlib stream should carry the same data with its own framing");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestHttpCompression() {
+    TEST_START("Test Http Compression");
+
+    std::string_view header = "gzip, deflate, br";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Gzip, "gzip should be preferred");
+    header = "deflate, gzip;q=0";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Deflate, "q=0 should refuse a coding");
+    header = "*;q=1, gzip; q=0.000";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Deflate, "* should cover codings not listed");
+    header = "deflate;q=1, gzip;q=0.1";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Deflate, "The higher q-value should win");
+    header = "gzip;q=0.5, deflate;q=0.500";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Gzip, "gzip should win a tie");
+    header = "gzip;q=0.2, *;q=0.8";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Deflate, "* should lend its q-value to deflate");
+    header = "br, identity";
+    ASSERT(HttpCompression::Negotiate(&header) == HttpContentCoding::Identity, "Unknown codings should be ignored");
+    ASSERT(HttpCompression::Negotiate(nullptr) == HttpContentCoding::Identity, "No header should mean identity");
+
+    HttpCompression compression(256);
+    HttpCompression::Buffers buffers;
+    HttpServerRequest request;
+    request.headers.emplace_back("Accept-Encoding", "gzip");
+    HttpServerRequest plain;
+
+    HttpServerResponse small;
+    small.body = "{\"id\":1}";
+    compression.Apply(request, small, buffers);
+    ASSERT(small.contentCoding == HttpContentCoding::Identity && !small.varyAcceptEncoding,
+           "Bodies under the threshold should be left alone");
+
+    StdString list = HttpServerTestSwitchList(20);
+    HttpServerResponse large;
+    large.body = list;
+    compression.Apply(plain, large, buffers);
+    ASSERT(large.body == list && large.varyAcceptEncoding, "Without Accept-Encoding the body should stay as is but vary");
+    compression.Apply(request, large, buffers);
+    ASSERT(large.contentCoding == HttpContentCoding::Gzip && large.body.size() < list.size(), "Large bodies should be gzipped");
+    ASSERT(FormatHttpResponse(large, true).find("\r\nContent-Encoding: gzip\r\nVary: Accept-Encoding\r\nContent-Length: ") !=
+           StdString::npos, "Encoded responses should say so");
+
+    // Constants are served from the cache at any size
+    StdString constant = HttpServerTestSwitchList(2);
+    compression.AddConstant(constant);
+    StdString expected;
+    DeflateEncoder().Gzip(constant, expected);
+    HttpServerResponse cached;
+    cached.body = constant;
+    compression.Apply(request, cached, buffers);
+    ASSERT(cached.contentCoding == HttpContentCoding::Gzip && cached.body == expected,
+           "A constant body should be sent precompressed");
+    compression.AddConstant("{}");
+    HttpServerResponse tiny;
+    tiny.body = "{}";
+    compression.Apply(request, tiny, buffers);
+    ASSERT(tiny.body == "{}" && !tiny.varyAcceptEncoding, "A constant that does not shrink should be sent as is");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+#ifndef ARDUINO
+// Everything readable from fd within 100 ms
+StdString HttpServerTestDrain(Int fd) {
+    StdString received;
+    char chunk[4096];
+    pollfd readable{fd, POLLIN, 0};
+    while (poll(&readable, 1, 100) > 0) {
+        ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+        if (count <= 0) {
+            break;
+        }
+        received.append(chunk, static_cast<Size>(count));
+    }
+    return received;
+}
+
+bool TestHttpResponseWriter() {
+    TEST_START("Test Http Response Writer");
+
+    int fds[2];
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "Socket pair should open");
+    HttpResponseWriter writer;
+    StdString expected;
+
+    HttpServerResponse& json = writer.Next();
+    json.body = "{\"id\":1}";
+    writer.Commit(true);
+    expected += FormatHttpResponse(json, true);
+
+    HttpServerResponse& text = writer.Next();
+    text.status = 203;
+    text.contentType = "text/plain";
+    text.body = "ORD-12345";
+    writer.Commit(true);
+    expected += FormatHttpResponse(text, true);
+
+    // No constant status line for 299, and no body
+    HttpServerResponse unusual;
+    unusual.status = 299;
+    expected += FormatHttpResponse(unusual, false);
+    writer.Add(std::move(unusual), false);
+
+    ASSERT(writer.Write(fds[0]) && writer.Empty(), "Queued responses should be written");
+    ASSERT(HttpServerTestDrain(fds[1]) == expected, "Bytes should match FormatHttpResponse");
+    ASSERT(writer.GetSyscallCount() == 1, "Pipelined responses should go out in one writev");
+    ASSERT(writer.GetBytesCopied() == 1 + 1 + std::strlen("HTTP/1.1 299 OK\r\n") + 1,
+           "Only the Content-Length digits and the unusual status line should be formatted");
+
+    // A body larger than the socket buffer goes out over several writes
+    HttpServerResponse& large = writer.Next();
+    large.body.assign(1 << 20, 'x');
+    writer.Commit(false);
+    StdString received;
+    std::thread reader([&]() { received = HttpServerTestDrain(fds[1]); });
+    ASSERT(writer.Flush(fds[0], 1000), "Flush should wait for the reader");
+    reader.join();
+    ASSERT(received.size() > (1u << 20) && received.compare(received.size() - 4, 4, "xxxx") == 0,
+           "The whole body should arrive");
+
+    close(fds[0]);
+    close(fds[1]);
+    testsPassed_http_server++;
+    return true;
+}
+
+Int HttpServerTestConnect(uint16_t port) {
+    Int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends raw bytes to 127.0.0.1:port and returns everything read until the server
+// closes, so the last request must ask for Connection: close
+StdString HttpServerTestExchange(uint16_t port, const StdString& request) {
+    Int fd = HttpServerTestConnect(port);
+    StdString response;
+    if (fd >= 0 && send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+        char chunk[1024];
+        ssize_t received;
+        while ((received = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+            response.append(chunk, static_cast<Size>(received));
+        }
+    }
+    close(fd);
+    return response;
+}
+
+// Slow handlers on different workers must overlap, not queue behind each other
+bool TestThreadedHttpServerParallel() {
+    TEST_START("Test Threaded Http Server Parallel");
+
+    const Int kClients = 4;
+    const auto kHandlerTime = std::chrono::milliseconds(100);
+    ThreadedHttpServer server([&](const HttpServerRequest& request) {
+        std::this_thread::sleep_for(kHandlerTime);
+        HttpServerResponse response;
+        response.body = StdString(request.Path());
+        return response;
+    }, kClients);
+    ASSERT(server.Start(0, "127.0.0.1"), "Server should start on a free port");
+
+    StdVector<StdString> responses(kClients);
+    StdVector<std::thread> clients;
+    auto start = std::chrono::steady_clock::now();
+    for (Int i = 0; i < kClients; i++) {
+        clients.emplace_back([&, i]() {
+            responses[i] = HttpServerTestExchange(server.GetPort(), "GET /client/" + std::to_string(i) + " HTTP/1.1\r\nConnection: close\r\n\r\n");
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    for (Int i = 0; i < kClients; i++) {
+        StdString expected = "/client/" + std::to_string(i);
+        ASSERT(responses[i].compare(0, 15, "HTTP/1.1 200 OK") == 0 &&
+               responses[i].size() >= expected.size() &&
+               responses[i].compare(responses[i].size() - expected.size(), expected.size(), expected) == 0,
+               "Each client should get its own response");
+    }
+    ASSERT(elapsed < kHandlerTime * (kClients - 1), "Requests should be handled in parallel");
+
+    ASSERT(HttpServerTestExchange(server.GetPort(), "nonsense\r\n\r\n").compare(0, 24, "HTTP/1.1 400 Bad Request") == 0,
+           "Malformed requests should get 400");
+
+    // A request a worker holds when Stop() is called is still answered
+    StdString late;
+    std::thread client([&]() {
+        late = HttpServerTestExchange(server.GetPort(), "GET /late HTTP/1.1\r\nConnection: close\r\n\r\n");
+    });
+    std::this_thread::sleep_for(kHandlerTime / 2);
+    server.Stop();
+    client.join();
+    ASSERT(!server.IsRunning(), "Server should stop");
+    ASSERT(late.compare(0, 15, "HTTP/1.1 200 OK") == 0 && late.size() > 5 && late.compare(late.size() - 5, 5, "/late") == 0,
+           "Stop should let a request in flight finish");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+// Keeps one connection open for a request, then pipelines three more (the last
+// split across two sends and asking to close); shared by both servers' tests
+bool HttpServerTestPipelinedExchange(uint16_t port) {
+    Int fd = HttpServerTestConnect(port);
+    ASSERT(fd >= 0, "Client should connect");
+    StdString first = "GET /one HTTP/1.1\r\n\r\n";
+    send(fd, first.data(), first.size(), 0);
+    char buffer[512];
+    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+    ASSERT(received > 0 && StdString(buffer, static_cast<Size>(received)).find("keep-alive\r\n\r\n/one") != StdString::npos,
+           "First response should keep the connection");
+
+    StdString pipelined = "GET /two HTTP/1.1\r\n\r\nPOST /three HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+                          "GET /four HTTP/1.1\r\nConn";
+    send(fd, pipelined.data(), pipelined.size(), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    StdString rest = "ection: close\r\n\r\n";
+    send(fd, rest.data(), rest.size(), 0);
+    StdString responses;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        responses.append(buffer, static_cast<Size>(received));
+    }
+    close(fd);
+    Size two = responses.find("\r\n\r\n/two");
+    Size three = responses.find("\r\n\r\n/threeabc");
+    Size four = responses.find("close\r\n\r\n/four");
+    ASSERT(two != StdString::npos && three != StdString::npos && four != StdString::npos && two < three && three < four,
+           "Pipelined requests should be answered in order");
+    return true;
+}
+
+HttpServerResponse HttpServerTestEcho(const HttpServerRequest& request) {
+    HttpServerResponse response;
+    response.body = StdString(request.Path());
+    response.body.append(request.body.data(), request.body.size());
+    return response;
+}
+
+bool TestThreadedHttpServerKeepAlive() {
+    TEST_START("Test Threaded Http Server Keep-Alive");
+
+    ThreadedHttpServer server(HttpServerTestEcho, 2);
+    ASSERT(server.Start(0, "127.0.0.1"), "Server should start on a free port");
+
+    Int idle = HttpServerTestConnect(server.GetPort());
+    ASSERT(HttpServerTestPipelinedExchange(server.GetPort()), "Keep-alive and pipelining should work");
+    ASSERT(server.GetConnectionCount() == 1, "Idle connection should stay open");
+    close(idle);
+
+    // Larger than the arena's first block, so it grows mid-request
+    StdString large(HTTPSERVER_ARENA_INITIAL_BYTES * 3, 'x');
+    StdString reply = HttpServerTestExchange(server.GetPort(), "POST /large HTTP/1.1\r\nConnection: close\r\nContent-Length: " +
+                                                               std::to_string(large.size()) + "\r\n\r\n" + large);
+    ASSERT(reply.size() > large.size() && reply.compare(reply.size() - large.size() - 6, StdString::npos, "/large" + large) == 0,
+           "A request larger than the arena's first block should be read whole");
+
+    server.Stop();
+    ASSERT(server.GetConnectionCount() == 0, "Stop should close every connection");
+
+    testsPassed_http_server++;
+    return true;
+}
+
+bool TestThreadedHttpServerCompression() {
+    TEST_START("Test Threaded Http Server Compression");
+
+    StdString list = HttpServerTestSwitchList(100);
+    HttpCompression compression;
+    ThreadedHttpServer server([&](const HttpServerRequest&, HttpServerResponse& response) { response.body = list; }, 1);
+    server.SetCompression(&compression);
+    ASSERT(server.Start(0, "127.0.0.1"), "Server should start on a free port");
+
+    StdString gzipped = HttpServerTestExchange(server.GetPort(),
+                                               "GET /switch HTTP/1.1\r\nAccept-Encoding: gzip\r\nConnection: close\r\n\r\n");
+    StdString expected;
+    DeflateEncoder().Gzip(list, expected);
+    ASSERT(gzipped.find("Content-Encoding: gzip\r\n") != StdString::npos &&
+           gzipped.find("Content-Length: " + std::to_string(expected.size()) + "\r\n") != StdString::npos &&
+           gzipped.compare(gzipped.size() - expected.size(), expected.size(), expected) == 0,
+           "Clients accepting gzip should get the gzipped body");
+    StdString plain = HttpServerTestExchange(server.GetPort(), "GET /switch HTTP/1.1\r\nConnection: close\r\n\r\n");
+    ASSERT(plain.find("Content-Encoding") == StdString::npos && plain.size() > list.size() &&
+           plain.compare(plain.size() - list.size(), list.size(), list) == 0,
+           "Other clients should get the body as is");
+
+    server.Stop();
+    testsPassed_http_server++;
+    return true;
+}
+
+// The ESP32 loop, driven from a thread standing in for loop()
+bool TestSelectHttpServerKeepAlive() {
+    TEST_START("Test Select Http Server Keep-Alive");
+
+    SelectHttpServer server(HttpServerTestEcho);
+    ASSERT(server.Start(0, "127.0.0.1"), "Server should start on a free port");
+    std::atomic<Bool> stop{false};
+    std::thread loop([&]() {
+        while (!stop.load()) {
+            server.Poll(10);
+        }
+    });
+
+    Bool exchanged = HttpServerTestPipelinedExchange(server.GetPort());
+    stop.store(true);
+    loop.join();
+    ASSERT(exchanged, "Keep-alive and pipelining should work");
+    ASSERT(server.GetConnectionCount() == 0, "Closed connection should free its slot");
+    server.Stop();
+
+    testsPassed_http_server++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllHttpServerTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  HttpServer Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_http_server = 0;
+    testsFailed_http_server = 0;
+
+    if (!TestHttpRequestParserComplete()) testsFailed_http_server++;
+    if (!TestHttpRequestParserRejects()) testsFailed_http_server++;
+    if (!TestRequestArena()) testsFailed_http_server++;
+    if (!TestFormatHttpResponse()) testsFailed_http_server++;
+    if (!TestPageRequest()) testsFailed_http_server++;
+    if (!TestDeflateEncoder()) testsFailed_http_server++;
+    if (!TestHttpCompression()) testsFailed_http_server++;
+#ifndef ARDUINO
+    if (!TestHttpResponseWriter()) testsFailed_http_server++;
+    if (!TestThreadedHttpServerParallel()) testsFailed_http_server++;
+    if (!TestThreadedHttpServerKeepAlive()) testsFailed_http_server++;
+    if (!TestThreadedHttpServerCompression()) testsFailed_http_server++;
+    if (!TestSelectHttpServerKeepAlive()) testsFailed_http_server++;
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_http_server);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_http_server);
+    std_print("Total Tests: ");
+    std_println(testsPassed_http_server + testsFailed_http_server);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_http_server;
+}
+
+#endif // HTTP_SERVER_TESTS_H
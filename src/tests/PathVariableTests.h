@@ -0,0 +1,207 @@
+#ifndef PATH_VARIABLE_TESTS_H
+#define PATH_VARIABLE_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+#endif
+
+#include <cstdint>
+#include <string_view>
+#include <StandardDefines.h>
+#include "../router/PathVariable.h"
+#include "../router/StaticRouteTable.h"
+#include "TestUtils.h"
+
+#if __has_include(<GeneratedRouteAdapters.h>)
+    #include <GeneratedRouteAdapters.h>
+    #define PATH_VARIABLE_TESTS_HAVE_ADAPTERS 1
+#else
+    #define PATH_VARIABLE_TESTS_HAVE_ADAPTERS 0
+#endif
+
+// Test counters
+static int testsPassed_path_variable = 0;
+static int testsFailed_path_variable = 0;
+
+// Enum with hand-written names, so the enum parser is tested without the generator
+enum class PathVariableTestColor { Red, Green, Blue };
+
+template<>
+struct PathVariableEnumNames<PathVariableTestColor> {
+    Static constexpr Bool available = true;
+    Static constexpr PathVariableEnumEntry<PathVariableTestColor> entries[] = {
+        {"Red", PathVariableTestColor::Red},
+        {"Green", PathVariableTestColor::Green},
+        {"Blue", PathVariableTestColor::Blue},
+    };
+};
+
+template<typename T>
+inline PathVariableError ParsePathText(const char* text, T& out) {
+    return PathVariableParser<T>::Parse(std::string_view(text), out);
+}
+
+// ========== PARSERS ==========
+
+bool TestPathVariableIntegers() {
+    TEST_START("Test Path Variable Integers");
+
+    Int value = 0;
+    int8_t small = 0;
+    uint16_t port = 0;
+    int64_t wide = 0;
+    ASSERT(ParsePathText("42", value) == PathVariableError::None && value == 42, "42 should parse");
+    ASSERT(ParsePathText("-7", value) == PathVariableError::None && value == -7, "-7 should parse");
+    ASSERT(ParsePathText("12abc", value) == PathVariableError::Malformed, "Trailing text should be malformed");
+    ASSERT(ParsePathText("abc", value) == PathVariableError::Malformed, "Letters should be malformed");
+    ASSERT(ParsePathText("+5", value) == PathVariableError::Malformed, "A plus sign should be malformed");
+    ASSERT(ParsePathText("", value) == PathVariableError::Empty, "Empty text should be rejected");
+    ASSERT(ParsePathText("99999999999", value) == PathVariableError::OutOfRange, "Values past Int should be out of range");
+    ASSERT(ParsePathText("128", small) == PathVariableError::OutOfRange, "128 should not fit int8_t");
+    ASSERT(ParsePathText("-1", port) == PathVariableError::Malformed, "Unsigned values should not take a sign");
+    ASSERT(ParsePathText("65535", port) == PathVariableError::None && port == 65535, "65535 should fit uint16_t");
+    ASSERT(ParsePathText("99999999999999999999", wide) == PathVariableError::OutOfRange,
+           "Values past int64 should be out of range, not malformed");
+    ASSERT(value == -7, "A rejected value should leave the output untouched");
+
+    testsPassed_path_variable++;
+    return true;
+}
+
+bool TestPathVariableOtherTypes() {
+    TEST_START("Test Path Variable Other Types");
+
+    bool flag = false;
+    double ratio = 0;
+    std::string_view view;
+    StdString copy;
+    PathVariableTestColor color = PathVariableTestColor::Red;
+
+    ASSERT(ParsePathText("true", flag) == PathVariableError::None && flag, "true should parse");
+    ASSERT(ParsePathText("yes", flag) == PathVariableError::Malformed, "yes should be malformed");
+    ASSERT(ParsePathText("2.5", ratio) == PathVariableError::None && ratio == 2.5, "2.5 should parse");
+    ASSERT(ParsePathText("1e999", ratio) == PathVariableError::OutOfRange, "Infinity should be out of range");
+    ASSERT(ParsePathText("MyNetwork", view) == PathVariableError::None && view == "MyNetwork", "Views should pass through");
+    ASSERT(ParsePathText("MyNetwork", copy) == PathVariableError::None && copy == "MyNetwork", "Strings should be copied");
+    ASSERT(ParsePathText("Blue", color) == PathVariableError::None && color == PathVariableTestColor::Blue, "Blue should parse");
+    ASSERT(ParsePathText("blue", color) == PathVariableError::UnknownValue, "Enum names are case-sensitive");
+    ASSERT(ParsePathText("2", color) == PathVariableError::UnknownValue, "Enum ordinals are not accepted");
+
+    testsPassed_path_variable++;
+    return true;
+}
+
+// ParsePathVariable works on a route match's captures and names the failing variable
+bool TestParsePathVariableFromMatch() {
+    TEST_START("Test Parse Path Variable From Match");
+
+    // What the matcher records for /api/{version}/user/{userId} on /api/v2/user/12x
+    StaticRouteMatch match;
+    match.routeId = 1;
+    match.Capture("v2");
+    match.Capture("12x");
+
+    StdString version;
+    Int userId = 0;
+    PathVariableFailure failure;
+    ASSERT(ParsePathVariable(match, 0, "version", version, failure) && version == "v2", "version should parse");
+    ASSERT(!ParsePathVariable(match, 1, "userId", userId, failure), "userId should be rejected");
+    ASSERT(failure.Failed() && failure.error == PathVariableError::Malformed, "Failure should be malformed");
+    ASSERT(failure.Message() == "Invalid path variable 'userId': malformed", "Message should name the variable");
+    ASSERT(!ParsePathVariable(match, 5, "missing", userId, failure) && failure.error == PathVariableError::Missing,
+           "A capture index past the match should be missing");
+
+    testsPassed_path_variable++;
+    return true;
+}
+
+#if PATH_VARIABLE_TESTS_HAVE_ADAPTERS
+// ========== GENERATED ADAPTERS ==========
+
+// Records what the adapter passed in, instead of touching hardware
+struct RecordingSwitchController {
+    Int calls = 0;
+    Int lastId = -1;
+    SwitchState lastState = SwitchState::Off;
+
+    Int SetSwitchState(Int id, SwitchState state) {
+        calls++;
+        lastId = id;
+        lastState = state;
+        return id;
+    }
+};
+
+bool TestGeneratedAdapterParsesAndInvokes() {
+    TEST_START("Test Generated Adapter Parses And Invokes");
+
+    typedef SwitchController_SetSwitchState_Adapter Adapter;
+    RecordingSwitchController controller;
+
+    StaticRouteMatch match = MatchGeneratedRoute(RouteMethod::Put, "/switch/3/state/On");
+    ASSERT(match.routeId == static_cast<Int>(Adapter::routeId), "PUT /switch/3/state/On should match");
+    Adapter::PathVariables variables;
+    PathVariableFailure failure;
+    ASSERT(Adapter::Parse(match, variables, failure), "Variables should parse");
+    ASSERT(variables.id == 3 && variables.state == SwitchState::On, "id and state should be typed");
+    ASSERT(Adapter::Invoke(controller, variables) == 3 && controller.lastState == SwitchState::On,
+           "Invoke should call the handler with typed arguments");
+
+    const char* rejected[] = {"/switch/abc/state/On", "/switch/3/state/Dim", "/switch/99999999999/state/Off"};
+    Bool allRejected = true;
+    for (const char* path : rejected) {
+        StaticRouteMatch bad = MatchGeneratedRoute(RouteMethod::Put, path);
+        PathVariableFailure badFailure;
+        allRejected = allRejected && bad.Found() && !Adapter::Parse(bad, variables, badFailure) && badFailure.Failed();
+    }
+    ASSERT(allRejected, "Malformed, unknown and out-of-range values should be rejected");
+    ASSERT(controller.calls == 1, "Rejected requests should never reach the handler");
+
+    testsPassed_path_variable++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllPathVariableTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  PathVariable Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_path_variable = 0;
+    testsFailed_path_variable = 0;
+
+    if (!TestPathVariableIntegers()) testsFailed_path_variable++;
+    if (!TestPathVariableOtherTypes()) testsFailed_path_variable++;
+    if (!TestParsePathVariableFromMatch()) testsFailed_path_variable++;
+#if PATH_VARIABLE_TESTS_HAVE_ADAPTERS
+    if (!TestGeneratedAdapterParsesAndInvokes()) testsFailed_path_variable++;
+#else
+    std_println("  GeneratedRouteAdapters.h not generated, skipping adapter tests");
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_path_variable);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_path_variable);
+    std_print("Total Tests: ");
+    std_println(testsPassed_path_variable + testsFailed_path_variable);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_path_variable;
+}
+
+#endif // PATH_VARIABLE_TESTS_H
@@ -0,0 +1,257 @@
+#ifndef RADIX_ROUTER_TESTS_H
+#define RADIX_ROUTER_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+#endif
+
+#include <StandardDefines.h>
+#include "../router/RadixRouter.h"
+#include "../server/AppRequestHandler.h"
+#include "TestUtils.h"
+
+// Test counters
+static int testsPassed_radix_router = 0;
+static int testsFailed_radix_router = 0;
+
+// ========== MATCHING ==========
+
+bool TestRadixLiteralAndVariableRoutes() {
+    TEST_START("Test Radix Literal And Variable Routes");
+
+    RadixRouter router;
+    ASSERT(router.Insert("/api/user/create", 1), "Literal route should insert");
+    ASSERT(router.Insert("/api/user/{userId}/get", 2), "Variable route should insert");
+    ASSERT(router.Insert("/api/user/{userId}/profile/{section}", 3), "Two-variable route should insert");
+
+    RadixRouteMatch literal = router.Match("/api/user/create");
+    ASSERT(literal.handlerId == 1 && literal.captureCount == 0, "Literal path should match without captures");
+
+    RadixRouteMatch single = router.Match("/api/user/123/get");
+    ASSERT(single.handlerId == 2, "Variable path should match");
+    ASSERT(single.captureCount == 1 && single.captures[0] == "123", "userId should be captured by index");
+    ASSERT(single.Capture("userId") == "123", "userId should be found by name");
+
+    RadixRouteMatch mixed = router.Match("/api/user/456/profile/settings");
+    ASSERT(mixed.handlerId == 3 && mixed.route->pattern == "/api/user/{userId}/profile/{section}", "Mixed path should match");
+    ASSERT(mixed.Capture("section") == "settings", "section should be settings");
+
+    ASSERT(!router.Match("/api/user/123/delete").Found(), "Unknown suffix should not match");
+    ASSERT(!router.Match("/api/user/123").Found(), "Shorter path should not match");
+    ASSERT(!router.Match("/api/user/123/get/extra").Found(), "Longer path should not match");
+    ASSERT(!router.Match("").Found(), "Empty path should not match");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+// Captures must point into the path passed in, not into copies
+bool TestRadixCapturesAreViews() {
+    TEST_START("Test Radix Captures Are Views");
+
+    RadixRouter router;
+    router.Insert("/switch/{id}/on", 7);
+
+    StdString path = "/switch/42/on?force=true";
+    RadixRouteMatch match = router.Match(path);
+    ASSERT(match.handlerId == 7, "Query string should be ignored");
+    ASSERT(match.captures[0].data() == path.data() + 8 && match.captures[0].size() == 2,
+           "id should be a view into the request path");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+bool TestRadixLiteralPriorityAndBacktracking() {
+    TEST_START("Test Radix Literal Priority And Backtracking");
+
+    RadixRouter router;
+    router.Insert("/wifi-credentials", 1);
+    router.Insert("/wifi-credentials/{ssid}", 2);
+    router.Insert("/wifi-credentials/last-connected", 3);
+    router.Insert("/files/latest/meta", 4);
+    router.Insert("/files/{name}/size", 5);
+
+    ASSERT(router.Match("/wifi-credentials").handlerId == 1, "Base path should match");
+    ASSERT(router.Match("/wifi-credentials/MyNetwork").Capture("ssid") == "MyNetwork", "ssid should be captured");
+    ASSERT(router.Match("/wifi-credentials/last-connected").handlerId == 3, "Literal should win over variable");
+    ASSERT(router.Match("/wifi-credentials/last").handlerId == 2, "Partial literal should fall back to the variable");
+
+    RadixRouteMatch backtracked = router.Match("/files/latest/size");
+    ASSERT(backtracked.handlerId == 5 && backtracked.captures[0] == "latest",
+           "A literal branch that fails deeper should backtrack to the variable");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+bool TestRadixTrailingSlash() {
+    TEST_START("Test Radix Trailing Slash");
+
+    RadixRouter router;
+    router.Insert("/xyz", 1);
+    router.Insert("/xyz/{ssid}", 2);
+    router.Insert("/api/user/{userId}", 3);
+    router.Insert("/", 4);
+
+    ASSERT(router.Match("/xyz/").handlerId == 1, "/xyz/ should match the literal /xyz");
+    ASSERT(router.Match("/xyz/something").handlerId == 2, "/xyz/something should match the variable");
+    ASSERT(!router.Match("/api/user/123/").Found(), "Trailing slash after a variable should not match");
+    ASSERT(router.Match("/").handlerId == 4, "Root should match");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+// Shared prefixes are split inside segments, e.g. /api/users vs /api/user/...
+bool TestRadixSharedPrefixes() {
+    TEST_START("Test Radix Shared Prefixes");
+
+    RadixRouter router;
+    router.Insert("/api/users", 1);
+    router.Insert("/api/users/{userId}", 2);
+    router.Insert("/api/users/{userId}/posts", 3);
+    router.Insert("/api/users/{userId}/posts/{postId}", 4);
+    router.Insert("/api/users/{userId}/posts/{postId}/comments", 5);
+    router.Insert("/api/user", 6);
+    router.Insert("/api/userinfo", 7);
+
+    ASSERT(router.Match("/api/users").handlerId == 1, "/api/users should match");
+    ASSERT(router.Match("/api/users/123").handlerId == 2, "/api/users/123 should match");
+    ASSERT(router.Match("/api/users/456/posts").handlerId == 3, "posts should match");
+    RadixRouteMatch comments = router.Match("/api/users/202/posts/303/comments");
+    ASSERT(comments.handlerId == 5, "comments should match");
+    ASSERT(comments.Capture("userId") == "202" && comments.Capture("postId") == "303", "Both ids should be captured");
+    ASSERT(router.Match("/api/user").handlerId == 6, "/api/user should match");
+    ASSERT(router.Match("/api/userinfo").handlerId == 7, "/api/userinfo should match");
+    ASSERT(!router.Match("/api/use").Found(), "A prefix of a route should not match");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+bool TestRadixManyVariables() {
+    TEST_START("Test Radix Many Variables");
+
+    RadixRouter router;
+    ASSERT(router.Insert("/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}", 1), "Eight variables should fit");
+    ASSERT(!router.Insert("/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}", 2), "Nine variables should be rejected");
+
+    RadixRouteMatch match = router.Match("/1/2/3/4/5/6/7/8");
+    ASSERT(match.handlerId == 1 && match.captureCount == 8, "All eight values should be captured");
+    ASSERT(match.captures[0] == "1" && match.captures[7] == "8", "Captures should be in path order");
+
+    StdString longValue(500, 'A');
+    router.Insert("/api/user/{userId}", 3);
+    ASSERT(router.Match("/api/user/" + longValue).Capture("userId") == longValue, "Long values should be preserved");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+bool TestRadixInsertRules() {
+    TEST_START("Test Radix Insert Rules");
+
+    RadixRouter router;
+    ASSERT(router.IsEmpty(), "New router should be empty");
+    ASSERT(!router.Insert("api/user", 1), "Pattern without leading slash should be rejected");
+    ASSERT(!router.Insert("/api/user{id}", 1), "Partial-segment variable should be rejected");
+    ASSERT(!router.Insert("/api/{}", 1), "Unnamed variable should be rejected");
+    ASSERT(!router.Insert("/api/{id", 1), "Unclosed variable should be rejected");
+
+    ASSERT(router.Insert("/api/user/{id}", 1), "Valid pattern should insert");
+    ASSERT(router.Insert("/api/user/{id}", 9), "Re-inserting should replace the handler");
+    ASSERT(router.GetRoutes().size() == 1, "Re-inserting should not add a route");
+    ASSERT(router.Match("/api/user/5").handlerId == 9, "Latest handler id should be returned");
+
+    router.Clear();
+    ASSERT(router.IsEmpty() && !router.Match("/api/user/5").Found(), "Clear should remove every route");
+
+    testsPassed_radix_router++;
+    return true;
+}
+
+#if APPREQUESTHANDLER_AVAILABLE
+// Routes added at runtime are served when the generated table has no match
+bool TestAppRequestHandlerRuntimeRoutes() {
+    TEST_START("Test App Request Handler Runtime Routes");
+
+    AppRequestHandler handler(nullptr);
+    ASSERT(!handler.AddRoute(RouteMethod::Get, "plugins/{name}", nullptr), "Malformed pattern should be rejected");
+    ASSERT(handler.AddRoute(RouteMethod::Get, "/plugins/{name}/status",
+                            [](const HttpServerRequest&, const RadixRouteMatch& match, HttpServerResponse& response) {
+                                response.contentType = "text/plain";
+                                response.body = "status of " + StdString(match.Capture("name"));
+                            }), "Runtime route should be added");
+    ASSERT(handler.AddRoute(RouteMethod::Post, "/response-entity/int",
+                            [](const HttpServerRequest&, const RadixRouteMatch&, HttpServerResponse& response) {
+                                response.status = 201;
+                            }), "A pattern the table serves for another method should be added");
+
+    HttpServerRequest request;
+    request.method = "GET";
+    request.target = "/plugins/fan/status?verbose=1";
+    HttpServerResponse status = handler.Handle(request);
+    ASSERT(status.status == 200 && status.body == "status of fan", "Runtime route should answer with its captures");
+
+    request.method = "POST";
+    request.target = "/plugins/fan/status";
+    ASSERT(handler.Handle(request).status == 404, "Runtime routes should only match their own method");
+    request.target = "/response-entity/int";
+    ASSERT(handler.Handle(request).status == 201, "Runtime route should serve a method the table lacks");
+
+    request.method = "GET";
+    ASSERT(handler.Handle(request).status == 202, "Generated routes should win over runtime ones");
+    request.target = "/plugins/fan";
+    ASSERT(handler.Handle(request).status == 404, "Paths no router matches should get 404");
+
+    testsPassed_radix_router++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllRadixRouterTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  RadixRouter Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_radix_router = 0;
+    testsFailed_radix_router = 0;
+
+    if (!TestRadixLiteralAndVariableRoutes()) testsFailed_radix_router++;
+    if (!TestRadixCapturesAreViews()) testsFailed_radix_router++;
+    if (!TestRadixLiteralPriorityAndBacktracking()) testsFailed_radix_router++;
+    if (!TestRadixTrailingSlash()) testsFailed_radix_router++;
+    if (!TestRadixSharedPrefixes()) testsFailed_radix_router++;
+    if (!TestRadixManyVariables()) testsFailed_radix_router++;
+    if (!TestRadixInsertRules()) testsFailed_radix_router++;
+#if APPREQUESTHANDLER_AVAILABLE
+    if (!TestAppRequestHandlerRuntimeRoutes()) testsFailed_radix_router++;
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_radix_router);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_radix_router);
+    std_print("Total Tests: ");
+    std_println(testsPassed_radix_router + testsFailed_radix_router);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_radix_router;
+}
+
+#endif // RADIX_ROUTER_TESTS_H
@@ -0,0 +1,215 @@
+#ifndef ROUTE_METRICS_TESTS_H
+#define ROUTE_METRICS_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+    #include <thread>
+#endif
+
+#include <memory>
+#include <StandardDefines.h>
+#include "../metrics/RouteMetrics.h"
+#include "TestUtils.h"
+
+// Test counters
+static int testsPassed_route_metrics = 0;
+static int testsFailed_route_metrics = 0;
+
+// ========== HISTOGRAM ==========
+
+// Buckets must tile the range: each latency falls below its bucket's upper
+// bound and at or above the previous one
+bool TestRouteMetricsBuckets() {
+    TEST_START("Test Route Metrics Buckets");
+
+    ASSERT(RouteMetrics::BucketIndex(0) == 0 && RouteMetrics::BucketIndex(63) == 0, "0-63 ns should be bucket 0");
+    ASSERT(RouteMetrics::BucketIndex(64) == 1, "64 ns should be bucket 1");
+    ASSERT(RouteMetrics::BucketIndex(~0ull) == RouteMetrics::kBucketCount - 1, "Huge latencies should saturate");
+
+    Bool tiled = true;
+    for (Size i = 1; i + 1 < RouteMetrics::kBucketCount && tiled; i++) {
+        uint64_t lower = RouteMetrics::BucketUpperNanos(i - 1);
+        uint64_t upper = RouteMetrics::BucketUpperNanos(i);
+        tiled = lower < upper && RouteMetrics::BucketIndex(lower) == i && RouteMetrics::BucketIndex(upper - 1) == i &&
+                (i < 4 || (upper - lower) * 4 <= upper);
+    }
+    ASSERT(tiled, "Buckets should be contiguous and, past 256 ns, at most 25% wide");
+
+    testsPassed_route_metrics++;
+    return true;
+}
+
+// ========== RECORDING ==========
+
+bool TestRouteMetricsRecord() {
+    TEST_START("Test Route Metrics Record");
+
+    // Kept off the stack: a RouteMetrics is over 10 KiB
+    std::unique_ptr<RouteMetrics> metrics(new RouteMetrics());
+    Int sw = metrics->RegisterRoute("PUT", "/switch/{id}/on");
+    Int all = metrics->RegisterRoute("GET", "/switch");
+    ASSERT(sw == 0 && all == 1, "Route ids should be assigned in order");
+
+    metrics->Record(sw, 200, 1000);
+    metrics->Record(sw, 200, 3000);
+    metrics->Record(sw, 404, 500);
+    metrics->Record(sw, 418, 500);
+    metrics->Record(RouteMetrics::kUnmatchedRoute, 404, 100);
+    metrics->Record(57, 404, 100);
+    {
+        RouteRequestTimer timer(*metrics, all);
+    }
+
+    StdVector<RouteMetricsSnapshot> snapshots = metrics->Snapshot();
+    ASSERT(snapshots.size() == 3, "Two routes and the unmatched slot should have data");
+    const RouteMetricsSnapshot& first = snapshots[0];
+    ASSERT(first.pattern == "/switch/{id}/on" && first.requests == 4 && first.sumNanos == 5000, "Totals should add up");
+    ASSERT(first.statuses.size() == 3 && first.statuses[0].first == 200 && first.statuses[0].second == 2,
+           "200 should be counted twice");
+    ASSERT(first.statuses[2].first == 0 && first.statuses[2].second == 1, "418 should be counted as other");
+    ASSERT(snapshots[1].statuses.size() == 1 && snapshots[1].statuses[0].first == 500,
+           "A timer without a status should count as 500");
+    ASSERT(snapshots[2].pattern == "unmatched" && snapshots[2].requests == 2, "Unknown ids should count as unmatched");
+
+    metrics->Reset();
+    ASSERT(metrics->Snapshot().empty() && metrics->GetRouteCount() == 2, "Reset should keep the routes");
+
+    Bool refused = false;
+    for (Size i = 0; i <= RouteMetrics::kMaxRoutes && !refused; i++) {
+        refused = metrics->RegisterRoute("GET", "/x") < 0;
+    }
+    ASSERT(refused, "Registration past kMaxRoutes should be refused");
+
+#if STATICROUTE_HAS_GENERATED_TABLE
+    ASSERT(RouteMetrics::Global().GetRouteCount() == kGeneratedRouteCount,
+           "Global() should register the generated routes, so route ids line up");
+#endif
+
+    testsPassed_route_metrics++;
+    return true;
+}
+
+// ========== EXPOSITION ==========
+
+bool TestRouteMetricsPrometheus() {
+    TEST_START("Test Route Metrics Prometheus");
+
+    std::unique_ptr<RouteMetrics> metrics(new RouteMetrics());
+    Int sw = metrics->RegisterRoute("PUT", "/switch/{id}/on");
+    metrics->Record(sw, 200, 100);
+    metrics->Record(sw, 200, 1000);
+    metrics->Record(sw, 404, 1000);
+    StdString text = metrics->WritePrometheus();
+
+    ASSERT(text.find("# TYPE http_requests_total counter\n") != StdString::npos, "Counter TYPE line expected");
+    ASSERT(text.find("http_requests_total{method=\"PUT\",route=\"/switch/{id}/on\",code=\"200\"} 2\n") != StdString::npos,
+           "200 count line expected");
+    ASSERT(text.find("http_request_duration_seconds_bucket{method=\"PUT\",route=\"/switch/{id}/on\",le=\"1.28e-07\"} 1\n") !=
+               StdString::npos,
+           "Cumulative bucket for 100 ns expected");
+    ASSERT(text.find("le=\"+Inf\"} 3\n") != StdString::npos, "+Inf bucket should hold every request");
+    ASSERT(text.find("http_request_duration_seconds_count{method=\"PUT\",route=\"/switch/{id}/on\"} 3\n") != StdString::npos,
+           "Count line expected");
+
+    testsPassed_route_metrics++;
+    return true;
+}
+
+bool TestRouteMetricsBinaryRoundTrip() {
+    TEST_START("Test Route Metrics Binary Round Trip");
+
+    std::unique_ptr<RouteMetrics> metrics(new RouteMetrics());
+    Int sw = metrics->RegisterRoute("PUT", "/switch/{id}/on");
+    Int all = metrics->RegisterRoute("GET", "/switch");
+    for (Int i = 0; i < 300; i++) {
+        metrics->Record(i % 2 == 0 ? sw : all, i % 3 == 0 ? 404 : 200, static_cast<uint64_t>(i) * 997);
+    }
+    StdVector<RouteMetricsSnapshot> expected = metrics->Snapshot();
+    StdString binary = metrics->WriteBinary();
+
+    StdVector<RouteMetricsSnapshot> decoded;
+    ASSERT(RouteMetrics::DecodeBinary(binary, decoded), "Binary form should decode");
+    Bool same = decoded.size() == expected.size();
+    for (Size i = 0; i < decoded.size() && same; i++) {
+        same = decoded[i].method == expected[i].method && decoded[i].pattern == expected[i].pattern &&
+               decoded[i].requests == expected[i].requests && decoded[i].sumNanos == expected[i].sumNanos &&
+               decoded[i].statuses == expected[i].statuses && decoded[i].buckets == expected[i].buckets;
+    }
+    ASSERT(same, "Decoded snapshots should equal the originals");
+    ASSERT(binary.size() < metrics->WritePrometheus().size() / 4, "Binary form should be much smaller than the text");
+    ASSERT(!RouteMetrics::DecodeBinary(binary.substr(0, binary.size() - 1), decoded), "Truncated data should be rejected");
+
+    testsPassed_route_metrics++;
+    return true;
+}
+
+#ifndef ARDUINO
+// Concurrent Record() calls must not lose counts
+bool TestRouteMetricsConcurrentRecord() {
+    TEST_START("Test Route Metrics Concurrent Record");
+
+    std::unique_ptr<RouteMetrics> metrics(new RouteMetrics());
+    Int route = metrics->RegisterRoute("GET", "/switch");
+    const Int perThread = 20000;
+    StdVector<std::thread> threads;
+    for (Int t = 0; t < 4; t++) {
+        threads.emplace_back([&metrics, route, perThread]() {
+            for (Int i = 0; i < perThread; i++) {
+                metrics->Record(route, 200, 150);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    StdVector<RouteMetricsSnapshot> snapshots = metrics->Snapshot();
+    ASSERT(snapshots.size() == 1 && snapshots[0].requests == 4u * perThread, "Every request should be counted");
+    ASSERT(snapshots[0].sumNanos == 150ull * 4 * perThread, "Latency sum should be exact");
+
+    testsPassed_route_metrics++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllRouteMetricsTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  RouteMetrics Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_route_metrics = 0;
+    testsFailed_route_metrics = 0;
+
+    if (!TestRouteMetricsBuckets()) testsFailed_route_metrics++;
+    if (!TestRouteMetricsRecord()) testsFailed_route_metrics++;
+    if (!TestRouteMetricsPrometheus()) testsFailed_route_metrics++;
+    if (!TestRouteMetricsBinaryRoundTrip()) testsFailed_route_metrics++;
+#ifndef ARDUINO
+    if (!TestRouteMetricsConcurrentRecord()) testsFailed_route_metrics++;
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_route_metrics);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_route_metrics);
+    std_print("Total Tests: ");
+    std_println(testsPassed_route_metrics + testsFailed_route_metrics);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_route_metrics;
+}
+
+#endif // ROUTE_METRICS_TESTS_H
@@ -0,0 +1,158 @@
+#ifndef STATIC_ROUTE_TABLE_TESTS_H
+#define STATIC_ROUTE_TABLE_TESTS_H
+
+// Conditionally include headers based on platform
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #include <string>
+#else
+    #include <iostream>
+    #include <string>
+#endif
+
+#include <StandardDefines.h>
+#include "EndpointTrie.h"
+#include "../router/StaticRouteTable.h"
+#include "TestUtils.h"
+
+// Test counters
+static int testsPassed_static_route_table = 0;
+static int testsFailed_static_route_table = 0;
+
+// ========== PATH SPLITTING ==========
+
+bool TestRouteSegmentsSplit() {
+    TEST_START("Test Route Segments Split");
+
+    RouteSegments segments;
+    ASSERT(RouteSegments::Split("/switch/3/on?force=1", segments), "Path with a query should split");
+    ASSERT(segments.count == 3 && segments.View(0) == "switch" && segments.View(1) == "3" && segments.View(2) == "on",
+           "Segments should stop at the query");
+    ASSERT(segments.keys[0] == RouteSegmentKey("switch"), "Keys should match RouteSegmentKey");
+    ASSERT(!segments.trailingSlash, "No trailing slash expected");
+
+    ASSERT(RouteSegments::Split("/xyz/", segments) && segments.count == 1 && segments.trailingSlash,
+           "A trailing slash should be dropped and remembered");
+    ASSERT(RouteSegments::Split("/", segments) && segments.count == 0 && !segments.trailingSlash, "Root has no segments");
+    ASSERT(RouteSegments::Split("/a//b", segments) && segments.count == 3 && segments.lengths[1] == 0,
+           "Empty segments should be kept");
+    ASSERT(!RouteSegments::Split("", segments), "Empty path should be rejected");
+    ASSERT(!RouteSegments::Split("switch/3", segments), "Relative path should be rejected");
+    ASSERT(!RouteSegments::Split("/1/2/3/4/5/6/7/8/9/10/11/12/13/14/15/16/17", segments),
+           "Paths deeper than STATICROUTE_MAX_SEGMENTS should be rejected");
+
+    testsPassed_static_route_table++;
+    return true;
+}
+
+#if STATICROUTE_HAS_GENERATED_TABLE
+// ========== GENERATED TABLE ==========
+
+// Every generated route, requested with its variables filled in, must resolve to
+// itself and to the route EndpointTrie picks
+bool TestGeneratedTableMatchesEveryRoute() {
+    TEST_START("Test Generated Table Matches Every Route");
+
+    EndpointTrie trie;
+    for (const StaticRoute& route : kGeneratedRoutes) {
+        trie.Insert(route.pattern);
+    }
+
+    Bool allMatch = true;
+    for (Size i = 0; i < kGeneratedRouteCount && allMatch; i++) {
+        StdString path;
+        for (const char* c = kGeneratedRoutes[i].pattern; *c != '\0'; c++) {
+            if (*c == '{') {
+                path += "42";
+                while (*c != '}') c++;
+            } else {
+                path += *c;
+            }
+        }
+        StaticRouteMatch match = MatchGeneratedRoute(kGeneratedRoutes[i].method, path);
+        EndpointMatchResult expected = trie.Search(path);
+        allMatch = match.routeId == static_cast<Int>(i) &&
+                   match.captureCount == kGeneratedRoutes[i].variableCount &&
+                   expected.found && expected.pattern == kGeneratedRoutes[i].pattern;
+        if (!allMatch) {
+            std_print("  mismatch on ");
+            std_println(path.c_str());
+        }
+    }
+    ASSERT(allMatch, "Generated matcher should agree with EndpointTrie on every route");
+
+    testsPassed_static_route_table++;
+    return true;
+}
+
+bool TestGeneratedTableMethodsAndMisses() {
+    TEST_START("Test Generated Table Methods And Misses");
+
+    ASSERT(!MatchGeneratedRoute(RouteMethod::Delete, "/switch").Found(), "Unmapped method should not match");
+    ASSERT(!MatchGeneratedRoute(RouteMethod::Get, "/no/such/route").Found(), "Unknown path should not match");
+    ASSERT(!MatchGeneratedRoute(RouteMethod::Unknown, "/switch").Found(), "Unknown method should not match");
+    ASSERT(RouteMethodFromString("PUT") == RouteMethod::Put, "PUT should parse");
+    ASSERT(RouteMethodFromString("put") == RouteMethod::Unknown, "Methods are case-sensitive");
+
+    testsPassed_static_route_table++;
+    return true;
+}
+
+bool TestGeneratedTableSwitchRoutes() {
+    TEST_START("Test Generated Table Switch Routes");
+
+    StdString path = "/switch/3/on";
+    StaticRouteMatch on = MatchGeneratedRoute(RouteMethod::Put, path);
+    ASSERT(on.routeId == static_cast<Int>(GeneratedRouteId::SwitchController_TurnOnSwitch), "PUT /switch/3/on should match");
+    ASSERT(on.captureCount == 1 && on.captures[0] == "3" && on.captures[0].data() == path.data() + 8,
+           "id should be a view into the path");
+
+    ASSERT(MatchGeneratedRoute(RouteMethod::Get, "/switch/").routeId ==
+               static_cast<Int>(GeneratedRouteId::SwitchController_GetAllSwitchState),
+           "Trailing slash after a literal should match");
+    ASSERT(!MatchGeneratedRoute(RouteMethod::Get, "/switch/3/").Found(), "Trailing slash after a variable should not match");
+    ASSERT(!MatchGeneratedRoute(RouteMethod::Put, "/switch//on").Found(), "Empty variable should not match");
+
+    testsPassed_static_route_table++;
+    return true;
+}
+#endif
+
+// Main test runner function
+int RunAllStaticRouteTableTests() {
+    std_println("");
+    std_println("========================================");
+    std_println("  StaticRouteTable Tests");
+    std_println("========================================");
+    std_println("");
+
+    testsPassed_static_route_table = 0;
+    testsFailed_static_route_table = 0;
+
+    if (!TestRouteSegmentsSplit()) testsFailed_static_route_table++;
+#if STATICROUTE_HAS_GENERATED_TABLE
+    if (!TestGeneratedTableMatchesEveryRoute()) testsFailed_static_route_table++;
+    if (!TestGeneratedTableMethodsAndMisses()) testsFailed_static_route_table++;
+    if (!TestGeneratedTableSwitchRoutes()) testsFailed_static_route_table++;
+#else
+    std_println("  GeneratedRouteTable.h not generated, skipping generated-table tests");
+#endif
+
+    // Print summary
+    std_println("");
+    std_println("========================================");
+    std_println("  Test Summary");
+    std_println("========================================");
+    std_print("Tests Passed: ");
+    std_println(testsPassed_static_route_table);
+    std_print("Tests Failed: ");
+    std_println(testsFailed_static_route_table);
+    std_print("Total Tests: ");
+    std_println(testsPassed_static_route_table + testsFailed_static_route_table);
+    std_println("========================================");
+    std_println("");
+
+    return testsFailed_static_route_table;
+}
+
+#endif // STATIC_ROUTE_TABLE_TESTS_H
@@ -11,15 +11,7 @@
 #endif
 
 // Print macros - compatible with both Arduino and non-Arduino
-#ifdef ARDUINO
-    // Arduino version using Serial.print/Serial.println
-    #define std_print(x) Serial.print(x)
-    #define std_println(x) Serial.println(x)
-#else
-    // Non-Arduino version using std::cout
-    #define std_print(x) std::cout << x
-    #define std_println(x) std::cout << x << std::endl
-#endif
+#include "../StdPrint.h"
 
 // Test helper macros - compatible with both Arduino and non-Arduino
 #ifdef ARDUINO